@@ -0,0 +1,174 @@
+/**
+ * @file ADC_LADDER.c
+ * @brief Resistor-ladder button banks on one ADC pin, sampled by circular DMA.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Functions:
+ * - ADC_LADDER_Init, ADC_LADDER_Deinit: One BUTTON per key, ADC started in circular DMA.
+ * - ADC_LADDER_Update: Classifies the samples written since the last call.
+ * - ADC_LADDER_GetKey, ADC_LADDER_KeyIndex: Key <-> button.
+ * - ADC_LADDER_Pressed: Key accepted now.
+ */
+
+
+
+#include "ADC_LADDER.h"
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef ADC_LADDER_Init(ADC_LADDER_t* lad, ADC_HandleTypeDef* hadc, uint16_t* buf, uint16_t len,
+                                  const uint16_t* levels, uint8_t keys,
+                                  ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t)) {
+    if (lad == NULL || hadc == NULL || buf == NULL || len == 0 || levels == NULL) return HAL_ERROR;
+    if (keys == 0 || keys > ADC_LADDER_MAX_KEYS) return HAL_ERROR;
+
+    // Nominal codes further apart than the hysteresis on each side, or two bands would overlap
+    for (uint8_t k = 0; k < keys; k++) {
+        uint32_t next = (k + 1U < keys) ? levels[k + 1U] : ADC_LADDER_IDLE;
+        if (next <= levels[k] || next - levels[k] <= 2U * ADC_LADDER_HYST) return HAL_ERROR;
+    }
+
+    *lad = (ADC_LADDER_t){ .hadc = hadc, .Buf = buf, .Len = len, .Keys = keys };
+    for (uint8_t k = 0; k < keys; k++) {
+        uint32_t next = (k + 1U < keys) ? levels[k + 1U] : ADC_LADDER_IDLE;
+        lad->Bound[k] = (uint16_t)((levels[k] + next + 1U) / 2U);
+    }
+    lad->Bound[keys] = 0xFFFFU;     // above any code: the search always ends
+    lad->Candidate = keys;
+    lad->Run = ADC_LADDER_STABLE;
+    lad->Current = keys;
+
+    for (uint8_t k = 0; k < keys; k++) {
+        Button_t* key = BUTTON_InitExternal(mode, Handler);
+        if (key == NULL) {
+            ADC_LADDER_Deinit(lad);     // BUTTON_MAX too small for the ladder
+            return HAL_ERROR;
+        }
+        lad->Btn[k] = key;
+    }
+
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t*)buf, len) != HAL_OK) {
+        ADC_LADDER_Deinit(lad);
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+void ADC_LADDER_Deinit(ADC_LADDER_t* lad) {
+    if (lad == NULL) return;
+    if (lad->hadc != NULL && lad->Keys) HAL_ADC_Stop_DMA(lad->hadc);
+    for (uint8_t k = 0; k < ADC_LADDER_MAX_KEYS; k++) {
+        BUTTON_Deinit(lad->Btn[k]);
+        lad->Btn[k] = NULL;
+    }
+    lad->Keys = 0;
+}
+
+// ========== Classification ==========
+
+// Class of a sample: the band of the previous one, widened by the hysteresis, is tried first
+static inline uint8_t ADC_LADDER_Classify(const ADC_LADDER_t* lad, uint8_t prev, uint32_t v) {
+    uint32_t lo = prev ? lad->Bound[prev - 1U] : 0U;
+    if (v + ADC_LADDER_HYST >= lo && v < (uint32_t)lad->Bound[prev] + ADC_LADDER_HYST) return prev;
+
+    uint8_t k = 0;
+    while (v >= lad->Bound[k]) k++;
+    return k;
+}
+
+// The key read on the ladder changed: release the old one, press the new one
+static void ADC_LADDER_Accept(ADC_LADDER_t* lad, uint8_t key) {
+    uint8_t old = lad->Current;
+    lad->Current = key;
+    if (old < lad->Keys) BUTTON_SetLevel(lad->Btn[old], 0);
+    if (key < lad->Keys) BUTTON_SetLevel(lad->Btn[key], 1);
+}
+
+// Samples from Tail up to the DMA position: one compare (or a short search) each
+void ADC_LADDER_Update(ADC_LADDER_t* lad) {
+    if (lad->Keys == 0) return;
+
+    uint16_t head = (uint16_t)(lad->Len - __HAL_DMA_GET_COUNTER(lad->hadc->DMA_Handle));
+    if (head >= lad->Len) head = 0;
+    uint16_t tail = lad->Tail;
+    if (tail == head) return;
+
+    uint8_t cand = lad->Candidate;
+    uint8_t run = lad->Run;
+    lad->Samples += (uint32_t)((head + lad->Len - tail) % lad->Len);
+    do {
+        uint8_t k = ADC_LADDER_Classify(lad, cand, lad->Buf[tail]);
+        if (k != cand) {
+            cand = k;
+            run = 1;
+        } else if (run < ADC_LADDER_STABLE) {
+            if (++run == ADC_LADDER_STABLE && cand != lad->Current) ADC_LADDER_Accept(lad, cand);
+        }
+        if (++tail == lad->Len) tail = 0;
+    } while (tail != head);
+
+    lad->Tail = tail;
+    lad->Candidate = cand;
+    lad->Run = run;
+}
+
+// ========== Keys ==========
+
+Button_t* ADC_LADDER_GetKey(const ADC_LADDER_t* lad, uint8_t key) {
+    if (key >= lad->Keys) return NULL;
+    return lad->Btn[key];
+}
+
+// Position of a key in the levels table (for a handler shared by all keys), -1 if not a key
+int16_t ADC_LADDER_KeyIndex(const ADC_LADDER_t* lad, const Button_t* btn) {
+    for (uint8_t k = 0; k < lad->Keys; k++) {
+        if (lad->Btn[k] == btn) return (int16_t)k;
+    }
+    return -1;
+}
+
+// Key accepted by the classification (before the BUTTON debounce), -1 if none
+int16_t ADC_LADDER_Pressed(const ADC_LADDER_t* lad) {
+    return (lad->Current < lad->Keys) ? (int16_t)lad->Current : -1;
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. CubeMX: PA1 as ADC1_IN1, continuous conversion, sampling time 239.5 cycles.
+#    DMA1 channel 1 on ADC1: circular, peripheral to memory, half-word on both sides.
+#    Ladder: 10k pull-up to 3.3 V, each key to GND through its own resistor.
+#    Build with BUTTON_MAX >= number of keys (+ other buttons)
+
+static ADC_LADDER_t panel;
+static uint16_t panelBuf[64];
+static const uint16_t panelLevels[] = { 0, 600, 1300, 2000, 2700, 3400 };		// measured codes
+enum { KEY_RIGHT, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_SELECT, KEY_MENU };
+
+void Panel_Handler(Button_t* btn, ButtonPressType_t type) {
+	switch (ADC_LADDER_KeyIndex(&panel, btn)) {
+		case KEY_UP: if (type == BUTTON_PressType_Repeat || type == BUTTON_PressType_OnPressed) MoveUp(); break;
+		case KEY_DOWN: if (type == BUTTON_PressType_Repeat || type == BUTTON_PressType_OnPressed) MoveDown(); break;
+		case KEY_SELECT: Select(); break;
+		default: break;
+	}
+}
+
+
+# 2. Init after MX_ADC1_Init: hadc1.DMA_Handle is the channel linked by CubeMX
+
+	ADC_LADDER_Init(&panel, &hadc1, panelBuf, 64, panelLevels, 6, BUTTON_Mode_Hold, Panel_Handler);
+	Set_DebounceTime(ADC_LADDER_GetKey(&panel, KEY_SELECT), 20);
+
+
+# 3. Main loop: classify the new samples, then the press timers
+
+while (1)
+{
+	ADC_LADDER_Update(&panel);
+	BUTTON_Update();
+}
+
+*/
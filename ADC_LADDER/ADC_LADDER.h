@@ -0,0 +1,86 @@
+/**
+ * @file ADC_LADDER.h
+ * @brief Resistor-ladder button banks on one ADC pin, sampled by circular DMA.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * A ladder puts several keys on one analog pin: each key pulls the pin to its own
+ * voltage, and the pull-up reads full scale (4095) when no key is pressed. The ADC
+ * converts continuously into a circular DMA buffer without the CPU. ADC_LADDER_Update
+ * reads the DMA position (CNDTR) and classifies only the samples written since the
+ * last call: a sample maps to a key through a threshold table (the midpoints between
+ * the nominal codes), with hysteresis around the band of the previous sample. A key is
+ * accepted after ADC_LADDER_STABLE samples in a row of the same class, which rejects
+ * the intermediate codes crossed while the voltage moves from one key to another.
+ *
+ * Each key is a regular Button_t fed with BUTTON_SetLevel: the BUTTON debounce
+ * (DebounceTime, in ms), Toggle / Hold classification, SetTime_* and handlers apply
+ * as for a GPIO button. One key at a time reads on a ladder: moving to another key
+ * releases the first one.
+ *
+ * Notes:
+ * - The ADC HT / TC interrupts are not needed: Update can run from the main loop.
+ *   A buffer lap is Len conversions (64 x 21 us = 1.3 ms by default); a slower loop
+ *   only skips samples, a press lasts many laps.
+ * - Every key takes a slot of the BUTTON pool: BUTTON_MAX must cover all the keys.
+ * - Handlers run from ADC_LADDER_Update; the hold / double-click timers run from
+ *   BUTTON_Update, call both from the main loop.
+ */
+
+
+
+#ifndef __ADC_LADDER_H
+#define __ADC_LADDER_H
+
+#include "stm32f1xx_hal.h"
+#include "BUTTON.h"
+#include <stdint.h>
+
+#ifndef ADC_LADDER_MAX_KEYS
+#define ADC_LADDER_MAX_KEYS 8
+#endif
+
+// Samples in a row of one class before the key changes (21 us each by default)
+#ifndef ADC_LADDER_STABLE
+#define ADC_LADDER_STABLE 4
+#endif
+
+// Codes by which the band of the previous sample is widened on both sides
+#ifndef ADC_LADDER_HYST
+#define ADC_LADDER_HYST 40
+#endif
+
+// Code read with no key pressed (pull-up to VDDA)
+#ifndef ADC_LADDER_IDLE
+#define ADC_LADDER_IDLE 4095
+#endif
+
+typedef struct {
+    ADC_HandleTypeDef* hadc;
+    const volatile uint16_t* Buf;       // written by the DMA
+    uint16_t Len;
+    uint16_t Tail;                      // next sample to classify
+
+    uint16_t Bound[ADC_LADDER_MAX_KEYS + 1];   // key k reads below Bound[k]; [Keys] = idle band end
+    uint8_t Keys;
+    uint8_t Candidate;                  // class of the last samples, Keys = no key
+    uint8_t Run;                        // samples in a row of Candidate
+    uint8_t Current;                    // accepted key, Keys = no key
+
+    Button_t* Btn[ADC_LADDER_MAX_KEYS];
+    uint32_t Samples;                   // classified so far
+} ADC_LADDER_t;
+
+// levels: nominal code of each key, ascending, all below ADC_LADDER_IDLE
+HAL_StatusTypeDef ADC_LADDER_Init(ADC_LADDER_t* lad, ADC_HandleTypeDef* hadc, uint16_t* buf, uint16_t len,
+                                  const uint16_t* levels, uint8_t keys,
+                                  ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t));
+void ADC_LADDER_Deinit(ADC_LADDER_t* lad);
+void ADC_LADDER_Update(ADC_LADDER_t* lad);
+
+Button_t* ADC_LADDER_GetKey(const ADC_LADDER_t* lad, uint8_t key);
+int16_t ADC_LADDER_KeyIndex(const ADC_LADDER_t* lad, const Button_t* btn);
+int16_t ADC_LADDER_Pressed(const ADC_LADDER_t* lad);
+
+#endif // __ADC_LADDER_H
@@ -0,0 +1,197 @@
+/**
+ * @file BENCH.c
+ * @brief Benchmark harness: collects HAL_SIM counters per call and checks baselines.
+ *
+ * Baseline format (one file per driver, CSV with header):
+ *   api,time_ns,gpio_writes,gpio_toggles,gpio_reads,i2c_transactions,i2c_bytes,delay_ms
+ *
+ * The simulator is deterministic, so an unchanged driver reproduces its baseline
+ * exactly; the threshold only absorbs intended small changes.
+ */
+
+
+
+#include "BENCH.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *suiteName;
+static const char *baselinePath;
+static int updateBaseline;
+static double thresholdPct = 5.0;
+
+static BENCH_Result results[BENCH_MAX_RESULTS];
+static uint64_t hostNs[BENCH_MAX_RESULTS];
+static int resultCount;
+static int checkFailures;
+static uint64_t hostStart;
+
+// Host CPU time of the simulated call; informative only, never compared
+uint64_t BENCH_HostNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void BENCH_Begin(int argc, char **argv, const char *suite) {
+    suiteName = suite;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (!strcmp(argv[i], "--update")) {
+            updateBaseline = 1;
+        } else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) {
+            thresholdPct = atof(argv[++i]);
+        }
+    }
+    HAL_SIM_Reset();
+}
+
+void BENCH_Start(void) {
+    HAL_SIM_ResetStats();
+    hostStart = BENCH_HostNs();
+}
+
+void BENCH_Stop(const char *api) {
+    uint64_t host = BENCH_HostNs() - hostStart;
+    HAL_SIM_Stats s;
+    HAL_SIM_GetStats(&s);
+    if (resultCount >= BENCH_MAX_RESULTS) return;
+
+    hostNs[resultCount] = host;
+    BENCH_Result *r = &results[resultCount++];
+    snprintf(r->Name, sizeof(r->Name), "%s", api);
+    r->TimeNs = HAL_SIM_CyclesToNs(s.Cycles);
+    r->GpioWrites = s.GpioWrites;
+    r->GpioToggles = s.GpioToggles;
+    r->GpioReads = s.GpioReads;
+    r->I2cTransactions = s.I2cTransactions;
+    r->I2cBytes = s.I2cBytes;
+    r->DelayMs = s.DelayMs;
+}
+
+// ========== Baseline I/O ==========
+
+static int LoadBaseline(const char *path, BENCH_Result *out, int max) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char line[256];
+    int n = 0;
+    while (fgets(line, sizeof(line), f) && n < max) {
+        BENCH_Result r;
+        unsigned long long t;
+        char name[BENCH_NAME_LEN];
+        if (line[0] == '#' || !strncmp(line, "api,", 4)) continue;
+        if (sscanf(line, "%47[^,],%llu,%u,%u,%u,%u,%u,%u", name, &t, &r.GpioWrites, &r.GpioToggles,
+                   &r.GpioReads, &r.I2cTransactions, &r.I2cBytes, &r.DelayMs) != 8) continue;
+        snprintf(r.Name, sizeof(r.Name), "%s", name);
+        r.TimeNs = t;
+        out[n++] = r;
+    }
+    fclose(f);
+    return n;
+}
+
+static int SaveBaseline(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    fprintf(f, "api,time_ns,gpio_writes,gpio_toggles,gpio_reads,i2c_transactions,i2c_bytes,delay_ms\n");
+    for (int i = 0; i < resultCount; ++i) {
+        const BENCH_Result *r = &results[i];
+        fprintf(f, "%s,%llu,%u,%u,%u,%u,%u,%u\n", r->Name, (unsigned long long)r->TimeNs,
+                r->GpioWrites, r->GpioToggles, r->GpioReads, r->I2cTransactions, r->I2cBytes, r->DelayMs);
+    }
+    fclose(f);
+    return 0;
+}
+
+// ========== Comparison ==========
+
+static int Regressed(uint64_t cur, uint64_t base) {
+    return (double)cur > (double)base * (1.0 + thresholdPct / 100.0);
+}
+
+static int CheckMetric(const char *api, const char *metric, uint64_t cur, uint64_t base) {
+    if (!Regressed(cur, base)) return 0;
+    printf("REGRESSION %s.%s: %llu -> %llu\n", api, metric,
+           (unsigned long long)base, (unsigned long long)cur);
+    return 1;
+}
+
+static int Compare(const BENCH_Result *cur, const BENCH_Result *base) {
+    int bad = 0;
+    bad += CheckMetric(cur->Name, "time_ns", cur->TimeNs, base->TimeNs);
+    bad += CheckMetric(cur->Name, "gpio_writes", cur->GpioWrites, base->GpioWrites);
+    bad += CheckMetric(cur->Name, "gpio_toggles", cur->GpioToggles, base->GpioToggles);
+    bad += CheckMetric(cur->Name, "gpio_reads", cur->GpioReads, base->GpioReads);
+    bad += CheckMetric(cur->Name, "i2c_transactions", cur->I2cTransactions, base->I2cTransactions);
+    bad += CheckMetric(cur->Name, "i2c_bytes", cur->I2cBytes, base->I2cBytes);
+    bad += CheckMetric(cur->Name, "delay_ms", cur->DelayMs, base->DelayMs);
+    return bad;
+}
+
+void BENCH_Fail(const char *file, int line, const char *cond) {
+    printf("FAIL %s:%d %s\n", file, line, cond);
+    checkFailures++;
+}
+
+int BENCH_Failures(void) {
+    return checkFailures;
+}
+
+// Table, then the baseline compare / update
+static int BENCH_Report(void) {
+    static BENCH_Result base[BENCH_MAX_RESULTS];
+    int failures = 0;
+
+    printf("== %s ==\n", suiteName);
+    printf("%-36s %12s %7s %7s %7s %5s %6s %6s %10s\n",
+           "api", "time_ns", "writes", "toggles", "reads", "i2c", "bytes", "delay", "host_ns");
+    for (int i = 0; i < resultCount; ++i) {
+        const BENCH_Result *r = &results[i];
+        printf("%-36s %12llu %7u %7u %7u %5u %6u %6u %10llu\n", r->Name, (unsigned long long)r->TimeNs,
+               r->GpioWrites, r->GpioToggles, r->GpioReads, r->I2cTransactions, r->I2cBytes, r->DelayMs,
+               (unsigned long long)hostNs[i]);
+    }
+
+    if (!baselinePath) return 0;
+
+    if (updateBaseline) {
+        if (SaveBaseline(baselinePath) != 0) {
+            printf("cannot write baseline %s\n", baselinePath);
+            return 1;
+        }
+        printf("baseline written: %s\n", baselinePath);
+        return 0;
+    }
+
+    int baseCount = LoadBaseline(baselinePath, base, BENCH_MAX_RESULTS);
+    if (baseCount < 0) {
+        printf("cannot read baseline %s\n", baselinePath);
+        return 1;
+    }
+
+    for (int i = 0; i < resultCount; ++i) {
+        int found = 0;
+        for (int j = 0; j < baseCount; ++j) {
+            if (strcmp(results[i].Name, base[j].Name) != 0) continue;
+            failures += Compare(&results[i], &base[j]);
+            found = 1;
+            break;
+        }
+        if (!found) printf("note: %s has no baseline yet\n", results[i].Name);
+    }
+
+    printf("%s: %d regression(s), threshold %.1f%%\n", suiteName, failures, thresholdPct);
+    return failures ? 1 : 0;
+}
+
+int BENCH_End(void) {
+    int rc = BENCH_Report();
+    if (checkFailures) printf("%s: %d check(s) failed\n", suiteName, checkFailures);
+    return checkFailures ? 1 : rc;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file BENCH.h
+ * @brief Per-API cost benchmark harness running on the HAL simulator.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Each benchmark program measures public driver functions one call at a time and
+ * records, per call:
+ * - blocking time (virtual ns spent inside the call),
+ * - GPIO writes / output toggles / reads,
+ * - I2C transactions and bytes on the bus,
+ * - milliseconds requested through HAL_Delay.
+ *
+ * The host time of each call is printed as well but never compared: the
+ * simulator only charges HAL calls, so pure computation shows up there only.
+ *
+ * Results are compared with a CSV baseline; the program exits non-zero when a
+ * metric grows more than the threshold (default 5 %), or when a BENCH_CHECK failed.
+ *
+ * Command line:
+ *   --baseline <file>   compare against (and with --update, rewrite) this file
+ *   --update            write the current results as the new baseline
+ *   --threshold <pct>   allowed growth per metric before failing
+ */
+
+
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include "HAL_SIM.h"
+
+// Set per program by the build (driver or variant name)
+#ifndef BENCH_SUITE
+#define BENCH_SUITE "bench"
+#endif
+
+#define BENCH_MAX_RESULTS 64
+#define BENCH_NAME_LEN    48
+
+typedef struct {
+    char Name[BENCH_NAME_LEN];
+    uint64_t TimeNs;
+    uint32_t GpioWrites;
+    uint32_t GpioToggles;
+    uint32_t GpioReads;
+    uint32_t I2cTransactions;
+    uint32_t I2cBytes;
+    uint32_t DelayMs;
+} BENCH_Result;
+
+void BENCH_Begin(int argc, char **argv, const char *suite);
+void BENCH_Start(void);
+void BENCH_Stop(const char *api);
+int BENCH_End(void);
+void BENCH_Fail(const char *file, int line, const char *cond);
+int BENCH_Failures(void);
+// Host monotonic clock in ns, for the host-time figures of a bench (never compared)
+uint64_t BENCH_HostNs(void);
+
+// Measure one statement under the given name
+#define BENCH_RUN(name, stmt) do { BENCH_Start(); stmt; BENCH_Stop(name); } while (0)
+
+// Functional check: printed with its location when false, BENCH_End then returns non-zero
+#define BENCH_CHECK(cond) do { if (!(cond)) BENCH_Fail(__FILE__, __LINE__, #cond); } while (0)
+
+#endif // __BENCH_H
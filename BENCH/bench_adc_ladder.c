@@ -0,0 +1,187 @@
+/**
+ * @file bench_adc_ladder.c
+ * @brief ADC_LADDER classification of DMA samples, keys through the BUTTON classifier.
+ *
+ * Six keys on ADC1 (nominal codes 0, 600, 1300, 2000, 2700, 3400, idle 4095), one
+ * conversion every 21 us into a 64-sample circular buffer. Checks presses with ADC
+ * noise, a level sitting on a threshold (hysteresis: no chatter), that a transient
+ * shorter than ADC_LADDER_STABLE samples never reaches a key, a slide from one key to
+ * another, and a main loop slower than one buffer lap. The key debounce is 0 so the
+ * button edges are the ladder decisions. The host time per classified sample is printed.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "ADC_LADDER.h"
+
+#define LEN 64
+#define KEYS 6
+#define HOST_SAMPLES 200000
+
+static const uint16_t levels[KEYS] = { 0, 600, 1300, 2000, 2700, 3400 };
+
+static ADC_LADDER_t lad;
+static uint16_t buf[LEN];
+static DMA_Channel_TypeDef dmaChannel;
+static DMA_HandleTypeDef hdma = { .Instance = &dmaChannel };
+static ADC_HandleTypeDef hadc = { .Instance = ADC1, .DMA_Handle = &hdma };
+static DMA_Channel_TypeDef hostChannel;
+static DMA_HandleTypeDef hostDma = { .Instance = &hostChannel };
+static ADC_HandleTypeDef hostAdc = { .Instance = ADC2, .DMA_Handle = &hostDma };
+static uint16_t hostBuf[LEN];
+static int downs[KEYS], ups[KEYS], presses[KEYS];
+
+static void KeyHandler(Button_t *btn, ButtonPressType_t type) {
+    int16_t k = ADC_LADDER_KeyIndex(&lad, btn);
+    if (k >= 0 && type != BUTTON_PressType_Provisional) presses[k]++;
+}
+
+static void OnEdge(Button_t *btn, uint8_t pressed, uint32_t tick) {
+    (void)tick;
+    int16_t k = ADC_LADDER_KeyIndex(&lad, btn);
+    if (k < 0) return;
+    if (pressed) downs[k]++; else ups[k]++;
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { ADC_LADDER_Update(&lad); BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+static void Input(uint16_t code) {
+    HAL_SIM_ADC_SetInput(ADC1, code);
+}
+
+static int Edges(void) {
+    int n = 0;
+    for (int k = 0; k < KEYS; ++k) n += downs[k] + ups[k];
+    return n;
+}
+
+static void Clear(void) {
+    for (int k = 0; k < KEYS; ++k) downs[k] = ups[k] = presses[k] = 0;
+}
+
+// Classification only: a noisy key held in a buffer of its own, the DMA position moved by hand
+static uint32_t HostPerSample(void) {
+    for (int i = 0; i < LEN; ++i) hostBuf[i] = (uint16_t)(1900U + (i * 37U) % 200U);
+    ADC_LADDER_t copy = lad;
+    copy.hadc = &hostAdc;
+    copy.Buf = hostBuf;
+    copy.Tail = 0;
+    for (int k = 0; k < KEYS; ++k) copy.Btn[k] = NULL;      // no BUTTON_SetLevel
+    uint64_t start = BENCH_HostNs();
+    for (int n = 0; n < HOST_SAMPLES; n += LEN / 2) {
+        hostChannel.CNDTR = (copy.Tail == 0) ? LEN / 2 : LEN;
+        ADC_LADDER_Update(&copy);
+    }
+    return (uint32_t)((BENCH_HostNs() - start) / HOST_SAMPLES);
+}
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_SIM_ADC_SetInput(ADC1, 4095);
+    BENCH_CHECK(HAL_ADC_Init(&hadc) == HAL_OK);
+    BUTTON_SetEdgeHook(OnEdge);
+
+    // Codes not ascending, or closer than the hysteresis allows
+    static const uint16_t unsorted[3] = { 0, 1300, 600 };
+    static const uint16_t close[3] = { 0, 60, 1300 };
+    BENCH_CHECK(ADC_LADDER_Init(&lad, &hadc, buf, LEN, unsorted, 3, BUTTON_Mode_Toggle, KeyHandler) == HAL_ERROR);
+    BENCH_CHECK(ADC_LADDER_Init(&lad, &hadc, buf, LEN, close, 3, BUTTON_Mode_Toggle, KeyHandler) == HAL_ERROR);
+    BENCH_CHECK(BUTTON_FromHandle(1) == NULL);
+
+    BENCH_RUN("ADC_LADDER_Init",
+              BENCH_CHECK(ADC_LADDER_Init(&lad, &hadc, buf, LEN, levels, KEYS, BUTTON_Mode_Toggle, KeyHandler) == HAL_OK));
+    BENCH_CHECK(hadc.State == HAL_ADC_STATE_REG_BUSY);
+    for (int k = 0; k < KEYS; ++k) Set_DebounceTime(ADC_LADDER_GetKey(&lad, (uint8_t)k), 0);
+    BENCH_RUN("ADC_LADDER_Update_empty", ADC_LADDER_Update(&lad));
+
+    // Idle: every sample is classified, no key; the DMA runs without the CPU
+    HAL_SIM_AdvanceUs(1000);
+    BENCH_RUN("ADC_LADDER_Update_1ms", ADC_LADDER_Update(&lad));
+    BENCH_CHECK(lad.Samples >= 47 && ADC_LADDER_Pressed(&lad) == -1);
+    Run(100);
+    BENCH_CHECK(Edges() == 0);
+
+    // A click of each key with +-60 codes of noise: one press and one release, on that key only
+    HAL_SIM_ADC_SetNoise(ADC1, 60);
+    for (int k = 0; k < KEYS; ++k) {
+        Clear();
+        Input(levels[k]);
+        Run(100);
+        BENCH_CHECK(ADC_LADDER_Pressed(&lad) == k);
+        Input(4095);
+        Run(400);
+        BENCH_CHECK(downs[k] == 1 && ups[k] == 1 && presses[k] == 1 && Edges() == 2);
+    }
+
+    // Held right on the threshold between keys 3 and 4: the hysteresis keeps one key
+    Clear();
+    Input((uint16_t)((levels[3] + levels[4]) / 2U));
+    HAL_SIM_ADC_SetNoise(ADC1, 30);
+    BENCH_Start();
+    Run(500);
+    BENCH_Stop("ADC_LADDER_threshold_500ms");
+    BENCH_CHECK(downs[3] + downs[4] == 1 && Edges() == 1);
+    Input(4095);
+    Run(400);
+    BENCH_CHECK(Edges() == 2);
+    HAL_SIM_ADC_SetNoise(ADC1, 0);
+
+    // Transient codes (a release crossing the bands of the higher keys) shorter than
+    // ADC_LADDER_STABLE samples never reach a key; the same code for longer does
+    Clear();
+    for (int i = 0; i < 50; ++i) {
+        Input(levels[1]);
+        HAL_SIM_AdvanceUs(21 * (ADC_LADDER_STABLE - 1));
+        Input(4095);
+        HAL_SIM_AdvanceUs(200);
+        ADC_LADDER_Update(&lad);
+    }
+    BENCH_CHECK(Edges() == 0);
+    Input(levels[1]);
+    HAL_SIM_AdvanceUs(21 * (ADC_LADDER_STABLE + 1));
+    Input(4095);
+    Run(10);
+    BENCH_CHECK(downs[1] == 1 && ups[1] == 1);
+
+    // Slide from key 0 to key 5 without letting go: key 0 is released, key 5 pressed
+    Clear();
+    Input(levels[0]);
+    Run(100);
+    Input(levels[5]);
+    Run(100);
+    BENCH_CHECK(downs[0] == 1 && ups[0] == 1 && downs[5] == 1 && ups[5] == 0);
+    Input(4095);
+    Run(400);
+    BENCH_CHECK(ups[5] == 1 && Edges() == 4);
+
+    // A main loop slower than a buffer lap (1.3 ms): samples are skipped, no press is lost
+    Clear();
+    for (int t = 0; t < 60; ++t) {
+        Input(t % 20 < 10 ? levels[2] : 4095);
+        HAL_SIM_AdvanceUs(5000);
+        ADC_LADDER_Update(&lad);
+        BUTTON_Update();
+    }
+    Run(400);
+    BENCH_CHECK(downs[2] == 3 && ups[2] == 3 && presses[2] == 3);
+
+    // 100 ms idle: what the DMA did, what the CPU did
+    HAL_SIM_Stats stats;
+    ADC_LADDER_Update(&lad);
+    uint32_t before = lad.Samples;
+    HAL_SIM_ResetStats();
+    Run(100);
+    ADC_LADDER_Update(&lad);
+    HAL_SIM_GetStats(&stats);
+    BENCH_CHECK(lad.Samples - before == stats.AdcSamples);
+    uint32_t host = HostPerSample();
+    printf("\nper 100 ms idle: %lu samples by DMA, %lu HT/TC interrupts (not used)\nhost ns per classified sample  %lu\n",
+           (unsigned long)stats.AdcSamples, (unsigned long)stats.AdcIrqs, (unsigned long)host);
+
+    ADC_LADDER_Deinit(&lad);
+    BENCH_CHECK(hadc.State == HAL_ADC_STATE_READY && BUTTON_FromHandle(1) == NULL);
+
+    return BENCH_End();
+}
@@ -0,0 +1,281 @@
+/**
+ * @file bench_button.c
+ * @brief Per-API cost of the BUTTON driver.
+ */
+
+#include "BENCH.h"
+#include "BUTTON.h"
+#include <stdio.h>
+
+static int clicks;
+static ButtonPressType_t lastType;
+
+static void Handler(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    (void)type;
+}
+
+static Button_t *selfRelease, *otherRelease, *created;
+static int releaseCalls;
+
+static void Releaser(Button_t *btn, ButtonPressType_t type) {
+    if (btn != selfRelease || type != BUTTON_PressType_RepeatOnce) return;
+    releaseCalls++;
+    BUTTON_Deinit(otherRelease);
+    BUTTON_Deinit(btn);
+    created = BUTTON_Init(GPIOA, GPIO_PIN_10, 0, BUTTON_Mode_Toggle, Handler);
+}
+
+// External key that releases itself from its first event, as a KEYPAD handler may
+static Button_t *selfExternal, *createdExternal;
+static int externalCalls;
+
+static void ExternalReleaser(Button_t *btn, ButtonPressType_t type) {
+    (void)type;
+    externalCalls++;
+    BUTTON_Deinit(btn);
+    createdExternal = BUTTON_InitExternal(BUTTON_Mode_Toggle, Handler);
+}
+
+static void Counter(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    clicks++;
+    lastType = type;
+}
+
+// Press types with the tick they were reported at
+static ButtonPressType_t logType[8];
+static uint32_t logTick[8];
+static int logCount;
+
+static void Logger(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    if (logCount < 8) { logType[logCount] = type; logTick[logCount] = HAL_GetTick(); }
+    logCount++;
+}
+
+// Hold PC0 down for 'down' ms then release it for 'up' ms, polled every millisecond
+static uint32_t Press(uint32_t down, uint32_t up) {
+    uint32_t release;
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_0, 0);
+    for (uint32_t ms = 0; ms < down; ++ms) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_0, 1);
+    release = HAL_GetTick();
+    for (uint32_t ms = 0; ms < up; ++ms) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    return release;
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    BUTTON_EXTI_Callback(GPIO_Pin);
+}
+
+// A 30 ms click (with contact bounce) between two passes of a 200 ms main loop
+static const HAL_SIM_PinStep shortClick[] = {
+    { 50000000, 1 }, { 1000000, 0 }, { 1000000, 1 }, { 30000000, 0 },
+};
+
+static Button_t *ClickButton(void) {
+    Button_t *b = BUTTON_Init(GPIOB, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Counter);
+    Set_DebounceTime(b, 20);
+    SetTime_Toggle_mode(b, 0, 300, 1000, 3000);
+    return b;
+}
+
+static void SlowLoop(void) {
+    HAL_SIM_GPIO_PlayScript(GPIOB, GPIO_PIN_0, shortClick, sizeof(shortClick) / sizeof(shortClick[0]), 1);
+    for (int pass = 0; pass < 3; ++pass) { BUTTON_Update(); HAL_SIM_AdvanceUs(200000); }
+    BUTTON_Update();
+}
+
+int main(int argc, char **argv) {
+    Button_t *btn[BUTTON_MAX];
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    // Pull-up buttons, released = high
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_All, 1);
+
+    BENCH_RUN("BUTTON_Init", btn[0] = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Handler));
+    for (int i = 1; i < BUTTON_MAX; ++i) {
+        btn[i] = BUTTON_Init(GPIOA, (uint16_t)(1U << i), 0, (i & 1) ? BUTTON_Mode_Hold : BUTTON_Mode_Toggle, Handler);
+    }
+    BENCH_RUN("SetTime_Toggle_mode", SetTime_Toggle_mode(btn[0], 200, 300, 1000, 3000));
+    BENCH_RUN("SetTime_Hold_mode", SetTime_Hold_mode(btn[1], 500, 200));
+    Set_DebounceTime(btn[0], 300);                              // wider than 8 bits, as the field
+    BENCH_CHECK(btn[0]->Config->DebounceTime == 300);
+    BENCH_RUN("Set_DebounceTime", Set_DebounceTime(btn[0], 20));
+
+    BENCH_RUN("BUTTON_Update_idle", BUTTON_Update());
+    BENCH_RUN("BUTTON_NextUpdate", BUTTON_NextUpdate());
+
+    // One press of 400 ms on the first button, polled once per millisecond
+    BENCH_Start();
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 0);
+    for (int ms = 0; ms < 400; ++ms) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+    for (int ms = 0; ms < 400; ++ms) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    BENCH_Stop("BUTTON_Update_press_800ms");
+
+    // Slots never move: a released slot is reused, its old handle stays dead
+    Button_t *kept = btn[2];
+    ButtonHandle_t h = BUTTON_GetHandle(btn[0]);
+    BENCH_RUN("BUTTON_Deinit", BUTTON_Deinit(btn[0]));
+    BUTTON_Deinit(btn[0]);                                      // twice: ignored
+    BENCH_CHECK(BUTTON_FromHandle(h) == NULL && btn[2] == kept && kept->Config->GPIO_Pin == GPIO_PIN_2);
+    BENCH_RUN("BUTTON_Init_reuse", btn[0] = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Handler));
+    BENCH_CHECK(btn[0] != NULL && BUTTON_FromHandle(h) == NULL && BUTTON_GetHandle(btn[0]) != h);
+    BENCH_CHECK(BUTTON_FromHandle(BUTTON_GetHandle(btn[3])) == btn[3]);
+
+    // Released from a handler while BUTTON_Update runs: itself and a button not yet
+    // visited; with the pool full, a button created there gets neither slot before
+    // the pass ends
+    selfRelease = btn[1];
+    otherRelease = btn[9];
+    BUTTON_SetHandler(btn[1], Releaser);
+    Set_DebounceTime(btn[1], 0);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_1 | GPIO_PIN_9, 0);
+    for (int ms = 0; ms < 5; ++ms) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_1 | GPIO_PIN_9, 1);
+    BENCH_CHECK(releaseCalls == 1 && created == NULL);
+    BENCH_CHECK(BUTTON_GetHandle(btn[1]) == 0 && BUTTON_GetHandle(btn[9]) == 0);
+    created = BUTTON_Init(GPIOA, GPIO_PIN_10, 0, BUTTON_Mode_Toggle, Handler);
+    BENCH_CHECK(created == btn[1] || created == btn[9]);
+    BUTTON_Deinit(created);
+
+    for (int i = 0; i < BUTTON_MAX; ++i) BUTTON_Deinit(btn[i]);
+    clicks = 0;
+
+    // Polled: the click falls between two passes and is never seen
+    HAL_SIM_GPIO_SetInput(GPIOB, GPIO_PIN_All, 1);
+    btn[0] = ClickButton();
+    SlowLoop();
+    BENCH_CHECK(clicks == 0);
+    BUTTON_Deinit(btn[0]);
+
+    // Edge driven: BUTTON_MAX buttons on EXTI lines 0..9 of port B
+    GPIO_InitTypeDef it = { .Mode = GPIO_MODE_IT_RISING_FALLING, .Pull = GPIO_PULLUP };
+    for (int i = 0; i < BUTTON_MAX; ++i) {
+        it.Pin = 1U << i;
+        HAL_GPIO_Init(GPIOB, &it);
+    }
+    btn[0] = ClickButton();
+    BENCH_RUN("BUTTON_EnableIrq", BUTTON_EnableIrq(btn[0]));
+    for (int i = 1; i < BUTTON_MAX; ++i) {
+        btn[i] = BUTTON_Init(GPIOB, (uint16_t)(1U << i), 0, (i & 1) ? BUTTON_Mode_Hold : BUTTON_Mode_Toggle, Handler);
+        BENCH_CHECK(BUTTON_EnableIrq(btn[i]) == HAL_OK);
+    }
+    BENCH_RUN("BUTTON_Update_idle_irq", BUTTON_Update());
+    BENCH_RUN("BUTTON_NextUpdate_irq", BENCH_CHECK(BUTTON_NextUpdate() == BUTTON_FOREVER));
+
+    // Same click, same slow loop: replayed from its edges, reported once
+    BENCH_Start();
+    SlowLoop();
+    BENCH_Stop("BUTTON_Update_slow_loop_irq");
+    BENCH_CHECK(clicks == 1 && lastType == BUTTON_PressType_OnPressed);
+    BENCH_CHECK(BUTTON_EdgesLost() == 0);
+
+    // More edges than the ring holds before the next pass: lost ones are counted and
+    // the button is sampled instead, the click still comes out
+    static HAL_SIM_PinStep chatter[BUTTON_EDGE_QUEUE + 9];
+    for (int i = 0; i < BUTTON_EDGE_QUEUE + 8; ++i) chatter[i] = (HAL_SIM_PinStep){ 100000, (uint8_t)(i & 1) };
+    chatter[BUTTON_EDGE_QUEUE + 8] = (HAL_SIM_PinStep){ 100000000, 0 };
+    HAL_SIM_GPIO_PlayScript(GPIOB, GPIO_PIN_0, chatter, BUTTON_EDGE_QUEUE + 9, 1);
+    HAL_SIM_AdvanceUs(50000);
+    BUTTON_Update();
+    HAL_SIM_AdvanceUs(150000);
+    BUTTON_Update();
+    BENCH_CHECK(BUTTON_EdgesLost() > 0);
+    BENCH_CHECK(clicks == 2);
+    for (int i = 0; i < BUTTON_MAX; ++i) BUTTON_Deinit(btn[i]);
+
+    // Immediate events: Long while held, a click at release, provisional then
+    // confirmed or upgraded once double-click is on
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_All, 1);
+    Button_t *imm = BUTTON_Init(GPIOC, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Logger);
+    SetTime_Toggle_mode(imm, 0, 300, 1000, 3000);
+    Set_DebounceTime(imm, 20);
+    BUTTON_SetImmediate(imm, 1);
+    uint32_t start = HAL_GetTick();
+    BENCH_Start();
+    uint32_t release = Press(1500, 100);
+    BENCH_Stop("BUTTON_Update_immediate_long");
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_Long && logTick[0] - start <= 1001U && logTick[0] < release);
+
+    logCount = 0;
+    release = Press(100, 50);
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_OnPressed && logTick[0] - release <= 1U);
+
+    SetTime_Toggle_mode(imm, 300, 80, 1000, 3000);
+    logCount = 0;
+    release = Press(100, 400);
+    BENCH_CHECK(logCount == 2 && logType[0] == BUTTON_PressType_Provisional && logTick[0] - release <= 1U);
+    BENCH_CHECK(logType[1] == BUTTON_PressType_Normal && logTick[1] - release >= 300U);
+
+    logCount = 0;
+    Press(100, 100);
+    release = Press(100, 400);
+    BENCH_CHECK(logCount == 2 && logType[0] == BUTTON_PressType_Provisional && logType[1] == BUTTON_PressType_Double);
+    BENCH_CHECK(logTick[1] - release <= 1U);
+
+    // The release-time classification waits for the release and the window
+    BUTTON_SetImmediate(imm, 0);
+    logCount = 0;
+    start = HAL_GetTick();
+    release = Press(1500, 400);
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_Long && logTick[0] - start > 1800U);
+
+    // Press duration kept on 16 bits: a 70 s press is still VeryLong
+    logCount = 0;
+    Press(70000, 400);
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_VeryLong);
+    BUTTON_Deinit(imm);
+
+    // Const configuration (flash on target): same classification, the Set* functions
+    // leave it alone
+    static const ButtonConfig_t flashKey = {
+        .GPIOx = GPIOC, .GPIO_Pin = GPIO_PIN_0, .ActiveState = 0, .Mode = BUTTON_Mode_Toggle,
+        .DebounceTime = 20, .NormalTime = 300, .LongTime = 1000, .VeryLongTime = 3000, .Handler = Logger,
+    };
+    static const ButtonConfig_t noHandler = { .GPIOx = GPIOC, .GPIO_Pin = GPIO_PIN_1 };
+    Button_t *con;
+    BENCH_CHECK(BUTTON_InitConst(NULL) == NULL && BUTTON_InitConst(&noHandler) == NULL);
+    BENCH_RUN("BUTTON_InitConst", con = BUTTON_InitConst(&flashKey));
+    BENCH_CHECK(con != NULL && con->Config == &flashKey);
+    Set_DebounceTime(con, 0);
+    SetTime_Toggle_mode(con, 300, 1, 2, 3);
+    BUTTON_SetImmediate(con, 1);
+    BUTTON_SetHandler(con, Counter);
+    logCount = 0;
+    release = Press(400, 100);
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_Normal && logTick[0] - release <= 1U);
+    BUTTON_Deinit(con);
+
+    // No pin: external for life, never polled; nothing can put it back on a port
+    Button_t *pinless = BUTTON_InitExternal(BUTTON_Mode_Toggle, Logger);
+    BENCH_CHECK(pinless != NULL && pinless->Config->GPIOx == NULL);
+    BENCH_CHECK(BUTTON_EnableIrq(pinless) == HAL_ERROR && BUTTON_EnableBatch(pinless) == HAL_ERROR);
+    BENCH_CHECK(BUTTON_EnableScan(pinless) == HAL_ERROR && BUTTON_EnableExternal(pinless) == HAL_OK);
+    BUTTON_DisableExternal(pinless);
+    logCount = 0;
+    BUTTON_SetLevel(pinless, 1);
+    for (int t = 0; t < 100; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    BUTTON_SetLevel(pinless, 0);
+    for (int t = 0; t < 400; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+    BENCH_CHECK(logCount == 1 && logType[0] == BUTTON_PressType_OnPressed);
+    BUTTON_Deinit(pinless);
+
+    // Released by its handler inside BUTTON_SetLevel: no event for the dead key, and
+    // its slot is not handed out before BUTTON_SetLevel returns
+    selfExternal = BUTTON_InitExternal(BUTTON_Mode_Toggle, ExternalReleaser);
+    BUTTON_SetImmediate(selfExternal, 1);
+    BUTTON_SetLevel(selfExternal, 1);
+    HAL_SIM_AdvanceUs(1500000);
+    BUTTON_SetLevel(selfExternal, 0);                           // catch-up fires, then the level
+    BENCH_CHECK(externalCalls == 1 && createdExternal != NULL && createdExternal != selfExternal);
+    created = BUTTON_InitExternal(BUTTON_Mode_Toggle, Handler);
+    BENCH_CHECK(created == selfExternal);                       // recycled once it returned
+    BUTTON_Deinit(created);
+    BUTTON_Deinit(createdExternal);
+
+    return BENCH_End();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file bench_button_adaptive.c
+ * @brief Adaptive debounce against the fixed 50 ms window, with a bouncy switch that wears.
+ *
+ * Button A (GPIOA 0) is adaptive, button B (GPIOB 0) keeps the fixed window; both are
+ * polled every millisecond, DebounceTime 50, and see the same presses. A fresh switch
+ * settles in 4 ms on press and 3 ms on release: after a few presses A must learn about
+ * 4 ms and report presses within 10 ms while B stays at 50, both with exactly one press
+ * and one release each. A release that bounces past the window must not be a second
+ * press. Short glitches must be counted and rejected. The switch then wears to a 12 ms
+ * bounce: A's window must grow past it, with every press reported once meanwhile.
+ * Button C (GPIOC 1) is adaptive and edge-driven, run by a 10 ms loop: the same, and a
+ * tap released before DebounceTime is released at DebounceTime without another edge.
+ * At most BUTTON_ADAPT_MAX buttons are adaptive at once.
+ * The rows are one BUTTON_Update in a settle window and a whole press.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "BUTTON.h"
+
+#define PRESSES  40
+
+// Fresh switch: 4 ms of bounce (uneven, the 1 ms polls see some of it), 120 ms held, 3 ms on release
+static const HAL_SIM_PinStep fresh[] = {
+    { 300000, 0 }, { 700000, 1 }, { 400000, 0 }, { 900000, 1 }, { 600000, 0 }, { 1100000, 1 },
+    { 120000000, 0 },
+    { 500000, 1 }, { 800000, 0 }, { 700000, 1 }, { 1000000, 0 },
+};
+
+// Worn switch: 12 ms of bounce on press
+static const HAL_SIM_PinStep worn[] = {
+    { 900000, 0 }, { 1300000, 1 }, { 1100000, 0 }, { 1700000, 1 }, { 1500000, 0 }, { 1900000, 1 },
+    { 1200000, 0 }, { 2400000, 1 },
+    { 120000000, 0 },
+    { 500000, 1 }, { 800000, 0 }, { 700000, 1 }, { 1000000, 0 },
+};
+
+// Fresh press, then a release that bounces back for 7 ms: longer than the learned window
+static const HAL_SIM_PinStep loose[] = {
+    { 300000, 0 }, { 700000, 1 }, { 400000, 0 }, { 900000, 1 }, { 600000, 0 }, { 1100000, 1 },
+    { 120000000, 0 },
+    { 1000000, 1 }, { 7000000, 0 }, { 500000, 1 }, { 1000000, 0 },
+};
+
+static const HAL_SIM_PinStep glitch[] = { { 2000000, 0 } };
+static const HAL_SIM_PinStep tap[] = { { 15000000, 0 } };
+
+static Button_t *adaptive, *fixed, *edgeDriven;
+
+typedef struct {
+    int Downs, Ups;
+    uint32_t DownTick;
+} Record;
+
+static Record recA, recB, recC;
+
+static void OnEdge(Button_t *btn, uint8_t pressed, uint32_t tick) {
+    Record *r = (btn == adaptive) ? &recA : (btn == edgeDriven) ? &recC : &recB;
+    if (pressed) { r->Downs++; r->DownTick = tick; }
+    else r->Ups++;
+}
+
+static void OnPress(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    (void)type;
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    BUTTON_EXTI_Callback(GPIO_Pin);
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+// One press of both buttons; latencies from the first contact, in ms
+static void Press(const HAL_SIM_PinStep *steps, uint16_t count, int32_t *latA, int32_t *latB) {
+    recA = (Record){ 0 };
+    recB = (Record){ 0 };
+    uint32_t start = HAL_GetTick();
+    HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, steps, count, 1);
+    HAL_SIM_GPIO_PlayScript(GPIOB, GPIO_PIN_0, steps, count, 1);
+    Run(400);
+    *latA = recA.Downs ? (int32_t)(recA.DownTick - start) : -1;
+    *latB = recB.Downs ? (int32_t)(recB.DownTick - start) : -1;
+}
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+    HAL_SIM_GPIO_SetInput(GPIOB, GPIO_PIN_0, 1);
+    BUTTON_SetEdgeHook(OnEdge);
+
+    adaptive = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, OnPress);
+    fixed = BUTTON_Init(GPIOB, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, OnPress);
+    ButtonAdaptive_t info;
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_ERROR);
+    BENCH_RUN("BUTTON_SetAdaptive", BENCH_CHECK(BUTTON_SetAdaptive(adaptive, 1) == HAL_OK));
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK && info.Window == 50);
+    BENCH_CHECK(BUTTON_EnableBatch(adaptive) == HAL_ERROR && BUTTON_EnableScan(adaptive) == HAL_ERROR);
+
+    // BUTTON_ADAPT_MAX adaptive buttons at once; an entry is freed by SetAdaptive(0) and Deinit
+    Button_t *more[BUTTON_ADAPT_MAX];
+    for (int k = 0; k < BUTTON_ADAPT_MAX; ++k) more[k] = BUTTON_Init(GPIOD, (uint16_t)(1U << k), 0, BUTTON_Mode_Toggle, OnPress);
+    for (int k = 0; k < BUTTON_ADAPT_MAX - 1; ++k) BENCH_CHECK(BUTTON_SetAdaptive(more[k], 1) == HAL_OK);
+    BENCH_CHECK(BUTTON_SetAdaptive(more[BUTTON_ADAPT_MAX - 1], 1) == HAL_ERROR);
+    BENCH_CHECK(BUTTON_SetAdaptive(more[0], 0) == HAL_OK && BUTTON_SetAdaptive(more[BUTTON_ADAPT_MAX - 1], 1) == HAL_OK);
+    BENCH_CHECK(BUTTON_GetAdaptive(more[0], &info) == HAL_ERROR && BUTTON_SetAdaptive(more[0], 1) == HAL_ERROR);
+    BUTTON_Deinit(more[1]);
+    BENCH_CHECK(BUTTON_SetAdaptive(more[0], 1) == HAL_OK);
+    for (int k = 0; k < BUTTON_ADAPT_MAX; ++k) BUTTON_Deinit(more[k]);
+
+    // Fresh switch: the window shrinks to the bounce, every press stays a single press
+    int32_t latA = 0, latB = 0, firstA = 0;
+    int clean = 1;
+    for (int p = 0; p < PRESSES; ++p) {
+        Press(fresh, 11, &latA, &latB);
+        if (p == 0) firstA = latA;
+        clean &= (recA.Downs == 1 && recA.Ups == 1 && recB.Downs == 1 && recB.Ups == 1);
+    }
+    BENCH_CHECK(clean);
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK);
+    BENCH_CHECK(firstA >= 50 && latA >= 3 && latA <= 10 && latB >= 50);
+    BENCH_CHECK(info.Bounce >= 3 && info.Bounce <= 5 && info.Window <= 8 && info.LastEdges >= 2);
+    BENCH_CHECK(info.Glitches == 0);
+    printf("\nfresh switch, press %d: adaptive %ld ms (window %u, bounce %u, edges %u), fixed %ld ms\n",
+           PRESSES, (long)latA, info.Window, info.Bounce, info.LastEdges, (long)latB);
+
+    // A release bouncing past the window: the bounce of a release gets the full window
+    Press(loose, 11, &latA, &latB);
+    BENCH_CHECK(recA.Downs == 1 && recA.Ups == 1 && recB.Downs == 1 && recB.Ups == 1);
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK && info.Window >= 10);
+    printf("loose release: %d press(es), window %u ms after it\n", recA.Downs, info.Window);
+    for (int p = 0; p < PRESSES; ++p) Press(fresh, 11, &latA, &latB);
+
+    // A settle window while the contact bounces
+    HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, fresh, 11, 1);
+    HAL_SIM_AdvanceUs(1500);
+    BENCH_RUN("BUTTON_Update_settling", BUTTON_Update());
+    Run(400);
+
+    // 2 ms glitches: rejected by both, counted by the adaptive one
+    recA = (Record){ 0 };
+    recB = (Record){ 0 };
+    for (int g = 0; g < 5; ++g) {
+        HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, glitch, 1, 1);
+        HAL_SIM_GPIO_PlayScript(GPIOB, GPIO_PIN_0, glitch, 1, 1);
+        Run(300);
+    }
+    BENCH_CHECK(recA.Downs == 0 && recB.Downs == 0);
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK && info.Glitches == 5);
+
+    // Worn switch: the window grows past the new bounce within a few presses, then clean again
+    int growth = 0, spurious = 0;
+    for (int p = 0; p < 20; ++p) {
+        Press(worn, 13, &latA, &latB);
+        BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK);
+        if (info.Window < 12) growth = p + 1;
+        spurious += (recA.Downs != 1) + (recA.Ups != 1);
+    }
+    clean = 1;
+    BENCH_Start();
+    for (int p = 0; p < 10; ++p) {
+        Press(worn, 13, &latA, &latB);
+        clean &= (recA.Downs == 1 && recA.Ups == 1);
+    }
+    BENCH_Stop("BUTTON_worn_10_presses");
+    BENCH_CHECK(clean && spurious == 0 && growth <= 10);
+    BENCH_CHECK(BUTTON_GetAdaptive(adaptive, &info) == HAL_OK && info.Window >= 12 && info.Window < 50);
+    printf("worn switch: window %u ms after %d press(es), %d miscounted press(es) meanwhile, press at %ld ms (fixed %ld ms)\n",
+           info.Window, growth + 1, spurious, (long)latA, (long)latB);
+
+    // Edge-driven: every press once, a tap shorter than DebounceTime released at DebounceTime
+    GPIO_InitTypeDef it = { .Pin = GPIO_PIN_1, .Mode = GPIO_MODE_IT_RISING_FALLING, .Pull = GPIO_PULLUP };
+    HAL_GPIO_Init(GPIOC, &it);
+    edgeDriven = BUTTON_Init(GPIOC, GPIO_PIN_1, 0, BUTTON_Mode_Toggle, OnPress);
+    BENCH_CHECK(BUTTON_EnableIrq(edgeDriven) == HAL_OK && BUTTON_SetAdaptive(edgeDriven, 1) == HAL_OK);
+    clean = 1;
+    for (int p = 0; p < 20; ++p) {
+        recC = (Record){ 0 };
+        HAL_SIM_GPIO_PlayScript(GPIOC, GPIO_PIN_1, (p & 1) ? worn : fresh, (p & 1) ? 13 : 11, 1);
+        for (int t = 0; t < 40; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(10000); }
+        clean &= (recC.Downs == 1 && recC.Ups == 1);
+    }
+    recC = (Record){ 0 };
+    uint32_t tapStart = HAL_GetTick();
+    HAL_SIM_GPIO_PlayScript(GPIOC, GPIO_PIN_1, tap, 1, 1);
+    for (int t = 0; t < 6; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(10000); }
+    BENCH_CHECK(clean && recC.Downs == 1 && recC.Ups == 1 && recC.DownTick - tapStart < 50);
+    BENCH_CHECK(BUTTON_GetAdaptive(edgeDriven, &info) == HAL_OK && info.Window >= 12 && info.Window < 50);
+    BUTTON_Deinit(edgeDriven);
+    edgeDriven = NULL;
+
+    // Off again: the fixed window
+    BENCH_CHECK(BUTTON_SetAdaptive(adaptive, 0) == HAL_OK && BUTTON_GetAdaptive(adaptive, &info) == HAL_ERROR);
+    Press(fresh, 11, &latA, &latB);
+    BENCH_CHECK(latA >= 50 && recA.Downs == 1);
+
+    return BENCH_End();
+}
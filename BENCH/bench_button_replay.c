@@ -0,0 +1,361 @@
+/**
+ * @file bench_button_replay.c
+ * @brief Press classification replayed from pin traces, and BUTTON_Update throughput.
+ *
+ * A trace is the level of one button per millisecond tick (1 = pressed) with the
+ * events the driver must report, at their tick. The built-in traces are synthesised
+ * from press lists with contact bounce (pseudo-random, seeded per trace) on every
+ * edge, shorter than the debounce time. Each trace is replayed through BUTTON_Update
+ * once per tick of the virtual HAL_GetTick, on a fresh button; any missing, extra or
+ * late event fails the run. They pin down the classification boundaries: press
+ * types at their thresholds, double-click in and out of its window, hold repeat,
+ * immediate events.
+ *
+ * The throughput part registers 10 to 10,000 idle buttons (BUTTON_MAX=10000, on
+ * the 5 simulated ports) and prints host ns per BUTTON_Update and buttons per
+ * second: polled with RAM configurations (BUTTON_Init), polled with a configuration
+ * table (BUTTON_InitConst, only the packed states written), and port batched. The
+ * RAM per button of both kinds is printed with it.
+ *
+ *   --record <file>   write the built-in traces in the text format below
+ *   --replay <file>   replay the traces of a file instead (e.g. captured on target)
+ *
+ * Trace file: '#' comments, then per trace
+ *   trace <name> toggle|hold|immediate <debounce> <dct> <normal> <long> <very_long> <length>
+ *   <tick> <level>          one line per level change, ticks ascending
+ *   expect <tick> <type>    ButtonPressType_t number, in order
+ * (hold: <normal> = repeat delay, <long> = repeat interval)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "BUTTON.h"
+
+#define MAX_CHANGES 256
+#define MAX_EVENTS  16
+#define PORTS       5
+
+typedef struct {
+    uint32_t Tick;
+    uint8_t Type;
+} Event;
+
+typedef enum { KIND_TOGGLE, KIND_HOLD, KIND_IMMEDIATE } Kind;
+
+typedef struct {
+    char Name[32];
+    Kind Kind;
+    uint16_t Debounce, Dct, Normal, Long, VeryLong;
+    uint32_t Length;
+    uint16_t ChangeCount;
+    struct { uint32_t Tick; uint8_t Level; } Change[MAX_CHANGES];
+    uint8_t ExpectCount;
+    Event Expect[MAX_EVENTS];
+} Trace;
+
+// Built-in traces: presses { start, duration } and expected { tick, type } (0-terminated)
+typedef struct {
+    const char *Name;
+    Kind Kind;
+    uint16_t Debounce, Dct, Normal, Long, VeryLong;
+    uint8_t Bounce;
+    struct { uint32_t At, Ms; } Press[4];
+    Event Expect[6];
+} Spec;
+
+static const Spec specs[] = {
+    { "click_short",        KIND_TOGGLE, 20,   0, 300, 1000, 3000, 5, { { 0, 100 } },  { { 101, BUTTON_PressType_OnPressed } } },
+    { "click_normal_edge",  KIND_TOGGLE, 20,   0, 300, 1000, 3000, 5, { { 0, 300 } },  { { 301, BUTTON_PressType_Normal } } },
+    { "click_below_normal", KIND_TOGGLE, 20,   0, 300, 1000, 3000, 5, { { 0, 299 } },  { { 300, BUTTON_PressType_OnPressed } } },
+    { "long",               KIND_TOGGLE, 20,   0, 300, 1000, 3000, 8, { { 0, 1500 } }, { { 1501, BUTTON_PressType_Long } } },
+    { "very_long",          KIND_TOGGLE, 20,   0, 300, 1000, 3000, 8, { { 0, 3200 } }, { { 3201, BUTTON_PressType_VeryLong } } },
+    { "glitch",             KIND_TOGGLE, 20,   0, 300, 1000, 3000, 0, { { 0, 15 } },   { { 0 } } },
+    { "single_in_window",   KIND_TOGGLE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 } },  { { 351, BUTTON_PressType_OnPressed } } },
+    { "double",             KIND_TOGGLE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 }, { 200, 100 } },
+      { { 300, BUTTON_PressType_Double } } },
+    { "double_window_edge", KIND_TOGGLE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 }, { 300, 50 } },
+      { { 350, BUTTON_PressType_Double } } },
+    { "double_too_late",    KIND_TOGGLE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 }, { 320, 100 } },
+      { { 351, BUTTON_PressType_OnPressed }, { 671, BUTTON_PressType_OnPressed } } },
+    { "second_click_long",  KIND_TOGGLE, 20, 250, 300, 1000, 3000, 5, { { 0, 400 }, { 500, 1200 } },
+      { { 651, BUTTON_PressType_Normal }, { 1951, BUTTON_PressType_Long } } },
+    { "hold_repeat",        KIND_HOLD,   20,   0, 500,  200,    0, 5, { { 0, 1000 } },
+      { { 20, BUTTON_PressType_RepeatOnce }, { 500, BUTTON_PressType_Repeat }, { 700, BUTTON_PressType_Repeat },
+        { 900, BUTTON_PressType_Repeat } } },
+    { "immediate_long",     KIND_IMMEDIATE, 20, 0, 300, 1000, 3000, 5, { { 0, 3500 } },
+      { { 1000, BUTTON_PressType_Long }, { 3000, BUTTON_PressType_VeryLong } } },
+    { "immediate_click",    KIND_IMMEDIATE, 20, 0, 300, 1000, 3000, 5, { { 0, 100 } },
+      { { 100, BUTTON_PressType_OnPressed } } },
+    { "immediate_single",   KIND_IMMEDIATE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 } },
+      { { 100, BUTTON_PressType_Provisional }, { 351, BUTTON_PressType_OnPressed } } },
+    { "immediate_double",   KIND_IMMEDIATE, 20, 250, 300, 1000, 3000, 5, { { 0, 100 }, { 200, 100 } },
+      { { 100, BUTTON_PressType_Provisional }, { 300, BUTTON_PressType_Double } } },
+};
+
+#define SPEC_COUNT (sizeof(specs) / sizeof(specs[0]))
+
+static Trace trace;
+static Event got[MAX_EVENTS];
+static uint8_t gotCount;
+static uint32_t base;
+
+static void Recorder(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    if (gotCount < MAX_EVENTS) got[gotCount] = (Event){ HAL_GetTick() - base, (uint8_t)type };
+    gotCount++;
+}
+
+static void Nop(Button_t *btn, ButtonPressType_t type) {
+    (void)btn; (void)type;
+}
+
+// ========== Traces ==========
+
+static uint32_t Random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void AddChange(Trace *t, uint32_t tick, uint8_t level) {
+    uint8_t last = t->ChangeCount ? t->Change[t->ChangeCount - 1].Level : 0;
+    if (level == last || t->ChangeCount >= MAX_CHANGES) return;
+    t->Change[t->ChangeCount].Tick = tick;
+    t->Change[t->ChangeCount].Level = level;
+    t->ChangeCount++;
+}
+
+// New level on 'tick', then 'bounce' - 1 random ticks, then steady
+static void Edge(Trace *t, uint32_t tick, uint8_t level, uint8_t bounce, uint32_t *seed) {
+    AddChange(t, tick, level);
+    for (uint8_t b = 1; b < bounce; ++b) AddChange(t, tick + b, (uint8_t)(Random(seed) & 1U));
+    AddChange(t, tick + (bounce ? bounce : 1U), level);
+}
+
+static void Synthesise(Trace *t, const Spec *s, uint32_t seed) {
+    *t = (Trace){ .Kind = s->Kind, .Debounce = s->Debounce, .Dct = s->Dct,
+                  .Normal = s->Normal, .Long = s->Long, .VeryLong = s->VeryLong };
+    snprintf(t->Name, sizeof(t->Name), "%s", s->Name);
+
+    uint32_t end = 0;
+    for (int p = 0; p < 4 && s->Press[p].Ms; ++p) {
+        Edge(t, s->Press[p].At, 1, s->Bounce, &seed);
+        Edge(t, s->Press[p].At + s->Press[p].Ms, 0, s->Bounce, &seed);
+        end = s->Press[p].At + s->Press[p].Ms;
+    }
+    for (int e = 0; e < 6 && s->Expect[e].Tick; ++e) t->Expect[t->ExpectCount++] = s->Expect[e];
+    t->Length = end + 1500U;
+}
+
+// One fresh button on PA0 (active low), one BUTTON_Update per tick
+static void Replay(const Trace *t) {
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+    Button_t *btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, t->Kind == KIND_HOLD ? BUTTON_Mode_Hold : BUTTON_Mode_Toggle, Recorder);
+    Set_DebounceTime(btn, t->Debounce);
+    if (t->Kind == KIND_HOLD) {
+        SetTime_Hold_mode(btn, t->Normal, t->Long);
+    } else {
+        SetTime_Toggle_mode(btn, t->Dct, t->Normal, t->Long, t->VeryLong);
+        BUTTON_SetImmediate(btn, t->Kind == KIND_IMMEDIATE);
+    }
+
+    // Tick 0 starts on a SysTick edge, each update is paced on the clock: the
+    // driver's own cost never slips a tick
+    uint32_t start = HAL_GetTick();
+    while (HAL_GetTick() == start) HAL_SIM_AdvanceUs(10);
+    base = HAL_GetTick();
+    uint64_t origin = HAL_SIM_Now(), ms = HAL_SIM_NsToCycles(1000000);
+
+    gotCount = 0;
+    uint16_t c = 0;
+    for (uint32_t tick = 0; tick < t->Length; ++tick) {
+        for (; c < t->ChangeCount && t->Change[c].Tick <= tick; ++c) {
+            HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, t->Change[c].Level ? 0 : 1);
+        }
+        BUTTON_Update();
+        HAL_SIM_Advance(origin + (tick + 1U) * ms - HAL_SIM_Now());
+    }
+    BUTTON_Deinit(btn);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+}
+
+static int Compare(const Trace *t) {
+    int ok = gotCount == t->ExpectCount;
+    for (uint8_t e = 0; ok && e < t->ExpectCount; ++e) {
+        ok = got[e].Tick == t->Expect[e].Tick && got[e].Type == t->Expect[e].Type;
+    }
+    if (!ok) {
+        printf("FAIL trace %s\n  expected:", t->Name);
+        for (uint8_t e = 0; e < t->ExpectCount; ++e) printf(" %lu:%u", (unsigned long)t->Expect[e].Tick, t->Expect[e].Type);
+        printf("\n  got:     ");
+        for (uint8_t e = 0; e < gotCount && e < MAX_EVENTS; ++e) printf(" %lu:%u", (unsigned long)got[e].Tick, got[e].Type);
+        printf("\n");
+    }
+    return ok;
+}
+
+static int ReplayAndCompare(const Trace *t) {
+    Replay(t);
+    return Compare(t);
+}
+
+static const char *kindName[] = { "toggle", "hold", "immediate" };
+
+static void Write(FILE *f, const Trace *t) {
+    fprintf(f, "trace %s %s %u %u %u %u %u %lu\n", t->Name, kindName[t->Kind], t->Debounce, t->Dct,
+            t->Normal, t->Long, t->VeryLong, (unsigned long)t->Length);
+    for (uint16_t c = 0; c < t->ChangeCount; ++c) fprintf(f, "%lu %u\n", (unsigned long)t->Change[c].Tick, t->Change[c].Level);
+    for (uint8_t e = 0; e < t->ExpectCount; ++e) fprintf(f, "expect %lu %u\n", (unsigned long)t->Expect[e].Tick, t->Expect[e].Type);
+}
+
+// Replay every trace of a file; returns the number of traces, -1 on a malformed file
+static int ReplayFile(const char *path, int *passed) {
+    FILE *f = fopen(path, "r");
+    char line[128], kind[16], name[32];
+    int count = 0;
+    if (!f) return -1;
+
+    *passed = 0;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long a, b;
+        unsigned deb, dct, nor, lng, vl;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, "trace %31s %15s %u %u %u %u %u %lu", name, kind, &deb, &dct, &nor, &lng, &vl, &a) == 8) {
+            if (count++) *passed += ReplayAndCompare(&trace);
+            snprintf(trace.Name, sizeof(trace.Name), "%s", name);
+            trace.Kind = !strcmp(kind, "hold") ? KIND_HOLD : !strcmp(kind, "immediate") ? KIND_IMMEDIATE : KIND_TOGGLE;
+            trace.Debounce = (uint16_t)deb; trace.Dct = (uint16_t)dct; trace.Normal = (uint16_t)nor;
+            trace.Long = (uint16_t)lng; trace.VeryLong = (uint16_t)vl; trace.Length = (uint32_t)a;
+            trace.ChangeCount = 0;
+            trace.ExpectCount = 0;
+        } else if (count && sscanf(line, "expect %lu %lu", &a, &b) == 2 && trace.ExpectCount < MAX_EVENTS) {
+            trace.Expect[trace.ExpectCount++] = (Event){ (uint32_t)a, (uint8_t)b };
+        } else if (count && sscanf(line, "%lu %lu", &a, &b) == 2 && trace.ChangeCount < MAX_CHANGES) {
+            trace.Change[trace.ChangeCount].Tick = (uint32_t)a;
+            trace.Change[trace.ChangeCount].Level = (uint8_t)(b != 0);
+            trace.ChangeCount++;
+        } else {
+            fclose(f);
+            return -1;
+        }
+    }
+    if (count) *passed += ReplayAndCompare(&trace);
+    fclose(f);
+    return count;
+}
+
+// ========== Throughput ==========
+
+enum { REG_POLLED, REG_CONST, REG_BATCHED };
+
+static Button_t *pool[BUTTON_MAX];
+static ButtonConfig_t table[BUTTON_MAX];    // const in flash on target, filled once here
+static int registered;
+
+static void Register(int n, int kind) {
+    for (; registered; --registered) BUTTON_Deinit(pool[registered - 1]);
+    for (registered = 0; registered < n; ++registered) {
+        int i = registered;
+        if (kind == REG_CONST) {
+            pool[i] = BUTTON_InitConst(&table[i]);
+            continue;
+        }
+        pool[i] = BUTTON_Init(&HAL_SIM_GPIOPorts[(i / 16) % PORTS], (uint16_t)(1U << (i % 16)), 0, BUTTON_Mode_Toggle, Nop);
+        if (kind == REG_BATCHED) BUTTON_EnableBatch(pool[i]);
+    }
+}
+
+// Fastest of the updates: the others are mostly preempted on a shared host
+static uint32_t HostPerUpdate(int n) {
+    int updates = n >= 10000 ? 200 : n >= 1000 ? 1000 : 5000;
+    uint64_t best = UINT64_MAX;
+    for (int k = 0; k < updates; ++k) {
+        HAL_SIM_AdvanceUs(BUTTON_BATCH_SCAN_MS * 1000U);   // a batched scan due on each
+        uint64_t start = BENCH_HostNs();
+        BUTTON_Update();
+        uint64_t ns = BENCH_HostNs() - start;
+        if (ns < best) best = ns;
+    }
+    return (uint32_t)best;
+}
+
+int main(int argc, char **argv) {
+    static const int sizes[] = { 10, 100, 1000, BUTTON_MAX };
+    static const char *polledRow[] = { "BUTTON_Update_polled_10", "BUTTON_Update_polled_100",
+                                       "BUTTON_Update_polled_1000", "BUTTON_Update_polled_10000" };
+    static const char *batchedRow[] = { "BUTTON_Update_batched_10", "BUTTON_Update_batched_100",
+                                        "BUTTON_Update_batched_1000", "BUTTON_Update_batched_10000" };
+    const char *recordPath = NULL, *replayPath = NULL;
+    int passed = 0;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--record")) recordPath = argv[i + 1];
+        if (!strcmp(argv[i], "--replay")) replayPath = argv[i + 1];
+    }
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    for (int p = 0; p < PORTS; ++p) HAL_SIM_GPIO_SetInput(&HAL_SIM_GPIOPorts[p], GPIO_PIN_All, 1);
+
+    if (replayPath) {
+        int count = ReplayFile(replayPath, &passed);
+        BENCH_CHECK(count >= 0);
+        printf("%s: %d / %d traces match\n", replayPath, count > 0 ? passed : 0, count > 0 ? count : 0);
+        BENCH_CHECK(passed == count);
+        return BENCH_Failures() ? 1 : 0;
+    }
+
+    // ==== Built-in traces ====
+    FILE *rec = recordPath ? fopen(recordPath, "w") : NULL;
+    if (recordPath) BENCH_CHECK(rec != NULL);
+    if (rec) fprintf(rec, "# BUTTON traces: level 1 = pressed, one BUTTON_Update per tick\n");
+
+    BENCH_Start();
+    for (uint32_t s = 0; s < SPEC_COUNT; ++s) {
+        Synthesise(&trace, &specs[s], 0x9E3779B9U + s);
+        passed += ReplayAndCompare(&trace);
+        if (rec) Write(rec, &trace);
+    }
+    BENCH_Stop("BUTTON_replay_traces");
+    if (rec) fclose(rec);
+    printf("%d / %u traces match\n", passed, (unsigned)SPEC_COUNT);
+    BENCH_CHECK(passed == (int)SPEC_COUNT);
+
+    // ==== Throughput ====
+    for (int i = 0; i < BUTTON_MAX; ++i) {
+        table[i] = (ButtonConfig_t){ .GPIOx = &HAL_SIM_GPIOPorts[(i / 16) % PORTS], .GPIO_Pin = (uint16_t)(1U << (i % 16)),
+                                     .Mode = BUTTON_Mode_Toggle, .DebounceTime = 50, .NormalTime = 300,
+                                     .LongTime = 1000, .VeryLongTime = 3000, .Handler = Nop };
+    }
+    uint32_t polledNs[4], constNs[4], batchedNs[4];
+    for (int s = 0; s < 4; ++s) {
+        Register(sizes[s], REG_POLLED);
+        BENCH_CHECK(registered == sizes[s] && pool[sizes[s] - 1] != NULL);
+        HAL_SIM_AdvanceUs(1000);
+        BENCH_RUN(polledRow[s], BUTTON_Update());
+        polledNs[s] = HostPerUpdate(sizes[s]);
+
+        Register(sizes[s], REG_CONST);
+        BENCH_CHECK(pool[sizes[s] - 1] != NULL && pool[sizes[s] - 1]->Config == &table[sizes[s] - 1]);
+        constNs[s] = HostPerUpdate(sizes[s]);
+
+        Register(sizes[s], REG_BATCHED);
+        HAL_SIM_AdvanceUs(BUTTON_BATCH_SCAN_MS * 1000U);
+        BENCH_RUN(batchedRow[s], BUTTON_Update());
+        batchedNs[s] = HostPerUpdate(sizes[s]);
+    }
+    Register(0, 0);
+
+    printf("\nhost BUTTON_Update, idle buttons (a batched scan due on each)\n");
+    printf("buttons     polled ns  Mbutton/s      const ns  Mbutton/s    batched ns  Mbutton/s\n");
+    for (int s = 0; s < 4; ++s) {
+        printf("%7d  %12lu  %9.1f  %12lu  %9.1f  %12lu  %9.1f\n", sizes[s],
+               (unsigned long)polledNs[s], polledNs[s] ? sizes[s] * 1000.0 / polledNs[s] : 0.0,
+               (unsigned long)constNs[s], constNs[s] ? sizes[s] * 1000.0 / constNs[s] : 0.0,
+               (unsigned long)batchedNs[s], batchedNs[s] ? sizes[s] * 1000.0 / batchedNs[s] : 0.0);
+    }
+    printf("\nRAM per button (this host): %u state + %u configuration with BUTTON_Init, %u with BUTTON_InitConst\n",
+           (unsigned)sizeof(Button_t), (unsigned)sizeof(ButtonConfig_t), (unsigned)sizeof(Button_t));
+
+    return BENCH_End();
+}
@@ -0,0 +1,108 @@
+/**
+ * @file bench_button_scan.c
+ * @brief BUTTON_Update against the number of buttons: polled one by one, port batched.
+ *
+ * Built with BUTTON_MAX=320 on the 5 simulated ports (buttons past the 80th share
+ * pins). The rows are one BUTTON_Update on which a batched scan is due; reads are
+ * the IDR loads of the batched scan (polled buttons read IDR directly, not
+ * counted). The host time per update is printed for 10, 80 and 320 buttons: the
+ * polled loop grows with the count, the batched scan with the ports.
+ *
+ * The batched engine must read each port once per scan whatever the count, filter
+ * a 10 ms glitch and report a press to every button of the pressed pin.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "BUTTON.h"
+
+#define PORTS        5
+#define HOST_UPDATES 2000
+
+static Button_t *btn[BUTTON_MAX];
+static int count;
+static int clicks;
+
+static void Counter(Button_t *b, ButtonPressType_t type) {
+    (void)b;
+    if (type == BUTTON_PressType_OnPressed) clicks++;
+}
+
+// Button i on port (i / 16) % PORTS, pin i % 16, active low
+static GPIO_TypeDef *PortOf(int i) { return &HAL_SIM_GPIOPorts[(i / 16) % PORTS]; }
+static uint16_t PinOf(int i)       { return (uint16_t)(1U << (i % 16)); }
+
+static void Register(int n, int batched) {
+    for (; count; --count) BUTTON_Deinit(btn[count - 1]);
+    for (count = 0; count < n; ++count) {
+        btn[count] = BUTTON_Init(PortOf(count), PinOf(count), 0, BUTTON_Mode_Toggle, Counter);
+        SetTime_Toggle_mode(btn[count], 0, 300, 1000, 3000);
+        if (batched) BENCH_CHECK(BUTTON_EnableBatch(btn[count]) == HAL_OK);
+    }
+    HAL_SIM_AdvanceUs(BUTTON_BATCH_SCAN_MS * 1000U);
+}
+
+static uint32_t HostPerUpdate(void) {
+    uint64_t sum = 0;
+    for (int k = 0; k < HOST_UPDATES; ++k) {
+        HAL_SIM_AdvanceUs(BUTTON_BATCH_SCAN_MS * 1000U);
+        uint64_t start = BENCH_HostNs();
+        BUTTON_Update();
+        sum += BENCH_HostNs() - start;
+    }
+    return (uint32_t)(sum / HOST_UPDATES);
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+int main(int argc, char **argv) {
+    static const int sizes[] = { 10, 80, BUTTON_MAX };
+    static const char *polledRow[] = { "BUTTON_Update_polled_10", "BUTTON_Update_polled_80", "BUTTON_Update_polled_320" };
+    static const char *batchedRow[] = { "BUTTON_Update_batched_10", "BUTTON_Update_batched_80", "BUTTON_Update_batched_320" };
+    uint32_t polledNs[3], batchedNs[3];
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    for (int p = 0; p < PORTS; ++p) HAL_SIM_GPIO_SetInput(&HAL_SIM_GPIOPorts[p], GPIO_PIN_All, 1);
+
+    for (int s = 0; s < 3; ++s) {
+        Register(sizes[s], 0);
+        BENCH_RUN(polledRow[s], BUTTON_Update());
+        polledNs[s] = HostPerUpdate();
+
+        Register(sizes[s], 1);
+        HAL_SIM_Stats stats;
+        HAL_SIM_ResetStats();
+        BENCH_RUN(batchedRow[s], BUTTON_Update());
+        HAL_SIM_GetStats(&stats);
+        BENCH_CHECK(stats.GpioReads == (uint32_t)(sizes[s] < 16 * PORTS ? (sizes[s] + 15) / 16 : PORTS));
+        batchedNs[s] = HostPerUpdate();
+    }
+
+    printf("\nhost ns per BUTTON_Update (a scan due on each)\n");
+    printf("buttons   polled  batched\n");
+    for (int s = 0; s < 3; ++s) {
+        printf("%7d  %7lu  %7lu\n", sizes[s], (unsigned long)polledNs[s], (unsigned long)batchedNs[s]);
+    }
+
+    // 320 batched buttons: a 10 ms glitch on PC3 is filtered, a 100 ms press is
+    // reported by the 4 buttons sharing PC3
+    clicks = 0;
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_3, 0);
+    Run(10);
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_3, 1);
+    Run(100);
+    BENCH_CHECK(clicks == 0);
+
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_3, 0);
+    Run(100);
+    HAL_SIM_GPIO_SetInput(GPIOC, GPIO_PIN_3, 1);
+    Run(100);
+    BENCH_CHECK(clicks == BUTTON_MAX / (16 * PORTS));
+
+    BENCH_RUN("BUTTON_DisableBatch", BUTTON_DisableBatch(btn[0]));
+    BENCH_RUN("BUTTON_EnableBatch", BUTTON_EnableBatch(btn[0]));
+
+    return BENCH_End();
+}
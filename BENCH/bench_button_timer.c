@@ -0,0 +1,170 @@
+/**
+ * @file bench_button_timer.c
+ * @brief Timer-scanned buttons against polled ones, under main-loop load.
+ *
+ * TIM2 raises its update interrupt at 4 kHz (PSC 71, ARR 249) and calls BUTTON_ScanTick.
+ * Button A (GPIOA 0) is timer scanned, button B (GPIOB 0) polled; both see the same
+ * bouncy 150 ms press, with a main loop busy for 5, 37 and 80 ms between two
+ * BUTTON_Update. The scanned press must be stamped within 1 ms of the end of its
+ * bounce, its duration within 1 ms (and within a scan period in us) whatever the load;
+ * the polled error is printed for comparison. A glitch shorter than the debounce must
+ * not reach the scanned button. The scan time must follow the simulated clock with a
+ * period that is not a whole number of us (3 kHz: 333.3 us). The rows are one
+ * BUTTON_ScanTick idle and a press.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "BUTTON.h"
+
+#define SCAN_US  250
+#define LOADS    3
+
+// Bounces of 500 us (two scans each) around a 150 ms press: stable low from 2 ms,
+// stable high again from 154 ms
+#define DOWN_US  2000U
+#define HELD_US  152000
+static const HAL_SIM_PinStep press[] = {
+    { 500000, 0 }, { 500000, 1 }, { 500000, 0 }, { 500000, 1 },
+    { 150000000, 0 },
+    { 500000, 1 }, { 500000, 0 }, { 500000, 1 }, { 500000, 0 },
+};
+static const HAL_SIM_PinStep glitch[] = { { 10000000, 0 } };
+
+static Button_t *scanned, *polled;
+static TIM_HandleTypeDef htim2 = { .Instance = TIM2, .Init = { .Prescaler = 71, .Period = SCAN_US - 1 } };
+static uint32_t scanBaseUs;         // sim time (us) of scan time 0
+
+typedef struct {
+    int Downs, Ups, Clicks;
+    uint32_t DownTick, UpTick;
+    uint32_t DownUs, UpUs;          // scan time, scanned button only
+} Record;
+
+static Record recA, recB;
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    if (htim == &htim2) BUTTON_ScanTick();
+}
+
+static uint32_t NowUs(void) {
+    return (uint32_t)(HAL_SIM_Now() / 72U);
+}
+
+static Record *RecordOf(Button_t *btn) {
+    return (btn == scanned) ? &recA : &recB;
+}
+
+static void OnEdge(Button_t *btn, uint8_t pressed, uint32_t tick) {
+    Record *r = RecordOf(btn);
+    uint32_t us = BUTTON_EdgeTimeUs(btn);
+    if (pressed) { r->Downs++; r->DownTick = tick; r->DownUs = us; }
+    else { r->Ups++; r->UpTick = tick; r->UpUs = us; }
+}
+
+static void OnPress(Button_t *btn, ButtonPressType_t type) {
+    if (type != BUTTON_PressType_Provisional) RecordOf(btn)->Clicks++;
+}
+
+// Main loop doing 'loadMs' of other work between two BUTTON_Update, for 'ms' in all
+static void Run(uint32_t loadMs, uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += loadMs) { BUTTON_Update(); HAL_SIM_AdvanceUs(loadMs * 1000U); }
+    BUTTON_Update();
+}
+
+static void Clear(void) {
+    recA = (Record){ 0 };
+    recB = (Record){ 0 };
+}
+
+static int32_t Diff(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b);
+}
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+    HAL_SIM_GPIO_SetInput(GPIOB, GPIO_PIN_0, 1);
+    BUTTON_SetEdgeHook(OnEdge);
+
+    scanned = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, OnPress);
+    polled = BUTTON_Init(GPIOB, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, OnPress);
+    Set_DebounceTime(scanned, 20);
+    Set_DebounceTime(polled, 20);
+    BENCH_RUN("BUTTON_EnableScan", BENCH_CHECK(BUTTON_EnableScan(scanned) == HAL_OK));
+
+    // One scanned button per pin, and a scanned button is in no other mode
+    Button_t *twin = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, OnPress);
+    BENCH_CHECK(BUTTON_EnableScan(twin) == HAL_ERROR);
+    BUTTON_Deinit(twin);
+    BENCH_CHECK(BUTTON_EnableIrq(scanned) == HAL_ERROR && BUTTON_EnableBatch(scanned) == HAL_ERROR);
+
+    BUTTON_ScanTick();      // starts the scan clock
+    BENCH_RUN("BUTTON_ScanTick_idle", BUTTON_ScanTick());
+
+    // From here the scan time follows the timer
+    BENCH_CHECK(HAL_TIM_Base_Start_IT(&htim2) == HAL_OK);
+    scanBaseUs = NowUs() - BUTTON_ScanTimeUs();
+    Run(1, 100);
+    BENCH_CHECK(recA.Downs == 0 && recB.Downs == 0);
+
+    static const uint32_t loads[LOADS] = { 5, 37, 80 };
+    printf("\nload ms   scanned: press err  duration  (us)     polled: press err  duration\n");
+    for (int l = 0; l < LOADS; ++l) {
+        Clear();
+        // Let the loop land anywhere in its period relative to the press
+        HAL_SIM_AdvanceUs(1000U * (uint32_t)(l + 1) + 300U);
+        uint32_t startUs = NowUs();
+        uint32_t downMs = (startUs + DOWN_US) / 1000U;
+        HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, press, 9, 1);
+        HAL_SIM_GPIO_PlayScript(GPIOB, GPIO_PIN_0, press, 9, 1);
+        if (l == 0) BENCH_Start();
+        Run(loads[l], 600);
+        if (l == 0) BENCH_Stop("BUTTON_scan_press_5ms_loop");
+
+        BENCH_CHECK(recA.Downs == 1 && recA.Ups == 1 && recA.Clicks == 1);
+        BENCH_CHECK(recB.Downs == 1 && recB.Ups == 1 && recB.Clicks == 1);
+
+        int32_t errA = Diff(recA.DownTick, downMs);
+        int32_t durA = Diff(recA.UpTick, recA.DownTick);
+        int32_t durUs = Diff(recA.UpUs, recA.DownUs);
+        int32_t errUs = Diff(scanBaseUs + recA.DownUs, startUs + DOWN_US);
+        BENCH_CHECK(errA >= -1 && errA <= 1);
+        BENCH_CHECK(durA >= HELD_US / 1000 - 1 && durA <= HELD_US / 1000 + 1);
+        BENCH_CHECK(errUs >= 0 && errUs <= SCAN_US);
+        BENCH_CHECK(durUs >= HELD_US - SCAN_US && durUs <= HELD_US + SCAN_US);
+
+        printf("%7lu   %17ld  %8ld  %7ld   %17ld  %8ld\n", (unsigned long)loads[l], (long)errA, (long)durA,
+               (long)durUs, (long)Diff(recB.DownTick, downMs), (long)Diff(recB.UpTick, recB.DownTick));
+    }
+
+    // A 10 ms glitch, shorter than the 20 ms debounce, seen by the scan and rejected in the ISR
+    Clear();
+    HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, glitch, 1, 1);
+    Run(37, 200);
+    BENCH_CHECK(recA.Downs == 0 && recA.Clicks == 0);
+
+    // 3 kHz (ARR 23999 at 72 MHz, 333.3 us): 10 s of scans stay on the clock to a period
+    HAL_TIM_Base_Stop_IT(&htim2);
+    htim2.Init.Prescaler = 0;
+    htim2.Init.Period = 23999;
+    BENCH_CHECK(HAL_TIM_Base_Start_IT(&htim2) == HAL_OK);
+    uint32_t simStart = NowUs(), scanStart = BUTTON_ScanTimeUs();
+    Run(37, 10000);
+    int32_t drift = Diff(BUTTON_ScanTimeUs() - scanStart, NowUs() - simStart);
+    BENCH_CHECK(drift >= -334 && drift <= 334);
+    printf("\n3 kHz scan, 10 s: scan time %ld us off the clock\n", (long)drift);
+    HAL_TIM_Base_Stop_IT(&htim2);
+    htim2.Init.Prescaler = 71;
+    htim2.Init.Period = SCAN_US - 1;
+    BENCH_CHECK(HAL_TIM_Base_Start_IT(&htim2) == HAL_OK);
+
+    // Back to polling: no more edges from the scan
+    BUTTON_DisableScan(scanned);
+    HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, press, 9, 1);
+    Run(1, 400);
+    BENCH_CHECK(recA.Downs == 1 && recA.Clicks == 1 && BUTTON_EdgeTimeUs(scanned) == 0);
+    HAL_TIM_Base_Stop_IT(&htim2);
+
+    return BENCH_End();
+}
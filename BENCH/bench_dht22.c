@@ -0,0 +1,53 @@
+/**
+ * @file bench_dht22.c
+ * @brief Per-API cost of the DHT22 driver.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "DHT22.h"
+#include "TIMING.h"
+
+int main(int argc, char **argv) {
+    TIM_HandleTypeDef htim = { .Instance = TIM2, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+    SIM_DHT22 sensor = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    DHT22_HandleTypedef dht;
+    DHT22_DataTypedef data;
+    DHT22_DataIntTypedef raw;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    SIM_DHT22_Attach(&sensor, GPIOA, GPIO_PIN_1);
+
+    BENCH_RUN("DHT22_Init", dht = DHT22_Init(GPIOA, GPIO_PIN_1, &htim));
+    BENCH_RUN("DHT22_Read", DHT22_Read(&dht, &data));
+    BENCH_CHECK(data.Temperature > 25.09f && data.Temperature < 25.11f && data.Humidity > 65.19f && data.Humidity < 65.21f);
+    BENCH_RUN("DHT22_Read_interval", DHT22_Read(&dht, &data));
+    BENCH_RUN("DHT22_NextReadIn", DHT22_NextReadIn(&dht));
+
+    HAL_Delay(2000);
+    sensor.BadChecksum = 1;
+    BENCH_RUN("DHT22_Read_checksum", DHT22_Read(&dht, &data));
+
+    HAL_Delay(2000);
+    sensor.Present = 0;
+    BENCH_RUN("DHT22_Read_no_sensor", DHT22_Read(&dht, &data));
+
+    // Same frame, tenths as integers; negative temperatures are sign + magnitude
+    HAL_Delay(2000);
+    sensor.Present = 1;
+    sensor.BadChecksum = 0;
+    sensor.Temperature = -123;
+    BENCH_RUN("DHT22_ReadInt", DHT22_ReadInt(&dht, &raw));
+    BENCH_CHECK(raw.Temperature == -123 && raw.Humidity == 652);
+
+    // Sensor hangs mid-frame holding the line low: bounded in time, not in loop turns
+    HAL_Delay(2000);
+    sensor.StuckAfter = 20;
+    uint32_t start = TIMING_Now();
+    BENCH_RUN("DHT22_ReadInt_stuck", BENCH_CHECK(DHT22_ReadInt(&dht, &raw) == DHT22_ERROR_TIMEOUT));
+    BENCH_CHECK(TIMING_TicksToNs(TIMING_Elapsed(start)) / 1000U <= DHT22_READ_MAX_US);
+    BENCH_CHECK(dht.timeouts == 2);
+
+    return BENCH_End();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file bench_ds_rtc.c
+ * @brief Per-API cost of the DS_RTC driver on a DS3231, a DS1307 and a DS1388 (runtime model).
+ *
+ * The program also checks the per-model behaviour (SRAM window, DS1388 register
+ * offset and EEPROM blocks, missing features) and fails on a mismatch.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "DS_RTC.h"
+
+int main(int argc, char **argv) {
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 } };
+    HAL_SIM_I2CSlave chip, eeprom0, eeprom1;
+    DS_RTC_HandleTypeDef rtc;
+    DS_RTC_Time time;
+    float temperature;
+    int16_t quarters;
+    uint8_t ram[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t back[20];
+    const DS_RTC_Alarm alarm1 = { 0, 30, 6, 1, true, true, true, false };
+    const DS_RTC_Alarm2 alarm2 = { 30, 6, 1, true, true, false };
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    // ==== DS3231 ====
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    BENCH_RUN("DS_RTC_Init", DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS3231));
+    BENCH_RUN("DS_RTC_ReadTime", DS_RTC_ReadTime(&rtc, &time));
+    BENCH_RUN("DS_RTC_WriteTime", DS_RTC_WriteTime(&rtc, &time));
+    BENCH_RUN("DS_RTC_SetAlarm", DS_RTC_SetAlarm(&rtc, &alarm1));
+    BENCH_RUN("DS_RTC_SetAlarm2", DS_RTC_SetAlarm2(&rtc, &alarm2));
+    BENCH_RUN("DS_RTC_ClearAlarmFlag", DS_RTC_ClearAlarmFlag(&rtc));
+    BENCH_RUN("DS_RTC_GetTemperature", DS_RTC_GetTemperature(&rtc, &temperature));
+    BENCH_CHECK(time.hours == 12 && time.minutes == 34 && temperature == 25.25f);
+    BENCH_RUN("DS_RTC_GetTemperatureQ", DS_RTC_GetTemperatureQ(&rtc, &quarters));
+    BENCH_CHECK(quarters == 101);
+    chip.Regs[0x11] = 0xF5;     // -10.75 degC
+    BENCH_CHECK(DS_RTC_GetTemperatureQ(&rtc, &quarters) == HAL_OK && quarters == -43);
+    BENCH_CHECK(DS_RTC_GetTemperature(&rtc, &temperature) == HAL_OK && temperature == -10.75f);
+    chip.Regs[0x11] = 25;
+
+    chip.Regs[0x0F] = 0x8B;
+    BENCH_RUN("DS_RTC_GetAlarmFlags", BENCH_CHECK(DS_RTC_GetAlarmFlags(&rtc) == 0x03));
+    BENCH_RUN("DS_RTC_ClearAlarmFlags", DS_RTC_ClearAlarmFlags(&rtc));
+    BENCH_CHECK(chip.Regs[0x0F] == 0x88);
+    BENCH_RUN("DS_RTC_SetSquareWave", DS_RTC_SetSquareWave(&rtc, DS_RTC_SQW_1024HZ, true));
+    BENCH_CHECK((chip.Regs[0x0E] & 0x1C) == 0x08);
+    BENCH_CHECK(DS_RTC_SetSquareWave(&rtc, DS_RTC_SQW_32768HZ, true) == HAL_ERROR);
+    BENCH_RUN("DS_RTC_Enable32KOutput", DS_RTC_Enable32KOutput(&rtc, false));
+    BENCH_CHECK((chip.Regs[0x0F] & 0x08) == 0);
+    BENCH_CHECK(DS_RTC_ReadRAM(&rtc, 0, back, 1) == HAL_ERROR);          // DS3231: no SRAM
+    chip.Nack = 1;                                                 // chip gone: no read-modify-write
+    BENCH_CHECK(DS_RTC_SetAlarm(&rtc, &alarm1) != HAL_OK && DS_RTC_SetAlarm2(&rtc, &alarm2) != HAL_OK);
+    chip.Nack = 0;
+    HAL_SIM_I2C_Detach(&chip);
+
+    // ==== DS1307: SRAM 0x08..0x3F, square wave in register 0x07 ====
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS1307);
+    BENCH_RUN("DS_RTC_Init_DS1307", DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS1307));
+    BENCH_RUN("DS_RTC_WriteRAM_8", DS_RTC_WriteRAM(&rtc, 0, ram, sizeof(ram)));
+    BENCH_RUN("DS_RTC_ReadRAM_8", DS_RTC_ReadRAM(&rtc, 0, back, sizeof(ram)));
+    BENCH_CHECK(memcmp(back, ram, sizeof(ram)) == 0 && memcmp(&chip.Regs[0x08], ram, sizeof(ram)) == 0);
+    BENCH_CHECK(DS_RTC_WriteRAM(&rtc, 48, ram, 8) == HAL_OK && chip.Regs[0x3F] == 8);
+    BENCH_CHECK(DS_RTC_WriteRAM(&rtc, 49, ram, 8) == HAL_ERROR);
+    BENCH_CHECK(DS_RTC_SetSquareWave(&rtc, DS_RTC_SQW_32768HZ, true) == HAL_OK && chip.Regs[0x07] == 0x13);
+    BENCH_CHECK(DS_RTC_GetTemperature(&rtc, &temperature) == HAL_ERROR);
+    BENCH_CHECK(DS_RTC_GetTemperatureQ(&rtc, &quarters) == HAL_ERROR);
+    BENCH_CHECK(DS_RTC_SetAlarm(&rtc, &alarm1) == HAL_ERROR);
+    HAL_SIM_I2C_Detach(&chip);
+
+    // ==== DS1388: time from 0x01, EEPROM on 0x69 / 0x6A ====
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS1307);
+    memmove(&chip.Regs[0x01], &chip.Regs[0x00], 7);
+    chip.Regs[0x00] = 0x99;                                        // hundredths
+    memset(&eeprom0, 0, sizeof(eeprom0));
+    memset(&eeprom1, 0, sizeof(eeprom1));
+    eeprom0.DevAddress = DS_RTC_EEPROM_ADDR;
+    eeprom1.DevAddress = DS_RTC_EEPROM_ADDR + 2;
+    HAL_SIM_I2C_Attach(&hi2c, &eeprom0);
+    HAL_SIM_I2C_Attach(&hi2c, &eeprom1);
+
+    DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS1388);
+    BENCH_RUN("DS_RTC_ReadTime_DS1388", DS_RTC_ReadTime(&rtc, &time));
+    BENCH_CHECK(time.seconds == 56 && time.minutes == 34 && time.hours == 12);
+    for (uint8_t i = 0; i < sizeof(back); i++) back[i] = i;
+    BENCH_RUN("DS_RTC_WriteEEPROM_20", DS_RTC_WriteEEPROM(&rtc, 250, back, 20));
+    BENCH_CHECK(eeprom0.Regs[250] == 0 && eeprom0.Regs[255] == 5 && eeprom1.Regs[0] == 6 && eeprom1.Regs[13] == 19);
+    memset(back, 0, sizeof(back));
+    BENCH_RUN("DS_RTC_ReadEEPROM_20", DS_RTC_ReadEEPROM(&rtc, 250, back, 20));
+    BENCH_CHECK(back[0] == 0 && back[19] == 19);
+    BENCH_CHECK(DS_RTC_ReadEEPROM(&rtc, 500, back, 20) == HAL_ERROR);
+    BENCH_CHECK(DS_RTC_SetAlarm(&rtc, &alarm1) == HAL_ERROR);
+
+    return BENCH_End();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file bench_encoder.c
+ * @brief ENCODER steps from a TIM3 counter in encoder mode, acceleration and push switch.
+ *
+ * TIM3 counts 4 edges per detent (TI12); the push switch is GPIOA 5 (pull-up). Checks
+ * slow turns both ways (1 step per detent), a jitter around a detent, a counter wrap,
+ * many detents between two reads, the acceleration of a fast spin and its bounds,
+ * and a click of the switch through the BUTTON classifier. An idle ENCODER_Update is
+ * one counter read.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "ENCODER.h"
+
+static ENCODER_t knob;
+static TIM_HandleTypeDef htim3 = { .Instance = TIM3, .Init = { .Period = 0xFFFF } };
+static int calls;
+static int32_t maxSteps;
+static int clicks;
+static ButtonPressType_t lastType;
+
+static void OnTurn(ENCODER_t *enc, int32_t steps) {
+    (void)enc;
+    calls++;
+    if (steps > maxSteps) maxSteps = steps;
+    if (-steps > maxSteps) maxSteps = -steps;
+}
+
+static void OnSwitch(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    clicks++;
+    lastType = type;
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { ENCODER_Update(&knob); BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+// 'detents' detents, one every 'ms' milliseconds, the loop reading every millisecond
+static void Spin(int detents, int ms) {
+    for (int i = 0; i < (detents < 0 ? -detents : detents); ++i) {
+        HAL_SIM_TIM_EncoderTurn(&htim3, detents < 0 ? -4 : 4);
+        Run(ms);
+    }
+}
+
+static void Clear(void) {
+    Run(300);
+    calls = 0;
+    maxSteps = 0;
+    ENCODER_SetPosition(&knob, 0);
+}
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_5, 1);
+
+    TIM_Encoder_InitTypeDef cfg = { .EncoderMode = TIM_ENCODERMODE_TI12 };
+    BENCH_CHECK(ENCODER_Init(&knob, &htim3, 4, OnTurn, NULL, 0, NULL) == HAL_ERROR);     // timer not in encoder mode
+    BENCH_CHECK(HAL_TIM_Encoder_Init(&htim3, &cfg) == HAL_OK);
+    BENCH_RUN("ENCODER_Init",
+              BENCH_CHECK(ENCODER_Init(&knob, &htim3, 4, OnTurn, GPIOA, GPIO_PIN_5, OnSwitch) == HAL_OK));
+    BENCH_RUN("ENCODER_Update_idle", ENCODER_Update(&knob));
+
+    // Slow: one step per detent, both ways; the direction bit follows
+    Spin(10, 150);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == 10 && calls == 10 && maxSteps == 1);
+    Spin(-4, 150);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == 6 && __HAL_TIM_IS_TIM_COUNTING_DOWN(&htim3));
+    Clear();
+
+    // Half a detent back and forth, then a quarter: nothing; the rest completes a detent
+    HAL_SIM_TIM_EncoderTurn(&htim3, 2);
+    Run(5);
+    HAL_SIM_TIM_EncoderTurn(&htim3, -2);
+    Run(5);
+    HAL_SIM_TIM_EncoderTurn(&htim3, 1);
+    Run(5);
+    BENCH_CHECK(calls == 0);
+    HAL_SIM_TIM_EncoderTurn(&htim3, 3);
+    HAL_SIM_AdvanceUs(1000);
+    BENCH_RUN("ENCODER_Update_step", ENCODER_Update(&knob));
+    BENCH_CHECK(calls == 1 && ENCODER_GetPosition(&knob) == 1);
+    Clear();
+
+    // Across the counter wrap, both ways
+    HAL_SIM_TIM_EncoderTurn(&htim3, -(int32_t)htim3.Instance->CNT - 8);
+    Clear();
+    BENCH_CHECK(htim3.Instance->CNT == 0xFFF8);
+    Spin(3, 150);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == 3 && htim3.Instance->CNT == 4);
+    Spin(-4, 150);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == -1 && htim3.Instance->CNT == 0xFFF4);
+    Clear();
+
+    // 30 detents while the loop is busy for 2 s: one report, not accelerated (from rest)
+    HAL_SIM_TIM_EncoderTurn(&htim3, 30 * 4);
+    HAL_SIM_AdvanceUs(2000000);
+    ENCODER_Update(&knob);
+    BENCH_CHECK(calls == 1 && ENCODER_GetPosition(&knob) == 30);
+    Clear();
+
+    // Fast spin, 100 detents/s: up to ENCODER_ACCEL_MAX steps each
+    BENCH_Start();
+    Spin(40, 10);
+    BENCH_Stop("ENCODER_spin_400ms");
+    int32_t fast = ENCODER_GetPosition(&knob);
+    BENCH_CHECK(calls == 40 && fast > 40 * 5 && maxSteps == ENCODER_ACCEL_MAX);
+    printf("\n40 detents at 100/s  -> %ld steps\n", (long)fast);
+    Clear();
+
+    // Medium, 25 detents/s: between 1 and the maximum
+    Spin(40, 40);
+    int32_t medium = ENCODER_GetPosition(&knob);
+    BENCH_CHECK(medium > 40 && medium < fast && maxSteps > 1 && maxSteps < ENCODER_ACCEL_MAX);
+    printf("40 detents at 25/s   -> %ld steps\n", (long)medium);
+    Clear();
+
+    // Reversal in a fast spin: the first detent back is one step
+    Spin(20, 10);
+    ENCODER_SetPosition(&knob, 0);
+    Spin(-1, 10);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == -1);
+    Clear();
+
+    // Acceleration off: one step per detent at any speed
+    ENCODER_SetAcceleration(&knob, 0, 0, 1);
+    Spin(40, 10);
+    BENCH_CHECK(ENCODER_GetPosition(&knob) == 40 && maxSteps == 1);
+    ENCODER_SetAcceleration(&knob, ENCODER_ACCEL_START, ENCODER_ACCEL_FULL, ENCODER_ACCEL_MAX);
+    Clear();
+
+    // Push switch: a Toggle-mode button
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_5, 0);
+    Run(400);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_5, 1);
+    Run(100);
+    BENCH_CHECK(clicks == 1 && lastType == BUTTON_PressType_Normal && calls == 0);
+
+    ENCODER_Deinit(&knob);
+    BENCH_CHECK(BUTTON_FromHandle(1) == NULL);
+    HAL_SIM_TIM_EncoderTurn(&htim3, 4);
+    ENCODER_Update(&knob);
+    BENCH_CHECK(calls == 0);
+
+    return BENCH_End();
+}
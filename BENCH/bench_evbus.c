@@ -0,0 +1,233 @@
+/**
+ * @file bench_evbus.c
+ * @brief Event bus cost, and the BUTTON / HC-SR04 / DHT22 / I2C_BUS / DS_RTC drivers built with EVBUS_ENABLED=1.
+ *
+ * time_ns is the time the caller is blocked. The program also checks:
+ * - queue full: the producer gets HAL_BUSY, nothing is overwritten;
+ * - main loop and a simulated ISR publishing together: nothing lost, order kept
+ *   per producer;
+ * - every driver event reaches its handler from the main loop, never inside the
+ *   ISR that produced it, with its publish-to-handler latency;
+ * - a slow button handler no longer holds BUTTON_Update.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "EVBUS.h"
+#include "BUTTON.h"
+#include "DHT22.h"
+#include "HC_SR04.h"
+#include "I2C_BUS.h"
+#include "DS_RTC.h"
+#include "TIMING.h"
+
+#if !EVBUS_ENABLED
+#error "bench_evbus needs EVBUS_ENABLED=1"
+#endif
+
+#define SLOW_HANDLER_US 5000U
+
+static HCSR04_t sonar;
+static volatile uint8_t inIsr;
+
+static uint32_t isrPublished;
+static uint32_t received[EVBUS_EV_MAX + 1];
+static EVBUS_Event last[EVBUS_EV_MAX + 1];
+static uint32_t nextArg[2];
+static uint8_t orderOk = 1;
+static uint32_t slowUs;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    inIsr = 1;
+    if (htim == sonar.htim) HCSR04_TIM_IC_CaptureCallback(&sonar);
+    inIsr = 0;
+}
+
+// Records every event; USER and USER + 1 carry a per-producer counter in Arg
+static void Record(EVBUS_Handler *h, const EVBUS_Event *ev) {
+    (void)h;
+    BENCH_CHECK(!inIsr);
+    received[ev->Type]++;
+    last[ev->Type] = *ev;
+    if (ev->Type == EVBUS_EV_USER || ev->Type == EVBUS_EV_USER + 1) {
+        uint32_t *expected = &nextArg[ev->Type - EVBUS_EV_USER];
+        if (ev->Arg != (uint16_t)*expected) orderOk = 0;
+        *expected = ev->Arg + 1U;
+    }
+}
+
+static void Slow(EVBUS_Handler *h, const EVBUS_Event *ev) {
+    (void)h;
+    (void)ev;
+    HAL_SIM_AdvanceUs(slowUs);
+}
+
+static void SlowButton(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    (void)type;
+    HAL_SIM_AdvanceUs(SLOW_HANDLER_US);
+}
+
+// Simulated ISR publishing next to the main loop
+static void IsrPublish(void *ctx) {
+    (void)ctx;
+    EVBUS_Publish(EVBUS_EV_USER + 1, 0, (uint16_t)isrPublished++, NULL);
+    if (isrPublished < 200) HAL_SIM_Schedule(HAL_SIM_Now() + 500, IsrPublish, NULL);
+}
+
+static uint32_t Us(uint32_t ticks) {
+    return TIMING_TicksToNs(ticks) / 1000U;
+}
+
+// One click on PA0 (100 ms), BUTTON_Update + dispatch every ms; returns the longest BUTTON_Update
+static uint32_t Click(uint16_t pin) {
+    uint32_t worst = 0;
+    HAL_SIM_GPIO_SetInput(GPIOA, pin, 0);
+    for (int ms = 0; ms < 600; ms++) {
+        if (ms == 100) HAL_SIM_GPIO_SetInput(GPIOA, pin, 1);
+        uint32_t start = TIMING_Now();
+        BUTTON_Update();
+        uint32_t us = Us(TIMING_Elapsed(start));
+        if (us > worst) worst = us;
+        EVBUS_Dispatch(0);
+        HAL_SIM_AdvanceUs(1000);
+    }
+    return worst;
+}
+
+int main(int argc, char **argv) {
+    EVBUS_Handler recorder, slow;
+    EVBUS_Event ev;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    TIMING_Init();
+
+    // ==== Bus calls ====
+    BENCH_RUN("EVBUS_Init", EVBUS_Init());
+    BENCH_RUN("EVBUS_Subscribe", EVBUS_Subscribe(&recorder, EVBUS_MASK_ALL, Record, NULL));
+    BENCH_RUN("EVBUS_Publish", EVBUS_Publish(EVBUS_EV_USER, 0, 0, NULL));
+    BENCH_RUN("EVBUS_Dispatch_1", BENCH_CHECK(EVBUS_Dispatch(0) == 1));
+    BENCH_RUN("EVBUS_Dispatch_empty", BENCH_CHECK(EVBUS_Dispatch(0) == 0));
+
+    // ==== Queue full: newest event refused, none overwritten ====
+    for (uint32_t i = 1; i <= EVBUS_QUEUE_SIZE; i++) BENCH_CHECK(EVBUS_Publish(EVBUS_EV_USER, 0, (uint16_t)i, NULL) == HAL_OK);
+    BENCH_RUN("EVBUS_Publish_full", BENCH_CHECK(EVBUS_Publish(EVBUS_EV_USER, 0, 999, NULL) == HAL_BUSY));
+    BENCH_CHECK(EVBUS_Pending() == EVBUS_QUEUE_SIZE && EVBUS_GetStats()->Dropped == 1);
+    BENCH_CHECK(EVBUS_Dispatch(4) == 4 && EVBUS_Pending() == EVBUS_QUEUE_SIZE - 4U);
+    BENCH_CHECK(EVBUS_Dispatch(0) == EVBUS_QUEUE_SIZE - 4U);
+    BENCH_CHECK(orderOk && nextArg[0] == EVBUS_QUEUE_SIZE + 1U);
+    BENCH_CHECK(EVBUS_GetStats()->MaxDepth == EVBUS_QUEUE_SIZE);
+
+    // ==== Main loop and an ISR publishing at the same time ====
+    EVBUS_ResetStats();
+    nextArg[0] = 0;
+    HAL_SIM_Schedule(HAL_SIM_Now() + 500, IsrPublish, NULL);
+    for (uint32_t i = 0; i < 400; i++) {
+        EVBUS_Publish(EVBUS_EV_USER, 0, (uint16_t)i, NULL);
+        HAL_SIM_AdvanceUs(3);
+        if (i % 8 == 7) EVBUS_Dispatch(0);
+    }
+    HAL_SIM_Cancel(IsrPublish, NULL);
+    EVBUS_Dispatch(0);
+    BENCH_CHECK(isrPublished > 100);
+    BENCH_CHECK(EVBUS_GetStats()->Dropped == 0 && EVBUS_GetStats()->Dispatched == 400 + isrPublished);
+    BENCH_CHECK(orderOk && nextArg[0] == 400 && nextArg[1] == isrPublished);
+
+    // ==== Drivers ====
+    TIM_HandleTypeDef htim = { .Instance = TIM3, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+    DMA_HandleTypeDef dmaTx = {0}, dmaRx = {0};
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 },
+                               .hdmatx = &dmaTx, .hdmarx = &dmaRx };
+    SIM_DHT22 dhtModel = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    SIM_HCSR04 echo = { .EchoUs = 58 * 100 };
+    HAL_SIM_I2CSlave chip;
+    I2C_BUS_HandleTypeDef bus;
+    DS_RTC_HandleTypeDef rtc;
+    DS_RTC_AsyncTypeDef req;
+    DS_RTC_Time time;
+    DHT22_HandleTypedef dht;
+    DHT22_DataIntTypedef reading;
+
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_All, 1);
+    SIM_DHT22_Attach(&dhtModel, GPIOA, GPIO_PIN_1);
+    SIM_HCSR04_Attach(&echo, GPIOA, GPIO_PIN_8, &htim, TIM_CHANNEL_1);
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    HAL_I2C_Init(&hi2c);
+    I2C_BUS_Init(&bus, &hi2c, 8);
+    DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS3231);
+    DS_RTC_AttachBus(&rtc, &bus);
+    dht = DHT22_Init(GPIOA, GPIO_PIN_1, NULL);
+    HCSR04_Init(&sonar, &htim, TIM_CHANNEL_1, GPIOA, GPIO_PIN_8);
+    EVBUS_ResetStats();
+
+    // Button: no inline handler, the press comes through the bus
+    Button_t *btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, NULL);
+    SetTime_Toggle_mode(btn, 200, 300, 1000, 3000);
+    Set_DebounceTime(btn, 20);
+    uint32_t busWorst = Click(GPIO_PIN_0);
+    BENCH_CHECK(received[EVBUS_EV_BUTTON] == 1);
+    BENCH_CHECK(last[EVBUS_EV_BUTTON].Source == btn && last[EVBUS_EV_BUTTON].Sub == BUTTON_PressType_OnPressed);
+    BENCH_CHECK(EVBUS_GetStats()->LatencyMaxUs <= 1000);
+
+    // Echo capture ISR -> handler in the main loop, after a slow handler
+    slowUs = 2000;
+    EVBUS_Subscribe(&slow, EVBUS_MASK(EVBUS_EV_HCSR04_ECHO), Slow, NULL);
+    HCSR04_Trigger(&sonar);
+    for (int ms = 0; ms < HCSR04_CYCLE_MS; ms++) {
+        HAL_SIM_AdvanceUs(1000);
+        EVBUS_Dispatch(0);
+    }
+    BENCH_CHECK(received[EVBUS_EV_HCSR04_ECHO] == 1 && last[EVBUS_EV_HCSR04_ECHO].Source == &sonar);
+    BENCH_CHECK(last[EVBUS_EV_HCSR04_ECHO].Arg == echo.EchoUs);       // 1 MHz capture timer
+    BENCH_CHECK(HCSR04_ReadDistanceMm(&sonar) == 1000);
+    BENCH_CHECK(slow.Stats.Events == 1 && slow.Stats.RunTimeMaxUs >= slowUs);
+    BENCH_CHECK(EVBUS_GetStats()->LatencyMaxUs <= 1000);
+
+    // An event queued behind a slow handler waits for it
+    EVBUS_Publish(EVBUS_EV_HCSR04_ECHO, 0, 0, &sonar);
+    EVBUS_Publish(EVBUS_EV_USER + 2, 0, 0, NULL);
+    BENCH_RUN("EVBUS_Dispatch_slow_handler", BENCH_CHECK(EVBUS_Dispatch(0) == 2));
+    BENCH_CHECK(received[EVBUS_EV_USER + 2] == 1 && recorder.Stats.LatencyMaxUs >= slowUs);
+    EVBUS_Unsubscribe(&slow);
+
+    // DHT22 read status
+    BENCH_RUN("DHT22_ReadInt", DHT22_ReadInt(&dht, &reading));
+    EVBUS_Dispatch(0);
+    BENCH_CHECK(received[EVBUS_EV_DHT22_READ] == 1 && last[EVBUS_EV_DHT22_READ].Sub == DHT22_OK);
+    BENCH_CHECK(last[EVBUS_EV_DHT22_READ].Source == &dht);
+
+    // I2C transfer done in the DMA ISR
+    BENCH_RUN("DS_RTC_ReadTime_Async", DS_RTC_ReadTime_Async(&rtc, &req, &time, NULL, NULL));
+    BENCH_CHECK(I2C_BUS_Wait(&req.Txn, 100) == HAL_OK && received[EVBUS_EV_I2C_DONE] == 0);
+    EVBUS_Dispatch(0);
+    BENCH_CHECK(received[EVBUS_EV_I2C_DONE] == 1 && last[EVBUS_EV_I2C_DONE].Source == &req.Txn);
+    BENCH_CHECK(last[EVBUS_EV_I2C_DONE].Sub == HAL_OK && last[EVBUS_EV_I2C_DONE].Arg == (0x68 << 1));
+
+    // RTC alarm flag
+    chip.Regs[0x0F] = 0x89;
+    BENCH_CHECK(DS_RTC_GetAlarmFlags(&rtc) == 0x01);
+    EVBUS_Dispatch(0);
+    BENCH_CHECK(received[EVBUS_EV_RTC_ALARM] == 1 && last[EVBUS_EV_RTC_ALARM].Sub == 0x01);
+    BENCH_CHECK(last[EVBUS_EV_RTC_ALARM].Source == &rtc);
+
+    // ==== Slow handler: inline in BUTTON_Update vs through the bus ====
+    BUTTON_Deinit(btn);
+    btn = BUTTON_Init(GPIOA, GPIO_PIN_2, 0, BUTTON_Mode_Toggle, SlowButton);
+    SetTime_Toggle_mode(btn, 200, 300, 1000, 3000);
+    Set_DebounceTime(btn, 20);
+    uint32_t inlineWorst = Click(GPIO_PIN_2);
+    printf("\nlongest BUTTON_Update around a click: %lu us with a %u us inline handler, %lu us through the bus\n",
+           (unsigned long)inlineWorst, SLOW_HANDLER_US, (unsigned long)busWorst);
+    BENCH_CHECK(inlineWorst >= SLOW_HANDLER_US && busWorst < SLOW_HANDLER_US / 10U);
+
+    ev = last[EVBUS_EV_BUTTON];
+    BENCH_CHECK(received[EVBUS_EV_BUTTON] == 2 && ev.Source == btn);
+    printf("publish -> handler latency: max %lu us, recorder avg %lu us over %lu events\n",
+           (unsigned long)EVBUS_GetStats()->LatencyMaxUs,
+           (unsigned long)(recorder.Stats.LatencySumUs / (recorder.Stats.Events ? recorder.Stats.Events : 1)),
+           (unsigned long)recorder.Stats.Events);
+
+    return BENCH_End();
+}
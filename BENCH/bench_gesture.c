@@ -0,0 +1,175 @@
+/**
+ * @file bench_gesture.c
+ * @brief GESTURE recognition on polled buttons, and the cost of one edge.
+ *
+ * Four buttons on GPIOA 0..3 (pull-up, 10 ms debounce) bound to keys UP, DOWN, OK,
+ * BACK. Checks a held chord, exact and counted clicks, a sequence, and that another
+ * key breaks a click run or a sequence. The host time of one edge is printed for a
+ * 32-gesture table where the key is in 1 gesture and where it is in all 32: only
+ * the gestures of the key (and those in progress) are visited.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "GESTURE.h"
+
+#define HOST_EDGES 20000
+
+enum { KEY_UP, KEY_DOWN, KEY_OK, KEY_BACK };
+enum { G_UNLOCK, G_TRIPLE_OK, G_CLICKS_UP, G_SEQ };
+
+static const GESTURE_Def table[] = {
+    [G_UNLOCK]    = { GESTURE_CHORD,    2, { KEY_UP, KEY_DOWN }, 0, 1000 },
+    [G_TRIPLE_OK] = { GESTURE_CLICKS,   1, { KEY_OK }, 3, 300 },
+    [G_CLICKS_UP] = { GESTURE_CLICKS,   1, { KEY_UP }, 0, 300 },
+    [G_SEQ]       = { GESTURE_SEQUENCE, 4, { KEY_UP, KEY_UP, KEY_DOWN, KEY_OK }, 0, 800 },
+};
+
+static int fired[GESTURE_MAX];
+static uint16_t lastArg;
+static uint32_t lastTick;
+static int buttonEvents;
+
+static void OnGesture(uint8_t gesture, uint16_t arg) {
+    fired[gesture]++;
+    lastArg = arg;
+    lastTick = HAL_GetTick();
+}
+
+static void OnButton(Button_t *btn, ButtonPressType_t type) {
+    (void)btn; (void)type;
+    buttonEvents++;
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { BUTTON_Update(); GESTURE_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+static void Key(int key, int down) {
+    HAL_SIM_GPIO_SetInput(GPIOA, (uint16_t)(1U << key), down ? 0 : 1);
+}
+
+static void Click(int key) {
+    Key(key, 1);
+    Run(60);
+    Key(key, 0);
+    Run(60);
+}
+
+static void Clear(void) {
+    Run(1000);
+    for (int g = 0; g < GESTURE_MAX; ++g) fired[g] = 0;
+}
+
+static uint32_t HostPerEdge(Button_t *btn) {
+    uint32_t tick = HAL_GetTick();
+    uint64_t start = BENCH_HostNs();
+    for (int k = 0; k < HOST_EDGES; k += 2) {
+        GESTURE_OnEdge(btn, 1, tick);
+        GESTURE_OnEdge(btn, 0, tick + 50U);
+        tick += 100U;
+    }
+    return (uint32_t)((BENCH_HostNs() - start) / HOST_EDGES);
+}
+
+int main(int argc, char **argv) {
+    Button_t *btn[4];
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_All, 1);
+
+    BENCH_RUN("GESTURE_Init", BENCH_CHECK(GESTURE_Init(table, 4, OnGesture) == HAL_OK));
+    for (int k = 0; k < 4; ++k) {
+        btn[k] = BUTTON_Init(GPIOA, (uint16_t)(1U << k), 0, BUTTON_Mode_Toggle, OnButton);
+        Set_DebounceTime(btn[k], 10);
+        BENCH_CHECK(GESTURE_Bind((uint8_t)k, btn[k]) == HAL_OK);
+    }
+    BENCH_RUN("GESTURE_Update_idle", GESTURE_Update());
+    BENCH_RUN("GESTURE_NextUpdate", BENCH_CHECK(GESTURE_NextUpdate() == BUTTON_FOREVER));
+
+    // Chord: UP + DOWN held, reported 1000 ms after both are down, once
+    Key(KEY_UP, 1);
+    Run(100);
+    Key(KEY_DOWN, 1);
+    uint32_t both = HAL_GetTick() + 10U;     // debounced
+    Run(900);
+    BENCH_CHECK(fired[G_UNLOCK] == 0);
+    BENCH_Start();
+    Run(1000);
+    BENCH_Stop("GESTURE_chord_hold");
+    BENCH_CHECK(fired[G_UNLOCK] == 1 && lastTick - both >= 1000U && lastTick - both <= 1002U);
+    Key(KEY_UP, 0);
+    Key(KEY_DOWN, 0);
+    Clear();
+
+    // Exactly three clicks of OK; two are not enough, four are too many
+    Click(KEY_OK); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_TRIPLE_OK] == 0);
+    Click(KEY_OK); Click(KEY_OK); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_TRIPLE_OK] == 1 && lastArg == 3);
+    Click(KEY_OK); Click(KEY_OK); Click(KEY_OK); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_TRIPLE_OK] == 1);
+    Clear();
+
+    // Counted clicks of UP: one run of 5, the count in arg; the button handlers still run
+    buttonEvents = 0;
+    for (int i = 0; i < 5; ++i) Click(KEY_UP);
+    Run(400);
+    BENCH_CHECK(fired[G_CLICKS_UP] == 1 && lastArg == 5 && fired[G_UNLOCK] == 0);
+    BENCH_CHECK(buttonEvents > 0);
+    Clear();
+
+    // Sequence UP UP DOWN OK: DOWN ends the UP click run before it is counted
+    Click(KEY_UP); Click(KEY_UP); Click(KEY_DOWN); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_SEQ] == 1 && fired[G_CLICKS_UP] == 0);
+    Clear();
+
+    // A third UP is a wrong press that still ends UP UP: the sequence goes on from there
+    Click(KEY_UP); Click(KEY_UP); Click(KEY_UP); Click(KEY_DOWN); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_SEQ] == 1);
+    Clear();
+
+    // Another key in the middle, or a gap too long, breaks it
+    Click(KEY_UP); Click(KEY_UP); Click(KEY_BACK); Click(KEY_DOWN); Click(KEY_OK);
+    Click(KEY_UP); Click(KEY_UP);
+    Run(900);
+    Click(KEY_DOWN); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_SEQ] == 0);
+
+    // Released button: its old handle no longer matches the binding
+    Button_t *old = btn[KEY_BACK];
+    BUTTON_Deinit(old);
+    btn[KEY_BACK] = BUTTON_Init(GPIOA, GPIO_PIN_3, 0, BUTTON_Mode_Toggle, OnButton);
+    BENCH_CHECK(btn[KEY_BACK] == old);
+    Click(KEY_UP); Click(KEY_UP); Click(KEY_BACK); Click(KEY_DOWN); Click(KEY_OK);
+    Run(400);
+    BENCH_CHECK(fired[G_SEQ] == 1);           // BACK is not bound any more
+    Clear();
+
+    // Cost of one edge with 32 gestures: the key in 1 of them, then in all 32
+    static GESTURE_Def big[GESTURE_MAX];
+    for (int g = 0; g < GESTURE_MAX; ++g) {
+        big[g] = (GESTURE_Def){ GESTURE_SEQUENCE, 2, { (uint8_t)(4 + g % 12), (uint8_t)(4 + (g + 1) % 12) }, 0, 500 };
+    }
+    big[0] = (GESTURE_Def){ GESTURE_CHORD, 2, { KEY_UP, KEY_DOWN }, 0, 1000 };
+    BENCH_CHECK(GESTURE_Init(big, GESTURE_MAX, OnGesture) == HAL_OK);
+    BENCH_RUN("GESTURE_OnEdge_1_of_32", GESTURE_OnEdge(btn[KEY_UP], 1, HAL_GetTick()));
+    GESTURE_OnEdge(btn[KEY_UP], 0, HAL_GetTick());
+    uint32_t hostOne = HostPerEdge(btn[KEY_UP]);
+
+    for (int g = 0; g < GESTURE_MAX; ++g) {
+        big[g] = (GESTURE_Def){ GESTURE_CLICKS, 1, { KEY_UP }, (uint8_t)(g + 2), 300 };
+    }
+    BENCH_CHECK(GESTURE_Init(big, GESTURE_MAX, OnGesture) == HAL_OK);
+    uint32_t hostAll = HostPerEdge(btn[KEY_UP]);
+    printf("\nhost ns per edge, 32 gestures\nkey in 1   %lu\nkey in 32  %lu\n",
+           (unsigned long)hostOne, (unsigned long)hostAll);
+
+    return BENCH_End();
+}
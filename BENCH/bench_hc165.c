@@ -0,0 +1,141 @@
+/**
+ * @file bench_hc165.c
+ * @brief HC165 snapshot cost on a chain of 8 74HC165 (64 inputs), keys through the BUTTON classifier.
+ *
+ * The chain is simulated on SPI1 (prescaler 16: 4.5 MHz) with SH/LD on GPIOA 4 and
+ * pull-ups on every input. A snapshot must be one SH/LD pulse, long enough for the
+ * chain to latch (HAL_SIM_HC165_LD_MIN_NS), one DMA receive of 8 bytes and one
+ * transfer-complete interrupt, whatever the number of inputs; the debounce of the idle
+ * inputs must skip their words. A 10 ms glitch is filtered, a press is one click of its
+ * input only, a Hold-mode input repeats. The rows are HC165_Update idle, with a
+ * snapshot to debounce, and a whole click.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "HC165.h"
+
+#define CHIPS    8
+#define INPUTS   (CHIPS * 8)
+#define HOLD_BIT 63
+
+static HC165_t chain;
+static DMA_Channel_TypeDef rxChannel;
+static DMA_HandleTypeDef hdmaRx = { .Instance = &rxChannel };
+static SPI_HandleTypeDef hspi1 = {
+    .Instance = SPI1, .hdmarx = &hdmaRx,
+    .Init = { .Mode = SPI_MODE_MASTER, .Direction = SPI_DIRECTION_2LINES_RXONLY, .DataSize = SPI_DATASIZE_8BIT,
+              .CLKPolarity = SPI_POLARITY_LOW, .CLKPhase = SPI_PHASE_1EDGE, .NSS = SPI_NSS_SOFT,
+              .BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16, .FirstBit = SPI_FIRSTBIT_MSB },
+};
+static int presses[INPUTS];
+static int repeats;
+
+static void InputHandler(Button_t *btn, ButtonPressType_t type) {
+    int16_t b = HC165_BitIndex(&chain, btn);
+    if (b < 0) return;
+    if (b == HOLD_BIT) { if (type == BUTTON_PressType_Repeat) repeats++; return; }
+    if (type != BUTTON_PressType_Provisional) presses[b]++;
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { HC165_Update(&chain); BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+// Button to GND: pressed reads low
+static void Press(uint16_t bit, int on) {
+    HAL_SIM_HC165_SetInput(SPI1, bit, on ? 0 : 1);
+}
+
+static int Total(void) {
+    int n = 0;
+    for (int b = 0; b < INPUTS; ++b) n += presses[b];
+    return n;
+}
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    GPIO_InitTypeDef ld = { .Pin = GPIO_PIN_4, .Mode = GPIO_MODE_OUTPUT_PP };
+    HAL_GPIO_Init(GPIOA, &ld);
+    HAL_SIM_HC165_Attach(SPI1, GPIOA, GPIO_PIN_4, CHIPS);
+
+    // The SPI must be initialised, the chain fit HC165_MAX_CHIPS
+    BENCH_CHECK(HC165_Init(&chain, &hspi1, GPIOA, GPIO_PIN_4, CHIPS, 0) == HAL_ERROR);
+    BENCH_CHECK(HAL_SPI_Init(&hspi1) == HAL_OK);
+    BENCH_CHECK(HC165_Init(&chain, &hspi1, GPIOA, GPIO_PIN_4, 0, 0) == HAL_ERROR);
+    BENCH_CHECK(HC165_Init(&chain, &hspi1, GPIOA, GPIO_PIN_4, HC165_MAX_CHIPS + 1, 0) == HAL_ERROR);
+    BENCH_CHECK(HC165_Init(&chain, &hspi1, GPIOA, GPIO_PIN_4, CHIPS, 0) == HAL_OK);
+
+    for (uint16_t b = 0; b < INPUTS; ++b) {
+        ButtonMode_t mode = (b == HOLD_BIT) ? BUTTON_Mode_Hold : BUTTON_Mode_Toggle;
+        BENCH_CHECK(HC165_Attach(&chain, b, mode, InputHandler) != NULL);
+    }
+    BENCH_CHECK(HC165_Attach(&chain, 3, BUTTON_Mode_Toggle, InputHandler) == NULL);
+    BENCH_CHECK(HC165_Attach(&chain, INPUTS, BUTTON_Mode_Toggle, InputHandler) == NULL);
+    BENCH_CHECK(HC165_BitIndex(&chain, HC165_GetButton(&chain, 42)) == 42);
+
+    // 100 ms idle: 20 snapshots, each one load, 8 bytes and one interrupt
+    Run(2);
+    HAL_SIM_Stats stats;
+    HAL_SIM_ResetStats();
+    uint32_t loads = HAL_SIM_HC165_Loads(SPI1), snaps = chain.Snapshots;
+    Run(100);
+    HAL_SIM_GetStats(&stats);
+    loads = HAL_SIM_HC165_Loads(SPI1) - loads;
+    snaps = chain.Snapshots - snaps;
+    BENCH_CHECK(loads == 100 / HC165_SCAN_MS && snaps == loads);
+    BENCH_CHECK(stats.SpiIrqs == loads && stats.SpiBytes == loads * CHIPS && chain.Errors == 0);
+    BENCH_CHECK(Total() == 0);
+    printf("\n100 ms idle, %d inputs: %lu snapshots, %lu SPI bytes, %lu DMA interrupts, %lu GPIO writes\n",
+           INPUTS, (unsigned long)snaps, (unsigned long)stats.SpiBytes, (unsigned long)stats.SpiIrqs,
+           (unsigned long)stats.GpioWrites);
+
+    // Between two snapshots: nothing to do; right after one: its debounce + the next start
+    BENCH_CHECK(HC165_NextUpdate(&chain) > 0);
+    BENCH_RUN("HC165_Update_idle", HC165_Update(&chain));
+    HAL_SIM_AdvanceUs(HC165_SCAN_MS * 1000U);
+    HC165_Update(&chain);
+    HAL_SIM_AdvanceUs(HC165_SCAN_MS * 1000U);
+    BENCH_CHECK(chain.Busy && HC165_NextUpdate(&chain) == 0);
+    BENCH_RUN("HC165_Update_snapshot", HC165_Update(&chain));
+    Run(50);
+
+    // A 10 ms glitch is filtered, a 100 ms press of input 13 is one click of that input
+    Press(13, 1);
+    Run(10);
+    Press(13, 0);
+    Run(100);
+    BENCH_CHECK(Total() == 0 && !HC165_Pressed(&chain, 13));
+
+    Press(13, 1);
+    BENCH_Start();
+    Run(100);
+    BENCH_CHECK(HC165_Pressed(&chain, 13));
+    Press(13, 0);
+    Run(100);
+    BENCH_Stop("HC165_click_200ms");
+    BENCH_CHECK(presses[13] == 1 && Total() == 1);
+
+    // Inputs on the first and last chips, in different words, at once
+    Press(0, 1);
+    Press(33, 1);
+    Press(62, 1);
+    Run(100);
+    Press(0, 0);
+    Press(33, 0);
+    Press(62, 0);
+    Run(100);
+    BENCH_CHECK(presses[0] == 1 && presses[33] == 1 && presses[62] == 1 && Total() == 4);
+
+    // Hold mode: repeats at 500 ms, then every 200 ms while held
+    Press(HOLD_BIT, 1);
+    Run(1200);
+    Press(HOLD_BIT, 0);
+    Run(100);
+    BENCH_CHECK(repeats == 4 && Total() == 4);
+
+    HC165_Deinit(&chain);
+    BENCH_CHECK(BUTTON_FromHandle(1) == NULL && HC165_GetButton(&chain, 0) == NULL);
+
+    return BENCH_End();
+}
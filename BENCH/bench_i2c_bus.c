@@ -0,0 +1,177 @@
+/**
+ * @file bench_i2c_bus.c
+ * @brief Main-loop cost of the shared I2C bus manager, LCD refresh + RTC on one bus.
+ *
+ * time_ns is the time the caller is blocked. The async rows only pay the submit;
+ * the "_wait" rows show when the result is available. The program also checks
+ * ordering, read-modify-write and the LCD content, and fails on a mismatch.
+ *
+ * The last rows hang the bus (slave stretching SCL, slave holding SDA low) and
+ * check each operation ends inside its budget, with the recovery and counters.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "I2C_BUS.h"
+#include "LCD162_I2C.h"
+#include "DS_RTC.h"
+#include "TIMING.h"
+
+static uint8_t order[8];
+static uint8_t orderCount;
+
+static void Record(uint8_t tag) {
+    if (orderCount < sizeof(order)) order[orderCount++] = tag;
+}
+
+static void FillerDone(I2C_BUS_Transaction *txn, HAL_StatusTypeDef status) {
+    (void)status;
+    Record((uint8_t)(uintptr_t)txn->Ctx);
+}
+
+static void RtcDone(DS_RTC_AsyncTypeDef *req, HAL_StatusTypeDef status) {
+    (void)status;
+    Record((uint8_t)(uintptr_t)req->Ctx);
+}
+
+static void Drain(I2C_BUS_HandleTypeDef *bus) {
+    while (!I2C_BUS_IsIdle(bus)) HAL_SIM_AdvanceUs(10);
+}
+
+static uint32_t ElapsedMs(uint32_t start) {
+    return TIMING_TicksToNs(TIMING_Elapsed(start)) / 1000000U;
+}
+
+int main(int argc, char **argv) {
+    DMA_HandleTypeDef dmaTx = {0}, dmaRx = {0};
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 },
+                               .hdmatx = &dmaTx, .hdmarx = &dmaRx };
+    SIM_PCF8574 backpack;
+    HAL_SIM_I2CSlave chip;
+    I2C_BUS_HandleTypeDef bus;
+    DS_RTC_HandleTypeDef rtc;
+    DS_RTC_AsyncTypeDef req;
+    DS_RTC_Time time;
+    float temperature = 0;
+    int16_t quarters = 0;
+    I2C_BUS_Transaction filler;
+    uint8_t fillerData[8] = {0};
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    SIM_PCF8574_Attach(&backpack, &hi2c, LCD_I2C_ADDR);
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    HAL_I2C_Init(&hi2c);
+    lcd_init(&hi2c);
+    DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS3231);
+
+    // ==== Reference: blocking refresh, then the RTC read waits for it ====
+    BENCH_RUN("blocking_lcd_row_16", { lcd_put_cur(0, 0); lcd_send_string("0123456789ABCDEF"); });
+    BENCH_RUN("blocking_rtc_read", DS_RTC_ReadTime(&rtc, &time));
+
+    // ==== Same work through the bus manager ====
+    BENCH_RUN("I2C_BUS_Init", I2C_BUS_Init(&bus, &hi2c, 8));
+    lcd_attach_bus(&bus);
+    DS_RTC_AttachBus(&rtc, &bus);
+
+    BENCH_RUN("lcd_write_at_async_16", lcd_write_at_async(1, 0, "FEDCBA9876543210", NULL));
+    BENCH_CHECK(HAL_I2C_Mem_Read(&hi2c, 0x68 << 1, 0, 1, fillerData, 1, 10) == HAL_BUSY);
+    BENCH_RUN("DS_RTC_ReadTime_Async", DS_RTC_ReadTime_Async(&rtc, &req, &time, RtcDone, (void *)2));
+    BENCH_RUN("DS_RTC_ReadTime_Async_wait", I2C_BUS_Wait(&req.Txn, 100));
+    BENCH_CHECK(req.Txn.Status == HAL_OK && time.hours == 12 && time.minutes == 34);
+    Drain(&bus);
+    BENCH_CHECK(memcmp(&backpack.Ddram[0x40], "FEDCBA9876543210", 16) == 0);
+    BENCH_CHECK(memcmp(&backpack.Ddram[0x00], "0123456789ABCDEF", 16) == 0);
+    BENCH_CHECK(backpack.Violations == 0);
+
+    // ==== Priority: a NORMAL RTC read overtakes a queued LOW transfer ====
+    orderCount = 0;
+    lcd_write_at_async(0, 0, "priority test", NULL);        // on the wire, not preempted
+    I2C_BUS_Transmit(&filler, LCD_I2C_ADDR, fillerData, sizeof(fillerData), I2C_BUS_PRIO_LOW);
+    I2C_BUS_Submit(&bus, &filler, FillerDone, (void *)1);
+    DS_RTC_ReadTime_Async(&rtc, &req, &time, RtcDone, (void *)2);
+    Drain(&bus);
+    BENCH_CHECK(orderCount == 2 && order[0] == 2 && order[1] == 1);
+
+    // ==== Blocking API through the queue while an async update runs ====
+    lcd_write_at_async(1, 0, "blocking + queue", NULL);
+    BENCH_RUN("DS_RTC_ReadTime_queued", BENCH_CHECK(DS_RTC_ReadTime(&rtc, &time) == HAL_OK));
+
+    // ==== Read-modify-write chain: only A1F cleared ====
+    Drain(&bus);
+    chip.Regs[0x0F] = 0x89;
+    BENCH_RUN("DS_RTC_ClearAlarmFlag_Async", DS_RTC_ClearAlarmFlag_Async(&rtc, &req, RtcDone, (void *)3));
+    BENCH_RUN("DS_RTC_ClearAlarmFlag_Async_wait", I2C_BUS_Wait(&req.Rmw.Read, 100));
+    BENCH_CHECK(chip.Regs[0x0F] == 0x88);
+
+    BENCH_RUN("DS_RTC_GetTemperature_Async", DS_RTC_GetTemperature_Async(&rtc, &req, &temperature, RtcDone, (void *)4));
+    BENCH_RUN("DS_RTC_GetTemperature_Async_wait", I2C_BUS_Wait(&req.Txn, 100));
+    BENCH_CHECK(temperature == 25.25f);
+    BENCH_CHECK(DS_RTC_GetTemperatureQ_Async(&rtc, &req, &quarters, NULL, NULL) == HAL_OK);
+    BENCH_CHECK(I2C_BUS_Wait(&req.Txn, 100) == HAL_OK && quarters == 101);
+
+    // ==== Missing device: error reported, queue keeps going ====
+    chip.Nack = 1;
+    DS_RTC_ReadTime_Async(&rtc, &req, &time, RtcDone, (void *)5);
+    BENCH_CHECK(I2C_BUS_Wait(&req.Txn, 100) == HAL_ERROR && req.Txn.ErrorCode == HAL_I2C_ERROR_AF);
+    chip.Nack = 0;
+    BENCH_CHECK(DS_RTC_ReadTime(&rtc, &time) == HAL_OK);
+
+    // ==== Fast mode: idle bytes keep the LCD inside its execution time ====
+    Drain(&bus);
+    hi2c.Init.ClockSpeed = 400000;
+    backpack.ByteNs = 22500;
+    BENCH_RUN("lcd_write_at_async_16_400k", lcd_write_at_async(0, 0, "fast mode 400kHz", NULL));
+    Drain(&bus);
+    BENCH_CHECK(memcmp(&backpack.Ddram[0x00], "fast mode 400kHz", 16) == 0);
+    BENCH_CHECK(backpack.Violations == 0);
+    BENCH_CHECK(bus.Failed == 1);
+
+    // ==== Stuck bus, direct HAL calls: budget per attempt, recovery, retries ====
+    DS_RTC_HandleTypeDef direct;
+    const I2C_BUS_DevStats *stats;
+    uint8_t regs[7];
+    uint32_t start;
+    hi2c.Init.ClockSpeed = 100000;
+    DS_RTC_Init(&direct, &hi2c, DS_RTC_DS3231);
+
+    HAL_SIM_I2C_HoldScl(I2C1, 200000);
+    BENCH_RUN("blocking_max_delay_scl_stretch", HAL_I2C_Mem_Read(&hi2c, 0x68 << 1, 0, 1, regs, 7, HAL_MAX_DELAY));
+    I2C_BUS_ResetDevStats();
+    HAL_SIM_I2C_HoldScl(I2C1, 200000);
+    start = TIMING_Now();
+    BENCH_RUN("DS_RTC_ReadTime_scl_stretch", BENCH_CHECK(DS_RTC_ReadTime(&direct, &time) == HAL_TIMEOUT));
+    stats = I2C_BUS_GetDevStats(&hi2c, 0x68 << 1);
+    BENCH_CHECK(ElapsedMs(start) <= 20);
+    BENCH_CHECK(stats && stats->Timeouts == 3 && stats->Retries == 2 && stats->Recoveries == 3 && stats->Failures == 1);
+    HAL_SIM_I2C_HoldScl(I2C1, 0);
+
+    I2C_BUS_ResetDevStats();
+    HAL_SIM_I2C_HoldSda(I2C1, 5);
+    BENCH_RUN("DS_RTC_ReadTime_sda_stuck", BENCH_CHECK(DS_RTC_ReadTime(&direct, &time) == HAL_OK));
+    stats = I2C_BUS_GetDevStats(&hi2c, 0x68 << 1);
+    BENCH_CHECK(stats && stats->Recoveries == 1 && stats->Retries == 1 && stats->Transfers == 1);
+    BENCH_CHECK(time.hours == 12 && time.minutes == 34);
+
+    // ==== Stuck bus through the queue: I2C_BUS_Poll drops the step past its budget ====
+    I2C_BUS_ResetDevStats();
+    HAL_SIM_I2C_HoldScl(I2C1, 200000);
+    DS_RTC_ReadTime_Async(&rtc, &req, &time, RtcDone, (void *)6);
+    uint32_t worstMs = I2C_BUS_WorstCaseMs(&bus, &req.Txn);
+    start = TIMING_Now();
+    BENCH_RUN("DS_RTC_ReadTime_Async_scl_stretch_wait", BENCH_CHECK(I2C_BUS_Wait(&req.Txn, HAL_MAX_DELAY) == HAL_TIMEOUT));
+    BENCH_CHECK(ElapsedMs(start) <= worstMs);
+    BENCH_CHECK(bus.Timeouts == 3 && bus.Recoveries == 3);
+    stats = I2C_BUS_GetDevStats(&hi2c, 0x68 << 1);
+    BENCH_CHECK(stats && stats->Timeouts == 3 && stats->Failures == 1);
+    HAL_SIM_I2C_HoldScl(I2C1, 0);
+
+    HAL_SIM_I2C_HoldSda(I2C1, 3);
+    BENCH_RUN("DS_RTC_ReadTime_Async_sda_stuck", DS_RTC_ReadTime_Async(&rtc, &req, &time, RtcDone, (void *)7));
+    BENCH_RUN("DS_RTC_ReadTime_Async_sda_stuck_wait", BENCH_CHECK(I2C_BUS_Wait(&req.Txn, HAL_MAX_DELAY) == HAL_OK));
+    BENCH_CHECK(bus.Recoveries == 4 && I2C_BUS_IsIdle(&bus) && bus.PendingMs == 0);
+    BENCH_CHECK(DS_RTC_ReadTime(&rtc, &time) == HAL_OK);
+
+    return BENCH_End();
+}
@@ -0,0 +1,166 @@
+/**
+ * @file bench_keypad.c
+ * @brief KEYPAD scan cost on 4x4 and 8x8 matrices, keys through the BUTTON classifier.
+ *
+ * The matrix is simulated without diodes: rows on GPIOA 0..7 (open drain), columns
+ * on GPIOB 0..7 (pull-up). A pressed key joins its row and column lines, so three
+ * keys on the corners of a rectangle pull the fourth column low, as on real hardware.
+ * A released column goes back high COLUMN_RISE_NS later (pull-up and line
+ * capacitance): a scan that reads it right after the strobe sees the key of the
+ * previous row in this row too.
+ * Writes / reads of a KEYPAD_Scan row are its BSRR stores and IDR loads; the host
+ * time per scan is printed.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "KEYPAD.h"
+
+#define HOST_SCANS 5000
+#define COLUMN_RISE_NS 1000
+
+static KEYPAD_t pad;
+static uint8_t pressed[8];          // column bits of the pressed keys, per row
+static int presses[64];
+static ButtonPressType_t lastType;
+
+static uint8_t colsLow;             // columns a key joins to a driven row
+
+// Pull-ups done: the released columns read high
+static void ColumnRise(void *ctx) {
+    (void)ctx;
+    HAL_SIM_GPIO_SetInput(GPIOB, (uint16_t)(0xFFU & ~colsLow), 1);
+}
+
+// Rows pulled low: the driven ones, then any row joined to a low column by a key
+static void Matrix(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx) {
+    (void)GPIOx; (void)GPIO_Pin; (void)level; (void)ctx;
+    uint8_t lowRows = (uint8_t)~GPIOA->ODR, lowCols = 0, before;
+
+    do {
+        before = lowRows;
+        lowCols = 0;
+        for (int r = 0; r < 8; ++r) if (lowRows & (1U << r)) lowCols |= pressed[r];
+        for (int r = 0; r < 8; ++r) if (pressed[r] & lowCols) lowRows |= (uint8_t)(1U << r);
+    } while (lowRows != before);
+
+    // Pulled low at once, back high only after the rise time
+    colsLow = lowCols;
+    if (lowCols) HAL_SIM_GPIO_SetInput(GPIOB, lowCols, 0);
+    if ((uint8_t)~GPIOB->IDR & (uint8_t)~lowCols) {
+        HAL_SIM_Cancel(ColumnRise, NULL);
+        HAL_SIM_Schedule(HAL_SIM_Now() + (uint64_t)COLUMN_RISE_NS * SystemCoreClock / 1000000000U, ColumnRise, NULL);
+    }
+}
+
+static void KeyHandler(Button_t *btn, ButtonPressType_t type) {
+    int16_t k = KEYPAD_KeyIndex(&pad, btn);
+    if (k >= 0 && type != BUTTON_PressType_Provisional) presses[k]++;
+    lastType = type;
+}
+
+static void Run(int ms) {
+    for (int t = 0; t < ms; ++t) { KEYPAD_Update(&pad); BUTTON_Update(); HAL_SIM_AdvanceUs(1000); }
+}
+
+static void Press(int row, int col, int on) {
+    if (on) pressed[row] |= (uint8_t)(1U << col); else pressed[row] &= (uint8_t)~(1U << col);
+}
+
+static int Total(void) {
+    int n = 0;
+    for (int k = 0; k < 64; ++k) n += presses[k];
+    return n;
+}
+
+static uint32_t HostPerScan(void) {
+    uint64_t start = BENCH_HostNs();
+    for (int k = 0; k < HOST_SCANS; ++k) KEYPAD_Scan(&pad);
+    return (uint32_t)((BENCH_HostNs() - start) / HOST_SCANS);
+}
+
+int main(int argc, char **argv) {
+    uint32_t host4, host8;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    GPIO_InitTypeDef rows = { .Pin = 0x00FF, .Mode = GPIO_MODE_OUTPUT_OD };
+    HAL_GPIO_Init(GPIOA, &rows);
+    for (int r = 0; r < 8; ++r) HAL_SIM_GPIO_SetWriteHook(GPIOA, (uint16_t)(1U << r), Matrix, NULL);
+    HAL_SIM_GPIO_SetInput(GPIOB, GPIO_PIN_All, 1);
+
+    // 4x4: one store per row + the release, one load per row
+    BENCH_CHECK(KEYPAD_Init(&pad, GPIOA, 0x000F, GPIOB, 0x000F, BUTTON_Mode_Toggle, KeyHandler) == HAL_OK);
+    HAL_SIM_Stats stats;
+    HAL_SIM_ResetStats();
+    BENCH_RUN("KEYPAD_Scan_4x4", KEYPAD_Scan(&pad));
+    HAL_SIM_GetStats(&stats);
+    BENCH_CHECK(stats.GpioWrites == 5 && stats.GpioReads == 4);
+    host4 = HostPerScan();
+    KEYPAD_Deinit(&pad);
+
+    // 8x8: 64 buttons
+    BENCH_RUN("KEYPAD_Init_8x8", KEYPAD_Init(&pad, GPIOA, 0x00FF, GPIOB, 0x00FF, BUTTON_Mode_Toggle, KeyHandler));
+    BENCH_CHECK(pad.Rows == 8 && pad.Cols == 8 && KEYPAD_GetKey(&pad, 7, 7) != NULL);
+    HAL_SIM_ResetStats();
+    BENCH_RUN("KEYPAD_Scan_8x8", KEYPAD_Scan(&pad));
+    HAL_SIM_GetStats(&stats);
+    BENCH_CHECK(stats.GpioWrites == 9 && stats.GpioReads == 8);
+    host8 = HostPerScan();
+    BENCH_RUN("KEYPAD_Update_due", KEYPAD_Update(&pad));
+
+    printf("\nhost ns per KEYPAD_Scan (matrix model included)\n4x4  %lu\n8x8  %lu\n", (unsigned long)host4, (unsigned long)host8);
+
+    // A 10 ms bounce is filtered, a 100 ms press of key (2,5) is one click of that key
+    Run(50);
+    Press(2, 5, 1);
+    Run(10);
+    Press(2, 5, 0);
+    Run(100);
+    BENCH_CHECK(Total() == 0);
+
+    Press(2, 5, 1);
+    BENCH_Start();
+    Run(100);
+    Press(2, 5, 0);
+    Run(100);
+    BENCH_Stop("KEYPAD_click_200ms");
+    BENCH_CHECK(presses[2 * 8 + 5] == 1 && Total() == 1);
+
+    // A long press goes through the Toggle classification of its key
+    SetTime_Toggle_mode(KEYPAD_GetKey(&pad, 6, 1), 0, 300, 1000, 3000);
+    Press(6, 1, 1);
+    Run(1200);
+    Press(6, 1, 0);
+    Run(100);
+    BENCH_CHECK(presses[6 * 8 + 1] == 1 && lastType == BUTTON_PressType_Long);
+
+    // Two keys of one column on two rows: both real
+    Press(0, 3, 1);
+    Press(4, 3, 1);
+    Run(100);
+    Press(0, 3, 0);
+    Press(4, 3, 0);
+    Run(100);
+    BENCH_CHECK(presses[0 * 8 + 3] == 1 && presses[4 * 8 + 3] == 1 && pad.Ghosts == 0);
+
+    // (0,0) and (0,1) held, then (1,0): (1,1) reads pressed too. Rows 0 and 1 are
+    // ambiguous and keep their state: (1,1) never fires, (0,0) and (0,1) still release
+    int before = Total();
+    Press(0, 0, 1);
+    Press(0, 1, 1);
+    Run(100);
+    Press(1, 0, 1);
+    Run(100);
+    BENCH_CHECK(pad.Ghosts > 0 && presses[1 * 8 + 1] == 0 && presses[1 * 8 + 0] == 0);
+    Press(1, 0, 0);
+    Run(50);
+    Press(0, 0, 0);
+    Press(0, 1, 0);
+    Run(100);
+    BENCH_CHECK(presses[1 * 8 + 1] == 0 && presses[0] == 1 && presses[1] == 1 && Total() == before + 2);
+
+    KEYPAD_Deinit(&pad);
+    BENCH_CHECK(BUTTON_FromHandle(1) == NULL);
+
+    return BENCH_End();
+}
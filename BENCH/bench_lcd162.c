@@ -0,0 +1,23 @@
+/**
+ * @file bench_lcd162.c
+ * @brief Per-API cost of the parallel HD44780 driver (LCD162).
+ */
+
+#include "BENCH.h"
+#include "LCD162.h"
+
+int main(int argc, char **argv) {
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    BENCH_RUN("initLCD", initLCD());
+    BENCH_RUN("clearLCD", clearLCD());
+    BENCH_RUN("setCursor", setCursor(0, 1));
+    BENCH_RUN("putLCD", putLCD('A'));
+    BENCH_RUN("writeLCD_16", writeLCD("0123456789ABCDEF"));
+    BENCH_RUN("cursorOn", cursorOn());
+    BENCH_RUN("blinkOn", blinkOn());
+    BENCH_RUN("clearDisp", clearDisp());
+    BENCH_RUN("setDisplay", setDisplay(LCD_DISPLAYON));
+
+    return BENCH_End();
+}
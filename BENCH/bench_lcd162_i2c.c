@@ -0,0 +1,27 @@
+/**
+ * @file bench_lcd162_i2c.c
+ * @brief Per-API cost of the PCF8574 I2C LCD driver (LCD162_I2C).
+ */
+
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "LCD162_I2C.h"
+
+int main(int argc, char **argv) {
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 } };
+    SIM_PCF8574 backpack;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    SIM_PCF8574_Attach(&backpack, &hi2c, LCD_I2C_ADDR);
+
+    BENCH_RUN("lcd_init", lcd_init(&hi2c));
+    BENCH_RUN("lcd_send_cmd", lcd_send_cmd(0x0C));
+    BENCH_RUN("lcd_send_data", lcd_send_data('A'));
+    BENCH_RUN("lcd_send_string_16", lcd_send_string("0123456789ABCDEF"));
+    BENCH_RUN("lcd_put_cur", lcd_put_cur(1, 4));
+    BENCH_RUN("lcd_clear", lcd_clear());
+    BENCH_RUN("lcd_backlight_off", lcd_backlight_off());
+    BENCH_RUN("lcd_backlight_on", lcd_backlight_on());
+
+    return BENCH_End();
+}
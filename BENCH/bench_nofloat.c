@@ -0,0 +1,60 @@
+/**
+ * @file bench_nofloat.c
+ * @brief DHT22, HC-SR04 and DS_RTC built with HAL_LIB_NO_FLOAT=1: integer readings only.
+ *
+ * The drivers of this build are compiled without floating-point registers when
+ * the compiler allows it, so any float left in them is a build error. Compare
+ * the rows with bench_dht22 / bench_hc_sr04 / bench_ds_rtc (float builds).
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "DHT22.h"
+#include "HC_SR04.h"
+#include "DS_RTC.h"
+
+#if !DHT22_NO_FLOAT || !HCSR04_NO_FLOAT || !DS_RTC_NO_FLOAT
+#error "bench_nofloat needs HAL_LIB_NO_FLOAT=1"
+#endif
+
+static HCSR04_t sonar;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim == sonar.htim) HCSR04_TIM_IC_CaptureCallback(&sonar);
+}
+
+int main(int argc, char **argv) {
+    TIM_HandleTypeDef htim = { .Instance = TIM3, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 } };
+    SIM_DHT22 dhtModel = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    SIM_HCSR04 echo = { .EchoUs = 58 * 100 };
+    HAL_SIM_I2CSlave chip;
+    DHT22_HandleTypedef dht;
+    DHT22_DataIntTypedef raw = {0};
+    DS_RTC_HandleTypeDef rtc;
+    int16_t quarters = 0;
+    int32_t mm = 0;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    SIM_DHT22_Attach(&dhtModel, GPIOA, GPIO_PIN_1);
+    SIM_HCSR04_Attach(&echo, GPIOA, GPIO_PIN_8, &htim, TIM_CHANNEL_1);
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    HAL_I2C_Init(&hi2c);
+
+    dht = DHT22_Init(GPIOA, GPIO_PIN_1, NULL);
+    BENCH_RUN("DHT22_ReadInt", DHT22_ReadInt(&dht, &raw));
+    BENCH_CHECK(raw.Temperature == 251 && raw.Humidity == 652);
+
+    HCSR04_Init(&sonar, &htim, TIM_CHANNEL_1, GPIOA, GPIO_PIN_8);
+    HCSR04_Trigger(&sonar);
+    HAL_SIM_AdvanceUs(30000);
+    BENCH_RUN("HCSR04_ReadDistanceMm", mm = HCSR04_ReadDistanceMm(&sonar));
+    BENCH_CHECK(mm == 1000);
+
+    DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS3231);
+    BENCH_RUN("DS_RTC_GetTemperatureQ", DS_RTC_GetTemperatureQ(&rtc, &quarters));
+    BENCH_CHECK(quarters == 101);
+
+    return BENCH_End();
+}
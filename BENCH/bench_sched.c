@@ -0,0 +1,254 @@
+/**
+ * @file bench_sched.c
+ * @brief Button, DHT22 and HC-SR04 update loops: spinning main loop vs the scheduler.
+ *
+ * The same 4 s workload (a double click, a normal click, DHT22 every 2 s, HC-SR04
+ * ranging every 60 ms) runs three times: polled from a busy main loop, from the
+ * scheduler sleeping with __WFI on SysTick, and from the tickless scheduler.
+ * The sleep time, wake-ups and task statistics are printed after the table; the
+ * program fails when an event is lost or the scheduler misses its targets.
+ * A last run has the button alone, edge driven: between two presses the button task
+ * waits for the SCHED_Notify of its EXTI line (BUTTON_FOREVER) and must not run.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "SCHED.h"
+#include "BUTTON.h"
+#include "DHT22.h"
+#include "HC_SR04.h"
+
+#define RUN_MS 4000
+
+static TIM_HandleTypeDef sonarTim = { .Instance = TIM3, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+static TIM_HandleTypeDef wakeTim = { .Instance = TIM4, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+static HCSR04_t sonar;
+static DHT22_HandleTypedef dht;
+static SCHED_Task buttonTask, dhtTask, sonarTask;
+
+// What the application saw during one run
+typedef struct {
+    const char *Name;
+    uint32_t Doubles;
+    uint32_t Normals;
+    uint32_t DhtReads;
+    uint32_t SonarReads;
+    uint32_t ClickLatencyMs;    // release -> normal click event
+    Button_t *Btn;
+    HAL_SIM_Stats Sim;
+} Result;
+
+static Result *cur;
+static uint32_t releaseTick;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim == sonar.htim) HCSR04_TIM_IC_CaptureCallback(&sonar);
+}
+
+static void Handler(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    if (type == BUTTON_PressType_Double) cur->Doubles++;
+    if (type == BUTTON_PressType_Normal) {
+        cur->Normals++;
+        cur->ClickLatencyMs = HAL_GetTick() - releaseTick;
+    }
+}
+
+// ==== Application jobs, shared by the main loop and the tasks ====
+static void ReadDht(void) {
+    DHT22_DataTypedef data;
+    if (DHT22_Read(&dht, &data) == DHT22_OK) cur->DhtReads++;
+}
+
+static void Ranging(void) {
+    if (HCSR04_ReadDistance(&sonar) > 0) cur->SonarReads++;
+    HCSR04_Trigger(&sonar);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    BUTTON_EXTI_Callback(GPIO_Pin);
+    SCHED_Notify(&buttonTask);
+}
+
+static void ButtonTask(SCHED_Task *task) {
+    BUTTON_Update();
+    SCHED_Reschedule(task, BUTTON_NextUpdate());
+}
+
+static void DhtTask(SCHED_Task *task) {
+    (void)task;
+    ReadDht();
+}
+
+static void SonarTask(SCHED_Task *task) {
+    (void)task;
+    Ranging();
+}
+
+// ==== Workload ====
+static const HAL_SIM_PinStep clicks[] = {
+    { 500000000, 1 },                   // released
+    { 80000000, 0 }, { 100000000, 1 },  // double click
+    { 80000000, 0 },
+    { 1240000000, 1 },
+    { 400000000, 0 },                   // normal click, released at 2.4 s
+};
+
+static void Setup(Result *r, const char *name) {
+    *r = (Result){ .Name = name };
+    cur = r;
+
+    r->Btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Handler);
+    SetTime_Toggle_mode(r->Btn, 200, 300, 1000, 3000);
+    HAL_SIM_GPIO_PlayScript(GPIOA, GPIO_PIN_0, clicks, sizeof(clicks) / sizeof(clicks[0]), 1);
+    releaseTick = HAL_GetTick() + 2400;
+
+    dht = DHT22_Init(GPIOA, GPIO_PIN_1, NULL);
+    HCSR04_Init(&sonar, &sonarTim, TIM_CHANNEL_1, GPIOA, GPIO_PIN_8);
+}
+
+static void Finish(Result *r) {
+    HAL_SIM_GetStats(&r->Sim);
+    BUTTON_Deinit(r->Btn);
+}
+
+static void SuperLoop(void) {
+    uint32_t end = HAL_GetTick() + RUN_MS;
+    uint32_t lastRanging = HAL_GetTick() - HCSR04_CYCLE_MS;
+
+    while ((int32_t)(HAL_GetTick() - end) < 0) {
+        BUTTON_Update();
+        if (DHT22_NextReadIn(&dht) == 0) ReadDht();
+        if (HAL_GetTick() - lastRanging >= HCSR04_CYCLE_MS) {
+            lastRanging += HCSR04_CYCLE_MS;
+            Ranging();
+        }
+    }
+}
+
+static void Scheduled(void) {
+    uint32_t end = HAL_GetTick() + RUN_MS;
+
+    SCHED_After(&buttonTask, "button", ButtonTask, NULL, 0);
+    SCHED_Every(&dhtTask, "dht22", DhtTask, NULL, DHT22_MIN_INTERVAL_MS);
+    SCHED_Every(&sonarTask, "hc_sr04", SonarTask, NULL, HCSR04_CYCLE_MS);
+    while ((int32_t)(HAL_GetTick() - end) < 0) {
+        SCHED_Step();
+    }
+}
+
+// Button alone, on EXTI: no timed run while it is idle
+static void EdgeOnly(void) {
+    uint32_t end = HAL_GetTick() + RUN_MS;
+
+    GPIO_InitTypeDef it = { .Pin = GPIO_PIN_0, .Mode = GPIO_MODE_IT_RISING_FALLING, .Pull = GPIO_PULLUP };
+    HAL_GPIO_Init(GPIOA, &it);
+    BUTTON_EnableIrq(cur->Btn);
+    SCHED_After(&buttonTask, "button", ButtonTask, NULL, 0);
+    while ((int32_t)(HAL_GetTick() - end) < 0) {
+        SCHED_Step();
+    }
+}
+
+static void PrintTask(const SCHED_Task *t) {
+    const SCHED_TaskStats *s = &t->Stats;
+    printf("  %-8s runs %5lu  run_us max %5lu avg %5lu  late_ms max %2lu  overruns %lu\n",
+           t->Name, (unsigned long)s->Runs, (unsigned long)s->RunTimeMaxUs,
+           (unsigned long)(s->Runs ? s->RunTimeSumUs / s->Runs : 0),
+           (unsigned long)s->LatenessMaxMs, (unsigned long)s->Overruns);
+}
+
+static void Report(const Result *r, uint8_t scheduled) {
+    uint64_t sleepPct10 = r->Sim.Cycles ? r->Sim.SleepCycles * 1000U / r->Sim.Cycles : 0;
+    printf("%-15s sleep %3llu.%llu %%  wakeups %5lu  clicks %lu/%lu  dht %lu  ranging %lu  click latency %lu ms\n",
+           r->Name, (unsigned long long)(sleepPct10 / 10), (unsigned long long)(sleepPct10 % 10),
+           (unsigned long)r->Sim.Wakeups, (unsigned long)r->Doubles, (unsigned long)r->Normals,
+           (unsigned long)r->DhtReads, (unsigned long)r->SonarReads, (unsigned long)r->ClickLatencyMs);
+    if (scheduled) {
+        PrintTask(&buttonTask);
+        PrintTask(&dhtTask);
+        PrintTask(&sonarTask);
+    }
+}
+
+// Same events seen whatever runs the loop
+static void CheckEvents(const Result *r) {
+    BENCH_CHECK(r->Doubles == 1 && r->Normals == 1);
+    BENCH_CHECK(r->DhtReads == 2);
+    BENCH_CHECK(r->SonarReads >= RUN_MS / HCSR04_CYCLE_MS - 1);
+    BENCH_CHECK(r->ClickLatencyMs <= 200 + BUTTON_POLL_MS + 1);
+}
+
+int main(int argc, char **argv) {
+    SIM_DHT22 dhtModel = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    SIM_HCSR04 echo = { .EchoUs = 58 * 100 };
+    Result loop, wfi, tickless;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    SIM_DHT22_Attach(&dhtModel, GPIOA, GPIO_PIN_1);
+    SIM_HCSR04_Attach(&echo, GPIOA, GPIO_PIN_8, &sonarTim, TIM_CHANNEL_1);
+
+    // ==== Scheduler calls ====
+    SCHED_Init();
+    BENCH_RUN("SCHED_Every", SCHED_Every(&sonarTask, "hc_sr04", SonarTask, NULL, HCSR04_CYCLE_MS));
+    BENCH_RUN("SCHED_After", SCHED_After(&dhtTask, "dht22", DhtTask, NULL, 1000));
+    BENCH_RUN("SCHED_Reschedule", SCHED_Reschedule(&dhtTask, 500));
+    BENCH_RUN("SCHED_Notify", SCHED_Notify(&dhtTask));
+    BENCH_RUN("SCHED_Cancel", SCHED_Cancel(&dhtTask));
+    BENCH_RUN("SCHED_Cancel_2", SCHED_Cancel(&sonarTask));
+    BENCH_RUN("SCHED_RunPending_nothing_due", SCHED_RunPending());
+    BENCH_CHECK(SCHED_InitTickless(&wakeTim, 72000000U) == HAL_ERROR);     // timer clock, no prescaler
+    BENCH_CHECK(SCHED_InitTickless(&wakeTim, SCHED_TICKLESS_MAX_HZ) == HAL_OK);
+    BENCH_RUN("SCHED_InitTickless", SCHED_InitTickless(&wakeTim, 1000000U));
+
+    // ==== Same workload, three ways ====
+    Setup(&loop, "superloop");
+    BENCH_RUN("superloop_4s", SuperLoop());
+    Finish(&loop);
+
+    SCHED_Init();
+    Setup(&wfi, "sched_wfi");
+    BENCH_RUN("sched_wfi_4s", Scheduled());
+    Finish(&wfi);
+    Report(&loop, 0);
+    Report(&wfi, 1);
+
+    SCHED_Init();
+    SCHED_InitTickless(&wakeTim, 1000000U);
+    Setup(&tickless, "sched_tickless");
+    BENCH_RUN("sched_tickless_4s", Scheduled());
+    Finish(&tickless);
+    Report(&tickless, 1);
+
+    CheckEvents(&loop);
+    CheckEvents(&wfi);
+    CheckEvents(&tickless);
+
+    // Busy loop never sleeps; the scheduler sleeps almost all the time and the
+    // tickless one without waking up every millisecond
+    BENCH_CHECK(loop.Sim.Wakeups == 0);
+    BENCH_CHECK(wfi.Sim.SleepCycles * 100U > wfi.Sim.Cycles * 95U);
+    BENCH_CHECK(tickless.Sim.SleepCycles * 100U > tickless.Sim.Cycles * 95U);
+    BENCH_CHECK(tickless.Sim.Wakeups * 4U < wfi.Sim.Wakeups);
+    uint32_t simMs = (uint32_t)(HAL_SIM_Now() / (SystemCoreClock / 1000U));
+    uint32_t tick = HAL_GetTick();
+    BENCH_CHECK(tick <= simMs && simMs - tick <= 2U);    // uwTick corrected after each tickless sleep
+    BENCH_CHECK(buttonTask.Stats.LatenessMaxMs <= 10 && sonarTask.Stats.Overruns == 0);
+
+    // Edge driven only: the button task runs on edges and debounce / click deadlines,
+    // never back to back, and the core sleeps through the idle seconds
+    Result edge;
+    SCHED_Init();
+    SCHED_InitTickless(&wakeTim, 1000000U);
+    Setup(&edge, "sched_edge");
+    BENCH_RUN("sched_edge_4s", EdgeOnly());
+    Finish(&edge);
+    Report(&edge, 0);
+    PrintTask(&buttonTask);
+    BENCH_CHECK(edge.Doubles == 1 && edge.Normals == 1 && edge.ClickLatencyMs <= 200 + 1);
+    BENCH_CHECK(buttonTask.Stats.Runs < 100 && buttonTask.Active && buttonTask.Waiting);
+    BENCH_CHECK(edge.Sim.SleepCycles * 100U > edge.Sim.Cycles * 99U);
+
+    return BENCH_End();
+}
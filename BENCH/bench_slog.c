@@ -0,0 +1,283 @@
+/**
+ * @file bench_slog.c
+ * @brief Sample log: sprintf text + blocking UART against SLOG binary blocks + DMA.
+ *
+ * time_ns is the time the caller is blocked. The text rows are the usual
+ * "date time,channel,values" CSV line sent with HAL_UART_Transmit at 115200 baud.
+ *
+ * A 60 s workload (HC-SR04 every 60 ms, DHT22 every 2 s, RTC temperature every
+ * 10 s) is then logged both ways; the program prints bytes per sample, blocked
+ * main-loop time and host encode time of each, and fails if SLOG does not save
+ * at least 5x on each. It ends with the real drivers on the simulated sensors.
+ *
+ *   --dump <file>   write the SLOG stream to a file (input of slog_decode)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "SLOG.h"
+#include "DHT22.h"
+#include "HC_SR04.h"
+#include "DS_RTC.h"
+
+#define WORKLOAD_MS     60000U
+#define ENCODE_BATCH    40U     // records per host timing batch (fit in one block)
+#define ENCODE_BATCHES  50U
+
+static HCSR04_t sonar;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim == sonar.htim) HCSR04_TIM_IC_CaptureCallback(&sonar);
+}
+
+// ==== Reference: the text line an application would print ====
+
+static const DS_RTC_Time textBase = { .seconds = 56, .minutes = 34, .hours = 12, .day = 14, .month = 5, .year = 2025 };
+
+static int TextFormat(char *line, uint8_t channel, const int32_t *v) {
+    uint32_t ms = HAL_GetTick();
+    uint32_t sec = textBase.seconds + textBase.minutes * 60U + textBase.hours * 3600U + ms / 1000U;
+    int n = sprintf(line, "%04u-%02u-%02u %02lu:%02lu:%02lu.%03lu,", textBase.year, textBase.month, textBase.day,
+                    (unsigned long)(sec / 3600U % 24U), (unsigned long)(sec / 60U % 60U),
+                    (unsigned long)(sec % 60U), (unsigned long)(ms % 1000U));
+    switch (channel) {
+        case SLOG_CH_DHT22:    n += sprintf(line + n, "dht22,%.1f,%.1f\r\n", v[0] / 10.0f, v[1] / 10.0f); break;
+        case SLOG_CH_HCSR04:   n += sprintf(line + n, "hc_sr04,%ld\r\n", (long)v[0]); break;
+        default:               n += sprintf(line + n, "rtc_temp,%.2f\r\n", v[0] / 4.0f); break;
+    }
+    return n;
+}
+
+static void TextLog(UART_HandleTypeDef *huart, uint8_t channel, const int32_t *v) {
+    char line[80];
+    int n = TextFormat(line, channel, v);
+    HAL_UART_Transmit(huart, (uint8_t *)line, (uint16_t)n, 100);
+}
+
+// ==== Workload: the same samples for both formats ====
+
+typedef void (*LogFn)(void *ctx, uint8_t channel, const int32_t *v, uint8_t count);
+
+typedef struct {
+    uint32_t Samples;
+    uint64_t BlockedCycles;
+} Workload;
+
+static void RunWorkload(Workload *w, LogFn fn, void *ctx) {
+    int32_t mm = 1000, t = 251, h = 652, q = 101;
+    *w = (Workload){0};
+
+    for (uint32_t ms = 0; ms < WORKLOAD_MS; ms++) {
+        uint64_t start = HAL_SIM_Now();
+        if (ms % HCSR04_CYCLE_MS == 0) {
+            mm += (int32_t)((ms / HCSR04_CYCLE_MS * 7U) % 9U) - 4;     // target moving a little
+            fn(ctx, SLOG_CH_HCSR04, &mm, 1);
+            w->Samples++;
+        }
+        if (ms % DHT22_MIN_INTERVAL_MS == 0) {
+            t += (int32_t)((ms / 2000U) % 3U) - 1;
+            h -= (int32_t)((ms / 2000U) % 2U);
+            int32_t v[2] = { t, h };
+            fn(ctx, SLOG_CH_DHT22, v, 2);
+            w->Samples++;
+        }
+        if (ms % 10000U == 0) {
+            fn(ctx, SLOG_CH_RTC_TEMP, &q, 1);
+            w->Samples++;
+        }
+        w->BlockedCycles += HAL_SIM_Now() - start;
+        HAL_SIM_AdvanceUs(1000);
+    }
+}
+
+// Bytes that went out on the UARTs (the capture buffer may be smaller)
+static uint32_t UartBytes(void) {
+    HAL_SIM_Stats stats;
+    HAL_SIM_GetStats(&stats);
+    return stats.UartBytes;
+}
+
+static void TextFn(void *ctx, uint8_t channel, const int32_t *v, uint8_t count) {
+    (void)count;
+    TextLog((UART_HandleTypeDef *)ctx, channel, v);
+}
+
+static void SlogFn(void *ctx, uint8_t channel, const int32_t *v, uint8_t count) {
+    BENCH_CHECK(SLOG_Add((SLOG_HandleTypeDef *)ctx, channel, v, count) == HAL_OK);
+}
+
+static void Drain(SLOG_HandleTypeDef *log) {
+    SLOG_Flush(log);
+    while (!SLOG_IsIdle(log)) HAL_SIM_AdvanceUs(100);
+}
+
+// Host time of the encoding alone: sprintf into RAM against SLOG_Add into its block
+static uint64_t EncodeNs(SLOG_HandleTypeDef *log, int text) {
+    char line[80];
+    uint64_t total = 0;
+    int32_t v[2] = { 251, 652 };
+
+    for (uint32_t b = 0; b < ENCODE_BATCHES; b++) {
+        uint64_t start = BENCH_HostNs();
+        for (uint32_t i = 0; i < ENCODE_BATCH; i++) {
+            v[0] += (int32_t)(i & 3U) - 1;
+            if (text) TextFormat(line, SLOG_CH_DHT22, v);
+            else SLOG_Add(log, SLOG_CH_DHT22, v, 2);
+        }
+        total += BENCH_HostNs() - start;
+        if (!text) Drain(log);
+    }
+    return total;
+}
+
+static void WriteFile(const char *path, const uint8_t *data, uint32_t len) {
+    FILE *f = fopen(path, "wb");
+    BENCH_CHECK(f != NULL);
+    if (f) {
+        fwrite(data, 1, len, f);
+        fclose(f);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *dumpPath = NULL;
+    DMA_HandleTypeDef dmaTx = {0};
+    UART_HandleTypeDef huart = { .Instance = USART1, .Init = { .BaudRate = 115200 }, .hdmatx = &dmaTx };
+    SLOG_HandleTypeDef slog;
+    int32_t dht[2] = { 251, 652 }, mm = 1000;
+    Workload text, bin;
+    const uint8_t *data;
+    uint32_t len;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--dump")) dumpPath = argv[i + 1];
+    }
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+    HAL_UART_Init(&huart);
+
+    // ==== One sample each way ====
+    BENCH_RUN("text_dht22", TextLog(&huart, SLOG_CH_DHT22, dht));
+    BENCH_RUN("text_hcsr04", TextLog(&huart, SLOG_CH_HCSR04, &mm));
+    HAL_SIM_UART_Data(USART1, &len);
+    uint32_t textFirst = len;
+
+    BENCH_RUN("SLOG_Init", SLOG_Init(&slog, &huart));
+    BENCH_RUN("SLOG_Add_dht22_first", SLOG_Add(&slog, SLOG_CH_DHT22, dht, 2));
+    HAL_SIM_AdvanceUs(2000);
+    dht[0] += 1;
+    BENCH_RUN("SLOG_Add_dht22_delta", SLOG_Add(&slog, SLOG_CH_DHT22, dht, 2));
+    BENCH_RUN("SLOG_Add_hcsr04", SLOG_Add(&slog, SLOG_CH_HCSR04, &mm, 1));
+    BENCH_RUN("SLOG_Flush", SLOG_Flush(&slog));
+    BENCH_CHECK(slog.Sending != 0 && slog.Blocks == 1 && slog.Len == 0);
+    // header + 6 (absolute) + 4 (delta) + 4 (absolute) + CRC
+    BENCH_CHECK(slog.Bytes == SLOG_BLOCK_HEADER + 14U + SLOG_BLOCK_CRC);
+    Drain(&slog);
+
+    // ==== Both buffers taken: records dropped, never a wait ====
+    for (uint32_t i = 0; i < 200 && slog.Dropped == 0; i++) SLOG_Add(&slog, SLOG_CH_HCSR04, &mm, 1);
+    BENCH_RUN("SLOG_Add_buffers_full", BENCH_CHECK(SLOG_Add(&slog, SLOG_CH_HCSR04, &mm, 1) == HAL_BUSY));
+    BENCH_CHECK(slog.Dropped == 2 && slog.Sending != 0 && slog.Queued != 0);
+    Drain(&slog);
+    BENCH_CHECK(SLOG_Add(&slog, SLOG_CH_HCSR04, &mm, 1) == HAL_OK);
+    Drain(&slog);
+    HAL_SIM_UART_Data(USART1, &len);
+    BENCH_CHECK(len == textFirst + slog.Bytes);
+
+    // ==== 60 s workload, text then SLOG ====
+    HAL_SIM_ResetStats();
+    RunWorkload(&text, TextFn, &huart);
+    uint32_t textBytes = UartBytes();
+
+    HAL_SIM_UART_Clear(USART1);
+    HAL_SIM_ResetStats();
+    SLOG_Init(&slog, &huart);
+    RunWorkload(&bin, SlogFn, &slog);
+    Drain(&slog);
+    HAL_SIM_UART_Data(USART1, &len);
+    uint32_t binBytes = len;
+    BENCH_CHECK(binBytes == UartBytes());
+    BENCH_CHECK(bin.Samples == text.Samples && slog.Records == bin.Samples && slog.Dropped == 0);
+    BENCH_CHECK(binBytes == slog.Bytes);
+
+    uint64_t textNs = HAL_SIM_CyclesToNs(text.BlockedCycles);
+    uint64_t binNs = HAL_SIM_CyclesToNs(bin.BlockedCycles);
+    printf("\nworkload: %lu samples in %lu s\n", (unsigned long)text.Samples, (unsigned long)(WORKLOAD_MS / 1000U));
+    printf("  text: %6lu bytes (%5.2f / sample), main loop blocked %8.2f ms\n", (unsigned long)textBytes,
+           (double)textBytes / text.Samples, textNs / 1e6);
+    printf("  slog: %6lu bytes (%5.2f / sample), main loop blocked %8.2f ms, %lu blocks\n", (unsigned long)binBytes,
+           (double)binBytes / bin.Samples, binNs / 1e6, (unsigned long)slog.Blocks);
+    BENCH_CHECK(binBytes * 5U <= textBytes);
+    BENCH_CHECK(binNs * 5U <= textNs);
+
+    // Encoding cost on this PC (not simulated): best of three runs each way
+    SLOG_HandleTypeDef encodeLog;
+    uint64_t textEnc = UINT64_MAX, binEnc = UINT64_MAX;
+    SLOG_Init(&encodeLog, &huart);
+    for (int run = 0; run < 3; run++) {
+        uint64_t t = EncodeNs(&encodeLog, 1), b = EncodeNs(&encodeLog, 0);
+        if (t < textEnc) textEnc = t;
+        if (b < binEnc) binEnc = b;
+    }
+    printf("  host encode per sample: text %.1f ns, slog %.1f ns (%.1fx)\n",
+           (double)textEnc / (ENCODE_BATCH * ENCODE_BATCHES), (double)binEnc / (ENCODE_BATCH * ENCODE_BATCHES),
+           (double)textEnc / (binEnc ? binEnc : 1));
+    BENCH_CHECK(binEnc * 5U <= textEnc);
+    SLOG_Init(&slog, &huart);           // the callback goes to the main log again
+
+    // ==== Real drivers on the simulated sensors, RTC time ====
+    TIM_HandleTypeDef htim = { .Instance = TIM3, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 } };
+    SIM_DHT22 dhtModel = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    SIM_HCSR04 echo = { .EchoUs = 58 * 100 };
+    HAL_SIM_I2CSlave chip;
+    DHT22_HandleTypedef dhtDev;
+    DHT22_DataIntTypedef reading;
+    DS_RTC_HandleTypeDef rtc;
+    DS_RTC_Time now;
+    int16_t quarters;
+
+    SIM_DHT22_Attach(&dhtModel, GPIOA, GPIO_PIN_1);
+    SIM_HCSR04_Attach(&echo, GPIOA, GPIO_PIN_8, &htim, TIM_CHANNEL_1);
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    HAL_I2C_Init(&hi2c);
+    DS_RTC_Init(&rtc, &hi2c, DS_RTC_DS3231);
+    dhtDev = DHT22_Init(GPIOA, GPIO_PIN_1, NULL);
+    HCSR04_Init(&sonar, &htim, TIM_CHANNEL_1, GPIOA, GPIO_PIN_8);
+
+    BENCH_CHECK(DS_RTC_ReadTime(&rtc, &now) == HAL_OK);
+    BENCH_CHECK(DS_RTC_ToSeconds(&now) == 800541296U);      // 2025-05-14 12:34:56
+    HAL_SIM_UART_Clear(USART1);
+    BENCH_RUN("SLOG_SetClock", SLOG_SetClock(&slog, DS_RTC_ToSeconds(&now)));
+
+    HCSR04_Trigger(&sonar);
+    // 6 s of 60 ms cycles: DHT22 every 34 cycles (2.04 s), RTC temperature every 17
+    for (uint32_t cycle = 0; cycle < 100; cycle++) {
+        int32_t v[2];
+        if (cycle % 34U == 0 && DHT22_ReadInt(&dhtDev, &reading) == DHT22_OK) {
+            v[0] = reading.Temperature;
+            v[1] = reading.Humidity;
+            SLOG_Add(&slog, SLOG_CH_DHT22, v, 2);
+        }
+        if (cycle % 17U == 0 && DS_RTC_GetTemperatureQ(&rtc, &quarters) == HAL_OK) {
+            v[0] = quarters;
+            SLOG_Add(&slog, SLOG_CH_RTC_TEMP, v, 1);
+        }
+        HAL_SIM_AdvanceUs(30000);
+        v[0] = HCSR04_ReadDistanceMm(&sonar);
+        if (v[0] >= 0) SLOG_Add(&slog, SLOG_CH_HCSR04, v, 1);
+        HCSR04_Trigger(&sonar);
+        HAL_SIM_AdvanceUs(HCSR04_CYCLE_MS * 1000U - 30000U);
+    }
+    Drain(&slog);
+    data = HAL_SIM_UART_Data(USART1, &len);
+    BENCH_CHECK(slog.Dropped == 0 && len == slog.Bytes);
+    BENCH_CHECK(slog.Records == 3U + 6U + 100U);
+    BENCH_CHECK(len > SLOG_BLOCK_HEADER && data[0] == SLOG_SYNC0 && data[1] == SLOG_SYNC1);
+    printf("  drivers: %lu records in %lu bytes\n", (unsigned long)slog.Records, (unsigned long)len);
+
+    if (dumpPath) WriteFile(dumpPath, data, len);
+
+    return BENCH_End();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file bench_timing.c
+ * @brief Delay accuracy of the TIMING service on the DWT and on the timer fallback.
+ *
+ * time_ns of each delay is the real blocking time: it must never be below the
+ * requested value, and the baseline catches any growth of the overshoot.
+ */
+
+#include <stdio.h>
+#include "BENCH.h"
+#include "TIMING.h"
+
+// Run one delay, check it is not shorter than asked
+static void RunDelay(const char *name, void (*fn)(uint32_t), uint32_t arg, uint32_t minNs) {
+    uint64_t start = HAL_SIM_Now();
+    BENCH_RUN(name, fn(arg));
+    uint64_t ns = HAL_SIM_CyclesToNs(HAL_SIM_Now() - start);
+    if (ns < minNs) printf("%s: %llu ns < %lu ns\n", name, (unsigned long long)ns, (unsigned long)minNs);
+    BENCH_CHECK(ns >= minNs);
+}
+
+static void DeadlineWaitUs(uint32_t us) {
+    TIMING_Deadline d;
+    TIMING_DeadlineUs(&d, us);
+    TIMING_DeadlineWait(&d);
+}
+
+int main(int argc, char **argv) {
+    TIM_HandleTypeDef htim = { .Instance = TIM2, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+    uint32_t t0;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    // ==== DWT cycle counter ====
+    BENCH_RUN("TIMING_Init", TIMING_Init());
+    BENCH_RUN("TIMING_Now", t0 = TIMING_Now());
+    BENCH_RUN("TIMING_Elapsed", TIMING_Elapsed(t0));
+    RunDelay("TIMING_DelayNs_450", TIMING_DelayNs, 450, 450);
+    RunDelay("TIMING_DelayNs_1400", TIMING_DelayNs, 1400, 1400);
+    RunDelay("TIMING_DelayUs_1", TIMING_DelayUs, 1, 1000);
+    RunDelay("TIMING_DelayUs_40", TIMING_DelayUs, 40, 40000);
+    RunDelay("TIMING_DelayUs_1000", TIMING_DelayUs, 1000, 1000000);
+    RunDelay("TIMING_DeadlineWait_100us", DeadlineWaitUs, 100, 100000);
+
+    // ==== Timer fallback (1 MHz) ====
+    BENCH_RUN("TIMING_InitTim", TIMING_InitTim(&htim, 1000000U));
+    RunDelay("TIMING_Tim_DelayUs_40", TIMING_DelayUs, 40, 40000);
+    RunDelay("TIMING_Tim_DelayUs_1000", TIMING_DelayUs, 1000, 1000000);
+    RunDelay("TIMING_Tim_DelayUs_70000", TIMING_DelayUs, 70000, 70000000);   // counter wraps
+
+    // ==== No cycle counter, no timer: HAL tick ====
+    HAL_SIM_DWT_SetPresent(0);
+    BENCH_RUN("TIMING_Init_no_dwt", TIMING_Init());
+    RunDelay("TIMING_Tick_DelayUs_40", TIMING_DelayUs, 40, 40000);
+
+    return BENCH_End();
+}
@@ -0,0 +1,23 @@
+/**
+ * @file bench_tm1637.c
+ * @brief Per-API cost of the TM1637 driver.
+ */
+
+#include "BENCH.h"
+#include "TM1637.h"
+
+int main(int argc, char **argv) {
+    TM1637_Handle tm;
+
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    BENCH_RUN("TM1637_Init", TM1637_Init(&tm, GPIOB, GPIO_PIN_6, GPIOB, GPIO_PIN_7));
+    BENCH_RUN("TM1637_SetBrightness", TM1637_SetBrightness(&tm, 7));
+    BENCH_RUN("TM1637_DisplayDecimal", TM1637_DisplayDecimal(&tm, 1234));
+    BENCH_RUN("TM1637_DisplayDecimal_negative", TM1637_DisplayDecimal(&tm, -42));
+    BENCH_RUN("TM1637_DisplayDigit", TM1637_DisplayDigit(&tm, 8, 2));
+    BENCH_RUN("TM1637_Point", TM1637_Point(&tm, true));
+    BENCH_RUN("TM1637_Clear", TM1637_Clear(&tm));
+
+    return BENCH_End();
+}
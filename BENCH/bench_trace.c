@@ -0,0 +1,197 @@
+/**
+ * @file bench_trace.c
+ * @brief Cost of the trace buffer, and the BUTTON / DHT22 / HC-SR04 / I2C_BUS drivers built with tracing.
+ *
+ * The driver rows are the same calls as in bench_button / bench_dht22: compare
+ * with those baselines for the overhead of the instrumentation. The program then
+ * runs a short scenario (a click, a DHT22 without sensor, HC-SR04 ranging, an RTC
+ * read through the bus), dumps the trace over SWO and checks the records.
+ *
+ *   --dump <file>   also write the dump to a file (input of trace_decode)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "BENCH.h"
+#include "SIM_DEVICES.h"
+#include "TRACE.h"
+#include "BUTTON.h"
+#include "DHT22.h"
+#include "HC_SR04.h"
+#include "I2C_BUS.h"
+
+static TIM_HandleTypeDef sonarTim = { .Instance = TIM3, .Init = { .Prescaler = 71, .Period = 0xFFFF } };
+static HCSR04_t sonar;
+static uint32_t isrRecords;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim == sonar.htim) HCSR04_TIM_IC_CaptureCallback(&sonar);
+}
+
+static void Handler(Button_t *btn, ButtonPressType_t type) {
+    (void)btn;
+    (void)type;
+}
+
+// Simulated ISR recording into the same ring as the main loop
+static void IsrRecord(void *ctx) {
+    (void)ctx;
+    TRACE_EVENT(TRACE_ID_USER + 1, isrRecords++);
+    if (isrRecords < 50) HAL_SIM_Schedule(HAL_SIM_Now() + 5, IsrRecord, NULL);
+}
+
+static void FileWrite(void *ctx, const uint8_t *data, uint16_t len) {
+    fwrite(data, 1, len, (FILE *)ctx);
+}
+
+static uint32_t CountTag(const TRACE_Rec *rec, uint32_t n, uint16_t tag) {
+    uint32_t c = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (rec[i].Tag == tag) c++;
+    }
+    return c;
+}
+
+static const TRACE_Rec *FindTag(const TRACE_Rec *rec, uint32_t n, uint16_t tag) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (rec[i].Tag == tag) return &rec[i];
+    }
+    return NULL;
+}
+
+// Dump over SWO and return the records the debugger received
+static const TRACE_Rec *DumpSwo(TRACE_Header *hdr) {
+    uint32_t len;
+    HAL_SIM_SWO_Clear();
+    TRACE_Dump(TRACE_WriteSwo, NULL);
+    const uint8_t *data = HAL_SIM_SWO_Data(&len);
+    memcpy(hdr, data, sizeof(*hdr));
+    BENCH_CHECK(memcmp(hdr->Magic, TRACE_MAGIC, 4) == 0);
+    BENCH_CHECK(len == sizeof(*hdr) + hdr->Count * sizeof(TRACE_Rec));
+    return (const TRACE_Rec *)(data + sizeof(*hdr));
+}
+
+static uint8_t Ordered(const TRACE_Rec *rec, uint32_t n) {
+    for (uint32_t i = 1; i < n; i++) {
+        if ((int32_t)(rec[i].Cycles - rec[i - 1].Cycles) < 0) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    const char *dumpPath = NULL;
+    DMA_HandleTypeDef dmaTx = {0}, dmaRx = {0};
+    I2C_HandleTypeDef hi2c = { .Instance = I2C1, .Init = { .ClockSpeed = 100000 },
+                               .hdmatx = &dmaTx, .hdmarx = &dmaRx };
+    HAL_SIM_I2CSlave chip;
+    I2C_BUS_HandleTypeDef bus;
+    I2C_BUS_Transaction txn;
+    uint8_t regs[7];
+    SIM_DHT22 dhtModel = { .Temperature = 251, .Humidity = 652, .Present = 1 };
+    SIM_HCSR04 echo = { .EchoUs = 58 * 100 };
+    DHT22_HandleTypedef dht;
+    DHT22_DataTypedef data;
+    TRACE_Header hdr;
+    const TRACE_Rec *rec;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--dump")) dumpPath = argv[i + 1];
+    }
+    BENCH_Begin(argc, argv, BENCH_SUITE);
+
+    // ==== Trace calls ====
+    BENCH_RUN("TRACE_Init", TRACE_Init());
+    BENCH_RUN("TRACE_EVENT", TRACE_EVENT(TRACE_ID_USER, 1));
+    BENCH_RUN("TRACE_ENTER_EXIT", { TRACE_ENTER(TRACE_ID_USER, 0); TRACE_EXIT(TRACE_ID_USER, 0); });
+    TRACE_Stop();
+    BENCH_RUN("TRACE_EVENT_stopped", TRACE_EVENT(TRACE_ID_USER, 2));
+    TRACE_Start();
+
+    // ==== Traced drivers, same calls as bench_button / bench_dht22 ====
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_All, 1);
+    Button_t *btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Handler);
+    SetTime_Toggle_mode(btn, 200, 300, 1000, 3000);
+    Set_DebounceTime(btn, 20);
+    BENCH_RUN("BUTTON_Update_idle", BUTTON_Update());
+
+    SIM_DHT22_Attach(&dhtModel, GPIOA, GPIO_PIN_1);
+    dht = DHT22_Init(GPIOA, GPIO_PIN_1, NULL);
+    BENCH_RUN("DHT22_Read", DHT22_Read(&dht, &data));
+    BENCH_RUN("DHT22_Read_interval", DHT22_Read(&dht, &data));
+
+    // ==== Wrap: the ring keeps the newest records, oldest first ====
+    TRACE_Clear();
+    for (uint16_t i = 0; i < 1000; i++) TRACE_EVENT(TRACE_ID_USER, i);
+    rec = DumpSwo(&hdr);
+    BENCH_CHECK(hdr.Count == TRACE_BUF_SIZE && hdr.Lost == 1000 - TRACE_BUF_SIZE);
+    BENCH_CHECK(rec[0].Arg == 1000 - TRACE_BUF_SIZE && rec[hdr.Count - 1].Arg == 999);
+    BENCH_CHECK(Ordered(rec, hdr.Count));
+
+    // ==== Main loop and an ISR writing at the same time ====
+    TRACE_Clear();
+    isrRecords = 0;
+    HAL_SIM_Schedule(HAL_SIM_Now() + 5, IsrRecord, NULL);
+    for (uint16_t i = 0; i < 150; i++) TRACE_EVENT(TRACE_ID_USER, i);
+    HAL_SIM_Cancel(IsrRecord, NULL);
+    rec = DumpSwo(&hdr);
+    BENCH_CHECK(isrRecords == 50);
+    BENCH_CHECK(hdr.Count == 150 + isrRecords && hdr.Lost == 0);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_USER)) == 150);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_USER + 1)) == isrRecords);
+
+    // ==== Scenario: click, DHT22 gone, ranging, RTC read ====
+    SIM_HCSR04_Attach(&echo, GPIOA, GPIO_PIN_8, &sonarTim, TIM_CHANNEL_1);
+    HCSR04_Init(&sonar, &sonarTim, TIM_CHANNEL_1, GPIOA, GPIO_PIN_8);
+    SIM_DSRTC_Attach(&chip, &hi2c, SIM_DSRTC_DS3231);
+    HAL_I2C_Init(&hi2c);
+    I2C_BUS_Init(&bus, &hi2c, 8);
+    HAL_SIM_AdvanceUs(DHT22_MIN_INTERVAL_MS * 1000U);
+    dhtModel.Present = 0;
+    TRACE_Clear();
+
+    HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 0);
+    for (int ms = 0; ms < 600; ms += BUTTON_POLL_MS) {
+        if (ms == 100) HAL_SIM_GPIO_SetInput(GPIOA, GPIO_PIN_0, 1);
+        if (ms == 200) DHT22_Read(&dht, &data);
+        if (ms % HCSR04_CYCLE_MS == 0) { HCSR04_ReadDistance(&sonar); HCSR04_Trigger(&sonar); }
+        if (ms == 300) {
+            I2C_BUS_MemRead(&txn, 0x68 << 1, 0x00, regs, sizeof(regs), I2C_BUS_PRIO_NORMAL);
+            I2C_BUS_Transfer(&bus, &txn, 100);
+        }
+        BUTTON_Update();
+        HAL_SIM_AdvanceUs(BUTTON_POLL_MS * 1000U);
+    }
+
+    BENCH_RUN("TRACE_Count", TRACE_Count());
+    HAL_SIM_SWO_Clear();
+    BENCH_RUN("TRACE_Dump_swo", TRACE_Dump(TRACE_WriteSwo, NULL));
+    rec = DumpSwo(&hdr);
+    BENCH_CHECK(hdr.Lost == 0 && hdr.CoreClockHz == SystemCoreClock);
+    BENCH_CHECK(Ordered(rec, hdr.Count));
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_ENTER, TRACE_ID_BUTTON_UPDATE)) == 600 / BUTTON_POLL_MS);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EXIT, TRACE_ID_BUTTON_UPDATE)) == 600 / BUTTON_POLL_MS);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_BUTTON_PRESS)) == 1);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_BUTTON_STATE)) >= 3);
+    const TRACE_Rec *err = FindTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_DHT22_ERROR));
+    BENCH_CHECK(err && (err->Arg >> 8) == DHT22_ERROR_TIMEOUT);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_HCSR04_TRIGGER)) == 10);
+    BENCH_CHECK(CountTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_HCSR04_RISE)) == 10);
+    const TRACE_Rec *rise = FindTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_HCSR04_RISE));
+    const TRACE_Rec *fall = FindTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_HCSR04_FALL));
+    BENCH_CHECK(rise && fall && (uint16_t)(fall->Arg - rise->Arg) == echo.EchoUs);
+    const TRACE_Rec *start = FindTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_I2C_BUS_START));
+    const TRACE_Rec *done = FindTag(rec, hdr.Count, TRACE_TAG(TRACE_KIND_EVENT, TRACE_ID_I2C_BUS_DONE));
+    BENCH_CHECK(start && start->Arg == ((0xD0 << 8) | I2C_BUS_OP_MEM_READ));
+    BENCH_CHECK(done && done->Arg == (HAL_OK << 8));
+
+    if (dumpPath) {
+        FILE *f = fopen(dumpPath, "wb");
+        BENCH_CHECK(f != NULL);
+        if (f) {
+            TRACE_Dump(FileWrite, f);
+            fclose(f);
+        }
+    }
+
+    return BENCH_End();
+}
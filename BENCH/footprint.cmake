@@ -0,0 +1,61 @@
+# Flash / RAM of each build of a driver, from the size tool.
+#
+#   cmake -DSIZE_TOOL=<size> -DLIBS="runtime=<lib>;NAME=<lib>;..." -P footprint.cmake
+#
+# The first entry is the reference; the others are printed with their savings and
+# the script fails if one of them needs more flash or RAM than the reference.
+
+function(measure lib out_text out_ram)
+    execute_process(COMMAND ${SIZE_TOOL} -t ${lib} OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "${SIZE_TOOL} failed on ${lib}")
+    endif()
+    # Berkeley format, last line: text data bss dec hex (TOTALS)
+    string(REGEX MATCH "([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-f]+[ \t]+\\(TOTALS\\)" _ "${out}")
+    math(EXPR flash "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2}")
+    math(EXPR ram "${CMAKE_MATCH_2} + ${CMAKE_MATCH_3}")
+    set(${out_text} ${flash} PARENT_SCOPE)
+    set(${out_ram} ${ram} PARENT_SCOPE)
+endfunction()
+
+# Right-align 'value' in 'width' columns
+function(pad value width out)
+    string(LENGTH "${value}" len)
+    set(s "${value}")
+    while(len LESS width)
+        set(s " ${s}")
+        math(EXPR len "${len} + 1")
+    endwhile()
+    set(${out} "${s}" PARENT_SCOPE)
+endfunction()
+
+set(failed 0)
+set(first 1)
+message("build        flash     RAM   flash saved   RAM saved")
+foreach(entry ${LIBS})
+    string(REGEX MATCH "^([^=]+)=(.*)$" _ "${entry}")
+    set(name ${CMAKE_MATCH_1})
+    measure(${CMAKE_MATCH_2} flash ram)
+    if(first)
+        set(refFlash ${flash})
+        set(refRam ${ram})
+        set(first 0)
+    endif()
+    math(EXPR dFlash "${refFlash} - ${flash}")
+    math(EXPR dRam "${refRam} - ${ram}")
+    math(EXPR pFlash "${dFlash} * 100 / ${refFlash}")
+    string(SUBSTRING "${name}          " 0 10 col)
+    pad(${flash} 7 c1)
+    pad(${ram} 7 c2)
+    pad("${dFlash} (${pFlash}%)" 13 c3)
+    pad(${dRam} 11 c4)
+    message("${col} ${c1} ${c2} ${c3} ${c4}")
+    if(dFlash LESS 0 OR dRam LESS 0)
+        message("FAIL ${name} is bigger than the reference build")
+        set(failed 1)
+    endif()
+endforeach()
+
+if(failed)
+    message(FATAL_ERROR "footprint regression")
+endif()
@@ -0,0 +1,8 @@
+/**
+ * @file footprint_ds_rtc.c
+ * @brief One RTC handle, as an application would allocate it: its size shows up as bss.
+ */
+
+#include "DS_RTC.h"
+
+DS_RTC_HandleTypeDef footprintRtc;
@@ -7,9 +7,19 @@
  * 
  * Functions:
  * - BUTTON_Init: Initializes a button with GPIO, active state, mode, and handler.
- * - BUTTON_Deinit: Deinitializes a button.
+ * - BUTTON_InitConst: Initializes a button from a const configuration (flash).
+ * - BUTTON_Deinit: Deinitializes a button (O(1), its slot is reused by a later Init).
+ * - BUTTON_GetHandle, BUTTON_FromHandle: Generation-checked references to a button.
  * - BUTTON_Update: Updates button states and handles press actions.
+ * - BUTTON_NextUpdate: Time until BUTTON_Update has something to do (for a scheduler).
+ * - BUTTON_EnableIrq, BUTTON_EXTI_Callback: Edge-driven buttons, no polling.
+ * - BUTTON_EnableExternal, BUTTON_SetLevel: Buttons sampled by another driver (e.g. KEYPAD).
+ * - BUTTON_InitExternal: Button with no pin, level from BUTTON_SetLevel only (ADC ladder...).
+ * - BUTTON_EnableScan, BUTTON_ScanTick: Buttons sampled and debounced by a fixed-rate timer ISR.
+ * - BUTTON_SetAdaptive, BUTTON_GetAdaptive: Debounce window learned from the bounce of each switch.
  * - Set_DebounceTime, SetTime_Hold_mode, SetTime_Toggle_mode: Adjust button timing.
+ * - BUTTON_SetImmediate: Report hold thresholds and clicks without waiting (Toggle mode).
+ * - BUTTON_SetHandler: Change the handler of a button.
  * 
  * Usage:
  * - Call BUTTON_Update regularly to process button events.
@@ -19,217 +29,1230 @@
 
 
 
-#include "button.h"
+#include "BUTTON.h"
+#include "TRACE.h"
+#include "EVBUS.h"
+#include "GPIO_FAST.h"
+#include "TIMING.h"
 
-// Button pool array to store button states
+#if (BUTTON_EDGE_QUEUE & (BUTTON_EDGE_QUEUE - 1)) != 0
+#error "BUTTON_EDGE_QUEUE must be a power of two"
+#endif
+
+#if BUTTON_ADAPT_MAX > 255
+#error "BUTTON_ADAPT_MAX must be 255 at most"
+#endif
+
+#define EDGE_MASK (BUTTON_EDGE_QUEUE - 1U)
+#define MASK_WORDS ((BUTTON_MAX + 31) / 32)
+
+// Slab of button slots: a slot never moves, so a Button_t* stays valid until its Deinit
 static Button_t buttonPool[BUTTON_MAX];
-// Array of pointers to initialized buttons
-static Button_t* buttons[BUTTON_MAX];
+static uint16_t slotGen[BUTTON_MAX];    // bumped by each Deinit: older handles stop matching
+static uint16_t nextFree[BUTTON_MAX];   // free list link, index + 1
+static uint16_t freeHead;               // first free slot, index + 1
+static uint16_t deferHead;              // slots freed during BUTTON_Update, recycled after it
+static uint16_t highWater;              // slots above it were never used
+static uint8_t updating;                // BUTTON_Update / BUTTON_SetLevel calls running (nested)
 // Count of initialized buttons
-static uint8_t buttonCount = 0;
+static uint16_t buttonCount = 0;
+
+// Configurations of the buttons made by BUTTON_Init (writable by the Set* functions)
+#if BUTTON_RAM_CONFIGS > 0
+static ButtonConfig_t configPool[BUTTON_RAM_CONFIGS];
+static uint16_t configNext[BUTTON_RAM_CONFIGS];     // free list link, index + 1
+static uint16_t configFree;                         // first free configuration, index + 1
+static uint16_t configHigh;                         // configurations above it were never used
+#endif
+
+// One bit per button index
+static uint32_t liveMask[MASK_WORDS];           // slot holds an initialized button
+static uint32_t pollMask[MASK_WORDS];           // sampled one by one by BUTTON_Update
+static uint32_t irqMask[MASK_WORDS];            // edge driven
+static uint32_t batchMask[MASK_WORDS];          // port batched
+static uint32_t extMask[MASK_WORDS];            // level given by BUTTON_SetLevel
+static uint32_t scanMask[MASK_WORDS];           // sampled by BUTTON_ScanTick
+static uint32_t adaptMask[MASK_WORDS];          // debounce window learned (BUTTON_SetAdaptive)
+static uint32_t armedMask[MASK_WORDS];          // not polled, with a timer running
+static volatile uint32_t resyncMask[MASK_WORDS]; // edge driven that lost an edge
+
+// Edge-driven buttons: a slot is free for position p when Seq == p, holds edge p when Seq == p + 1
+typedef struct {
+    volatile uint32_t Seq;
+    uint32_t Tick;
+    uint32_t Us;            // timer-scanned buttons: scan time of the edge
+    uint16_t Index;
+    uint8_t Gen;            // low byte of the slot generation: edges of a freed button are ignored
+    uint8_t Level;
+} Edge;
+
+static Edge edges[BUTTON_EDGE_QUEUE];
+static volatile uint32_t edgeHead;  // next position to claim (EXTI ISRs)
+static uint32_t edgeTail;           // next position to replay (BUTTON_Update only)
+static uint8_t edgesReady;
+static uint16_t lineButton[16];     // EXTI line -> button index + 1, 0 = none
+static uint32_t edgesLost;
+
+// Port-batched buttons: the 16 pins of a port debounced at once, one bit per pin
+typedef struct {
+    GPIO_TypeDef* GPIOx;
+    uint16_t Pins;          // pins with a batched button
+    uint16_t ActiveHigh;    // pins pressed when high
+    uint16_t State;         // debounced, 1 = pressed
+    ButtonCounter_t Cnt;    // debounce of the batched pins
+    uint16_t First[16];     // first button of each pin, index + 1
+} BatchPort;
+
+static BatchPort batchPorts[BUTTON_BATCH_PORTS];
+static uint8_t batchPortCount;
+static uint16_t pinNext[BUTTON_MAX];    // next batched button on the same pin, index + 1
+static uint32_t nextScan;
+
+// Timer-scanned buttons: one button per pin, debounced by BUTTON_ScanTick in the timer ISR.
+// Pins / ActiveHigh / Button are written by the thread, State / Moving / Since* by the ISR
+typedef struct {
+    GPIO_TypeDef* GPIOx;
+    volatile uint16_t Pins;     // pins with a scanned button
+    volatile uint16_t ActiveHigh;
+    volatile uint16_t State;    // debounced, 1 = pressed
+    volatile uint16_t Moving;   // pins whose last samples disagree with State
+    uint32_t Since[16];         // scan time of the first sample that disagrees
+    uint32_t SinceTick[16];     // HAL tick read by that same scan
+    uint32_t EdgeUs[16];        // scan time of the last edge replayed (thread)
+    uint16_t Button[16];        // index + 1
+} ScanPort;
+
+static ScanPort scanPorts[BUTTON_SCAN_PORTS];
+static volatile uint8_t scanPortCount;
+static volatile uint32_t scanUs;    // time of the last BUTTON_ScanTick
+static uint32_t scanStamp;          // TIMING_Now of the last BUTTON_ScanTick
+static uint32_t scanRest;           // TIMING ticks not yet counted in scanUs
+static uint8_t scanClock;           // scanStamp valid
+
+// Adaptive debounce: the burst of level changes in progress, and the bounce learned from
+// the past ones. A burst is the changes less than a window apart from each other; a press
+// keeps its burst open until DebounceTime, whatever the gaps, and so does a press that
+// comes within DebounceTime of the last change (the bounce of a release or of a glitch)
+typedef struct {
+    uint32_t BurstStart;    // tick of the first change of the burst
+    uint32_t LastChange;    // tick of the last change seen
+    uint16_t Bounce;        // learned settle time, 1/16 ms
+    uint16_t LastBounce;    // ms, last burst measured
+    uint16_t Glitches;      // windows that ended released, alone in their burst
+    uint8_t Edges;          // changes in the burst
+    uint8_t Level : 1;      // last level seen
+    uint8_t Tail : 1;       // press within DebounceTime of the last change: full window
+    uint8_t Settling : 1;   // press accepted, DebounceTime not over yet
+} Adapt;
+
+// Adaptive state in its own small pool: a button that is not adaptive only costs its entry byte
+#if BUTTON_ADAPT_MAX > 0
+static Adapt adaptPool[BUTTON_ADAPT_MAX];
+static uint8_t adaptEntry[BUTTON_MAX];                      // pool entry of an adaptive button, index + 1
+static uint32_t adaptUsed[(BUTTON_ADAPT_MAX + 31) / 32];    // entries taken
+#endif
+
+static ScanPort* BUTTON_ScanPort(const Button_t* btn) {
+    for (uint8_t p = 0; p < scanPortCount; ++p) {
+        if (scanPorts[p].GPIOx == btn->Config->GPIOx) return &scanPorts[p];
+    }
+    return NULL;
+}
+
+static inline void MaskSet(uint32_t* m, uint16_t i)   { m[i >> 5] |= 1UL << (i & 31U); }
+static inline void MaskClear(uint32_t* m, uint16_t i) { m[i >> 5] &= ~(1UL << (i & 31U)); }
+static inline uint8_t MaskTest(const uint32_t* m, uint16_t i) { return (uint8_t)((m[i >> 5] >> (i & 31U)) & 1U); }
+
+static inline uint8_t MaskAny(const uint32_t* m) {
+    for (uint16_t w = 0; w < MASK_WORDS; ++w) {
+        if (m[w]) return 1;
+    }
+    return 0;
+}
+
+// Pool index of an initialized button, BUTTON_MAX when 'btn' is not one
+static inline uint16_t BUTTON_Index(const Button_t* btn) {
+    uintptr_t offset = (uintptr_t)btn - (uintptr_t)buttonPool;
+    if (btn == NULL || offset >= sizeof(buttonPool) || offset % sizeof(Button_t)) return BUTTON_MAX;
+    uint16_t i = (uint16_t)(offset / sizeof(Button_t));
+    return MaskTest(liveMask, i) ? i : BUTTON_MAX;
+}
+
+// Adaptive state of button 'i', which must be in adaptMask
+static inline Adapt* AdaptOf(uint16_t i) {
+#if BUTTON_ADAPT_MAX > 0
+    return &adaptPool[adaptEntry[i] - 1U];
+#else
+    (void)i;
+    return NULL;
+#endif
+}
+
+// Back to the fixed window, its pool entry freed
+static void BUTTON_AdaptRelease(uint16_t i) {
+    if (!MaskTest(adaptMask, i)) return;
+    MaskClear(adaptMask, i);
+#if BUTTON_ADAPT_MAX > 0
+    MaskClear(adaptUsed, (uint16_t)(adaptEntry[i] - 1U));
+    adaptEntry[i] = 0;
+#endif
+}
+
+// Adaptive window: the learned bounce and a margin, DebounceTime at most
+static inline uint32_t AdaptWindow(uint16_t i) {
+    uint32_t limit = buttonPool[i].Config->DebounceTime;
+    uint32_t window = (AdaptOf(i)->Bounce + 15U) / 16U + BUTTON_ADAPT_MARGIN;
+    return (window < limit) ? window : limit;
+}
+
+// Debounce of the state machine: none for a timer-scanned button, its ISR did it
+static inline uint32_t DebounceOf(const Button_t* btn) {
+    uint16_t i = (uint16_t)(btn - buttonPool);
+    if (MaskTest(scanMask, i)) return 0U;
+    return (MaskTest(adaptMask, i) && !AdaptOf(i)->Tail) ? AdaptWindow(i) : btn->Config->DebounceTime;
+}
+
+// Writable view of a configuration of the RAM pool, NULL for a const one
+static inline ButtonConfig_t* RamConfig(const ButtonConfig_t* cfg) {
+#if BUTTON_RAM_CONFIGS > 0
+    uintptr_t offset = (uintptr_t)cfg - (uintptr_t)configPool;
+    if (cfg != NULL && offset < sizeof(configPool)) return &configPool[offset / sizeof(ButtonConfig_t)];
+#endif
+    return NULL;
+}
 
-// Function to read the current state of the button
+// RAM configuration of a button made by BUTTON_Init, NULL for a const one
+static inline ButtonConfig_t* BUTTON_Config(const Button_t* btn) {
+    return btn ? RamConfig(btn->Config) : NULL;
+}
+
+static ButtonConfig_t* ConfigAlloc(void) {
+#if BUTTON_RAM_CONFIGS > 0
+    uint16_t c;
+    if (configFree) {
+        c = (uint16_t)(configFree - 1U);
+        configFree = configNext[c];
+    } else if (configHigh < BUTTON_RAM_CONFIGS) {
+        c = configHigh++;
+    } else {
+        return NULL;
+    }
+    return &configPool[c];
+#else
+    return NULL;
+#endif
+}
+
+// Back to the RAM pool (nothing for a const configuration)
+static void ConfigRelease(const ButtonConfig_t* config) {
+#if BUTTON_RAM_CONFIGS > 0
+    ButtonConfig_t* cfg = RamConfig(config);
+    if (cfg == NULL) return;
+    uint16_t c = (uint16_t)(cfg - configPool);
+    configNext[c] = configFree;
+    configFree = (uint16_t)(c + 1U);
+#else
+    (void)config;
+#endif
+}
+
+static inline uint8_t PinIndex(uint16_t GPIO_Pin) {
+    uint8_t pin = 0;
+    while (pin < 15 && !(GPIO_Pin & (1U << pin))) pin++;
+    return pin;
+}
+
+// Ports of the buttons, by slot: Button_t.Input names one with 3 bits
+#define INPUT_PORTS 8
+static GPIO_TypeDef* inputPorts[INPUT_PORTS];
+static uint8_t inputPortCount;
+
+// Input code of a configuration, 0xFF when all port slots are taken by other ports
+static uint8_t InputCode(const ButtonConfig_t* cfg) {
+    uint8_t p = 0;
+    while (p < inputPortCount && inputPorts[p] != cfg->GPIOx) p++;
+    if (p == inputPortCount) {
+        if (inputPortCount >= INPUT_PORTS) return 0xFFU;
+        inputPorts[inputPortCount++] = cfg->GPIOx;
+    }
+    return (uint8_t)((p << 5) | ((cfg->ActiveState ? 1U : 0U) << 4) | PinIndex(cfg->GPIO_Pin));
+}
+
+// Function to read the current state of the button (from its state only, not its configuration)
 static inline uint8_t BUTTON_Read(Button_t* btn) {
-    return ((btn->GPIOx->IDR & btn->GPIO_Pin) ? 1 : 0) == btn->ActiveState; 	
+    uint8_t in = btn->Input;
+    return ((inputPorts[in >> 5]->IDR >> (in & 15U)) & 1U) == ((in >> 4) & 1U);
 } // ActiveState = 0 is PULLUP -- 1  is PULLDOWN
 
+// Debounced press / release of any button (gesture recognizer)
+static void (*edgeHook)(Button_t* btn, uint8_t pressed, uint32_t tick);
+
+// Report a press to the application (and to the trace / event bus)
+static inline void BUTTON_Fire(Button_t* btn, ButtonPressType_t type) {
+    TRACE_EVENT(TRACE_ID_BUTTON_PRESS, ((btn - buttonPool) << 8) | type);
+    EVBUS_PUBLISH(EVBUS_EV_BUTTON, type, btn - buttonPool, btn);
+    btn->Config->Handler(btn, type);
+}
+
+static inline uint16_t Saturate16(uint32_t ms) {
+    return (ms > 0xFFFFU) ? 0xFFFFU : (uint16_t)ms;
+}
+
 
 // Configure the button in Toggle mode
-static void ConfigureToggleMode(Button_t* btn) {
-    btn->Mode = BUTTON_Mode_Toggle;
-    btn->NormalTime = 300;
-    btn->LongTime = 1000;
-    btn->VeryLongTime = 3000;
-    btn->DoubleClickTime = 0;
-    btn->FirstClickDone = 0;
+static void ConfigureToggleMode(ButtonConfig_t* cfg) {
+    cfg->Mode = BUTTON_Mode_Toggle;
+    cfg->NormalTime = 300;
+    cfg->LongTime = 1000;
+    cfg->VeryLongTime = 3000;
+    cfg->DoubleClickTime = 0;
 }
 
 // Configure the button in Hold mode
-static void ConfigureHoldMode(Button_t* btn) {
-    btn->Mode = BUTTON_Mode_Hold;
-    btn->RepeatDelay = 500;
-    btn->RepeatInterval = 200;
-    btn->RepeatStarted = 0;
+static void ConfigureHoldMode(ButtonConfig_t* cfg) {
+    cfg->Mode = BUTTON_Mode_Hold;
+    cfg->RepeatDelay = 500;
+    cfg->RepeatInterval = 200;
+}
+
+// Take a free slot (O(1): last freed first, then slots never used) for a button of 'cfg'.
+// Without a port the button is external for life: no port slot, never polled
+static Button_t* BUTTON_Register(const ButtonConfig_t* cfg) {
+    uint8_t input = 0;
+    if (cfg->GPIOx != NULL) {
+        input = InputCode(cfg);
+        if (input == 0xFFU) return NULL;
+    }
+
+    uint16_t i;
+    if (freeHead) {
+        i = (uint16_t)(freeHead - 1U);
+        freeHead = nextFree[i];
+    } else if (highWater < BUTTON_MAX) {
+        i = highWater++;
+    } else {
+        return NULL;
+    }
+
+    Button_t* btn = &buttonPool[i];
+    *btn = (Button_t){0};
+    btn->Config = cfg;
+    btn->Input = input;
+    btn->State = BUTTON_STATE_START;
+
+    buttonCount++;
+    MaskSet(liveMask, i);
+    MaskSet((cfg->GPIOx != NULL) ? pollMask : extMask, i);
+    return btn;
 }
 
 // Initialize a button with specific GPIO, mode, and handler
 Button_t* BUTTON_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint8_t ActiveState,
                       ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t)) {
-    if (buttonCount >= BUTTON_MAX) return NULL;
+    if (mode != BUTTON_Mode_Toggle && mode != BUTTON_Mode_Hold) return NULL;
+    if (freeHead == 0 && highWater >= BUTTON_MAX) return NULL;
 
-    Button_t* btn = &buttonPool[buttonCount];
-    buttons[buttonCount++] = btn;
+    ButtonConfig_t* cfg = ConfigAlloc();
+    if (cfg == NULL) return NULL;
 
-    btn->GPIOx = GPIOx;
-    btn->GPIO_Pin = GPIO_Pin;
-    btn->ActiveState = ActiveState;
-
-    btn->LastStatus = 0;
-    btn->State = BUTTON_STATE_START;
-    btn->DebounceTime = 50;
-    btn->Handler = (Handler != NULL) ? Handler : BUTTON_Callback;
+    *cfg = (ButtonConfig_t){0};
+    cfg->GPIOx = GPIOx;
+    cfg->GPIO_Pin = GPIO_Pin;
+    cfg->ActiveState = ActiveState;
+    cfg->DebounceTime = 50;
+    cfg->Handler = (Handler != NULL) ? Handler : BUTTON_Callback;
 
     // Configure button based on selected mode
     if (mode == BUTTON_Mode_Toggle) {
-        ConfigureToggleMode(btn);
-    } else if (mode == BUTTON_Mode_Hold) {
-        ConfigureHoldMode(btn);
+        ConfigureToggleMode(cfg);
     } else {
-        buttonCount--; // Undo if mode is invalid
-        return NULL;
+        ConfigureHoldMode(cfg);
     }
-
+    Button_t* btn = BUTTON_Register(cfg);
+    if (btn == NULL) ConfigRelease(cfg);
     return btn;
 }
 
-// Deinitialize a button and remove it from the pool
+// Button with no pin, its level pushed by another driver with BUTTON_SetLevel (ADC ladder,
+// shift register...): external from the start, it can never be polled, batched or scanned
+Button_t* BUTTON_InitExternal(ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t)) {
+    return BUTTON_Init(NULL, 0, 1, mode, Handler);
+}
+
+// Initialize a button from a configuration that outlives it (a const table in flash):
+// only its state takes RAM, the Set* functions do not apply to it
+Button_t* BUTTON_InitConst(const ButtonConfig_t* config) {
+    if (config == NULL || config->Handler == NULL) return NULL;
+    if (config->Mode != BUTTON_Mode_Toggle && config->Mode != BUTTON_Mode_Hold) return NULL;
+    return BUTTON_Register(config);
+}
+
+// Deinitialize a button and give its slot back (O(1), safe from a button handler)
 void BUTTON_Deinit(Button_t* btn) {
-    if (!btn) return;
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX) return;    // NULL, not from the pool or already released
+
+    BUTTON_DisableIrq(btn);
+    BUTTON_DisableBatch(btn);
+    BUTTON_DisableExternal(btn);
+    BUTTON_DisableScan(btn);
+    MaskClear(extMask, i);          // pinless buttons stay external
+    MaskClear(armedMask, i);
+    BUTTON_AdaptRelease(i);
+    MaskClear(pollMask, i);
+    MaskClear(liveMask, i);
+    slotGen[i]++;
+    buttonCount--;
+
+    // Inside BUTTON_Update or BUTTON_SetLevel the slot may still be in use by the running pass
+    if (updating) {
+        nextFree[i] = deferHead;
+        deferHead = (uint16_t)(i + 1U);
+    } else {
+        ConfigRelease(btn->Config);
+        nextFree[i] = freeHead;
+        freeHead = (uint16_t)(i + 1U);
+    }
+}
 
-    for (uint8_t i = 0; i < buttonCount; ++i) {
-        if (buttons[i] == btn) {
-            for (uint8_t j = i; j < buttonCount - 1; ++j) {
-                buttons[j] = buttons[j + 1];
-                buttonPool[j] = buttonPool[j + 1];
-            }
-            buttonCount--;
-            break;
-        }
+// End of a BUTTON_Update / BUTTON_SetLevel: once the outermost one returns, the slots
+// released by the handlers can be reused
+static void BUTTON_EndUpdate(void) {
+    if (--updating) return;
+    while (deferHead) {
+        uint16_t i = (uint16_t)(deferHead - 1U);
+        deferHead = nextFree[i];
+        ConfigRelease(buttonPool[i].Config);
+        nextFree[i] = freeHead;
+        freeHead = (uint16_t)(i + 1U);
     }
 }
 
+// Handle of a button: pool index and generation, 0 for an invalid button
+ButtonHandle_t BUTTON_GetHandle(const Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX) return 0;
+    return ((uint32_t)slotGen[i] << 16) | (uint32_t)(i + 1U);
+}
+
+// Button of a handle, NULL once that button was released (even if its slot was reused)
+Button_t* BUTTON_FromHandle(ButtonHandle_t handle) {
+    uint16_t i = (uint16_t)((handle & 0xFFFFU) - 1U);
+    if (i >= BUTTON_MAX || !MaskTest(liveMask, i) || slotGen[i] != (uint16_t)(handle >> 16)) return NULL;
+    return &buttonPool[i];
+}
+
+// Press type of a Toggle-mode press from its duration
+static ButtonPressType_t BUTTON_Classify(const ButtonConfig_t* cfg, uint32_t duration) {
+    return (duration >= cfg->VeryLongTime) ? BUTTON_PressType_VeryLong :
+           (duration >= cfg->LongTime) ? BUTTON_PressType_Long :
+           (duration >= cfg->NormalTime) ? BUTTON_PressType_Normal :
+           BUTTON_PressType_OnPressed;
+}
+
 // Set the debounce time for a button
-void Set_DebounceTime(Button_t* btn, uint8_t debounceTime) {
-    btn->DebounceTime = debounceTime;
+void Set_DebounceTime(Button_t* btn, uint16_t debounceTime) {
+    ButtonConfig_t* cfg = BUTTON_Config(btn);
+    if (!cfg) return;
+    cfg->DebounceTime = debounceTime;
 }
 
 // Set the repeat delay and interval for Hold mode
 void SetTime_Hold_mode(Button_t* btn, uint16_t delay, uint16_t interval) {
-    if (!btn) return;
-    btn->RepeatDelay = delay;
-    btn->RepeatInterval = interval;
+    ButtonConfig_t* cfg = BUTTON_Config(btn);
+    if (!cfg) return;
+    cfg->RepeatDelay = delay;
+    cfg->RepeatInterval = interval;
 }
 
 // Set times for press durations in Toggle mode
 void SetTime_Toggle_mode(Button_t* btn, uint16_t time4Double, uint16_t normal, uint16_t longer, uint16_t very_long) {
-    if (!btn) return;
-    btn->DoubleClickTime = time4Double;
-    btn->NormalTime = normal;
-    btn->LongTime = longer;
-    btn->VeryLongTime = very_long;
+    ButtonConfig_t* cfg = BUTTON_Config(btn);
+    if (!cfg) return;
+    cfg->DoubleClickTime = time4Double;
+    cfg->NormalTime = normal;
+    cfg->LongTime = longer;
+    cfg->VeryLongTime = very_long;
 }
 
-// Update the state of all buttons
-void BUTTON_Update(void) {
-    uint32_t now = HAL_GetTick(); // Get the current time in milliseconds
+// Set the handler of a button (NULL = BUTTON_Callback)
+void BUTTON_SetHandler(Button_t* btn, void (*Handler)(Button_t*, ButtonPressType_t)) {
+    ButtonConfig_t* cfg = BUTTON_Config(btn);
+    if (!cfg) return;
+    cfg->Handler = (Handler != NULL) ? Handler : BUTTON_Callback;
+}
+
+// Called with every debounced press (1) and release (0), at their time, before the press types
+void BUTTON_SetEdgeHook(void (*hook)(Button_t* btn, uint8_t pressed, uint32_t tick)) {
+    edgeHook = hook;
+}
+
+// Toggle mode: report Long / VeryLong while held, clicks at release (see BUTTON.h)
+void BUTTON_SetImmediate(Button_t* btn, uint8_t enable) {
+    ButtonConfig_t* cfg = BUTTON_Config(btn);
+    if (!cfg) return;
+    cfg->Immediate = enable ? 1 : 0;
+    btn->HoldReported = 0;
+}
+
+// Adaptive debounce: a settle of 'ms' measured. A longer bounce is learned at once
+// (worn contacts), a shorter one 1/2^BUTTON_ADAPT_SHIFT of the way per press
+static void BUTTON_Learn(uint16_t i, uint32_t ms) {
+    Adapt* a = AdaptOf(i);
+    uint32_t limit = buttonPool[i].Config->DebounceTime;
+    if (ms > limit) ms = limit;
+    if (ms > 4095U) ms = 4095U;
+    a->LastBounce = (uint16_t)ms;
+
+    uint16_t m = (uint16_t)(ms * 16U);
+    if (m >= a->Bounce) a->Bounce = m;
+    else a->Bounce = (uint16_t)(a->Bounce - ((a->Bounce - m) >> BUTTON_ADAPT_SHIFT));
+}
+
+// Adaptive debounce: a level change seen at 'now', in the burst or starting one
+static void BUTTON_Change(uint16_t i, uint8_t level, uint32_t now) {
+    Adapt* a = AdaptOf(i);
+    if (!a->Settling && !a->Tail && now - a->LastChange > AdaptWindow(i)) {
+        a->BurstStart = now;
+        a->Edges = 0;
+    }
+    a->LastChange = now;
+    a->Level = level;
+    if (a->Edges < 0xFFU) a->Edges++;
+}
 
-    for (uint8_t i = 0; i < buttonCount; ++i) {
-        Button_t* btn = buttons[i];  // Access the current button
-        uint8_t currentStatus = BUTTON_Read(btn); // Read the current status of the button (pressed or not)
+// Adaptive debounce: a window that ended released. In a longer burst it was the bounce
+// of a release (or of a press accepted too early), alone it was a glitch
+static void BUTTON_Reject(uint16_t i, uint32_t start) {
+    Adapt* a = AdaptOf(i);
+    if (a->BurstStart != start) BUTTON_Learn(i, a->LastChange - a->BurstStart);
+    else if (a->Glitches < 0xFFFFU) a->Glitches++;
+}
 
-        switch (btn->State) {
-            case BUTTON_STATE_START:
+// One pass of the state machine of one button, with its level at time 'now'
+static void BUTTON_Step(Button_t* btn, uint8_t currentStatus, uint32_t now) {
+    const ButtonConfig_t* cfg = btn->Config;
+    uint16_t i = (uint16_t)(btn - buttonPool);
+    uint8_t adaptive = MaskTest(adaptMask, i);
+    Adapt* a = adaptive ? AdaptOf(i) : NULL;
+#if TRACE_ENABLED
+    ButtonState_t prevState = btn->State;
+#endif
+
+    switch (btn->State) {
+        case BUTTON_STATE_START:
+            if (currentStatus) {
+                // Button is pressed, record start time and switch to debounce state
+                btn->StartTime = now;
+                btn->State = BUTTON_STATE_DEBOUNCE; // Enter debounce phase to filter out noise
+                if (adaptive) {
+                    // Right after a release or a glitch it may be their bounce: the full window
+                    a->Tail = (now - a->LastChange < cfg->DebounceTime);
+                    BUTTON_Change(i, 1, now);
+                }
+            }
+            break;
+
+        case BUTTON_STATE_DEBOUNCE:
+            // Adaptive: count the bounces of the window, note when the last one was
+            if (adaptive && currentStatus != a->Level) BUTTON_Change(i, currentStatus, now);
+            // If debounce time has passed, transition to pressed state if button is still pressed
+            if (now - btn->StartTime >= DebounceOf(btn)) {
+                if (adaptive) a->Tail = 0;
                 if (currentStatus) {
-                    // Button is pressed, record start time and switch to debounce state
-                    btn->StartTime = now;
-                    btn->State = BUTTON_STATE_DEBOUNCE; // Enter debounce phase to filter out noise
+                    if (adaptive) a->Settling = 1;    // learned once DebounceTime is over
+                    btn->State = BUTTON_STATE_PRESSED; // Transition to pressed state
+                    if (cfg->Mode == BUTTON_Mode_Hold) btn->LastRepeatTime = now; // Shares its word with FirstClickReleaseTime
+                    btn->HoldReported = 0;
+                    if (edgeHook) edgeHook(btn, 1, now);
+
+                    // Handle button press in Hold mode if applicable
+                    if (cfg->Mode == BUTTON_Mode_Hold && cfg->Handler) {
+                        BUTTON_Fire(btn, BUTTON_PressType_RepeatOnce); // Trigger repeat once event
+                    }
+                } else {
+                    // If button is released, return to the start state
+                    btn->State = BUTTON_STATE_START;
+                    if (adaptive) BUTTON_Reject(i, btn->StartTime);
                 }
-                break;
-
-            case BUTTON_STATE_DEBOUNCE:
-                // If debounce time has passed, transition to pressed state if button is still pressed
-                if (now - btn->StartTime >= btn->DebounceTime) {
-                    if (currentStatus) {
-                        btn->State = BUTTON_STATE_PRESSED; // Transition to pressed state
-                        btn->LastRepeatTime = now; // Record the last time the button was pressed
-
-                        // Handle button press in Hold mode if applicable
-                        if (btn->Mode == BUTTON_Mode_Hold && btn->Handler) {
-                            btn->Handler(btn, BUTTON_PressType_RepeatOnce); // Trigger repeat once event
-                        }
+            }
+            break;
+
+        case BUTTON_STATE_PRESSED:
+            // Adaptive: a press accepted early may still bounce. Until DebounceTime its changes
+            // are part of its burst, then the settle is learned if it is still pressed
+            if (adaptive && a->Settling) {
+                if (currentStatus != a->Level) BUTTON_Change(i, currentStatus, now);
+                if (now - btn->StartTime < cfg->DebounceTime) break;
+                a->Settling = 0;
+                if (currentStatus) BUTTON_Learn(i, a->LastChange - a->BurstStart);
+            }
+            // Button is pressed, now checking for release or repeating actions
+            if (!currentStatus) {
+                uint32_t pressDuration = now - btn->StartTime; // Calculate how long the button was pressed
+                if (adaptive && a->Level) BUTTON_Change(i, 0, now);
+                if (edgeHook) edgeHook(btn, 0, now);
+
+                // Immediate mode: this press, classified by its own duration
+                if (cfg->Mode == BUTTON_Mode_Toggle && cfg->Immediate && cfg->Handler) {
+                    ButtonPressType_t type = BUTTON_Classify(cfg, pressDuration);
+
+                    if (btn->HoldReported) {
+                        // Long / VeryLong already reported while held
+                    } else if (btn->FirstClickDone && now - btn->FirstClickReleaseTime <= cfg->DoubleClickTime) {
+                        btn->FirstClickDone = 0;
+                        BUTTON_Fire(btn, BUTTON_PressType_Double); // Upgrade of the provisional click
+                    } else if (cfg->DoubleClickTime == 0 || type >= BUTTON_PressType_Long) {
+                        BUTTON_Fire(btn, type); // Nothing can follow: final at once
                     } else {
-                        // If button is released, return to the start state
-                        btn->State = BUTTON_STATE_START;
+                        if (btn->FirstClickDone) { // Window over but not confirmed yet (late update)
+                            btn->FirstClickDone = 0;
+                            BUTTON_Fire(btn, BUTTON_Classify(cfg, btn->LastPressDuration));
+                        }
+                        btn->FirstClickDone = 1;
+                        btn->FirstClickReleaseTime = now;
+                        btn->LastPressDuration = Saturate16(pressDuration);
+                        BUTTON_Fire(btn, BUTTON_PressType_Provisional);
                     }
-                }
-                break;
-
-            case BUTTON_STATE_PRESSED:
-                // Button is pressed, now checking for release or repeating actions
-                if (!currentStatus) {
-                    uint32_t pressDuration = now - btn->StartTime; // Calculate how long the button was pressed
-
-                    // Handle Toggle mode if button is released
-                    if (btn->Mode == BUTTON_Mode_Toggle && btn->Handler) {
-                        if (btn->FirstClickDone) { // Check if first click is completed
-                            if (now - btn->FirstClickReleaseTime <= btn->DoubleClickTime) {
-                                // If within double-click time, trigger double-click event
-                                btn->Handler(btn, BUTTON_PressType_Double);
-                                btn->FirstClickDone = 0; // Reset first click flag
-                            } else {
-                                // Determine press type based on press duration
-                                ButtonPressType_t type =
-                                    (btn->LastPressDuration >= btn->VeryLongTime) ? BUTTON_PressType_VeryLong :
-                                    (btn->LastPressDuration >= btn->LongTime) ? BUTTON_PressType_Long :
-                                    (btn->LastPressDuration >= btn->NormalTime) ? BUTTON_PressType_Normal :
-                                    BUTTON_PressType_OnPressed;
-
-                                // Trigger the appropriate handler based on press type
-                                btn->Handler(btn, type);
-                                btn->FirstClickDone = 1; // Mark first click as done
-                                btn->FirstClickReleaseTime = now; // Store release time for future comparison
-                                btn->LastPressDuration = pressDuration; // Store press duration
-                            }
+                } else if (cfg->Mode == BUTTON_Mode_Toggle && cfg->Handler) {
+                    if (btn->FirstClickDone) { // Check if first click is completed
+                        if (now - btn->FirstClickReleaseTime <= cfg->DoubleClickTime) {
+                            // If within double-click time, trigger double-click event
+                            BUTTON_Fire(btn, BUTTON_PressType_Double);
+                            btn->FirstClickDone = 0; // Reset first click flag
                         } else {
-                            // First click handling if it hasn't been processed yet
-                            btn->FirstClickDone = 1;
-                            btn->FirstClickReleaseTime = now;
-                            btn->LastPressDuration = pressDuration;
+                            // Determine press type based on press duration
+                            ButtonPressType_t type = BUTTON_Classify(cfg, btn->LastPressDuration);
+
+                            // Trigger the appropriate handler based on press type
+                            BUTTON_Fire(btn, type);
+                            btn->FirstClickDone = 1; // Mark first click as done
+                            btn->FirstClickReleaseTime = now; // Store release time for future comparison
+                            btn->LastPressDuration = Saturate16(pressDuration); // Store press duration
                         }
-                    }
-
-                    // After processing the button release, reset to start state
-                    btn->State = BUTTON_STATE_START;
-                    btn->RepeatStarted = 0; // Reset repeat action flag
-                } else if (btn->Mode == BUTTON_Mode_Hold) {
-                    // Handle button held down for repeat functionality
-                    if (!btn->RepeatStarted && now - btn->StartTime >= btn->RepeatDelay) {
-                        btn->RepeatStarted = 1; // Start repeat action
-                        btn->LastRepeatTime = now; // Record time of repeat
-                        if (btn->Handler) btn->Handler(btn, BUTTON_PressType_Repeat); // Trigger repeat event
-                    } else if (btn->RepeatStarted && now - btn->LastRepeatTime >= btn->RepeatInterval) {
-                        // Continue repeating if interval time has passed
-                        btn->LastRepeatTime = now;
-                        if (btn->Handler) btn->Handler(btn, BUTTON_PressType_Repeat); // Trigger repeat event
+                    } else {
+                        // First click handling if it hasn't been processed yet
+                        btn->FirstClickDone = 1;
+                        btn->FirstClickReleaseTime = now;
+                        btn->LastPressDuration = Saturate16(pressDuration);
                     }
                 }
-                break;
 
-            default:
-                // Handle any unexpected state transitions
+                // After processing the button release, reset to start state
                 btn->State = BUTTON_STATE_START;
-                break;
+                btn->RepeatStarted = 0; // Reset repeat action flag
+            } else if (cfg->Mode == BUTTON_Mode_Hold) {
+                // Handle button held down for repeat functionality
+                if (!btn->RepeatStarted && now - btn->StartTime >= cfg->RepeatDelay) {
+                    btn->RepeatStarted = 1; // Start repeat action
+                    btn->LastRepeatTime = now; // Record time of repeat
+                    if (cfg->Handler) BUTTON_Fire(btn, BUTTON_PressType_Repeat); // Trigger repeat event
+                } else if (btn->RepeatStarted && now - btn->LastRepeatTime >= cfg->RepeatInterval) {
+                    // Continue repeating if interval time has passed
+                    btn->LastRepeatTime = now;
+                    if (cfg->Handler) BUTTON_Fire(btn, BUTTON_PressType_Repeat); // Trigger repeat event
+                }
+            } else if (cfg->Immediate && cfg->Handler) {
+                // Toggle mode, immediate: report the hold thresholds as they are crossed
+                uint32_t held = now - btn->StartTime;
+                if (btn->HoldReported < 1 && held >= cfg->LongTime) {
+                    btn->HoldReported = 1;
+                    BUTTON_Fire(btn, BUTTON_PressType_Long);
+                }
+                if (btn->HoldReported < 2 && held >= cfg->VeryLongTime) {
+                    btn->HoldReported = 2;
+                    BUTTON_Fire(btn, BUTTON_PressType_VeryLong);
+                }
+            }
+            break;
+
+        default:
+            // Handle any unexpected state transitions
+            btn->State = BUTTON_STATE_START;
+            break;
+    }
+#if TRACE_ENABLED
+    if (btn->State != prevState) TRACE_EVENT(TRACE_ID_BUTTON_STATE, ((btn - buttonPool) << 8) | btn->State);
+#endif
+
+    // Handle Toggle mode for release timing, checking if double click time has passed
+    if (btn->FirstClickDone && cfg->Mode == BUTTON_Mode_Toggle) {
+        if (now - btn->FirstClickReleaseTime > cfg->DoubleClickTime) {
+            btn->FirstClickDone = 0; // Reset first click after double-click time
+
+            // Determine press type based on duration of the press
+            ButtonPressType_t type = BUTTON_Classify(cfg, btn->LastPressDuration);
+
+            // Trigger the appropriate handler for the press type
+            if (cfg->Handler) BUTTON_Fire(btn, type);
         }
+    }
+}
+
+// Next time the button has a timer to run (debounce end, repeat, double-click expiry)
+static uint8_t BUTTON_Deadline(const Button_t* btn, uint32_t* at) {
+    const ButtonConfig_t* cfg = btn->Config;
+    uint8_t found = 0;
+
+    if (btn->State == BUTTON_STATE_DEBOUNCE) {
+        *at = btn->StartTime + DebounceOf(btn);
+        found = 1;
+    } else if (btn->State == BUTTON_STATE_PRESSED && MaskTest(adaptMask, (uint16_t)(btn - buttonPool)) &&
+               AdaptOf((uint16_t)(btn - buttonPool))->Settling) {
+        *at = btn->StartTime + cfg->DebounceTime;  // adaptive: end of the settle of the press
+        found = 1;
+    } else if (btn->State == BUTTON_STATE_PRESSED && cfg->Mode == BUTTON_Mode_Hold) {
+        *at = btn->RepeatStarted ? btn->LastRepeatTime + cfg->RepeatInterval : btn->StartTime + cfg->RepeatDelay;
+        found = 1;
+    } else if (btn->State == BUTTON_STATE_PRESSED && cfg->Immediate && btn->HoldReported < 2) {
+        *at = btn->StartTime + (btn->HoldReported ? cfg->VeryLongTime : cfg->LongTime);
+        found = 1;
+    }
+    // Single click is reported once the double-click window has passed
+    if (cfg->Mode == BUTTON_Mode_Toggle && btn->FirstClickDone) {
+        uint32_t expiry = btn->FirstClickReleaseTime + cfg->DoubleClickTime + 1U;
+        if (!found || (int32_t)(expiry - *at) < 0) *at = expiry;
+        found = 1;
+    }
+    return found;
+}
 
-        // Handle Toggle mode for release timing, checking if double click time has passed
-        if (btn->Mode == BUTTON_Mode_Toggle && btn->FirstClickDone) {
-            if (now - btn->FirstClickReleaseTime > btn->DoubleClickTime) {
-                btn->FirstClickDone = 0; // Reset first click after double-click time
+// ========== Timers ==========
 
-                // Determine press type based on duration of the press
-                ButtonPressType_t type =
-                    (btn->LastPressDuration >= btn->VeryLongTime) ? BUTTON_PressType_VeryLong :
-                    (btn->LastPressDuration >= btn->LongTime) ? BUTTON_PressType_Long :
-                    (btn->LastPressDuration >= btn->NormalTime) ? BUTTON_PressType_Normal :
-                    BUTTON_PressType_OnPressed;
+// Run the timers of an edge-driven or batched button that expired up to 'until', at their own time
+static void BUTTON_CatchUp(Button_t* btn, uint32_t until) {
+    uint32_t at, next;
 
-                // Trigger the appropriate handler for the press type
-                if (btn->Handler) btn->Handler(btn, type);
+    while (BUTTON_Deadline(btn, &at) && (int32_t)(until - at) >= 0) {
+        if (BUTTON_Index(btn) >= BUTTON_MAX) break;     // released by its handler
+        BUTTON_Step(btn, btn->LastStatus, at);
+        if (BUTTON_Deadline(btn, &next) && next == at) break;   // repeat interval 0: once per catch-up
+    }
+}
+
+static void BUTTON_Arm(uint16_t i) {
+    uint32_t at;
+    uint8_t unsampled = MaskTest(irqMask, i) || MaskTest(batchMask, i) || MaskTest(extMask, i) ||
+                        MaskTest(scanMask, i);  // not released by its handler
+    if (unsampled && BUTTON_Deadline(&buttonPool[i], &at)) MaskSet(armedMask, i);
+    else MaskClear(armedMask, i);
+}
+
+// A new level for a button that is not sampled by BUTTON_Update, known at time 'now'
+static void BUTTON_Apply(uint16_t i, uint8_t level, uint32_t now) {
+    Button_t* btn = &buttonPool[i];
+
+    BUTTON_CatchUp(btn, now);
+    if (BUTTON_Index(btn) >= BUTTON_MAX) return;    // released by its handler
+    btn->LastStatus = level;
+    BUTTON_Step(btn, level, now);
+    if (BUTTON_Index(btn) >= BUTTON_MAX) return;
+    if (btn->State == BUTTON_STATE_DEBOUNCE && MaskTest(scanMask, i)) BUTTON_Step(btn, level, now);  // debounced already
+    BUTTON_Arm(i);
+}
+
+// ========== Edge-driven buttons ==========
+
+// ISR side: stamp the level of the button on this line; 0 when the ring is full
+static uint8_t BUTTON_PushEdge(uint16_t index, uint8_t level, uint32_t tick, uint32_t us) {
+    uint8_t gen = (uint8_t)slotGen[index];
+    uint32_t pos = __atomic_load_n(&edgeHead, __ATOMIC_RELAXED);
+    Edge* e;
+
+    for (;;) {
+        e = &edges[pos & EDGE_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&e->Seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff < 0) return 0;
+        if (diff == 0 && __atomic_compare_exchange_n(&edgeHead, &pos, pos + 1U, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        if (diff > 0) pos = __atomic_load_n(&edgeHead, __ATOMIC_RELAXED);
+    }
+
+    e->Tick = tick;
+    e->Us = us;
+    e->Index = index;
+    e->Gen = gen;
+    e->Level = level;
+    __atomic_store_n(&e->Seq, pos + 1U, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void BUTTON_EXTI_Callback(uint16_t GPIO_Pin) {
+    uint32_t tick = HAL_GetTick();
+
+    for (uint8_t line = 0; line < 16; ++line) {
+        if (!(GPIO_Pin & (1U << line)) || !lineButton[line]) continue;
+        uint16_t i = (uint16_t)(lineButton[line] - 1U);
+        if (!BUTTON_PushEdge(i, BUTTON_Read(&buttonPool[i]), tick, 0)) {
+            __atomic_fetch_or(&resyncMask[i >> 5], 1UL << (i & 31U), __ATOMIC_RELAXED);
+            __atomic_fetch_add(&edgesLost, 1U, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+#if BUTTON_HAL_CALLBACKS
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    BUTTON_EXTI_Callback(GPIO_Pin);
+}
+#endif
+
+// Edges in arrival order, each after the timers it follows
+static void BUTTON_UpdateIrq(uint32_t now) {
+    for (;;) {
+        Edge* e = &edges[edgeTail & EDGE_MASK];
+        if (__atomic_load_n(&e->Seq, __ATOMIC_ACQUIRE) != edgeTail + 1U) break;
+
+        uint16_t i = e->Index;
+        uint8_t gen = e->Gen;
+        uint8_t level = e->Level;
+        uint32_t tick = e->Tick;
+        uint32_t us = e->Us;
+        __atomic_store_n(&e->Seq, edgeTail + BUTTON_EDGE_QUEUE, __ATOMIC_RELEASE);
+        edgeTail++;
+        if (gen != (uint8_t)slotGen[i]) continue;
+        if (MaskTest(irqMask, i)) {
+            BUTTON_Apply(i, level, tick);
+        } else if (MaskTest(scanMask, i)) {
+            ScanPort* sp = BUTTON_ScanPort(&buttonPool[i]);
+            if (sp) sp->EdgeUs[PinIndex(buttonPool[i].Config->GPIO_Pin)] = us;
+            BUTTON_Apply(i, level, tick);
+        }
+    }
+
+    // Edges lost to a full ring: sample those buttons once (scanned: their debounced level)
+    for (uint16_t w = 0; w < MASK_WORDS; ++w) {
+        uint32_t resync = __atomic_exchange_n(&resyncMask[w], 0U, __ATOMIC_RELAXED) & (irqMask[w] | scanMask[w]);
+        for (; resync; resync &= resync - 1U) {
+            uint16_t i = (uint16_t)(w * 32U + __builtin_ctz(resync));
+            if (MaskTest(irqMask, i)) {
+                BUTTON_Apply(i, BUTTON_Read(&buttonPool[i]), now);
+            } else if (MaskTest(scanMask, i)) {     // not released by a handler meanwhile
+                ScanPort* sp = BUTTON_ScanPort(&buttonPool[i]);
+                BUTTON_Apply(i, sp ? (uint8_t)((sp->State >> PinIndex(buttonPool[i].Config->GPIO_Pin)) & 1U) : 0U, now);
             }
         }
     }
 }
+
+// Nothing queued, nothing lost
+static inline uint8_t BUTTON_IrqIdle(void) {
+    if (__atomic_load_n(&edgeHead, __ATOMIC_RELAXED) != edgeTail) return 0;
+    return !MaskAny((const uint32_t*)resyncMask);
+}
+
+// Ring slots free for the first positions, once
+static void BUTTON_EdgesInit(void) {
+    if (edgesReady) return;
+    for (uint32_t k = 0; k < BUTTON_EDGE_QUEUE; k++) edges[k].Seq = k;
+    edgeHead = 0;
+    edgeTail = 0;
+    edgesReady = 1;
+}
+
+// Switch a button to edge-driven: its pin must already be an EXTI input on both edges
+HAL_StatusTypeDef BUTTON_EnableIrq(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !btn->Config->GPIOx || !btn->Config->GPIO_Pin) return HAL_ERROR;
+    if (MaskTest(batchMask, i) || MaskTest(extMask, i) || MaskTest(scanMask, i)) return HAL_ERROR;
+
+    uint8_t line = PinIndex(btn->Config->GPIO_Pin);
+    if (lineButton[line] && lineButton[line] != i + 1U) return HAL_ERROR;   // line taken by another port
+
+    BUTTON_EdgesInit();
+    btn->LastStatus = BUTTON_Read(btn);
+    lineButton[line] = (uint16_t)(i + 1U);
+    MaskSet(irqMask, i);
+    MaskClear(pollMask, i);
+    BUTTON_Arm(i);
+    return HAL_OK;
+}
+
+// Back to polling (the EXTI line itself is left to the application)
+void BUTTON_DisableIrq(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(irqMask, i)) return;
+
+    for (uint8_t line = 0; line < 16; ++line) {
+        if (lineButton[line] == i + 1U) lineButton[line] = 0;
+    }
+    MaskClear(irqMask, i);
+    MaskClear(armedMask, i);
+    __atomic_fetch_and(&resyncMask[i >> 5], ~(1UL << (i & 31U)), __ATOMIC_RELAXED);
+    MaskSet(pollMask, i);
+}
+
+uint32_t BUTTON_EdgesLost(void) {
+    return edgesLost;
+}
+
+// ========== Port-batched buttons ==========
+
+// One IDR load per port; only the pins whose debounced level flipped reach their buttons
+static void BUTTON_Scan(uint32_t now) {
+    for (uint8_t p = 0; p < batchPortCount; ++p) {
+        BatchPort* bp = &batchPorts[p];
+        if (!bp->Pins) continue;
+        uint16_t pressed = (uint16_t)~(GPIO_FAST_ReadIDR(bp->GPIOx) ^ bp->ActiveHigh);
+        uint16_t delta = (uint16_t)((pressed ^ bp->State) & bp->Pins);
+
+        uint16_t toggle = (uint16_t)BUTTON_CounterStep(&bp->Cnt, delta);
+        bp->State ^= toggle;
+
+        for (; toggle; toggle &= (uint16_t)(toggle - 1U)) {
+            uint8_t pin = (uint8_t)__builtin_ctz(toggle);
+            uint8_t level = (uint8_t)((bp->State >> pin) & 1U);
+            // DebounceTime is 0: the debounce timer of a new press expires in this same update
+            // Next link read first: a handler may release the button it is called for
+            for (uint16_t link = bp->First[pin], next; link; link = next) {
+                next = pinNext[link - 1U];
+                if (MaskTest(batchMask, (uint16_t)(link - 1U))) BUTTON_Apply((uint16_t)(link - 1U), level, now);
+            }
+        }
+    }
+}
+
+// Move a button to the batched scan of its port: debounce = 4 scans, Set_DebounceTime adds on top
+HAL_StatusTypeDef BUTTON_EnableBatch(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !btn->Config->GPIOx || !btn->Config->GPIO_Pin) return HAL_ERROR;
+    if (MaskTest(irqMask, i) || MaskTest(extMask, i)) return HAL_ERROR;
+    if (MaskTest(scanMask, i) || MaskTest(adaptMask, i)) return HAL_ERROR;
+    if (MaskTest(batchMask, i)) return HAL_OK;
+
+    const ButtonConfig_t* cfg = btn->Config;
+    BatchPort* bp = NULL;
+    for (uint8_t p = 0; p < batchPortCount; ++p) {
+        if (batchPorts[p].GPIOx == cfg->GPIOx) bp = &batchPorts[p];
+    }
+    if (bp == NULL) {
+        if (batchPortCount >= BUTTON_BATCH_PORTS) return HAL_ERROR;
+        bp = &batchPorts[batchPortCount++];
+        *bp = (BatchPort){ .GPIOx = cfg->GPIOx, .Cnt = BUTTON_COUNTER_INIT };
+    }
+
+    uint8_t pin = PinIndex(cfg->GPIO_Pin);
+    uint16_t bit = (uint16_t)(1U << pin);
+    uint16_t high = cfg->ActiveState ? bit : 0U;
+    if (bp->Pins & bit) {
+        if ((bp->ActiveHigh & bit) != high) return HAL_ERROR;   // same pin, other polarity
+    } else {
+        bp->Pins |= bit;
+        bp->ActiveHigh = (uint16_t)((bp->ActiveHigh & ~bit) | high);
+        bp->State &= (uint16_t)~bit;
+        BUTTON_CounterReset(&bp->Cnt, bit);
+    }
+    if (!MaskAny(batchMask)) nextScan = HAL_GetTick();
+
+    pinNext[i] = bp->First[pin];
+    bp->First[pin] = (uint16_t)(i + 1U);
+    ButtonConfig_t* ram = BUTTON_Config(btn);
+    if (ram) ram->DebounceTime = 0;     // a const configuration keeps its own
+    btn->LastStatus = (uint8_t)((bp->State >> pin) & 1U);
+    MaskSet(batchMask, i);
+    MaskClear(pollMask, i);
+    BUTTON_Arm(i);
+    return HAL_OK;
+}
+
+// Back to polling (the debounce time stays 0 until Set_DebounceTime)
+void BUTTON_DisableBatch(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(batchMask, i)) return;
+
+    for (uint8_t p = 0; p < batchPortCount; ++p) {
+        BatchPort* bp = &batchPorts[p];
+        if (bp->GPIOx != btn->Config->GPIOx) continue;
+
+        uint8_t pin = PinIndex(btn->Config->GPIO_Pin);
+        uint16_t* link = &bp->First[pin];
+        while (*link && *link != i + 1U) link = &pinNext[*link - 1U];
+        if (*link) *link = pinNext[i];
+        if (!bp->First[pin]) bp->Pins &= (uint16_t)~(1U << pin);
+    }
+    MaskClear(batchMask, i);
+    MaskClear(armedMask, i);
+    MaskSet(pollMask, i);
+}
+
+// ========== Timer-scanned buttons ==========
+
+// Scan time now, from the TIMING ticks since the last scan (remainder carried: no drift)
+static uint32_t BUTTON_ScanClock(void) {
+    uint32_t stamp = TIMING_Now();
+    if (!scanClock) {
+        scanStamp = stamp;
+        scanClock = 1;
+        return scanUs;
+    }
+
+    uint32_t ticks = stamp - scanStamp + scanRest;
+    uint32_t perUs = TIMING_GetTickHz() / 1000000U;
+    scanStamp = stamp;
+    if (perUs) {
+        scanRest = ticks % perUs;
+        return scanUs + ticks / perUs;
+    }
+    scanRest = 0;
+    return scanUs + ticks * 1000U;      // HAL tick fallback: ms
+}
+
+// Timer ISR (HAL_TIM_PeriodElapsedCallback or a SysTick hook) at the scan rate: one IDR
+// load per port. A pin flips once its samples disagree with its state for DebounceTime in
+// a row, and the edge goes to the ring stamped with the time of its first sample
+void BUTTON_ScanTick(void) {
+    uint32_t t = BUTTON_ScanClock();
+    uint32_t tick = HAL_GetTick();
+    scanUs = t;
+
+    for (uint8_t p = 0; p < scanPortCount; ++p) {
+        ScanPort* sp = &scanPorts[p];
+        uint16_t pins = sp->Pins;
+        if (!pins) continue;
+        uint16_t pressed = (uint16_t)~(GPIO_FAST_ReadIDR(sp->GPIOx) ^ sp->ActiveHigh);
+        uint16_t delta = (uint16_t)((pressed ^ sp->State) & pins);
+
+        // A sample that agrees again (bounce) restarts the debounce of its pin
+        for (uint16_t fresh = (uint16_t)(delta & ~sp->Moving); fresh; fresh &= (uint16_t)(fresh - 1U)) {
+            sp->Since[__builtin_ctz(fresh)] = t;
+            sp->SinceTick[__builtin_ctz(fresh)] = tick;
+        }
+        sp->Moving = delta;
+
+        for (; delta; delta &= (uint16_t)(delta - 1U)) {
+            uint8_t pin = (uint8_t)__builtin_ctz(delta);
+            uint16_t i = (uint16_t)(sp->Button[pin] - 1U);
+            uint32_t stable = t - sp->Since[pin];
+            if (stable < (uint32_t)buttonPool[i].Config->DebounceTime * 1000U) continue;
+
+            uint16_t bit = (uint16_t)(1U << pin);
+            sp->State ^= bit;
+            sp->Moving &= (uint16_t)~bit;
+            if (!BUTTON_PushEdge(i, (uint8_t)((sp->State >> pin) & 1U), sp->SinceTick[pin], sp->Since[pin])) {
+                __atomic_fetch_or(&resyncMask[i >> 5], 1UL << (i & 31U), __ATOMIC_RELAXED);
+                __atomic_fetch_add(&edgesLost, 1U, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+// Move a button to the timer scan: its DebounceTime is counted in scans, in the ISR
+HAL_StatusTypeDef BUTTON_EnableScan(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !btn->Config->GPIOx || !btn->Config->GPIO_Pin) return HAL_ERROR;
+    if (MaskTest(irqMask, i) || MaskTest(batchMask, i) || MaskTest(extMask, i)) return HAL_ERROR;
+    if (MaskTest(adaptMask, i)) return HAL_ERROR;
+    if (MaskTest(scanMask, i)) return HAL_OK;
+
+    const ButtonConfig_t* cfg = btn->Config;
+    ScanPort* sp = BUTTON_ScanPort(btn);
+    if (sp == NULL) {
+        if (scanPortCount >= BUTTON_SCAN_PORTS) return HAL_ERROR;
+        sp = &scanPorts[scanPortCount];
+        *sp = (ScanPort){ .GPIOx = cfg->GPIOx };
+        __atomic_store_n(&scanPortCount, (uint8_t)(scanPortCount + 1U), __ATOMIC_RELEASE);
+    }
+
+    uint8_t pin = PinIndex(cfg->GPIO_Pin);
+    uint16_t bit = (uint16_t)(1U << pin);
+    if (sp->Pins & bit) return HAL_ERROR;      // one scanned button per pin
+
+    // Starts released: a button held now is reported once debounced
+    BUTTON_EdgesInit();
+    sp->Button[pin] = (uint16_t)(i + 1U);
+    if (cfg->ActiveState) __atomic_fetch_or(&sp->ActiveHigh, bit, __ATOMIC_RELAXED);
+    else __atomic_fetch_and(&sp->ActiveHigh, (uint16_t)~bit, __ATOMIC_RELAXED);
+    __atomic_fetch_and(&sp->State, (uint16_t)~bit, __ATOMIC_RELAXED);
+    __atomic_fetch_and(&sp->Moving, (uint16_t)~bit, __ATOMIC_RELAXED);
+    btn->LastStatus = 0;
+    MaskSet(scanMask, i);
+    MaskClear(pollMask, i);
+    __atomic_fetch_or(&sp->Pins, bit, __ATOMIC_RELEASE);   // the ISR takes the pin from here
+    BUTTON_Arm(i);
+    return HAL_OK;
+}
+
+// Back to polling
+void BUTTON_DisableScan(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(scanMask, i)) return;
+
+    ScanPort* sp = BUTTON_ScanPort(btn);
+    if (sp) {
+        uint8_t pin = PinIndex(btn->Config->GPIO_Pin);
+        __atomic_fetch_and(&sp->Pins, (uint16_t)~(1U << pin), __ATOMIC_RELEASE);
+        sp->Button[pin] = 0;
+    }
+    MaskClear(scanMask, i);
+    MaskClear(armedMask, i);
+    __atomic_fetch_and(&resyncMask[i >> 5], ~(1UL << (i & 31U)), __ATOMIC_RELAXED);
+    MaskSet(pollMask, i);
+}
+
+// Scan time (us since the first scan, wraps after 71 minutes) of the last BUTTON_ScanTick,
+// on the TIMING clock
+uint32_t BUTTON_ScanTimeUs(void) {
+    return scanUs;
+}
+
+// Scan time of the last debounced edge of a timer-scanned button (its first sample at
+// the new level), as known to its handler; 0 for another button
+uint32_t BUTTON_EdgeTimeUs(const Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(scanMask, i)) return 0;
+    ScanPort* sp = BUTTON_ScanPort(btn);
+    return sp ? sp->EdgeUs[PinIndex(btn->Config->GPIO_Pin)] : 0U;
+}
+
+// ========== Adaptive debounce ==========
+
+// Learn the bounce of the switch and debounce for that plus BUTTON_ADAPT_MARGIN, DebounceTime
+// at most (polled, edge-driven and external buttons; the others debounce by scans).
+// HAL_ERROR when the BUTTON_ADAPT_MAX entries are taken
+HAL_StatusTypeDef BUTTON_SetAdaptive(Button_t* btn, uint8_t enable) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || MaskTest(batchMask, i) || MaskTest(scanMask, i)) return HAL_ERROR;
+
+    if (!enable) {
+        BUTTON_AdaptRelease(i);
+        return HAL_OK;
+    }
+    if (MaskTest(adaptMask, i)) return HAL_OK;
+
+#if BUTTON_ADAPT_MAX > 0
+    uint16_t e = 0;
+    while (e < BUTTON_ADAPT_MAX && MaskTest(adaptUsed, e)) e++;
+    if (e == BUTTON_ADAPT_MAX) return HAL_ERROR;
+    MaskSet(adaptUsed, e);
+    adaptEntry[i] = (uint8_t)(e + 1U);
+
+    // Starts from the full window, shrinks as short bounces are measured
+    uint32_t limit = btn->Config->DebounceTime;
+    uint32_t bounce = (limit > BUTTON_ADAPT_MARGIN) ? limit - BUTTON_ADAPT_MARGIN : 0U;
+    if (bounce > 4095U) bounce = 4095U;
+    Adapt* a = AdaptOf(i);
+    *a = (Adapt){ .Bounce = (uint16_t)(bounce * 16U), .Level = btn->State != BUTTON_STATE_START };
+    a->LastChange = HAL_GetTick() - 0x80000000U;    // the next change starts a burst
+    MaskSet(adaptMask, i);
+    return HAL_OK;
+#else
+    return HAL_ERROR;
+#endif
+}
+
+// What the adaptive debounce learned so far; HAL_ERROR when it is not on
+HAL_StatusTypeDef BUTTON_GetAdaptive(const Button_t* btn, ButtonAdaptive_t* info) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || info == NULL || !MaskTest(adaptMask, i)) return HAL_ERROR;
+
+    const Adapt* a = AdaptOf(i);
+    info->Window = (uint16_t)AdaptWindow(i);
+    info->Bounce = (uint16_t)((a->Bounce + 15U) / 16U);
+    info->LastBounce = a->LastBounce;
+    info->LastEdges = a->Edges;
+    info->Glitches = a->Glitches;
+    return HAL_OK;
+}
+
+// ========== Externally sampled buttons ==========
+
+// The level now comes from BUTTON_SetLevel (key matrix, shift register, ADC ladder...)
+HAL_StatusTypeDef BUTTON_EnableExternal(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || MaskTest(irqMask, i) || MaskTest(batchMask, i) || MaskTest(scanMask, i)) return HAL_ERROR;
+
+    MaskSet(extMask, i);
+    MaskClear(pollMask, i);
+    BUTTON_Arm(i);
+    return HAL_OK;
+}
+
+// Back to polling; a button without a pin (BUTTON_InitExternal) has nothing to poll and stays external
+void BUTTON_DisableExternal(Button_t* btn) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(extMask, i) || btn->Config->GPIOx == NULL) return;
+
+    MaskClear(extMask, i);
+    MaskClear(armedMask, i);
+    MaskSet(pollMask, i);
+}
+
+// New pressed (1) / released (0) level of an external button, known now. Handlers
+// run from the caller: call it from the main loop, not from an ISR
+void BUTTON_SetLevel(Button_t* btn, uint8_t level) {
+    uint16_t i = BUTTON_Index(btn);
+    if (i >= BUTTON_MAX || !MaskTest(extMask, i)) return;
+
+    updating++;
+    BUTTON_Apply(i, level ? 1U : 0U, HAL_GetTick());
+    BUTTON_EndUpdate();
+}
+
+// ========== Update ==========
+
+// Update the state of all buttons
+void BUTTON_Update(void) {
+    uint8_t batched = MaskAny(batchMask);
+    uint8_t polled = MaskAny(pollMask);
+    if (!polled && !batched && !MaskAny(armedMask) && BUTTON_IrqIdle()) return;  // edge-driven only, nothing happened
+
+    TRACE_ENTER(TRACE_ID_BUTTON_UPDATE, buttonCount);
+    uint32_t now = HAL_GetTick(); // Get the current time in milliseconds
+    updating++;
+
+    // Bits are re-checked on the live masks: a handler may release any button
+    for (uint16_t w = 0; polled && w < MASK_WORDS; ++w) {
+        for (uint32_t bits = pollMask[w]; bits; bits &= bits - 1U) {
+            uint16_t i = (uint16_t)(w * 32U + __builtin_ctz(bits));
+            if (!MaskTest(pollMask, i)) continue;
+            Button_t* btn = &buttonPool[i];
+            uint8_t level = BUTTON_Read(btn);
+            if (!level && btn->State == BUTTON_STATE_START && !btn->FirstClickDone) continue;  // idle: state only
+            BUTTON_Step(btn, level, now);
+        }
+    }
+    if (MaskAny(irqMask) || MaskAny(scanMask)) BUTTON_UpdateIrq(now);
+    if (batched && (int32_t)(now - nextScan) >= 0) {
+        BUTTON_Scan(now);
+        nextScan += BUTTON_BATCH_SCAN_MS;
+        if ((int32_t)(now - nextScan) >= 0) nextScan = now + BUTTON_BATCH_SCAN_MS;   // late: no burst of scans
+    }
+
+    // Timers of the buttons that are not sampled
+    for (uint16_t w = 0; w < MASK_WORDS; ++w) {
+        for (uint32_t bits = armedMask[w]; bits; bits &= bits - 1U) {
+            uint16_t i = (uint16_t)(w * 32U + __builtin_ctz(bits));
+            if (!MaskTest(armedMask, i)) continue;
+            BUTTON_CatchUp(&buttonPool[i], now);
+            BUTTON_Arm(i);
+        }
+    }
+
+    BUTTON_EndUpdate();
+    TRACE_EXIT(TRACE_ID_BUTTON_UPDATE, buttonCount);
+}
  
+// Milliseconds until BUTTON_Update must run again: the nearest debounce end, repeat
+// or double-click expiry, at most BUTTON_POLL_MS while a polled button is released
+// and the next batched scan (BUTTON_FOREVER when all buttons are edge driven and idle)
+uint32_t BUTTON_NextUpdate(void) {
+    uint32_t now = HAL_GetTick();
+    uint32_t next = MaskAny(pollMask) ? BUTTON_POLL_MS : BUTTON_FOREVER;
+
+    if ((MaskAny(irqMask) || MaskAny(scanMask)) && !BUTTON_IrqIdle()) return 0;
+    if (MaskAny(batchMask)) {
+        if ((int32_t)(nextScan - now) <= 0) return 0;
+        if (nextScan - now < next) next = nextScan - now;
+    }
+
+    for (uint16_t w = 0; w < MASK_WORDS; ++w) {
+        for (uint32_t bits = pollMask[w] | armedMask[w]; bits; bits &= bits - 1U) {
+            uint32_t at;
+            if (!BUTTON_Deadline(&buttonPool[w * 32U + __builtin_ctz(bits)], &at)) continue;
+            if ((int32_t)(at - now) <= 0) return 0;
+            if (at - now < next) next = at - now;
+        }
+    }
+    return next;
+}
 
 // Default callback for button presses
 __weak void BUTTON_Callback(Button_t* btn, ButtonPressType_t type) {
@@ -350,5 +1373,170 @@ while (1)
 
 
 
-*/
+================================= Example for EDGE-DRIVEN buttons =========================================
 
+
+# 1. Pin as EXTI on both edges (CubeMX: GPIO_EXTIx, pull-up, NVIC line enabled)
+
+	GPIO_InitTypeDef it = { .Pin = GPIO_PIN_0, .Mode = GPIO_MODE_IT_RISING_FALLING, .Pull = GPIO_PULLUP };
+	HAL_GPIO_Init(GPIOA, &it);
+	Button_t* btn3 = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Toggle_ButtonHandler1);
+	BUTTON_EnableIrq(btn3);
+
+
+# 2. Hand the EXTI interrupts to the driver (or build with BUTTON_HAL_CALLBACKS=1)
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+	BUTTON_EXTI_Callback(GPIO_Pin);
+	SCHED_Notify(&buttonTask);			// with the scheduler: run the button task now
+}
+
+
+# 3. Update as before: a slow loop no longer misses short presses. With the scheduler,
+#    BUTTON_FOREVER means no timer is running: the task waits for the SCHED_Notify of an edge
+
+void ButtonTask(SCHED_Task* task) {
+	BUTTON_Update();
+	SCHED_Reschedule(task, BUTTON_NextUpdate());
+}
+
+
+
+================================= Example for PORT-BATCHED buttons =========================================
+
+
+# 1. Many buttons (BUTTON_MAX raised in the project symbols, e.g. BUTTON_MAX=64)
+
+	for (uint8_t pin = 0; pin < 16; pin++) {
+		Button_t* key = BUTTON_Init(GPIOB, 1U << pin, 0, BUTTON_Mode_Toggle, Key_Handler);
+		BUTTON_EnableBatch(key);			// GPIOB read once per scan for all 16
+	}
+
+
+# 2. Update as before, at least every BUTTON_BATCH_SCAN_MS (debounce = 4 scans)
+
+while (1)
+{
+	BUTTON_Update();
+}
+
+
+
+================================= Example for TIMER-SCANNED buttons =========================================
+
+
+# 1. A timer at the scan rate (CubeMX: TIM2, PSC 71, ARR 249 -> 4 kHz at 72 MHz, update interrupt on)
+
+	HAL_TIM_Base_Start_IT(&htim2);
+	Button_t* btn4 = BUTTON_Init(GPIOA, GPIO_PIN_1, 0, BUTTON_Mode_Toggle, Toggle_ButtonHandler1);
+	Set_DebounceTime(btn4, 20);
+	BUTTON_EnableScan(btn4);			// debounced in the ISR: 20 ms stable, to the scan period
+
+
+# 2. Scan from the timer interrupt (the edge times come from the DWT, any rate works)
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim) {
+	if (htim == &htim2) BUTTON_ScanTick();
+}
+
+
+# 3. Update as before; the edge times no longer depend on the loop
+
+void Toggle_ButtonHandler1(Button_t* btn, ButtonPressType_t type) {
+	uint32_t us = BUTTON_EdgeTimeUs(btn);			// scan time of the release
+	...
+}
+
+
+
+================================= Example for ADAPTIVE DEBOUNCE =========================================
+
+
+# 1. Keep DebounceTime as the worst case (50 ms by default): the window starts there and
+#    shrinks to the bounce of this switch plus BUTTON_ADAPT_MARGIN after a few presses
+
+	Button_t* btn5 = BUTTON_Init(GPIOA, GPIO_PIN_2, 0, BUTTON_Mode_Toggle, Toggle_ButtonHandler1);
+	BUTTON_SetAdaptive(btn5, 1);
+
+
+# 2. What was learned, e.g. for a maintenance screen
+
+	ButtonAdaptive_t info;
+	if (BUTTON_GetAdaptive(btn5, &info) == HAL_OK) {
+		printf("window %u ms, bounce %u ms, %u glitches\r\n", info.Window, info.Bounce, info.Glitches);
+	}
+
+
+
+================================= Example for IMMEDIATE EVENTS =========================================
+
+
+# 1. Toggle mode, events as soon as they are known
+
+	Button_t* btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Fast_Handler);
+	SetTime_Toggle_mode(btn, 250, 300, 1000, 3000);
+	BUTTON_SetImmediate(btn, 1);
+
+
+# 2. Show the click at once, undo it if it turns into a double-click
+
+void Fast_Handler(Button_t* btn, ButtonPressType_t type) {
+	switch (type) {
+		case BUTTON_PressType_Provisional: HighlightItem(); break;	// at release
+		case BUTTON_PressType_OnPressed:
+		case BUTTON_PressType_Normal: SelectItem(); break;			// confirmed, window closed
+		case BUTTON_PressType_Double: OpenItem(); break;			// upgrade
+		case BUTTON_PressType_Long: ShowMenu(); break;				// still held, at 1000 ms
+		case BUTTON_PressType_VeryLong: FactoryReset(); break;		// still held, at 3000 ms
+		default: break;
+	}
+}
+
+
+
+================================= Example for BUTTON HANDLES =========================================
+
+
+# 1. Keep a handle where the button may be released meanwhile (menus, hot-plug)
+
+static ButtonHandle_t okKey;
+
+	okKey = BUTTON_GetHandle(BUTTON_Init(GPIOA, GPIO_PIN_4, 0, BUTTON_Mode_Toggle, Ok_Handler));
+
+
+# 2. Resolve it before use: NULL once released, even if the slot holds a new button
+
+	Button_t* key = BUTTON_FromHandle(okKey);
+	if (key) SetTime_Toggle_mode(key, 200, 300, 1000, 3000);
+
+
+# 3. A handler may release buttons, its own included
+
+void Ok_Handler(Button_t* btn, ButtonPressType_t type) {
+	if (type == BUTTON_PressType_Long) BUTTON_Deinit(btn);	// slot reused after this BUTTON_Update
+}
+
+
+
+================================= Example for CONFIGURATION IN FLASH =========================================
+
+
+# 1. Configurations in a const table (flash), BUTTON_RAM_CONFIGS=0 if no button uses BUTTON_Init
+
+static const ButtonConfig_t keyTable[] = {
+	{ .GPIOx = GPIOA, .GPIO_Pin = GPIO_PIN_0, .ActiveState = 0, .Mode = BUTTON_Mode_Toggle, .DebounceTime = 30,
+	  .NormalTime = 300, .LongTime = 1000, .VeryLongTime = 3000, .DoubleClickTime = 250, .Handler = Menu_Handler },
+	{ .GPIOx = GPIOA, .GPIO_Pin = GPIO_PIN_1, .ActiveState = 0, .Mode = BUTTON_Mode_Hold, .DebounceTime = 30,
+	  .RepeatDelay = 500, .RepeatInterval = 100, .Handler = Volume_Handler },
+};
+
+
+# 2. Only the 16-byte states take RAM
+
+	for (uint8_t k = 0; k < sizeof(keyTable) / sizeof(keyTable[0]); k++) {
+		BUTTON_InitConst(&keyTable[k]);		// Set_DebounceTime, SetTime_* ... do not apply
+	}
+
+
+
+*/
@@ -7,6 +7,84 @@
  * 
  * This file provides functions for initializing, managing, and updating button states.
  * Supports debounce, toggle, and hold modes. 
+ *
+ * A button is split in two: its configuration (ButtonConfig_t: pin, mode, times,
+ * handler), only read by the driver, and its state (Button_t, 16 bytes on target),
+ * kept in one packed array walked in order by BUTTON_Update. The state holds what a
+ * poll needs (port slot, pin, active level), so an idle scan does not touch the
+ * configurations. Polled buttons span at most 8 ports. BUTTON_Init takes the
+ * configuration from a RAM pool of BUTTON_RAM_CONFIGS entries so the Set* functions
+ * can change it; BUTTON_InitConst takes a const ButtonConfig_t the linker places in
+ * flash, and costs only the state in RAM. The Set* functions leave such a button
+ * unchanged. With all buttons declared const, BUTTON_RAM_CONFIGS=0 drops the pool.
+ *
+ * Buttons live in a pool of BUTTON_MAX fixed slots: BUTTON_Init and BUTTON_Deinit are
+ * O(1) (free list) and never move another button, so a Button_t* stays valid until
+ * its own Deinit. A ButtonHandle_t also carries the generation of its slot:
+ * BUTTON_FromHandle returns NULL once the button is released, even if the slot
+ * was reused since. BUTTON_Deinit may be called from a button handler, for any
+ * button: the slot is recycled after the running BUTTON_Update (or BUTTON_SetLevel).
+ *
+ * Edge-driven buttons (BUTTON_EnableIrq): the pin is configured as EXTI on both
+ * edges and BUTTON_EXTI_Callback, called from HAL_GPIO_EXTI_Callback, stamps each
+ * edge with HAL_GetTick into a lock-free ring. BUTTON_Update then reads no pin: it
+ * replays the edges at their own time and only runs the timers (debounce, repeat,
+ * double-click) of the buttons that have one running. A press shorter than the loop
+ * period is not missed, and an idle BUTTON_Update costs a few loads.
+ * - One EXTI line per pin number: PA0 and PB0 cannot both be edge driven.
+ * - Ring full: the edge is dropped and counted (BUTTON_EdgesLost), the button is
+ *   sampled once at the next BUTTON_Update.
+ * - BUTTON_HAL_CALLBACKS=1 lets this driver define HAL_GPIO_EXTI_Callback itself;
+ *   default 0 because applications usually own it for other EXTI lines.
+ *
+ * Port-batched buttons (BUTTON_EnableBatch): every BUTTON_BATCH_SCAN_MS, BUTTON_Update
+ * reads the IDR of each port once and debounces its 16 pins together with vertical
+ * counters (a pin flips after 4 scans in a row that disagree with its state). Only
+ * the buttons whose debounced level flipped, or that have a timer running, reach the
+ * press classification, so a scan costs the same for 10 buttons or a few hundred.
+ * - Debounce is done by the counters: BUTTON_EnableBatch sets DebounceTime to 0
+ *   (a const configuration keeps its own, declare it 0).
+ * - Several buttons may share a pin (same active level).
+ *
+ * Timer-scanned buttons (BUTTON_EnableScan): BUTTON_ScanTick, called by the application
+ * from a timer interrupt at a fixed rate (2-5 kHz), reads each port once and debounces
+ * in the interrupt: a pin flips once it has disagreed with its state for DebounceTime,
+ * whatever the load of the main loop. Only the debounced edges reach the ring, stamped
+ * with the scan time of their first sample (us, BUTTON_EdgeTimeUs) and the HAL tick
+ * read by that same scan; BUTTON_Update classifies them like EXTI edges.
+ * - The scan time is read from the TIMING service (DWT cycle counter) by each tick:
+ *   it follows the hardware whatever the timer period, ISR latency included.
+ * - One timer-scanned button per pin. Enable and Disable from thread context.
+ *
+ * Adaptive debounce (BUTTON_SetAdaptive): the level changes of a button less than a
+ * window apart make a burst (a press or a release and its bounce); the time from its
+ * first to its last change is the settle time of that switch. The debounce window
+ * becomes the learned settle time plus BUTTON_ADAPT_MARGIN, DebounceTime at most: a
+ * longer settle is learned at once (worn contacts), a shorter one a fraction per press.
+ * A window that ends released alone in its burst is a rejected glitch; the learned
+ * values and the glitch count are read with BUTTON_GetAdaptive.
+ * - Starts from DebounceTime and shrinks press after press.
+ * - At most BUTTON_ADAPT_MAX adaptive buttons at once, their state in a pool of its own.
+ * - A press is reported at the end of its window but its burst stays open until
+ *   DebounceTime: a longer bounce is learned there, the press is not released by it.
+ *   A press within DebounceTime of the last change (the bounce of a release) waits
+ *   the full DebounceTime. A switch bouncing less than DebounceTime is one press.
+ * - Polled, edge-driven and external buttons; with a loop slower than the bounce the
+ *   polls see no edge and the window shrinks to the margin (the polls debounce).
+ *
+ * Externally sampled buttons (BUTTON_EnableExternal): another driver samples and
+ * debounces the key (KEYPAD matrix, shift register...) and pushes each level change
+ * with BUTTON_SetLevel; BUTTON_Update only runs the timers of the classification.
+ * A key with no pin of its own (ADC ladder, shift register) is made with
+ * BUTTON_InitExternal: external from the start, it takes no port slot and
+ * BUTTON_DisableExternal / EnableIrq / EnableBatch / EnableScan refuse it.
+ *
+ * Immediate events (BUTTON_SetImmediate, Toggle mode): Long and VeryLong fire while
+ * the button is still held, the moment the hold crosses LongTime and VeryLongTime
+ * (both fire on a very long hold, nothing more at release). A shorter press is
+ * classified by its own duration and reported at release: at once when DoubleClickTime
+ * is 0, otherwise as BUTTON_PressType_Provisional followed, when the window closes, by
+ * its Normal / OnPressed confirmation, or by Double if a second click comes in time.
  */
 
 
@@ -17,7 +95,63 @@
 #include "stm32f1xx_hal.h"
 #include <stdint.h>
 
+// Slots of the button pool. Up to a few hundred: per-update work scales with the
+// words of a button bitmap
+#ifndef BUTTON_MAX
 #define BUTTON_MAX 10
+#endif
+
+// Sampling period of released buttons when BUTTON_Update runs from a scheduler
+#ifndef BUTTON_POLL_MS
+#define BUTTON_POLL_MS 10
+#endif
+
+// Edges waiting for BUTTON_Update (power of two), 16 bytes each
+#ifndef BUTTON_EDGE_QUEUE
+#define BUTTON_EDGE_QUEUE 32
+#endif
+
+#ifndef BUTTON_HAL_CALLBACKS
+#define BUTTON_HAL_CALLBACKS 0
+#endif
+
+// Configurations in RAM, one per button made by BUTTON_Init (28 bytes each on target);
+// buttons made by BUTTON_InitConst do not use one
+#ifndef BUTTON_RAM_CONFIGS
+#define BUTTON_RAM_CONFIGS BUTTON_MAX
+#endif
+
+// Port-batched scan: period and ports (debounce = 4 scans, 15-20 ms by default)
+#ifndef BUTTON_BATCH_SCAN_MS
+#define BUTTON_BATCH_SCAN_MS 5
+#endif
+
+#ifndef BUTTON_BATCH_PORTS
+#define BUTTON_BATCH_PORTS 4
+#endif
+
+// Timer scan: ports with scanned buttons
+#ifndef BUTTON_SCAN_PORTS
+#define BUTTON_SCAN_PORTS 2
+#endif
+
+// Adaptive debounce: ms added to the learned bounce, and how fast a shorter bounce is
+// learned (1/2^SHIFT of the difference per press)
+#ifndef BUTTON_ADAPT_MARGIN
+#define BUTTON_ADAPT_MARGIN 2
+#endif
+
+#ifndef BUTTON_ADAPT_SHIFT
+#define BUTTON_ADAPT_SHIFT 3
+#endif
+
+// Adaptive debounce: buttons that can have it at once (16 bytes each on target); 0 leaves it out
+#ifndef BUTTON_ADAPT_MAX
+#define BUTTON_ADAPT_MAX 4
+#endif
+
+// BUTTON_NextUpdate: only edge-driven buttons, all idle, nothing to do until an edge
+#define BUTTON_FOREVER 0xFFFFFFFFU
 
 typedef enum {
     BUTTON_Mode_Toggle = 0,
@@ -31,7 +165,8 @@ typedef enum {
     BUTTON_PressType_VeryLong,
     BUTTON_PressType_Double,
     BUTTON_PressType_Repeat,
-    BUTTON_PressType_RepeatOnce
+    BUTTON_PressType_RepeatOnce,
+    BUTTON_PressType_Provisional    // immediate mode: a click, Double may still follow
 } ButtonPressType_t;
 
 typedef enum {
@@ -40,20 +175,14 @@ typedef enum {
     BUTTON_STATE_PRESSED
 } ButtonState_t;
 
-typedef struct Button_s {
+struct Button_s;
+
+// Cold part of a button: read-only for the driver, may be a const table in flash
+typedef struct {
     GPIO_TypeDef* GPIOx;
     uint16_t GPIO_Pin;
-    uint8_t ActiveState;
-
-    ButtonState_t State;
-    uint8_t LastStatus;
-
-    ButtonMode_t Mode;
-
-    uint32_t StartTime;
-    uint32_t LastPressDuration;
-    uint32_t FirstClickReleaseTime;
-    uint8_t FirstClickDone;
+    uint8_t ActiveState;        // 0 = pull-up (pressed low), 1 = pull-down
+    uint8_t Mode;               // ButtonMode_t
     uint16_t DebounceTime;
 
     // Toggle mode
@@ -61,25 +190,110 @@ typedef struct Button_s {
     uint16_t LongTime;
     uint16_t VeryLongTime;
     uint16_t DoubleClickTime;
+    uint8_t Immediate;          // BUTTON_SetImmediate
 
     // Hold mode
     uint16_t RepeatDelay;
     uint16_t RepeatInterval;
-    uint32_t LastRepeatTime;
-    uint8_t RepeatStarted;
 
-    void (*Handler)(struct Button_s*, ButtonPressType_t);
+    void (*Handler)(struct Button_s*, ButtonPressType_t);   // not NULL
+} ButtonConfig_t;
+
+// Hot part of a button: what BUTTON_Update writes
+typedef struct Button_s {
+    const ButtonConfig_t* Config;
+    uint32_t StartTime;
+    union {
+        uint32_t FirstClickReleaseTime;     // Toggle mode
+        uint32_t LastRepeatTime;            // Hold mode
+    };
+    uint16_t LastPressDuration;             // ms, saturated at 65535
+    uint8_t Input;                          // polled read: port slot << 5 | ActiveState << 4 | pin
+    uint8_t State : 2;                      // ButtonState_t
+    uint8_t LastStatus : 1;
+    uint8_t FirstClickDone : 1;
+    uint8_t RepeatStarted : 1;
+    uint8_t HoldReported : 2;               // immediate mode: 1 = Long fired, 2 = VeryLong fired
 } Button_t;
 
+// What the adaptive debounce of a button learned
+typedef struct {
+    uint16_t Window;        // ms, debounce applied to the next press
+    uint16_t Bounce;        // ms, learned settle time
+    uint16_t LastBounce;    // ms, settle time of the last press or release measured
+    uint8_t LastEdges;      // level changes seen in the last window, the press included
+    uint16_t Glitches;      // windows that ended released, not after a release
+} ButtonAdaptive_t;
+
+// Pool slot + generation of a button; 0 = none
+typedef uint32_t ButtonHandle_t;
+
+// Vertical 2-bit debounce counters, one lane per input of a sample of up to 32 (batched
+// port, KEYPAD row, HC165 chain): 11 = stable, 00 -> 11 = 4th sample in a row that differs
+typedef struct {
+    uint32_t Cnt0, Cnt1;
+} ButtonCounter_t;
+
+// Counters at "no change seen": an input flips after 4 samples
+#define BUTTON_COUNTER_INIT ((ButtonCounter_t){ 0xFFFFFFFFU, 0xFFFFFFFFU })
+
+// One sample: 'delta' = sample ^ debounced state. The counter of an input restarts while
+// it agrees with the state; returns the inputs whose state flips (their 4th change)
+static inline uint32_t BUTTON_CounterStep(ButtonCounter_t* c, uint32_t delta) {
+    c->Cnt0 = ~(c->Cnt0 & delta);
+    c->Cnt1 = c->Cnt0 ^ (c->Cnt1 & delta);
+    return delta & c->Cnt0 & c->Cnt1;
+}
+
+// Inputs 'mask' start again from "no change seen"
+static inline void BUTTON_CounterReset(ButtonCounter_t* c, uint32_t mask) {
+    c->Cnt0 |= mask;
+    c->Cnt1 |= mask;
+}
+
 Button_t* BUTTON_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint8_t ActiveState,
                       ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t));
+Button_t* BUTTON_InitConst(const ButtonConfig_t* config);
 void BUTTON_Deinit(Button_t* btn);
+ButtonHandle_t BUTTON_GetHandle(const Button_t* btn);
+Button_t* BUTTON_FromHandle(ButtonHandle_t handle);
 void BUTTON_Update(void);
+uint32_t BUTTON_NextUpdate(void);
+
+// Edge-driven buttons (pin configured by the application as GPIO_MODE_IT_RISING_FALLING)
+HAL_StatusTypeDef BUTTON_EnableIrq(Button_t* btn);
+void BUTTON_DisableIrq(Button_t* btn);
+void BUTTON_EXTI_Callback(uint16_t GPIO_Pin);
+uint32_t BUTTON_EdgesLost(void);
+
+// Port-batched buttons (one IDR read per port and scan)
+HAL_StatusTypeDef BUTTON_EnableBatch(Button_t* btn);
+void BUTTON_DisableBatch(Button_t* btn);
+
+// Timer-scanned buttons (BUTTON_ScanTick from a timer ISR, debounce in the ISR)
+HAL_StatusTypeDef BUTTON_EnableScan(Button_t* btn);
+void BUTTON_DisableScan(Button_t* btn);
+void BUTTON_ScanTick(void);
+uint32_t BUTTON_ScanTimeUs(void);
+uint32_t BUTTON_EdgeTimeUs(const Button_t* btn);
+
+// Adaptive debounce (learned per switch, DebounceTime at most)
+HAL_StatusTypeDef BUTTON_SetAdaptive(Button_t* btn, uint8_t enable);
+HAL_StatusTypeDef BUTTON_GetAdaptive(const Button_t* btn, ButtonAdaptive_t* info);
+
+// Externally sampled buttons (level pushed by another driver, timers run in BUTTON_Update)
+Button_t* BUTTON_InitExternal(ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t));
+HAL_StatusTypeDef BUTTON_EnableExternal(Button_t* btn);
+void BUTTON_DisableExternal(Button_t* btn);
+void BUTTON_SetLevel(Button_t* btn, uint8_t level);
 
 
-void Set_DebounceTime(Button_t* btn, uint8_t debounceTime);
+void Set_DebounceTime(Button_t* btn, uint16_t debounceTime);
 void SetTime_Hold_mode(Button_t* btn, uint16_t delay, uint16_t interval);
 void SetTime_Toggle_mode(Button_t* btn, uint16_t time4Double, uint16_t normal, uint16_t longer, uint16_t very_long);
+void BUTTON_SetImmediate(Button_t* btn, uint8_t enable);
+void BUTTON_SetHandler(Button_t* btn, void (*Handler)(Button_t*, ButtonPressType_t));
+void BUTTON_SetEdgeHook(void (*hook)(Button_t* btn, uint8_t pressed, uint32_t tick));
 
 __weak void BUTTON_Callback(Button_t* btn, ButtonPressType_t type);
 
@@ -8,6 +8,8 @@
  * Functions:
  * - DHT22_Init: Initializes the sensor with the specified GPIO pin.
  * - DHT22_Read: Reads temperature and humidity values from the sensor.
+ * - DHT22_ReadInt: Same read, values in tenths of degC / %RH (no float).
+ * - DHT22_NextReadIn: Milliseconds until the next read is allowed.
  * - DHT22_GetTemperature: Returns the last read temperature.
  * - DHT22_GetHumidity: Returns the last read humidity.
  * 
@@ -18,8 +20,14 @@
  * 
 * Notes:
  * - DHT22 requires a delay of at least 2 seconds between reads.
+ * - Define DHT22_FAST_GPIO=1 to poll the line through IDR instead of HAL_GPIO_ReadPin.
+ * - The sensor already sends tenths: DHT22_ReadInt only assembles the bytes. Define
+ *   DHT22_NO_FLOAT=1 (or HAL_LIB_NO_FLOAT=1) to drop the float API on a core without FPU.
  * - Reading may fail due to timing issues or sensor errors; always check return status.
- *** - If hardware timer is not properly initialized, the sensor may return invalid data or cause runtime errors.
+ * - Every wait on the line is bounded in microseconds, not loop iterations: a read never
+ *   blocks longer than DHT22_READ_MAX_US (~11 ms), whatever the core clock or GPIO path.
+ *** - Microsecond delays come from the TIMING service (DWT cycle counter). The timer passed to
+ ***   DHT22_Init (1 tick = 1 us) is only used as fallback time base when the DWT is not available.
 
 
 	========================================================================================================
@@ -28,15 +36,19 @@
 
 
 #include "DHT22.h"
+#include "TIMING.h"
+#include "TRACE.h"
+#include "EVBUS.h"
 
-// Pointer to timer handler used for microsecond delay
-static TIM_HandleTypeDef* _dhtTim;
+#define delay_us(us)  TIMING_DelayUs(us)
 
-// Delay function in microseconds using hardware timer
-static void delay_us(uint16_t us) {
-    __HAL_TIM_SET_COUNTER(_dhtTim, 0);
-    while (__HAL_TIM_GET_COUNTER(_dhtTim) < us);
-}
+#if DHT22_FAST_GPIO
+#define DHT_READ(dht)         GPIO_FAST_Read(&(dht)->pin)
+#define DHT_WRITE(dht, lvl)   GPIO_FAST_Write(&(dht)->pin, (lvl))
+#else
+#define DHT_READ(dht)         HAL_GPIO_ReadPin((dht)->GPIOx, (dht)->GPIO_Pin)
+#define DHT_WRITE(dht, lvl)   HAL_GPIO_WritePin((dht)->GPIOx, (dht)->GPIO_Pin, (lvl) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+#endif
 
 // Configure the GPIO pin as output (push-pull)
 static void Set_Pin_Output(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
@@ -58,95 +70,133 @@ static void Set_Pin_Input(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
 
 // Initialize the DHT22 sensor and associated GPIO and Timer
 DHT22_HandleTypedef DHT22_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TIM_HandleTypeDef* htim) {
-    _dhtTim = htim;
-    HAL_TIM_Base_Start(htim); // Start the hardware timer
+    // Shared time base: DWT when it runs, else the 1 MHz timer given by the caller
+    if (TIMING_GetSource() == TIMING_SOURCE_NONE && TIMING_Init() != HAL_OK && htim != NULL) {
+        TIMING_InitTim(htim, 1000000U);
+    }
 
     DHT22_HandleTypedef dht;
     dht.GPIOx = GPIOx;
     dht.GPIO_Pin = GPIO_Pin;
-    dht.lastReadTick = HAL_GetTick() - 2000;  // Allow immediate reading
+    dht.lastReadTick = HAL_GetTick() - DHT22_MIN_INTERVAL_MS;  // Allow immediate reading
+    dht.timeouts = 0;
+#if DHT22_FAST_GPIO
+    GPIO_FAST_Init(&dht.pin, GPIOx, GPIO_Pin);
+#endif
     return dht;
 }
 
-// Read a single bit from DHT22 data line
-static uint8_t DHT22_ReadBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
-    uint32_t timeout = 0;
+// Wait while the line stays at 'level'; 0 if it is still there after 'us'
+static uint8_t DHT22_WaitWhile(const DHT22_HandleTypedef* dht, uint8_t level, uint32_t us) {
+    TIMING_Deadline deadline;
+    TIMING_DeadlineUs(&deadline, us);
+    while ((DHT_READ(dht) ? 1U : 0U) == level) {
+        if (TIMING_DeadlineExpired(&deadline)) return 0;
+    }
+    return 1;
+}
 
+// Read a single bit from DHT22 data line; -1 when the line stops moving
+static int8_t DHT22_ReadBit(const DHT22_HandleTypedef* dht) {
     // Wait for pin to go HIGH (start of bit)
-    while (!HAL_GPIO_ReadPin(GPIOx, GPIO_Pin)) {
-        if (++timeout > 10000) return 0;
-    }
+    if (!DHT22_WaitWhile(dht, 0, DHT22_BIT_TIMEOUT_US)) return -1;
 
     // Delay 40us then read the level (1 or 0)
     delay_us(40);
-    uint8_t bit = HAL_GPIO_ReadPin(GPIOx, GPIO_Pin);
+    uint8_t bit = DHT_READ(dht);
 
     // Wait until pin goes LOW (end of bit)
-    timeout = 0;
-    while (HAL_GPIO_ReadPin(GPIOx, GPIO_Pin)) {
-        if (++timeout > 10000) break;
-    }
+    if (!DHT22_WaitWhile(dht, 1, DHT22_BIT_TIMEOUT_US)) return -1;
 
     return bit;
 }
 
-// Read a byte (8 bits) from the DHT22
-static uint8_t DHT22_ReadByte(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+// Read a byte (8 bits) from the DHT22; -1 on a bit timeout
+static int16_t DHT22_ReadByte(const DHT22_HandleTypedef* dht) {
     uint8_t byte = 0;
     for (int i = 0; i < 8; i++) {
-        byte <<= 1;
-        byte |= DHT22_ReadBit(GPIOx, GPIO_Pin);
+        int8_t bit = DHT22_ReadBit(dht);
+        if (bit < 0) return -1;
+        byte = (uint8_t)((byte << 1) | bit);
     }
     return byte;
 }
 
-// Read temperature and humidity from DHT22 sensor
-DHT22_StatusTypedef DHT22_Read(DHT22_HandleTypedef* dht, DHT22_DataTypedef* data) {
-    uint8_t bits[5] = {0};
-
+// One start signal + 40-bit frame; 'bytes' = bytes received before an error
+static DHT22_StatusTypedef DHT22_ReadFrame(DHT22_HandleTypedef* dht, uint8_t* bits, uint8_t* bytes) {
     // Enforce minimum interval between reads (2 seconds)
-    if (HAL_GetTick() - dht->lastReadTick < 2000) return DHT22_ERROR_INTERVAL;
+    if (DHT22_NextReadIn(dht) != 0) return DHT22_ERROR_INTERVAL;
     dht->lastReadTick = HAL_GetTick();
 
     // Send start signal
     Set_Pin_Output(dht->GPIOx, dht->GPIO_Pin);
-    HAL_GPIO_WritePin(dht->GPIOx, dht->GPIO_Pin, GPIO_PIN_RESET);
+    DHT_WRITE(dht, 0);
     delay_us(1000);  // Hold low for at least 1ms
-    HAL_GPIO_WritePin(dht->GPIOx, dht->GPIO_Pin, GPIO_PIN_SET);
+    DHT_WRITE(dht, 1);
     delay_us(30);    // Pull high briefly before switching to input
 
     // Wait for sensor response
     Set_Pin_Input(dht->GPIOx, dht->GPIO_Pin);
-    uint32_t timeout = 0;
 
-    // Wait for sensor to pull pin low
-    if (HAL_GPIO_ReadPin(dht->GPIOx, dht->GPIO_Pin)) return DHT22_ERROR_TIMEOUT;
-    while (!HAL_GPIO_ReadPin(dht->GPIOx, dht->GPIO_Pin)) {
-        if (++timeout > 10000) return DHT22_ERROR_TIMEOUT;
-    }
-
-    // Wait for sensor to pull pin high
-    timeout = 0;
-    while (HAL_GPIO_ReadPin(dht->GPIOx, dht->GPIO_Pin)) {
-        if (++timeout > 10000) return DHT22_ERROR_TIMEOUT;
-    }
+    // Sensor pulls the pin low, then high, 80 us each
+    if (DHT_READ(dht)) return DHT22_ERROR_TIMEOUT;
+    if (!DHT22_WaitWhile(dht, 0, DHT22_RESPONSE_TIMEOUT_US)) return DHT22_ERROR_TIMEOUT;
+    if (!DHT22_WaitWhile(dht, 1, DHT22_RESPONSE_TIMEOUT_US)) return DHT22_ERROR_TIMEOUT;
 
     // Read 5 bytes (40 bits) from sensor
     for (int i = 0; i < 5; i++) {
-        bits[i] = DHT22_ReadByte(dht->GPIOx, dht->GPIO_Pin);
+        int16_t byte = DHT22_ReadByte(dht);
+        if (byte < 0) return DHT22_ERROR_TIMEOUT;
+        bits[i] = (uint8_t)byte;
+        *bytes = (uint8_t)(i + 1);
     }
 
     // Verify checksum
     uint8_t sum = bits[0] + bits[1] + bits[2] + bits[3];
     if (sum != bits[4]) return DHT22_ERROR_CHECKSUM;
 
-    // Convert and store humidity and temperature
-    data->Humidity = ((bits[0] << 8) | bits[1]) / 10.0f;
-    data->Temperature = (((bits[2] & 0x7F) << 8) | bits[3]) / 10.0f;
-    if (bits[2] & 0x80) data->Temperature *= -1;
+    return DHT22_OK;
+}
+
+// Read temperature (0.1 degC) and humidity (0.1 %RH) from DHT22 sensor
+DHT22_StatusTypedef DHT22_ReadInt(DHT22_HandleTypedef* dht, DHT22_DataIntTypedef* data) {
+    uint8_t bits[5] = {0};
+    uint8_t bytes = 0;
+
+    TRACE_ENTER(TRACE_ID_DHT22_READ, 0);
+    DHT22_StatusTypedef status = DHT22_ReadFrame(dht, bits, &bytes);
+    if (status == DHT22_ERROR_TIMEOUT) dht->timeouts++;
+    if (status != DHT22_OK) TRACE_EVENT(TRACE_ID_DHT22_ERROR, (status << 8) | bytes);
+    TRACE_EXIT(TRACE_ID_DHT22_READ, status);
+    EVBUS_PUBLISH(EVBUS_EV_DHT22_READ, status, 0, dht);
+    if (status != DHT22_OK) return status;
+
+    // Sign + magnitude on the wire, tenths already
+    int16_t temperature = (int16_t)(((bits[2] & 0x7F) << 8) | bits[3]);
+    data->Humidity = (uint16_t)((bits[0] << 8) | bits[1]);
+    data->Temperature = (bits[2] & 0x80) ? -temperature : temperature;
+    return DHT22_OK;
+}
+
+#if !DHT22_NO_FLOAT
+// Read temperature and humidity from DHT22 sensor
+DHT22_StatusTypedef DHT22_Read(DHT22_HandleTypedef* dht, DHT22_DataTypedef* data) {
+    DHT22_DataIntTypedef raw;
+
+    DHT22_StatusTypedef status = DHT22_ReadInt(dht, &raw);
+    if (status != DHT22_OK) return status;
 
+    data->Humidity = raw.Humidity / 10.0f;
+    data->Temperature = raw.Temperature / 10.0f;
     return DHT22_OK;
 }
+#endif
+
+// Milliseconds left before DHT22_Read is allowed again (0 = now)
+uint32_t DHT22_NextReadIn(const DHT22_HandleTypedef* dht) {
+    uint32_t elapsed = HAL_GetTick() - dht->lastReadTick;
+    return (elapsed >= DHT22_MIN_INTERVAL_MS) ? 0 : DHT22_MIN_INTERVAL_MS - elapsed;
+}
 
 /*
 	====================================================================================
@@ -178,6 +228,13 @@ Example usage:
         // Use the temperature and humidity values
     }
 
+Integer read (no float, e.g. with HAL_LIB_NO_FLOAT=1):
+
+    DHT22_DataIntTypedef raw;
+    if (DHT22_ReadInt(&dht, &raw) == DHT22_OK) {
+        // raw.Temperature = 251 -> 25.1 degC, raw.Humidity = 652 -> 65.2 %RH
+    }
+
 */
 
 
@@ -20,6 +20,32 @@
 
 #include "stm32f1xx_hal.h"
 
+// 1 = sample / drive the data line through IDR / BSRR instead of HAL_GPIO_ReadPin / WritePin
+#ifndef DHT22_FAST_GPIO
+#define DHT22_FAST_GPIO 0
+#endif
+
+#if DHT22_FAST_GPIO
+#include "GPIO_FAST.h"
+#endif
+
+// 1 = no float API (DHT22_Read / DHT22_DataTypedef), DHT22_ReadInt only; follows HAL_LIB_NO_FLOAT
+#ifndef HAL_LIB_NO_FLOAT
+#define HAL_LIB_NO_FLOAT 0
+#endif
+#ifndef DHT22_NO_FLOAT
+#define DHT22_NO_FLOAT HAL_LIB_NO_FLOAT
+#endif
+
+#define DHT22_MIN_INTERVAL_MS 2000   // sensor needs 2 s between two reads
+
+// Longest the sensor may hold the line at one level (datasheet + margin, us)
+#define DHT22_RESPONSE_TIMEOUT_US 100   // response: 80 us low, 80 us high
+#define DHT22_BIT_TIMEOUT_US      100   // bit: 50 us low, 26-28 us (0) or 70 us (1) high
+
+// Worst case a read blocks: start signal, response, 40 bits (wait high, 40 us, wait low)
+#define DHT22_READ_MAX_US (1030U + 2U * DHT22_RESPONSE_TIMEOUT_US + 40U * (2U * DHT22_BIT_TIMEOUT_US + 40U))
+
 typedef enum {
     DHT22_OK,
     DHT22_ERROR_TIMEOUT,
@@ -31,14 +57,30 @@ typedef struct {
     GPIO_TypeDef* GPIOx;
     uint16_t GPIO_Pin;
     uint32_t lastReadTick;
+    uint32_t timeouts;      // reads that ended on DHT22_ERROR_TIMEOUT
+#if DHT22_FAST_GPIO
+    GPIO_FAST_Pin pin;
+#endif
 } DHT22_HandleTypedef;
 
+// Raw sensor units, no conversion at all
+typedef struct {
+    int16_t Temperature;    // 0.1 degC
+    uint16_t Humidity;      // 0.1 %RH
+} DHT22_DataIntTypedef;
+
+#if !DHT22_NO_FLOAT
 typedef struct {
     float Temperature;
     float Humidity;
 } DHT22_DataTypedef;
+#endif
 
 DHT22_HandleTypedef DHT22_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TIM_HandleTypeDef* htim);
+DHT22_StatusTypedef DHT22_ReadInt(DHT22_HandleTypedef* dht, DHT22_DataIntTypedef* data);
+#if !DHT22_NO_FLOAT
 DHT22_StatusTypedef DHT22_Read(DHT22_HandleTypedef* dht, DHT22_DataTypedef* data);
+#endif
+uint32_t DHT22_NextReadIn(const DHT22_HandleTypedef* dht);
 
 #endif
@@ -1,4 +1,15 @@
+/**
+ * @file DS_RTC.c
+ * @brief Driver for the Maxim/Dallas DS13xx / DS32xx I2C real-time clocks.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
 #include "DS_RTC.h"
+#include "EVBUS.h"
 
 // ========== Utility ==========
 
@@ -10,67 +21,46 @@ uint8_t DS_RTC_FromBCD(uint8_t bcd) {
     return ((bcd >> 4) * 10) + (bcd & 0x0F);
 }
 
-// ========== Init ==========
+// Seconds since 2000-01-01 00:00:00 (the chips count years 2000-2099)
+uint32_t DS_RTC_ToSeconds(const DS_RTC_Time *time) {
+    static const uint16_t daysBefore[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+    uint32_t years = (time->year >= 2000) ? time->year - 2000U : 0;
+    uint8_t month = (time->month >= 1 && time->month <= 12) ? time->month : 1;
+    uint32_t days = years * 365U + (years + 3U) / 4U + daysBefore[month - 1] + time->day - 1U;
+    if (month > 2 && (years % 4U) == 0) days++;     // 2000-2099: every 4th year is a leap year
+    return ((days * 24U + time->hours) * 60U + time->minutes) * 60U + time->seconds;
+}
 
-void DS_RTC_Init(DS_RTC_HandleTypeDef *rtc, I2C_HandleTypeDef *hi2c, DS_RTC_Model chip) {
-    rtc->hi2c = hi2c;
-    rtc->chip = chip;
-    rtc->i2c_addr = 0x68 << 1; // HAL expects 8-bit address
+// ========== Bus access ==========
 
-    // Reset flags
-    rtc->has_alarm = false;
-    rtc->has_temp  = false;
-    rtc->has_sram  = false; // Optional if supported
-    rtc->has_eeprom = false;
+// Register read/write: through the bus queue when attached, direct HAL call otherwise.
+// Either way bounded by the transfer budget, with retries and bus recovery.
+static HAL_StatusTypeDef DevRead(DS_RTC_HandleTypeDef *rtc, uint16_t dev, uint8_t reg, uint8_t *buf, uint16_t len) {
+    I2C_BUS_Transaction txn;
+    I2C_BUS_MemRead(&txn, dev, reg, buf, len, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Exec(rtc->bus, rtc->hi2c, &txn);
+}
 
-    switch (chip) {
-        case DS_RTC_DS1307:
-            rtc->has_sram = true;
-            break;
-
-        case DS_RTC_DS1338:
-        case DS_RTC_DS1340:
-            break;
-
-        case DS_RTC_DS1337:
-        case DS_RTC_DS1339:
-        case DS_RTC_DS1341:
-        case DS_RTC_DS1342:
-            rtc->has_alarm = true;
-            break;
-
-        case DS_RTC_DS1388:
-            rtc->has_alarm = true;
-            rtc->has_eeprom = true;
-            break;
-
-        case DS_RTC_DS3231:
-        case DS_RTC_DS3232:
-            rtc->has_alarm = true;
-            rtc->has_temp = true;
-            if (chip == DS_RTC_DS3232) {
-                rtc->has_sram = true;
-            }
-
-            // Enable battery-backed oscillator and alarm control
-            {
-                uint8_t ctrl = 0x1C; // EOSC=0, BBSQW=1, CONV=1, RS2=1, RS1=0
-                HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0E, 1, &ctrl, 1, HAL_MAX_DELAY);
-            }
-            break;
-
-        default:
-            break;
-    }
+static HAL_StatusTypeDef DevWrite(DS_RTC_HandleTypeDef *rtc, uint16_t dev, uint8_t reg, uint8_t *buf, uint16_t len) {
+    I2C_BUS_Transaction txn;
+    I2C_BUS_MemWrite(&txn, dev, reg, buf, len, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Exec(rtc->bus, rtc->hi2c, &txn);
 }
 
-// ========== Read Time ==========
+static HAL_StatusTypeDef MemRead(DS_RTC_HandleTypeDef *rtc, uint8_t reg, uint8_t *buf, uint16_t len) {
+    return DevRead(rtc, DS_RTC_ADDR, reg, buf, len);
+}
 
-HAL_StatusTypeDef DS_RTC_ReadTime(DS_RTC_HandleTypeDef *rtc, DS_RTC_Time *time) {
-    uint8_t buf[7];
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x00, 1, buf, 7, HAL_MAX_DELAY);
-    if (status != HAL_OK) return status;
+static HAL_StatusTypeDef MemWrite(DS_RTC_HandleTypeDef *rtc, uint8_t reg, uint8_t *buf, uint16_t len) {
+    return DevWrite(rtc, DS_RTC_ADDR, reg, buf, len);
+}
+
+// First time register: the DS1388 keeps hundredths of seconds at 0x00
+static inline uint8_t TimeReg(const DS_RTC_HandleTypeDef *rtc) {
+    return (DS_RTC_CHIP(rtc) == DS_RTC_DS1388) ? 0x01 : 0x00;
+}
 
+static void DecodeTime(const uint8_t *buf, DS_RTC_Time *time) {
     time->seconds      = DS_RTC_FromBCD(buf[0] & 0x7F);
     time->minutes      = DS_RTC_FromBCD(buf[1] & 0x7F);
     time->hours        = DS_RTC_FromBCD(buf[2] & 0x3F);
@@ -78,15 +68,9 @@ HAL_StatusTypeDef DS_RTC_ReadTime(DS_RTC_HandleTypeDef *rtc, DS_RTC_Time *time)
     time->day          = DS_RTC_FromBCD(buf[4] & 0x3F);
     time->month        = DS_RTC_FromBCD(buf[5] & 0x1F);
     time->year         = 2000 + DS_RTC_FromBCD(buf[6]);
-
-    return HAL_OK;
 }
 
-// ========== Write Time ==========
-
-HAL_StatusTypeDef DS_RTC_WriteTime(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Time *time) {
-    uint8_t buf[7];
-
+static void EncodeTime(const DS_RTC_Time *time, uint8_t *buf) {
     buf[0] = DS_RTC_ToBCD(time->seconds) & 0x7F; // Ensure CH bit is 0
     buf[1] = DS_RTC_ToBCD(time->minutes);
     buf[2] = DS_RTC_ToBCD(time->hours);
@@ -94,14 +78,86 @@ HAL_StatusTypeDef DS_RTC_WriteTime(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Time
     buf[4] = DS_RTC_ToBCD(time->day);
     buf[5] = DS_RTC_ToBCD(time->month);
     buf[6] = DS_RTC_ToBCD(time->year % 100);
+}
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+// Quarter degrees: signed MSB, 0.25 degC steps in the 2 upper bits of the LSB
+static int16_t DecodeTemperatureQ(const uint8_t *buf) {
+    int8_t temp_msb = (int8_t)buf[0];
+    uint8_t temp_lsb = buf[1] >> 6;
+    return (int16_t)(temp_msb * 4 + temp_lsb);
+}
 
-    return HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x00, 1, buf, 7, HAL_MAX_DELAY);
+#if !DS_RTC_NO_FLOAT
+static float DecodeTemperature(const uint8_t *buf) {
+    return DecodeTemperatureQ(buf) * 0.25f;
+}
+#endif
+#endif
+
+// ========== Init ==========
+
+#if !DS_RTC_FIXED_MODEL
+static uint8_t ModelCaps(DS_RTC_Model chip) {
+    switch (chip) {
+        case DS_RTC_DS1307: return DS_RTC_CAPS_DS_RTC_DS1307;
+        case DS_RTC_DS1337: return DS_RTC_CAPS_DS_RTC_DS1337;
+        case DS_RTC_DS1338: return DS_RTC_CAPS_DS_RTC_DS1338;
+        case DS_RTC_DS1339: return DS_RTC_CAPS_DS_RTC_DS1339;
+        case DS_RTC_DS1340: return DS_RTC_CAPS_DS_RTC_DS1340;
+        case DS_RTC_DS1341: return DS_RTC_CAPS_DS_RTC_DS1341;
+        case DS_RTC_DS1342: return DS_RTC_CAPS_DS_RTC_DS1342;
+        case DS_RTC_DS1388: return DS_RTC_CAPS_DS_RTC_DS1388;
+        case DS_RTC_DS3231: return DS_RTC_CAPS_DS_RTC_DS3231;
+        case DS_RTC_DS3232: return DS_RTC_CAPS_DS_RTC_DS3232;
+        default:            return 0;
+    }
+}
+#endif
+
+// 'chip' is ignored in a fixed build (DS_RTC_MODEL)
+void DS_RTC_Init(DS_RTC_HandleTypeDef *rtc, I2C_HandleTypeDef *hi2c, DS_RTC_Model chip) {
+    rtc->hi2c = hi2c;
+    rtc->bus = NULL;           // DS_RTC_AttachBus after Init to share the bus
+#if DS_RTC_FIXED_MODEL
+    (void)chip;
+#else
+    rtc->chip = chip;
+    rtc->caps = ModelCaps(chip);
+#endif
+
+    // DS3231 / DS3232: enable battery-backed oscillator and alarm control
+    if (DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) {
+        uint8_t ctrl = 0x1C; // EOSC=0, BBSQW=1, CONV=1, RS2=1, RS1=0
+        MemWrite(rtc, 0x0E, &ctrl, 1);
+    }
+}
+
+// ========== Read Time ==========
+
+HAL_StatusTypeDef DS_RTC_ReadTime(DS_RTC_HandleTypeDef *rtc, DS_RTC_Time *time) {
+    uint8_t buf[7];
+    HAL_StatusTypeDef status = MemRead(rtc, TimeReg(rtc), buf, 7);
+    if (status != HAL_OK) return status;
+
+    DecodeTime(buf, time);
+    return HAL_OK;
+}
+
+// ========== Write Time ==========
+
+HAL_StatusTypeDef DS_RTC_WriteTime(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Time *time) {
+    uint8_t buf[7];
+
+    EncodeTime(time, buf);
+    return MemWrite(rtc, TimeReg(rtc), buf, 7);
 }
 
 // ========== Set Alarm ==========
 
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_ALARM
 HAL_StatusTypeDef DS_RTC_SetAlarm(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm *alarm) {
-    if (!rtc->has_alarm) return HAL_ERROR;
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_ALARM)) return HAL_ERROR;
 
     uint8_t buf[5];
 
@@ -114,24 +170,25 @@ HAL_StatusTypeDef DS_RTC_SetAlarm(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm
     buf[4] = 0x00; // DY/DT = 0, ch? dng ngy, khng dng th?
 
     // Ghi 5 byte vo t? d?a ch? 0x07
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x07, 1, buf, 4, HAL_MAX_DELAY);
+    HAL_StatusTypeDef status = MemWrite(rtc, 0x07, buf, 4);
     if (status != HAL_OK) return status;
 
     // B?t A1IE (Alarm 1 Interrupt Enable) v INTCN
     uint8_t ctrl = 0x05;
-    status = HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0E, 1, &ctrl, 1, HAL_MAX_DELAY);
+    status = MemWrite(rtc, 0x0E, &ctrl, 1);
     if (status != HAL_OK) return status;
 
     // Xa c? bo th?c A1F n?u dang set
     uint8_t status_reg;
-    HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+    status = MemRead(rtc, 0x0F, &status_reg, 1);
+    if (status != HAL_OK) return status;
     status_reg &= ~(1 << 0); // Clear bit A1F
-    return HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+    return MemWrite(rtc, 0x0F, &status_reg, 1);
 }
 
 
 HAL_StatusTypeDef DS_RTC_SetAlarm2(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm2 *alarm) {
-    if (!rtc->has_alarm) return HAL_ERROR;
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_ALARM)) return HAL_ERROR;
 
     uint8_t buf[3];
     buf[0] = DS_RTC_ToBCD(alarm->minutes) | (alarm->match_minutes ? 0x00 : 0x80);
@@ -139,21 +196,25 @@ HAL_StatusTypeDef DS_RTC_SetAlarm2(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm
     buf[2] = (DS_RTC_ToBCD(alarm->day) & 0x3F) | (alarm->match_day ? 0x00 : 0x80);
 
     // Ghi vo thanh ghi Alarm 2 (0x0B - 0x0D)
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0B, 1, buf, 3, HAL_MAX_DELAY);
+    HAL_StatusTypeDef status = MemWrite(rtc, 0x0B, buf, 3);
     if (status != HAL_OK) return status;
 
     // B?t Alarm 2 v INTCN
     uint8_t ctrl;
-    HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x0E, 1, &ctrl, 1, HAL_MAX_DELAY);
+    status = MemRead(rtc, 0x0E, &ctrl, 1);
+    if (status != HAL_OK) return status;
     ctrl |= (1 << 2) | (1 << 1); // INTCN = 1, A2IE = 1
-    HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0E, 1, &ctrl, 1, HAL_MAX_DELAY);
+    status = MemWrite(rtc, 0x0E, &ctrl, 1);
+    if (status != HAL_OK) return status;
 
     // Clear c? A2F
     uint8_t status_reg;
-    HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+    status = MemRead(rtc, 0x0F, &status_reg, 1);
+    if (status != HAL_OK) return status;
     status_reg &= ~(1 << 1); // clear A2F
-    return HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+    return MemWrite(rtc, 0x0F, &status_reg, 1);
 }
+#endif
 
 
 
@@ -161,34 +222,306 @@ HAL_StatusTypeDef DS_RTC_SetAlarm2(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm
 
 // ========== Get Temperature ==========
 
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+HAL_StatusTypeDef DS_RTC_GetTemperatureQ(DS_RTC_HandleTypeDef *rtc, int16_t *quarters) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) return HAL_ERROR;
+
+    uint8_t buf[2];
+    HAL_StatusTypeDef status = MemRead(rtc, 0x11, buf, 2);
+    if (status != HAL_OK) return status;
+
+    *quarters = DecodeTemperatureQ(buf);
+    return HAL_OK;
+}
+
+#if !DS_RTC_NO_FLOAT
 HAL_StatusTypeDef DS_RTC_GetTemperature(DS_RTC_HandleTypeDef *rtc, float *temperature) {
-    if (!rtc->has_temp) return HAL_ERROR;
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) return HAL_ERROR;
 
     uint8_t buf[2];
     HAL_StatusTypeDef status;
 
     // Thanh ghi nhi?t d?: 0x11 (MSB), 0x12 (LSB)
-    status = HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x11, 1, buf, 2, HAL_MAX_DELAY);
+    status = MemRead(rtc, 0x11, buf, 2);
     if (status != HAL_OK) return status;
 
-    int8_t temp_msb = (int8_t)buf[0];       // C d?u
-    uint8_t temp_lsb = buf[1] >> 6;         // L?y 2 bit cao nh?t
-
-    *temperature = temp_msb + (temp_lsb * 0.25f);
+    *temperature = DecodeTemperature(buf);
 
     return HAL_OK;
 }
+#endif
+#endif
 
 
 // ========== Clear Alarm Flag ==========
 
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_ALARM
+static HAL_StatusTypeDef ClearFlags(DS_RTC_HandleTypeDef *rtc, uint8_t flags) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_ALARM)) return HAL_ERROR;
+
+    uint8_t status_reg;
+    HAL_StatusTypeDef status = MemRead(rtc, 0x0F, &status_reg, 1);
+    if (status != HAL_OK) return status;
+
+    status_reg &= ~flags;
+    return MemWrite(rtc, 0x0F, &status_reg, 1);
+}
+
 HAL_StatusTypeDef DS_RTC_ClearAlarmFlag(DS_RTC_HandleTypeDef *rtc) {
-    if (!rtc->has_alarm) return HAL_ERROR;
+    return ClearFlags(rtc, 0x01); // Clear A1F
+}
+
+HAL_StatusTypeDef DS_RTC_ClearAlarmFlags(DS_RTC_HandleTypeDef *rtc) {
+    return ClearFlags(rtc, 0x03); // Clear A1F and A2F
+}
+
+// A1F (bit 0) and A2F (bit 1); 0 when the chip cannot be read
+uint8_t DS_RTC_GetAlarmFlags(DS_RTC_HandleTypeDef *rtc) {
+    uint8_t status_reg = 0;
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_ALARM)) return 0;
+    if (MemRead(rtc, 0x0F, &status_reg, 1) != HAL_OK) return 0;
+    if (status_reg & 0x03) EVBUS_PUBLISH(EVBUS_EV_RTC_ALARM, status_reg & 0x03, 0, rtc);
+    return status_reg & 0x03;
+}
+#endif
+
+// ========== SRAM ==========
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_SRAM
+// DS1307 / DS1338: 56 bytes at 0x08, DS3232: 236 bytes at 0x14
+static HAL_StatusTypeDef RamRange(DS_RTC_HandleTypeDef *rtc, uint8_t offset, uint8_t length, uint8_t *reg) {
+    uint8_t base = (DS_RTC_CHIP(rtc) == DS_RTC_DS3232) ? 0x14 : 0x08;
+    uint16_t size = (DS_RTC_CHIP(rtc) == DS_RTC_DS3232) ? 236 : 56;
+
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_SRAM)) return HAL_ERROR;
+    if ((uint16_t)offset + length > size) return HAL_ERROR;
+    *reg = (uint8_t)(base + offset);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef DS_RTC_ReadRAM(DS_RTC_HandleTypeDef *rtc, uint8_t offset, uint8_t *data, uint8_t length) {
+    uint8_t reg;
+    if (RamRange(rtc, offset, length, &reg) != HAL_OK) return HAL_ERROR;
+    return MemRead(rtc, reg, data, length);
+}
+
+HAL_StatusTypeDef DS_RTC_WriteRAM(DS_RTC_HandleTypeDef *rtc, uint8_t offset, const uint8_t *data, uint8_t length) {
+    uint8_t reg;
+    if (RamRange(rtc, offset, length, &reg) != HAL_OK) return HAL_ERROR;
+    return MemWrite(rtc, reg, (uint8_t *)data, length);
+}
+#endif
+
+// ========== EEPROM (DS1388) ==========
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_EEPROM
+#define EEPROM_SIZE 512U
+#define EEPROM_PAGE 8U
+
+// Two 256-byte blocks, one I2C address each
+static inline uint16_t EepromDev(uint16_t address) {
+    return (uint16_t)(DS_RTC_EEPROM_ADDR + ((address >> 8) << 1));
+}
 
+HAL_StatusTypeDef DS_RTC_ReadEEPROM(DS_RTC_HandleTypeDef *rtc, uint16_t address, uint8_t *data, uint16_t length) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_EEPROM)) return HAL_ERROR;
+    if ((uint32_t)address + length > EEPROM_SIZE) return HAL_ERROR;
+
+    while (length) {
+        uint16_t chunk = 0x100U - (address & 0xFFU);     // stay inside one block
+        if (chunk > length) chunk = length;
+        HAL_StatusTypeDef status = DevRead(rtc, EepromDev(address), (uint8_t)address, data, chunk);
+        if (status != HAL_OK) return status;
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return HAL_OK;
+}
+
+// Page writes (8 bytes), each followed by the write cycle time
+HAL_StatusTypeDef DS_RTC_WriteEEPROM(DS_RTC_HandleTypeDef *rtc, uint16_t address, const uint8_t *data, uint16_t length) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_EEPROM)) return HAL_ERROR;
+    if ((uint32_t)address + length > EEPROM_SIZE) return HAL_ERROR;
+
+    while (length) {
+        uint16_t chunk = EEPROM_PAGE - (address % EEPROM_PAGE);
+        if (chunk > length) chunk = length;
+        HAL_StatusTypeDef status = DevWrite(rtc, EepromDev(address), (uint8_t)address, (uint8_t *)data, chunk);
+        if (status != HAL_OK) return status;
+        HAL_Delay(DS_RTC_EEPROM_WRITE_MS);
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return HAL_OK;
+}
+#endif
+
+// ========== Square wave / 32 kHz output ==========
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_SQW
+HAL_StatusTypeDef DS_RTC_SetSquareWave(DS_RTC_HandleTypeDef *rtc, DS_RTC_SquareWaveFreq freq, bool enable) {
+    static const int8_t rs1307[] = { 0, -1, 1, 2, 3 };     // control 0x07, RS1:RS0
+    static const int8_t rs3231[] = { 0, 1, 2, 3, -1 };     // control 0x0E, RS2:RS1
+    uint8_t ctrl;
+
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_SQW) || (unsigned)freq > DS_RTC_SQW_32768HZ) return HAL_ERROR;
+
+    if (DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) {
+        // DS3231 / DS3232: INTCN = 0 routes the square wave to INT/SQW
+        if (rs3231[freq] < 0) return HAL_ERROR;
+        if (MemRead(rtc, 0x0E, &ctrl, 1) != HAL_OK) return HAL_ERROR;
+        ctrl &= ~((3 << 3) | (1 << 2));
+        ctrl |= (uint8_t)(rs3231[freq] << 3) | (enable ? 0 : (1 << 2));
+        return MemWrite(rtc, 0x0E, &ctrl, 1);
+    }
+
+    // DS1307 / DS1338: SQWE (bit 4) + RS1:RS0
+    if (rs1307[freq] < 0) return HAL_ERROR;
+    if (MemRead(rtc, 0x07, &ctrl, 1) != HAL_OK) return HAL_ERROR;
+    ctrl &= ~((1 << 4) | 0x03);
+    if (enable) ctrl |= (1 << 4) | (uint8_t)rs1307[freq];
+    return MemWrite(rtc, 0x07, &ctrl, 1);
+}
+#endif
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_32K
+HAL_StatusTypeDef DS_RTC_Enable32KOutput(DS_RTC_HandleTypeDef *rtc, bool enable) {
     uint8_t status_reg;
-    HAL_StatusTypeDef status = HAL_I2C_Mem_Read(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_32K)) return HAL_ERROR;
+    if (MemRead(rtc, 0x0F, &status_reg, 1) != HAL_OK) return HAL_ERROR;
+
+    if (enable) status_reg |= (1 << 3);     // EN32kHz = 1
+    else status_reg &= ~(1 << 3);
+    return MemWrite(rtc, 0x0F, &status_reg, 1);
+}
+#endif
+
+// ========== Non-blocking (I2C_BUS) ==========
+
+void DS_RTC_AttachBus(DS_RTC_HandleTypeDef *rtc, I2C_BUS_HandleTypeDef *bus) {
+    rtc->bus = bus;
+}
+
+// Bus callback (interrupt context): convert the raw registers, then report
+static void AsyncDone(I2C_BUS_Transaction *txn, HAL_StatusTypeDef status) {
+    DS_RTC_AsyncTypeDef *req = (DS_RTC_AsyncTypeDef *)txn->Ctx;
+
+    if (status == HAL_OK) {
+        if (req->Time) DecodeTime(req->Buf, req->Time);
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+        if (req->TemperatureQ) *req->TemperatureQ = DecodeTemperatureQ(req->Buf);
+#if !DS_RTC_NO_FLOAT
+        if (req->Temperature) *req->Temperature = DecodeTemperature(req->Buf);
+#endif
+#endif
+    }
+    if (req->Callback) req->Callback(req, status);
+}
+
+static bool InFlight(const I2C_BUS_Transaction *txn) {
+    return txn->State == I2C_BUS_TXN_QUEUED || txn->State == I2C_BUS_TXN_ACTIVE;
+}
+
+static HAL_StatusTypeDef AsyncPrepare(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req,
+                                      DS_RTC_AsyncCallback callback, void *ctx) {
+    if (rtc->bus == NULL) return HAL_ERROR;
+    if (InFlight(&req->Txn) || InFlight(&req->Rmw.Read)) return HAL_BUSY;
+
+    req->Time = NULL;
+    req->TemperatureQ = NULL;
+#if !DS_RTC_NO_FLOAT
+    req->Temperature = NULL;
+#endif
+    req->Callback = callback;
+    req->Ctx = ctx;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef DS_RTC_ReadTime_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, DS_RTC_Time *time,
+                                        DS_RTC_AsyncCallback callback, void *ctx) {
+    HAL_StatusTypeDef status = AsyncPrepare(rtc, req, callback, ctx);
     if (status != HAL_OK) return status;
 
-    status_reg &= ~(0x01); // Clear A1F
-    return HAL_I2C_Mem_Write(rtc->hi2c, rtc->i2c_addr, 0x0F, 1, &status_reg, 1, HAL_MAX_DELAY);
+    req->Time = time;
+    I2C_BUS_MemRead(&req->Txn, DS_RTC_ADDR, TimeReg(rtc), req->Buf, 7, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Submit(rtc->bus, &req->Txn, AsyncDone, req);
 }
+
+HAL_StatusTypeDef DS_RTC_WriteTime_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, const DS_RTC_Time *time,
+                                         DS_RTC_AsyncCallback callback, void *ctx) {
+    HAL_StatusTypeDef status = AsyncPrepare(rtc, req, callback, ctx);
+    if (status != HAL_OK) return status;
+
+    EncodeTime(time, req->Buf);
+    I2C_BUS_MemWrite(&req->Txn, DS_RTC_ADDR, TimeReg(rtc), req->Buf, 7, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Submit(rtc->bus, &req->Txn, AsyncDone, req);
+}
+
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+HAL_StatusTypeDef DS_RTC_GetTemperatureQ_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, int16_t *quarters,
+                                               DS_RTC_AsyncCallback callback, void *ctx) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) return HAL_ERROR;
+    HAL_StatusTypeDef status = AsyncPrepare(rtc, req, callback, ctx);
+    if (status != HAL_OK) return status;
+
+    req->TemperatureQ = quarters;
+    I2C_BUS_MemRead(&req->Txn, DS_RTC_ADDR, 0x11, req->Buf, 2, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Submit(rtc->bus, &req->Txn, AsyncDone, req);
+}
+
+#if !DS_RTC_NO_FLOAT
+HAL_StatusTypeDef DS_RTC_GetTemperature_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, float *temperature,
+                                              DS_RTC_AsyncCallback callback, void *ctx) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_TEMP)) return HAL_ERROR;
+    HAL_StatusTypeDef status = AsyncPrepare(rtc, req, callback, ctx);
+    if (status != HAL_OK) return status;
+
+    req->Temperature = temperature;
+    I2C_BUS_MemRead(&req->Txn, DS_RTC_ADDR, 0x11, req->Buf, 2, DS_RTC_BUS_PRIORITY);
+    return I2C_BUS_Submit(rtc->bus, &req->Txn, AsyncDone, req);
+}
+#endif
+#endif
+
+// Status register read-modify-write, kept atomic on the bus by the chain
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_ALARM
+HAL_StatusTypeDef DS_RTC_ClearAlarmFlag_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req,
+                                              DS_RTC_AsyncCallback callback, void *ctx) {
+    if (!DS_RTC_HAS(rtc, DS_RTC_CAP_ALARM)) return HAL_ERROR;
+    HAL_StatusTypeDef status = AsyncPrepare(rtc, req, callback, ctx);
+    if (status != HAL_OK) return status;
+
+    return I2C_BUS_UpdateReg(rtc->bus, &req->Rmw, DS_RTC_ADDR, 0x0F, 0x01, 0x00,
+                             DS_RTC_BUS_PRIORITY, AsyncDone, req);
+}
+#endif
+
+/*
+=================================== How to USE ==========================================
+
+# 1. Runtime model (chip chosen or probed at start-up)
+
+    DS_RTC_HandleTypeDef rtc;
+    DS_RTC_Init(&rtc, &hi2c1, DS_RTC_DS3231);
+    DS_RTC_ReadTime(&rtc, &time);
+    if (DS_RTC_GetTemperature(&rtc, &temp) != HAL_OK) { ... }   // HAL_ERROR on chips without sensor
+    DS_RTC_GetTemperatureQ(&rtc, &quarters);                    // 101 = 25.25 degC, no float
+
+# 2. Fixed model: add DS_RTC_MODEL=DS_RTC_DS1307 to the project symbols
+#    (Project > Properties > C/C++ Build > Settings > Symbols)
+
+    DS_RTC_Init(&rtc, &hi2c1, DS_RTC_DS1307);
+    DS_RTC_WriteRAM(&rtc, 0, data, 8);
+    DS_RTC_GetTemperature(&rtc, &temp);     // build error: the DS1307 has no sensor
+
+# 3. Bus errors: every call is bounded, HAL_TIMEOUT when the bus stays stuck
+
+    if (DS_RTC_ReadTime(&rtc, &time) == HAL_TIMEOUT) {
+        const I2C_BUS_DevStats *s = I2C_BUS_GetDevStats(&hi2c1, DS_RTC_ADDR);
+        printf("rtc: %lu timeouts, %lu recoveries\n", s->Timeouts, s->Recoveries);
+    }
+
+*/
@@ -1,10 +1,98 @@
+/**
+ * @file DS_RTC.h
+ * @brief Driver for the Maxim/Dallas DS13xx / DS32xx I2C real-time clocks.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * One driver for every supported chip. What a chip can do is a set of DS_RTC_CAP_*
+ * bits (table below), used two ways:
+ * - Runtime build (default): DS_RTC_Init takes the model, the handle keeps it and
+ *   each feature call checks the capability (boards that probe or configure the chip).
+ * - Fixed build: define DS_RTC_MODEL (e.g. -DDS_RTC_MODEL=DS_RTC_DS3231). The
+ *   capability checks become constants, the functions of missing features are not
+ *   compiled (calling one is a build error) and the handle loses its model fields.
+ *   'ctest -R ds_rtc_footprint' prints the flash / RAM of each model against the
+ *   runtime build.
+ *
+ * Notes:
+ * - Alarms use the DS3231 register layout (alarm 1 at 0x07, alarm 2 at 0x0B,
+ *   control 0x0E, status 0x0F), shared by the DS1337/1339/1341/1342.
+ * - DS1388: time registers start at 0x01 (0x00 = hundredths), EEPROM on the
+ *   next two I2C addresses, no alarm support in this driver.
+ * - Temperature: DS_RTC_GetTemperatureQ gives quarter degrees as an integer (the
+ *   sensor resolution). DS_RTC_NO_FLOAT=1 (or HAL_LIB_NO_FLOAT=1) drops the float API.
+ */
+
+
+
 #ifndef __DS_RTC_H
 #define __DS_RTC_H
 
 #include "stm32f1xx_hal.h"
+#include "I2C_BUS.h"
 #include <stdint.h>
 #include <stdbool.h>
 
+// Queue priority of the RTC transfers when a bus manager is attached
+#ifndef DS_RTC_BUS_PRIORITY
+#define DS_RTC_BUS_PRIORITY I2C_BUS_PRIO_NORMAL
+#endif
+
+// 1 = no float API (DS_RTC_GetTemperature*), quarter-degree calls only; follows HAL_LIB_NO_FLOAT
+#ifndef HAL_LIB_NO_FLOAT
+#define HAL_LIB_NO_FLOAT 0
+#endif
+#ifndef DS_RTC_NO_FLOAT
+#define DS_RTC_NO_FLOAT HAL_LIB_NO_FLOAT
+#endif
+
+// ==== Capabilities ====
+#define DS_RTC_CAP_ALARM   0x01U   // alarm 1 + 2, flags in the status register
+#define DS_RTC_CAP_TEMP    0x02U   // temperature sensor
+#define DS_RTC_CAP_SRAM    0x04U   // battery-backed RAM behind the clock registers
+#define DS_RTC_CAP_EEPROM  0x08U   // DS1388 512 bytes EEPROM
+#define DS_RTC_CAP_SQW     0x10U   // square-wave output with selectable rate
+#define DS_RTC_CAP_32K     0x20U   // separate 32 kHz output
+#define DS_RTC_CAP_CLOCK   0x80U   // every model (marks a known model)
+#define DS_RTC_CAP_ALL     0xFFU
+
+#define DS_RTC_CAPS_DS_RTC_DS1307 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_SRAM | DS_RTC_CAP_SQW)
+#define DS_RTC_CAPS_DS_RTC_DS1337 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_ALARM)
+#define DS_RTC_CAPS_DS_RTC_DS1338 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_SRAM | DS_RTC_CAP_SQW)
+#define DS_RTC_CAPS_DS_RTC_DS1339 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_ALARM)
+#define DS_RTC_CAPS_DS_RTC_DS1340 (DS_RTC_CAP_CLOCK)
+#define DS_RTC_CAPS_DS_RTC_DS1341 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_ALARM)
+#define DS_RTC_CAPS_DS_RTC_DS1342 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_ALARM)
+#define DS_RTC_CAPS_DS_RTC_DS1388 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_EEPROM)
+#define DS_RTC_CAPS_DS_RTC_DS3231 (DS_RTC_CAP_CLOCK | DS_RTC_CAP_ALARM | DS_RTC_CAP_TEMP | DS_RTC_CAP_SQW | DS_RTC_CAP_32K)
+#define DS_RTC_CAPS_DS_RTC_DS3232 (DS_RTC_CAPS_DS_RTC_DS3231 | DS_RTC_CAP_SRAM)
+
+#define DS_RTC_CAPS_OF_(model) DS_RTC_CAPS_##model
+#define DS_RTC_CAPS_OF(model)  DS_RTC_CAPS_OF_(model)
+
+#ifdef DS_RTC_MODEL
+#define DS_RTC_FIXED_MODEL     1
+#define DS_RTC_BUILD_CAPS      DS_RTC_CAPS_OF(DS_RTC_MODEL)
+#if !(DS_RTC_BUILD_CAPS & DS_RTC_CAP_CLOCK)
+#error "DS_RTC_MODEL must be one of DS_RTC_DS1307 ... DS_RTC_DS3232"
+#endif
+#define DS_RTC_CHIP(rtc)       ((void)(rtc), DS_RTC_MODEL)
+#define DS_RTC_HAS(rtc, cap)   ((void)(rtc), (DS_RTC_BUILD_CAPS & (cap)) != 0)
+#else
+#define DS_RTC_FIXED_MODEL     0
+#define DS_RTC_BUILD_CAPS      DS_RTC_CAP_ALL
+#define DS_RTC_CHIP(rtc)       ((rtc)->chip)
+#define DS_RTC_HAS(rtc, cap)   (((rtc)->caps & (cap)) != 0)
+#endif
+
+#define DS_RTC_ADDR          (0x68 << 1)   // HAL (8-bit) address, every model
+#define DS_RTC_EEPROM_ADDR   (0x69 << 1)   // DS1388 EEPROM block 0, block 1 at +2
+
+#ifndef DS_RTC_EEPROM_WRITE_MS
+#define DS_RTC_EEPROM_WRITE_MS 10          // DS1388 EEPROM write cycle
+#endif
+
 // H? tr? cc lo?i chip
 typedef enum {
     DS_RTC_DS1307,
@@ -52,27 +140,102 @@ typedef struct {
 } DS_RTC_Alarm2;
 
 
+// Square-wave rates (DS_RTC_CAP_SQW); not every chip has every rate
+typedef enum {
+    DS_RTC_SQW_1HZ,
+    DS_RTC_SQW_1024HZ,     // DS3231 / DS3232
+    DS_RTC_SQW_4096HZ,
+    DS_RTC_SQW_8192HZ,
+    DS_RTC_SQW_32768HZ     // DS1307 / DS1338
+} DS_RTC_SquareWaveFreq;
+
 typedef struct {
     I2C_HandleTypeDef *hi2c;
+    I2C_BUS_HandleTypeDef *bus;   // NULL = direct blocking HAL calls
+#if !DS_RTC_FIXED_MODEL
     DS_RTC_Model chip;
-    uint8_t i2c_addr;
-    bool has_alarm;
-    bool has_temp;
-		bool has_sram;
-		bool has_eeprom;
+    uint8_t caps;                 // DS_RTC_CAP_* of the chip
+#endif
 } DS_RTC_HandleTypeDef;
 
+// Non-blocking request: owned by the caller, valid until the callback ran
+typedef struct DS_RTC_Async_s {
+    I2C_BUS_Transaction Txn;
+    I2C_BUS_RegUpdate Rmw;
+    uint8_t Buf[7];
+    DS_RTC_Time *Time;
+    int16_t *TemperatureQ;
+#if !DS_RTC_NO_FLOAT
+    float *Temperature;
+#endif
+    void (*Callback)(struct DS_RTC_Async_s *req, HAL_StatusTypeDef status);   // interrupt context
+    void *Ctx;
+} DS_RTC_AsyncTypeDef;
+
+typedef void (*DS_RTC_AsyncCallback)(DS_RTC_AsyncTypeDef *req, HAL_StatusTypeDef status);
+
 // API
 void DS_RTC_Init(DS_RTC_HandleTypeDef *rtc, I2C_HandleTypeDef *hi2c, DS_RTC_Model chip);
 HAL_StatusTypeDef DS_RTC_ReadTime(DS_RTC_HandleTypeDef *rtc, DS_RTC_Time *time);
 HAL_StatusTypeDef DS_RTC_WriteTime(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Time *time);
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_ALARM
 HAL_StatusTypeDef DS_RTC_SetAlarm(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm *alarm);
 HAL_StatusTypeDef DS_RTC_SetAlarm2(DS_RTC_HandleTypeDef *rtc, const DS_RTC_Alarm2 *alarm);
 HAL_StatusTypeDef DS_RTC_ClearAlarmFlag(DS_RTC_HandleTypeDef *rtc);
+HAL_StatusTypeDef DS_RTC_ClearAlarmFlags(DS_RTC_HandleTypeDef *rtc);
+uint8_t DS_RTC_GetAlarmFlags(DS_RTC_HandleTypeDef *rtc);
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+HAL_StatusTypeDef DS_RTC_GetTemperatureQ(DS_RTC_HandleTypeDef *rtc, int16_t *quarters);   // degC x 4
+#if !DS_RTC_NO_FLOAT
 HAL_StatusTypeDef DS_RTC_GetTemperature(DS_RTC_HandleTypeDef *rtc, float *temperature);
+#endif
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_SRAM
+HAL_StatusTypeDef DS_RTC_ReadRAM(DS_RTC_HandleTypeDef *rtc, uint8_t offset, uint8_t *data, uint8_t length);
+HAL_StatusTypeDef DS_RTC_WriteRAM(DS_RTC_HandleTypeDef *rtc, uint8_t offset, const uint8_t *data, uint8_t length);
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_EEPROM
+HAL_StatusTypeDef DS_RTC_ReadEEPROM(DS_RTC_HandleTypeDef *rtc, uint16_t address, uint8_t *data, uint16_t length);
+HAL_StatusTypeDef DS_RTC_WriteEEPROM(DS_RTC_HandleTypeDef *rtc, uint16_t address, const uint8_t *data, uint16_t length);
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_SQW
+HAL_StatusTypeDef DS_RTC_SetSquareWave(DS_RTC_HandleTypeDef *rtc, DS_RTC_SquareWaveFreq freq, bool enable);
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_32K
+HAL_StatusTypeDef DS_RTC_Enable32KOutput(DS_RTC_HandleTypeDef *rtc, bool enable);
+#endif
+
+// Shared bus (I2C_BUS): blocking calls queue behind other devices, async calls return at once
+void DS_RTC_AttachBus(DS_RTC_HandleTypeDef *rtc, I2C_BUS_HandleTypeDef *bus);
+HAL_StatusTypeDef DS_RTC_ReadTime_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, DS_RTC_Time *time,
+                                        DS_RTC_AsyncCallback callback, void *ctx);
+HAL_StatusTypeDef DS_RTC_WriteTime_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, const DS_RTC_Time *time,
+                                         DS_RTC_AsyncCallback callback, void *ctx);
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_TEMP
+HAL_StatusTypeDef DS_RTC_GetTemperatureQ_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, int16_t *quarters,
+                                               DS_RTC_AsyncCallback callback, void *ctx);
+#if !DS_RTC_NO_FLOAT
+HAL_StatusTypeDef DS_RTC_GetTemperature_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req, float *temperature,
+                                              DS_RTC_AsyncCallback callback, void *ctx);
+#endif
+#endif
+#if DS_RTC_BUILD_CAPS & DS_RTC_CAP_ALARM
+HAL_StatusTypeDef DS_RTC_ClearAlarmFlag_Async(DS_RTC_HandleTypeDef *rtc, DS_RTC_AsyncTypeDef *req,
+                                              DS_RTC_AsyncCallback callback, void *ctx);
+#endif
+
+// Wall time as one number: seconds since 2000-01-01 00:00:00 (sample log timestamps)
+uint32_t DS_RTC_ToSeconds(const DS_RTC_Time *time);
 
 // Internal
 uint8_t DS_RTC_ToBCD(uint8_t val);
 uint8_t DS_RTC_FromBCD(uint8_t bcd);
 
+// Names used by the former DS_RTC_layer_lib
+typedef DS_RTC_Alarm DS_RTC_Alarm1;
+#define DS_RTC_SetAlarm1(rtc, alarm)  DS_RTC_SetAlarm((rtc), (alarm))
+#define DS1307_Init(rtc, hi2c)        DS_RTC_Init((rtc), (hi2c), DS_RTC_DS1307)
+#define DS3231_Init(rtc, hi2c)        DS_RTC_Init((rtc), (hi2c), DS_RTC_DS3231)
+
 #endif
@@ -0,0 +1,163 @@
+/**
+ * @file ENCODER.c
+ * @brief Rotary encoder on a timer in encoder mode, with its push switch and acceleration.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Functions:
+ * - ENCODER_Init, ENCODER_Deinit: Starts the timer in encoder mode, makes the switch button.
+ * - ENCODER_Update: Reads the counter, reports the (accelerated) steps since the last read.
+ * - ENCODER_SetAcceleration: Rates of the acceleration, or none.
+ * - ENCODER_GetPosition, ENCODER_SetPosition: Sum of the steps reported.
+ */
+
+
+
+#include "ENCODER.h"
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef ENCODER_Init(ENCODER_t* enc, TIM_HandleTypeDef* htim, uint8_t countsPerStep,
+                               ENCODER_Handler Handler, GPIO_TypeDef* swPort, uint16_t swPin,
+                               void (*SwitchHandler)(Button_t*, ButtonPressType_t)) {
+    if (enc == NULL || htim == NULL || countsPerStep == 0 || countsPerStep > 64) return HAL_ERROR;
+
+    *enc = (ENCODER_t){ .htim = htim, .CountsPerStep = countsPerStep };
+    enc->Handler = (Handler != NULL) ? Handler : ENCODER_Callback;
+    enc->AccelStart = ENCODER_ACCEL_START;
+    enc->AccelFull = ENCODER_ACCEL_FULL;
+    enc->AccelMax = ENCODER_ACCEL_MAX;
+
+    if (swPort != NULL) {
+        enc->Switch = BUTTON_Init(swPort, swPin, 0, BUTTON_Mode_Toggle, SwitchHandler);
+        if (enc->Switch == NULL) return HAL_ERROR;      // BUTTON pool full
+    }
+    if (HAL_TIM_Encoder_Start(htim, TIM_CHANNEL_ALL) != HAL_OK) {
+        BUTTON_Deinit(enc->Switch);
+        enc->Switch = NULL;
+        return HAL_ERROR;
+    }
+    enc->LastCount = (uint16_t)__HAL_TIM_GET_COUNTER(htim);
+    return HAL_OK;
+}
+
+void ENCODER_Deinit(ENCODER_t* enc) {
+    if (enc == NULL || enc->htim == NULL) return;
+    HAL_TIM_Encoder_Stop(enc->htim, TIM_CHANNEL_ALL);
+    BUTTON_Deinit(enc->Switch);
+    enc->Switch = NULL;
+    enc->htim = NULL;
+}
+
+// Detents per second at or below 'start': 1 step each; at 'full' and above: 'max' steps (1 = off)
+void ENCODER_SetAcceleration(ENCODER_t* enc, uint16_t start, uint16_t full, uint8_t max) {
+    if (max == 0 || (max > 1 && full <= start)) return;
+    enc->AccelStart = start;
+    enc->AccelFull = full;
+    enc->AccelMax = max;
+}
+
+// ========== Update ==========
+
+// Steps per detent at the current rate
+static uint32_t ENCODER_Scale(const ENCODER_t* enc) {
+    if (enc->AccelMax <= 1 || enc->Rate <= enc->AccelStart) return 1;
+    if (enc->Rate >= enc->AccelFull) return enc->AccelMax;
+    return 1U + (uint32_t)(enc->AccelMax - 1U) * (enc->Rate - enc->AccelStart) / (enc->AccelFull - enc->AccelStart);
+}
+
+// One counter read; the handler only when a detent was passed
+void ENCODER_Update(ENCODER_t* enc) {
+    if (enc->htim == NULL) return;
+
+    uint16_t cnt = (uint16_t)__HAL_TIM_GET_COUNTER(enc->htim);
+    if (cnt == enc->LastCount) return;
+
+    // Counts moved since the last read, the shorter way around the auto-reload
+    int32_t period = (int32_t)__HAL_TIM_GET_AUTORELOAD(enc->htim) + 1;
+    int32_t counts = (int32_t)cnt - (int32_t)enc->LastCount;
+    if (counts > period / 2) counts -= period;
+    else if (counts < -period / 2) counts += period;
+    enc->LastCount = cnt;
+
+    counts += enc->Pending;
+    int32_t detents = counts / enc->CountsPerStep;      // towards 0: a jitter around a detent cancels out
+    enc->Pending = (int8_t)(counts - detents * enc->CountsPerStep);
+    if (detents == 0) return;
+
+    uint32_t now = HAL_GetTick();
+    int8_t dir = (detents > 0) ? 1 : -1;
+    uint32_t n = (uint32_t)(detents * dir);
+    uint32_t dt = now - enc->LastStepTime;
+
+    if (dir != enc->Direction || dt >= ENCODER_IDLE_MS) {
+        enc->Rate = 0;      // from rest, or reversed: no acceleration yet
+    } else {
+        uint32_t rate = n * 1000U / (dt ? dt : 1U);
+        if (rate > 0xFFFFU) rate = 0xFFFFU;
+        enc->Rate = (uint16_t)((enc->Rate + rate) / 2U);
+    }
+    enc->Direction = dir;
+    enc->LastStepTime = now;
+
+    int32_t steps = (int32_t)(n * ENCODER_Scale(enc)) * dir;
+    enc->Position += steps;
+    enc->Handler(enc, steps);
+}
+
+// ========== Position ==========
+
+int32_t ENCODER_GetPosition(const ENCODER_t* enc) {
+    return enc->Position;
+}
+
+void ENCODER_SetPosition(ENCODER_t* enc, int32_t position) {
+    enc->Position = position;
+}
+
+// Default handler: the application overrides it or passes its own to ENCODER_Init
+__weak void ENCODER_Callback(ENCODER_t* enc, int32_t steps) {
+    (void)enc;
+    (void)steps;
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. CubeMX: TIM3 Combined Channels = Encoder Mode TI1 and TI2, Period 65535,
+#    input filter 10 on both channels (contact bounce), PA6 / PA7 with pull-ups.
+#    Push switch on PB0 as GPIO_Input pull-up.
+
+static ENCODER_t knob;
+static int32_t volume;
+
+void Knob_Handler(ENCODER_t* enc, int32_t steps) {
+	(void)enc;
+	volume += steps;									// 1 per detent, up to 10 when spun fast
+	if (volume < 0) volume = 0;
+	if (volume > 1000) volume = 1000;
+}
+
+void Knob_Switch(Button_t* btn, ButtonPressType_t type) {
+	(void)btn;
+	if (type == BUTTON_PressType_OnPressed || type == BUTTON_PressType_Normal) ToggleMute();
+	if (type == BUTTON_PressType_Long) volume = 0;
+}
+
+
+# 2. Init after MX_TIM3_Init: 4 counts per detent (EC11 type)
+
+	ENCODER_Init(&knob, &htim3, 4, Knob_Handler, GPIOB, GPIO_PIN_0, Knob_Switch);
+	ENCODER_SetAcceleration(&knob, 10, 60, 10);			// or (0, 0, 1): one step per detent
+
+
+# 3. Main loop: one counter read, then the switch timers
+
+while (1)
+{
+	ENCODER_Update(&knob);
+	BUTTON_Update();
+}
+
+*/
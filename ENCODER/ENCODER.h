@@ -0,0 +1,90 @@
+/**
+ * @file ENCODER.h
+ * @brief Rotary encoder on a timer in encoder mode, with its push switch and acceleration.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * The A/B phases go to CH1/CH2 of a timer in encoder mode (TIM_ENCODERMODE_TI12): the
+ * timer counts every edge up or down in hardware, so no step is lost however slow the
+ * main loop, and no interrupt is taken per step. ENCODER_Update reads CNT once, turns
+ * the counts since the last read into detents (CountsPerStep counts each, the rest is
+ * kept for the next call) and calls the handler with the signed number of steps.
+ *
+ * Acceleration: the rate of the detents (per second, averaged over the last reads)
+ * scales the steps. At or below AccelStart detents/s a detent is one step; at
+ * AccelFull and above it is AccelMax steps, linear in between. A change of direction
+ * or a pause of ENCODER_IDLE_MS starts again at one step per detent. AccelMax = 1
+ * turns it off (ENCODER_SetAcceleration).
+ *
+ * The push switch is a regular Button_t (Toggle mode, pull-up) with its own
+ * ButtonPressType_t handler, run from BUTTON_Update.
+ *
+ * Notes:
+ * - Read at least once per 32767 counts (16-bit counter), i.e. always in practice.
+ * - Handlers run from ENCODER_Update; call it and BUTTON_Update from the main loop.
+ */
+
+
+
+#ifndef __ENCODER_H
+#define __ENCODER_H
+
+#include "stm32f1xx_hal.h"
+#include "BUTTON.h"
+#include <stdint.h>
+
+// Detents per second: one step per detent up to START, ACCEL_MAX steps from FULL
+#ifndef ENCODER_ACCEL_START
+#define ENCODER_ACCEL_START 10
+#endif
+
+#ifndef ENCODER_ACCEL_FULL
+#define ENCODER_ACCEL_FULL 60
+#endif
+
+#ifndef ENCODER_ACCEL_MAX
+#define ENCODER_ACCEL_MAX 10
+#endif
+
+// No detent for this long: the rate starts again from 0
+#ifndef ENCODER_IDLE_MS
+#define ENCODER_IDLE_MS 200
+#endif
+
+struct ENCODER_s;
+
+typedef void (*ENCODER_Handler)(struct ENCODER_s* enc, int32_t steps);
+
+typedef struct ENCODER_s {
+    TIM_HandleTypeDef* htim;
+    ENCODER_Handler Handler;            // not NULL
+    Button_t* Switch;                   // NULL without a push switch
+
+    uint16_t LastCount;                 // CNT at the last read
+    int8_t Pending;                     // counts short of a detent
+    uint8_t CountsPerStep;
+    int8_t Direction;                   // of the last detent: 1, -1, 0 = none yet
+    uint32_t LastStepTime;              // tick of the last detent
+    uint16_t Rate;                      // detents per second, averaged
+
+    uint16_t AccelStart;
+    uint16_t AccelFull;
+    uint8_t AccelMax;
+
+    int32_t Position;                   // sum of the steps reported
+} ENCODER_t;
+
+HAL_StatusTypeDef ENCODER_Init(ENCODER_t* enc, TIM_HandleTypeDef* htim, uint8_t countsPerStep,
+                               ENCODER_Handler Handler, GPIO_TypeDef* swPort, uint16_t swPin,
+                               void (*SwitchHandler)(Button_t*, ButtonPressType_t));
+void ENCODER_Deinit(ENCODER_t* enc);
+void ENCODER_Update(ENCODER_t* enc);
+
+void ENCODER_SetAcceleration(ENCODER_t* enc, uint16_t start, uint16_t full, uint8_t max);
+int32_t ENCODER_GetPosition(const ENCODER_t* enc);
+void ENCODER_SetPosition(ENCODER_t* enc, int32_t position);
+
+__weak void ENCODER_Callback(ENCODER_t* enc, int32_t steps);
+
+#endif // __ENCODER_H
@@ -0,0 +1,222 @@
+/**
+ * @file EVBUS.c
+ * @brief ISR-safe event bus: drivers publish, the main loop dispatches.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "EVBUS.h"
+#include "TIMING.h"
+
+#if (EVBUS_QUEUE_SIZE & (EVBUS_QUEUE_SIZE - 1)) != 0
+#error "EVBUS_QUEUE_SIZE must be a power of two"
+#endif
+
+#define QUEUE_MASK (EVBUS_QUEUE_SIZE - 1U)
+
+// A slot is free for position p when Seq == p, holds the event of p when Seq == p + 1
+typedef struct {
+    volatile uint32_t Seq;
+    EVBUS_Event Event;
+} Slot;
+
+static Slot queue[EVBUS_QUEUE_SIZE];
+static volatile uint32_t head;      // next position to claim (producers)
+static uint32_t tail;               // next position to dispatch (consumer only)
+
+static EVBUS_Handler* handlers;
+static void (*wakeFn)(void* ctx);
+static void* wakeCtx;
+static EVBUS_Stats stats;
+
+static inline uint32_t ElapsedUs(uint32_t stamp) {
+    return TIMING_TicksToNs(TIMING_Elapsed(stamp)) / 1000U;
+}
+
+// ========== Setup ==========
+
+void EVBUS_Init(void) {
+    for (uint32_t i = 0; i < EVBUS_QUEUE_SIZE; i++) {
+        queue[i].Seq = i;
+    }
+    head = 0;
+    tail = 0;
+    handlers = NULL;
+    wakeFn = NULL;
+    EVBUS_ResetStats();
+}
+
+// Appended: handlers see each event in subscription order
+HAL_StatusTypeDef EVBUS_Subscribe(EVBUS_Handler* handler, uint32_t mask, EVBUS_HandlerFn fn, void* ctx) {
+    if (handler == NULL || fn == NULL) return HAL_ERROR;
+
+    EVBUS_Unsubscribe(handler);
+    handler->Mask = mask;
+    handler->Fn = fn;
+    handler->Ctx = ctx;
+    handler->Stats = (EVBUS_HandlerStats){0};
+    handler->Next = NULL;
+
+    EVBUS_Handler** link = &handlers;
+    while (*link) link = &(*link)->Next;
+    *link = handler;
+    return HAL_OK;
+}
+
+void EVBUS_Unsubscribe(EVBUS_Handler* handler) {
+    for (EVBUS_Handler** link = &handlers; *link; link = &(*link)->Next) {
+        if (*link == handler) {
+            *link = handler->Next;
+            return;
+        }
+    }
+}
+
+// Called after each publish, from the publishing context (keep it ISR safe)
+void EVBUS_OnPublish(void (*fn)(void* ctx), void* ctx) {
+    wakeCtx = ctx;
+    wakeFn = fn;
+}
+
+// ========== Producers ==========
+
+// ISR safe: claim a position, fill its slot, then mark it ready
+HAL_StatusTypeDef EVBUS_Publish(uint8_t type, uint8_t sub, uint16_t arg, void* source) {
+    uint32_t stamp = TIMING_Now();
+    uint32_t pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    Slot* slot;
+
+    for (;;) {
+        slot = &queue[pos & QUEUE_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->Seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff < 0) {
+            __atomic_fetch_add(&stats.Dropped, 1U, __ATOMIC_RELAXED);
+            return HAL_BUSY;
+        }
+        // diff > 0: another producer took 'pos' meanwhile, the failed CAS reloads it
+        if (diff == 0 && __atomic_compare_exchange_n(&head, &pos, pos + 1U, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        if (diff > 0) pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    }
+
+    slot->Event.Type = type;
+    slot->Event.Sub = sub;
+    slot->Event.Arg = arg;
+    slot->Event.Source = source;
+    slot->Event.Stamp = stamp;
+    __atomic_store_n(&slot->Seq, pos + 1U, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&stats.Published, 1U, __ATOMIC_RELAXED);
+    uint32_t depth = pos + 1U - tail;
+    if (depth > stats.MaxDepth) stats.MaxDepth = depth;
+
+    void (*fn)(void*) = wakeFn;
+    if (fn) fn(wakeCtx);
+    return HAL_OK;
+}
+
+// ========== Consumer ==========
+
+static void Deliver(const EVBUS_Event* ev) {
+    uint32_t bit = EVBUS_MASK(ev->Type & EVBUS_EV_MAX);
+
+    for (EVBUS_Handler* h = handlers; h; h = h->Next) {
+        if (!(h->Mask & bit)) continue;
+
+        uint32_t latency = ElapsedUs(ev->Stamp);
+        uint32_t start = TIMING_Now();
+        h->Fn(h, ev);
+        uint32_t run = ElapsedUs(start);
+
+        h->Stats.Events++;
+        h->Stats.LatencySumUs += latency;
+        if (latency > h->Stats.LatencyMaxUs) h->Stats.LatencyMaxUs = latency;
+        if (run > h->Stats.RunTimeMaxUs) h->Stats.RunTimeMaxUs = run;
+        if (latency > stats.LatencyMaxUs) stats.LatencyMaxUs = latency;
+    }
+}
+
+// Hand up to 'max' events (0 = all ready) to the handlers; returns how many
+uint32_t EVBUS_Dispatch(uint32_t max) {
+    uint32_t n = 0;
+
+    while (max == 0 || n < max) {
+        Slot* slot = &queue[tail & QUEUE_MASK];
+        // Stops at a slot still being filled, even if later ones are ready
+        if (__atomic_load_n(&slot->Seq, __ATOMIC_ACQUIRE) != tail + 1U) break;
+
+        EVBUS_Event ev = slot->Event;
+        __atomic_store_n(&slot->Seq, tail + EVBUS_QUEUE_SIZE, __ATOMIC_RELEASE);
+        tail++;
+
+        Deliver(&ev);
+        stats.Dispatched++;
+        n++;
+    }
+    return n;
+}
+
+uint32_t EVBUS_Pending(void) {
+    return __atomic_load_n(&head, __ATOMIC_RELAXED) - tail;
+}
+
+// ========== Statistics ==========
+
+const EVBUS_Stats* EVBUS_GetStats(void) {
+    return &stats;
+}
+
+void EVBUS_ResetStats(void) {
+    stats = (EVBUS_Stats){0};
+    for (EVBUS_Handler* h = handlers; h; h = h->Next) {
+        h->Stats = (EVBUS_HandlerStats){0};
+    }
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. Build the drivers with EVBUS_ENABLED=1 (Project > Properties > C/C++ Build > Settings > Symbols)
+
+# 2. Subscribe, and let the scheduler run the dispatcher when something is published
+
+static EVBUS_Handler uiHandler, busHandler;
+static SCHED_Task evTask;
+
+void EventTask(SCHED_Task* task) {
+    EVBUS_Dispatch(0);
+}
+
+void WakeEvents(void* ctx) {
+    SCHED_Notify((SCHED_Task*)ctx);     // ISR safe
+}
+
+void OnUi(EVBUS_Handler* h, const EVBUS_Event* ev) {
+    if (ev->Type == EVBUS_EV_BUTTON && ev->Sub == BUTTON_PressType_Long) MenuOpen();
+    if (ev->Type == EVBUS_EV_HCSR04_ECHO) ShowDistance(HCSR04_ReadDistanceMm((HCSR04_t*)ev->Source));
+}
+
+int main(void) {
+    ...
+    EVBUS_Init();
+    EVBUS_Subscribe(&uiHandler, EVBUS_MASK(EVBUS_EV_BUTTON) | EVBUS_MASK(EVBUS_EV_HCSR04_ECHO), OnUi, NULL);
+    EVBUS_Subscribe(&busHandler, EVBUS_MASK(EVBUS_EV_I2C_DONE), OnBusDone, NULL);
+    SCHED_Every(&evTask, "events", EventTask, NULL, 1000);   // + at once on each publish
+    EVBUS_OnPublish(WakeEvents, &evTask);
+    Button_t* btn = BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, NULL);  // no inline handler
+    ...
+    SCHED_Run();
+}
+
+# 3. Own events, from any ISR or task
+
+EVBUS_Publish(EVBUS_EV_USER + 0, 0, adcValue, NULL);
+
+# 4. Latency check
+
+EVBUS_GetStats()->LatencyMaxUs        // worst publish -> handler
+uiHandler.Stats.RunTimeMaxUs          // slowest handler run
+
+*/
@@ -0,0 +1,121 @@
+/**
+ * @file EVBUS.h
+ * @brief ISR-safe event bus: drivers publish, the main loop dispatches.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Without the bus every driver reports in its own way: button presses call the
+ * handler inside BUTTON_Update, an HC-SR04 echo ends in a capture ISR, I2C_BUS
+ * callbacks run from the transfer-complete ISR, DHT22 and RTC alarms are return
+ * codes. Built with EVBUS_ENABLED=1, those drivers also publish a small typed event
+ * (EVBUS_Event) into one queue, and EVBUS_Dispatch hands them to the subscribed
+ * handlers from the main loop:
+ * - a slow handler never runs inside an ISR, nor inside another driver's update;
+ * - every event carries its publish time: producer-to-handler latency is measured
+ *   per handler and overall.
+ *
+ * Notes:
+ * - Multi-producer, single-consumer ring of EVBUS_QUEUE_SIZE events. A slot is
+ *   claimed with a compare-and-swap and published with its sequence number
+ *   (LDREX/STREX on Cortex-M3), so ISRs of any priority and the main loop publish
+ *   without masking interrupts. Only one context may call EVBUS_Dispatch.
+ * - When the queue is full the event is dropped and counted, the producer never waits.
+ * - Handlers are owned by the caller (no dynamic memory) and receive the types of
+ *   their mask, in subscription order.
+ * - EVBUS_OnPublish wakes the dispatcher, e.g. with SCHED_Notify.
+ * - With the default EVBUS_ENABLED=0 the driver hooks compile to nothing.
+ */
+
+
+
+#ifndef __EVBUS_H
+#define __EVBUS_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#ifndef EVBUS_ENABLED
+#define EVBUS_ENABLED 0
+#endif
+
+// Events in flight (power of two), 12 bytes each + 4 of sequence
+#ifndef EVBUS_QUEUE_SIZE
+#define EVBUS_QUEUE_SIZE 32
+#endif
+
+// Event types (bit number in a handler mask)
+typedef enum {
+    EVBUS_EV_BUTTON,        // Source: Button_t*, Sub: ButtonPressType_t
+    EVBUS_EV_HCSR04_ECHO,   // Source: HCSR04_t*, Arg: echo in timer ticks (ISR)
+    EVBUS_EV_DHT22_READ,    // Source: DHT22_HandleTypedef*, Sub: DHT22_StatusTypedef
+    EVBUS_EV_RTC_ALARM,     // Source: DS_RTC_HandleTypeDef*, Sub: alarm flags (bit 0 = alarm 1)
+    EVBUS_EV_I2C_DONE,      // Source: I2C_BUS_Transaction*, Sub: HAL status, Arg: device address (ISR)
+    EVBUS_EV_GESTURE,       // Source: const GESTURE_Def*, Sub: table index, Arg: clicks (GESTURE_CLICKS)
+    EVBUS_EV_USER = 8,      // application events: EVBUS_EV_USER .. 31
+    EVBUS_EV_MAX = 31
+} EVBUS_Type;
+
+#define EVBUS_MASK(type) (1UL << (type))
+#define EVBUS_MASK_ALL   0xFFFFFFFFUL
+
+typedef struct {
+    uint8_t Type;           // EVBUS_Type
+    uint8_t Sub;            // per type, see EVBUS_Type
+    uint16_t Arg;
+    void* Source;           // driver handle that published
+    uint32_t Stamp;         // TIMING_Now() at publish
+} EVBUS_Event;
+
+typedef struct EVBUS_Handler_s EVBUS_Handler;
+typedef void (*EVBUS_HandlerFn)(EVBUS_Handler* handler, const EVBUS_Event* event);
+
+typedef struct {
+    uint32_t Events;
+    uint32_t LatencyMaxUs;      // publish -> start of the handler
+    uint32_t LatencySumUs;
+    uint32_t RunTimeMaxUs;
+} EVBUS_HandlerStats;
+
+struct EVBUS_Handler_s {
+    uint32_t Mask;              // EVBUS_MASK of the types received
+    EVBUS_HandlerFn Fn;
+    void* Ctx;
+    EVBUS_HandlerStats Stats;
+    EVBUS_Handler* Next;
+};
+
+typedef struct {
+    uint32_t Published;
+    uint32_t Dropped;           // queue full
+    uint32_t Dispatched;
+    uint32_t MaxDepth;          // most events waiting at once
+    uint32_t LatencyMaxUs;      // publish -> dispatch, any handler
+} EVBUS_Stats;
+
+// Setup
+void EVBUS_Init(void);
+HAL_StatusTypeDef EVBUS_Subscribe(EVBUS_Handler* handler, uint32_t mask, EVBUS_HandlerFn fn, void* ctx);
+void EVBUS_Unsubscribe(EVBUS_Handler* handler);
+void EVBUS_OnPublish(void (*fn)(void* ctx), void* ctx);
+
+// Producers (any context)
+HAL_StatusTypeDef EVBUS_Publish(uint8_t type, uint8_t sub, uint16_t arg, void* source);
+
+// Consumer (one context)
+uint32_t EVBUS_Dispatch(uint32_t max);
+uint32_t EVBUS_Pending(void);
+
+// Statistics
+const EVBUS_Stats* EVBUS_GetStats(void);
+void EVBUS_ResetStats(void);
+
+// Driver hook
+#if EVBUS_ENABLED
+#define EVBUS_PUBLISH(type, sub, arg, source) \
+    ((void)EVBUS_Publish((type), (uint8_t)(sub), (uint16_t)(arg), (void*)(source)))
+#else
+#define EVBUS_PUBLISH(type, sub, arg, source) ((void)0)
+#endif
+
+#endif // __EVBUS_H
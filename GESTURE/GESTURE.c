@@ -0,0 +1,279 @@
+/**
+ * @file GESTURE.c
+ * @brief Chords, N-clicks and press sequences over the debounced button edges.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Functions:
+ * - GESTURE_Init: Compiles a gesture table and hooks the button edges.
+ * - GESTURE_Bind: Key number of a button.
+ * - GESTURE_Update: Timeouts of the gestures in progress.
+ * - GESTURE_NextUpdate: Time until the next timeout (for a scheduler).
+ */
+
+
+
+#include "GESTURE.h"
+#include "EVBUS.h"
+
+typedef struct {
+    uint32_t Deadline;      // first tick of the timeout (bit set in timedMask)
+    uint8_t Down;           // CHORD: one bit per key of the chord held
+    uint8_t Step;           // CLICKS: clicks so far, SEQUENCE: keys matched
+    uint8_t Done;           // CHORD: reported for this hold
+} GestureState;
+
+static const GESTURE_Def* gestures;
+static uint8_t gestureCount;
+static GESTURE_Handler gestureHandler;
+static GestureState state[GESTURE_MAX];
+
+static uint32_t keyMask[GESTURE_MAX_KEYS];     // gestures using each key (the compiled table)
+static uint8_t seqBack[GESTURE_MAX][GESTURE_KEYS]; // SEQUENCE: keys still matched when the next one differs
+static uint32_t activeMask;                     // gestures in progress
+static uint32_t timedMask;                      // in progress with a timeout
+
+static ButtonHandle_t keyHandle[GESTURE_MAX_KEYS];
+static uint8_t slotKey[BUTTON_MAX];             // key + 1 of a pool slot, checked against keyHandle
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef GESTURE_Init(const GESTURE_Def* table, uint8_t count, GESTURE_Handler handler) {
+    if ((table == NULL && count) || count > GESTURE_MAX) return HAL_ERROR;
+
+    for (uint8_t g = 0; g < count; g++) {
+        const GESTURE_Def* d = &table[g];
+        if (d->KeyCount == 0 || d->KeyCount > GESTURE_KEYS) return HAL_ERROR;
+        if (d->Type == GESTURE_CLICKS && d->KeyCount != 1) return HAL_ERROR;
+        for (uint8_t k = 0; k < d->KeyCount; k++) {
+            if (d->Keys[k] >= GESTURE_MAX_KEYS) return HAL_ERROR;
+        }
+    }
+
+    for (uint8_t k = 0; k < GESTURE_MAX_KEYS; k++) keyMask[k] = 0;
+    for (uint8_t g = 0; g < count; g++) {
+        for (uint8_t k = 0; k < table[g].KeyCount; k++) keyMask[table[g].Keys[k]] |= 1UL << g;
+        state[g] = (GestureState){0};
+
+        // Failure table: seqBack[g][k] = longest proper prefix that is also a suffix of Keys[0..k]
+        const uint8_t* keys = table[g].Keys;
+        seqBack[g][0] = 0;
+        for (uint8_t k = 1, n = 0; k < table[g].KeyCount; k++) {
+            while (n && keys[k] != keys[n]) n = seqBack[g][n - 1U];
+            if (keys[k] == keys[n]) n++;
+            seqBack[g][k] = n;
+        }
+    }
+    gestures = table;
+    gestureCount = count;
+    gestureHandler = handler;
+    activeMask = 0;
+    timedMask = 0;
+    BUTTON_SetEdgeHook(GESTURE_OnEdge);
+    return HAL_OK;
+}
+
+// Key 'key' is now the button 'btn' (NULL unbinds); bindings are kept across GESTURE_Init
+HAL_StatusTypeDef GESTURE_Bind(uint8_t key, Button_t* btn) {
+    if (key >= GESTURE_MAX_KEYS) return HAL_ERROR;
+
+    ButtonHandle_t handle = BUTTON_GetHandle(btn);
+    if (btn != NULL && handle == 0) return HAL_ERROR;
+
+    if (keyHandle[key]) slotKey[(keyHandle[key] & 0xFFFFU) - 1U] = 0;
+    keyHandle[key] = handle;
+    if (handle) slotKey[(handle & 0xFFFFU) - 1U] = (uint8_t)(key + 1U);
+    return HAL_OK;
+}
+
+// ========== Recognition ==========
+
+static void GESTURE_Fire(uint8_t g, uint16_t arg) {
+    EVBUS_PUBLISH(EVBUS_EV_GESTURE, g, arg, &gestures[g]);
+    if (gestureHandler) gestureHandler(g, arg);
+}
+
+static void GESTURE_Arm(uint8_t g, uint32_t at) {
+    state[g].Deadline = at;
+    timedMask |= 1UL << g;
+}
+
+// The timeout of gesture 'g' is reached
+static void GESTURE_Timeout(uint8_t g) {
+    const GESTURE_Def* d = &gestures[g];
+    GestureState* s = &state[g];
+
+    timedMask &= ~(1UL << g);
+    switch (d->Type) {
+        case GESTURE_CHORD:         // held long enough
+            s->Done = 1;
+            GESTURE_Fire(g, 0);
+            break;
+        case GESTURE_CLICKS:        // no further click: the run is over
+            if (d->Clicks ? s->Step == d->Clicks : s->Step >= 2) GESTURE_Fire(g, s->Step);
+            s->Step = 0;
+            activeMask &= ~(1UL << g);
+            break;
+        case GESTURE_SEQUENCE:      // next key too late
+            s->Step = 0;
+            activeMask &= ~(1UL << g);
+            break;
+    }
+}
+
+// One debounced edge of key 'key' for gesture 'g' (a key of 'g', or any key while 'g' is in progress)
+static void GESTURE_Step(uint8_t g, uint8_t key, uint8_t pressed, uint32_t tick) {
+    const GESTURE_Def* d = &gestures[g];
+    GestureState* s = &state[g];
+    uint32_t bit = 1UL << g;
+
+    int8_t pos = -1;
+    for (uint8_t k = 0; k < d->KeyCount; k++) {
+        if (d->Keys[k] == key) pos = (int8_t)k;
+    }
+
+    switch (d->Type) {
+        case GESTURE_CHORD: {
+            if (pos < 0) break;
+            uint8_t all = (uint8_t)((1U << d->KeyCount) - 1U);
+            if (pressed) {
+                s->Down |= (uint8_t)(1U << pos);
+                if (s->Down == all && !s->Done) {
+                    if (d->TimeMs == 0) {
+                        s->Done = 1;
+                        GESTURE_Fire(g, 0);
+                    } else {
+                        GESTURE_Arm(g, tick + d->TimeMs);
+                    }
+                }
+            } else {
+                s->Down &= (uint8_t)~(1U << pos);
+                s->Done = 0;
+                timedMask &= ~bit;
+            }
+            if (s->Down) activeMask |= bit; else activeMask &= ~bit;
+            break;
+        }
+
+        case GESTURE_CLICKS:
+            if (pos < 0) {
+                // Another key pressed in the middle of the run
+                if (pressed) {
+                    s->Step = 0;
+                    activeMask &= ~bit;
+                    timedMask &= ~bit;
+                }
+            } else if (pressed) {
+                timedMask &= ~bit;      // in time for one more click, wait for its release
+            } else {
+                if (s->Step < 0xFFU) s->Step++;
+                activeMask |= bit;
+                GESTURE_Arm(g, tick + d->TimeMs + 1U);
+            }
+            break;
+
+        case GESTURE_SEQUENCE:
+            if (!pressed) break;
+            // Wrong key: fall back on the longest start of the sequence the presses still end with
+            while (s->Step && key != d->Keys[s->Step]) s->Step = seqBack[g][s->Step - 1U];
+            if (key == d->Keys[s->Step]) s->Step++;
+            if (s->Step == d->KeyCount) {
+                s->Step = 0;
+                GESTURE_Fire(g, 0);
+            }
+            if (s->Step) {
+                activeMask |= bit;
+                GESTURE_Arm(g, tick + d->TimeMs + 1U);
+            } else {
+                activeMask &= ~bit;
+                timedMask &= ~bit;
+            }
+            break;
+    }
+}
+
+// BUTTON edge hook: only the gestures of this key and those in progress are visited
+void GESTURE_OnEdge(Button_t* btn, uint8_t pressed, uint32_t tick) {
+    ButtonHandle_t handle = BUTTON_GetHandle(btn);
+    if (handle == 0) return;
+    uint8_t key = slotKey[(handle & 0xFFFFU) - 1U];
+    if (key == 0 || keyHandle[key - 1U] != handle) return;     // not bound (or an old button of that slot)
+    key--;
+
+    // Timeouts that fell before this edge come first
+    for (uint32_t bits = timedMask; bits; bits &= bits - 1U) {
+        uint8_t g = (uint8_t)__builtin_ctz(bits);
+        if ((int32_t)(tick - state[g].Deadline) >= 0) GESTURE_Timeout(g);
+    }
+
+    for (uint32_t bits = keyMask[key] | activeMask; bits; bits &= bits - 1U) {
+        GESTURE_Step((uint8_t)__builtin_ctz(bits), key, pressed, tick);
+    }
+}
+
+// ========== Update ==========
+
+void GESTURE_Update(void) {
+    uint32_t now = HAL_GetTick();
+    for (uint32_t bits = timedMask; bits; bits &= bits - 1U) {
+        uint8_t g = (uint8_t)__builtin_ctz(bits);
+        if ((int32_t)(now - state[g].Deadline) >= 0) GESTURE_Timeout(g);
+    }
+}
+
+// Milliseconds until the nearest timeout, BUTTON_FOREVER when no gesture is timed
+uint32_t GESTURE_NextUpdate(void) {
+    uint32_t now = HAL_GetTick();
+    uint32_t next = BUTTON_FOREVER;
+
+    for (uint32_t bits = timedMask; bits; bits &= bits - 1U) {
+        int32_t wait = (int32_t)(state[__builtin_ctz(bits)].Deadline - now);
+        if (wait <= 0) return 0;
+        if ((uint32_t)wait < next) next = (uint32_t)wait;
+    }
+    return next;
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. Key numbers and the gesture table (constant, in flash)
+
+enum { KEY_UP, KEY_DOWN, KEY_OK };
+enum { G_UNLOCK, G_TRIPLE_OK, G_CLICKS_UP, G_KONAMI };
+
+static const GESTURE_Def gestureTable[] = {
+	[G_UNLOCK]    = { GESTURE_CHORD,    2, { KEY_UP, KEY_DOWN }, 0, 1000 },		// UP+DOWN held 1 s
+	[G_TRIPLE_OK] = { GESTURE_CLICKS,   1, { KEY_OK }, 3, 300 },				// exactly 3 clicks
+	[G_CLICKS_UP] = { GESTURE_CLICKS,   1, { KEY_UP }, 0, 300 },				// 2+ clicks, count in arg
+	[G_KONAMI]    = { GESTURE_SEQUENCE, 4, { KEY_UP, KEY_UP, KEY_DOWN, KEY_OK }, 0, 800 },
+};
+
+void Gesture_Handler(uint8_t gesture, uint16_t arg) {
+	switch (gesture) {
+		case G_UNLOCK: Unlock(); break;
+		case G_TRIPLE_OK: FactoryMenu(); break;
+		case G_CLICKS_UP: ScrollUp(arg); break;
+		case G_KONAMI: ShowCredits(); break;
+	}
+}
+
+
+# 2. Buttons as usual, then bind them to key numbers
+
+	GESTURE_Init(gestureTable, sizeof(gestureTable) / sizeof(gestureTable[0]), Gesture_Handler);
+	GESTURE_Bind(KEY_UP, BUTTON_Init(GPIOA, GPIO_PIN_0, 0, BUTTON_Mode_Toggle, Up_Handler));
+	GESTURE_Bind(KEY_DOWN, BUTTON_Init(GPIOA, GPIO_PIN_1, 0, BUTTON_Mode_Toggle, Down_Handler));
+	GESTURE_Bind(KEY_OK, BUTTON_Init(GPIOA, GPIO_PIN_2, 0, BUTTON_Mode_Toggle, NULL));
+
+
+# 3. Main loop: the edges come from BUTTON_Update, the timeouts from GESTURE_Update
+
+while (1)
+{
+	BUTTON_Update();
+	GESTURE_Update();
+}
+
+*/
@@ -0,0 +1,80 @@
+/**
+ * @file GESTURE.h
+ * @brief Chords, N-clicks and press sequences over the debounced button edges.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * BUTTON reports per button (Normal, Long, Double, Repeat...). GESTURE recognizes
+ * what spans several presses or several buttons, from a constant table given to
+ * GESTURE_Init:
+ * - GESTURE_CHORD: all keys held together for TimeMs (0 = as soon as all are down).
+ * - GESTURE_CLICKS: Clicks clicks of one key, at most TimeMs between a release and
+ *   the next press; reported TimeMs after the last release. Clicks = 0 counts any
+ *   run of 2 clicks or more (count in 'arg').
+ * - GESTURE_SEQUENCE: the keys pressed in order, at most TimeMs apart, no other
+ *   key pressed in between. A wrong press keeps the longest start of the sequence
+ *   it still ends (UP UP UP DOWN OK matches UP,UP,DOWN,OK).
+ *
+ * Keys are numbers 0..GESTURE_MAX_KEYS-1 bound to buttons with GESTURE_Bind. Init
+ * compiles the table into one gesture mask per key: a debounced edge (BUTTON edge
+ * hook, at the time of the edge) visits the gestures of its key and the gestures in
+ * progress only, and GESTURE_Update only the gestures in progress, whatever the
+ * number of buttons and gestures. The per-button press types still reach the button
+ * handlers; a recognized gesture calls the gesture handler (and publishes
+ * EVBUS_EV_GESTURE).
+ *
+ * Notes:
+ * - Up to GESTURE_MAX (32) gestures of up to GESTURE_KEYS keys each.
+ * - GESTURE_Update (timeouts) from the main loop, like BUTTON_Update.
+ */
+
+
+
+#ifndef __GESTURE_H
+#define __GESTURE_H
+
+#include "stm32f1xx_hal.h"
+#include "BUTTON.h"
+#include <stdint.h>
+
+// Gestures of a table (one bit each in a 32-bit mask)
+#ifndef GESTURE_MAX
+#define GESTURE_MAX 32
+#endif
+
+#ifndef GESTURE_MAX_KEYS
+#define GESTURE_MAX_KEYS 16
+#endif
+
+// Keys of one chord / sequence
+#ifndef GESTURE_KEYS
+#define GESTURE_KEYS 4
+#endif
+
+typedef enum {
+    GESTURE_CHORD = 0,
+    GESTURE_CLICKS,
+    GESTURE_SEQUENCE
+} GESTURE_Type;
+
+typedef struct {
+    GESTURE_Type Type;
+    uint8_t KeyCount;               // CLICKS: 1
+    uint8_t Keys[GESTURE_KEYS];
+    uint8_t Clicks;                 // CLICKS only: exact count, 0 = any count >= 2
+    uint16_t TimeMs;                // CHORD: hold, CLICKS / SEQUENCE: max gap
+} GESTURE_Def;
+
+// Called with the table index of the gesture; arg = clicks for GESTURE_CLICKS
+typedef void (*GESTURE_Handler)(uint8_t gesture, uint16_t arg);
+
+HAL_StatusTypeDef GESTURE_Init(const GESTURE_Def* table, uint8_t count, GESTURE_Handler handler);
+HAL_StatusTypeDef GESTURE_Bind(uint8_t key, Button_t* btn);
+void GESTURE_Update(void);
+uint32_t GESTURE_NextUpdate(void);
+
+// BUTTON edge hook (installed by GESTURE_Init)
+void GESTURE_OnEdge(Button_t* btn, uint8_t pressed, uint32_t tick);
+
+#endif // __GESTURE_H
@@ -0,0 +1,87 @@
+/**
+ * @file GPIO_FAST.h
+ * @brief Direct-register GPIO access for bit-banged drivers.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * HAL_GPIO_WritePin / HAL_GPIO_ReadPin are real function calls with parameter
+ * checks; on a bit-banged bus they are paid on every edge. This header keeps the
+ * BSRR set/reset masks and the IDR mask of a pin so an edge becomes one store
+ * and a sample one load. Pins of the same port can be updated together with a
+ * single BSRR store (set bits low half, reset bits high half).
+ *
+ * Drivers opt in at compile time with their own switch:
+ * - TM1637_FAST_GPIO, LCD162_FAST_GPIO, DHT22_FAST_GPIO (default 0 = HAL calls)
+ *
+ * Notes:
+ * - Pin mode changes still go through HAL_GPIO_Init.
+ * - BSRR writes are atomic, no read-modify-write of ODR, safe against ISRs.
+ */
+
+
+
+#ifndef __GPIO_FAST_H
+#define __GPIO_FAST_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#ifdef HAL_SIM
+#include "HAL_SIM.h"
+#endif
+
+typedef struct {
+    GPIO_TypeDef* Port;
+    uint32_t SetMask;     // BSRR value that drives the pin high
+    uint32_t ResetMask;   // BSRR value that drives the pin low
+    uint32_t IdrMask;     // IDR bit of the pin
+} GPIO_FAST_Pin;
+
+// Precompute the masks of one pin (call once at driver init)
+static inline void GPIO_FAST_Init(GPIO_FAST_Pin* p, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    p->Port = GPIOx;
+    p->SetMask = GPIO_Pin;
+    p->ResetMask = (uint32_t)GPIO_Pin << 16;
+    p->IdrMask = GPIO_Pin;
+}
+
+// One BSRR store: any mix of pins of the port set and reset at once
+static inline void GPIO_FAST_WriteBSRR(GPIO_TypeDef* GPIOx, uint32_t bsrr) {
+#ifdef HAL_SIM
+    HAL_SIM_GPIO_WriteBSRR(GPIOx, bsrr);
+#else
+    GPIOx->BSRR = bsrr;
+#endif
+}
+
+static inline uint32_t GPIO_FAST_ReadIDR(GPIO_TypeDef* GPIOx) {
+#ifdef HAL_SIM
+    return HAL_SIM_GPIO_ReadIDR(GPIOx);
+#else
+    return GPIOx->IDR;
+#endif
+}
+
+// BSRR value that writes 'value' to the pins in 'mask' (others untouched)
+static inline uint32_t GPIO_FAST_BSRR(uint16_t mask, uint16_t value) {
+    return (uint32_t)(value & mask) | ((uint32_t)(~value & mask) << 16);
+}
+
+static inline void GPIO_FAST_High(const GPIO_FAST_Pin* p) {
+    GPIO_FAST_WriteBSRR(p->Port, p->SetMask);
+}
+
+static inline void GPIO_FAST_Low(const GPIO_FAST_Pin* p) {
+    GPIO_FAST_WriteBSRR(p->Port, p->ResetMask);
+}
+
+static inline void GPIO_FAST_Write(const GPIO_FAST_Pin* p, uint8_t level) {
+    GPIO_FAST_WriteBSRR(p->Port, level ? p->SetMask : p->ResetMask);
+}
+
+static inline uint8_t GPIO_FAST_Read(const GPIO_FAST_Pin* p) {
+    return (GPIO_FAST_ReadIDR(p->Port) & p->IdrMask) ? 1 : 0;
+}
+
+#endif // __GPIO_FAST_H
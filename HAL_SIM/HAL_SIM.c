@@ -0,0 +1,1688 @@
+/**
+ * @file HAL_SIM.c
+ * @brief Host-side implementation of the HAL subset used by the drivers.
+ *
+ * Everything runs on one virtual clock counted in CPU cycles at SystemCoreClock.
+ * A HAL call first charges its cost (HAL_SIM_CostModel), then acts on the
+ * simulated peripherals:
+ *
+ * - GPIO: ODR/IDR registers per port. A pin reads its output level when it is an
+ *   output, otherwise the level set by the test (static or scripted waveform).
+ * - SysTick: uwTick follows the clock one increment per ms, HAL_Delay jumps the
+ *   clock exactly like the real HAL (Delay + 1 tick of wait). HAL_SuspendTick
+ *   stops the increments, the counter phase keeps running.
+ * - __WFI jumps the clock to the next interrupt: a scheduled event, or the next
+ *   SysTick while the tick is not suspended.
+ * - TIM: the counter is computed from the clock, prescaler and auto-reload,
+ *   captures are injected by the test. HAL_TIM_Base_Start_IT raises the update
+ *   interrupt at every counter wrap.
+ * - I2C: transfers are routed to attached virtual slaves and take the bus time
+ *   of every bit at Init.ClockSpeed. _IT/_DMA transfers return at once and
+ *   complete from a scheduled event that calls the HAL callbacks.
+ * - SPI: a DMA receive takes 8 SCK periods per byte and reads a 74HC165 chain
+ *   latched by its SH/LD pin (the bytes are fixed when the transfer starts).
+ *
+ * Notes:
+ * - Scheduled events fire while the clock advances, so they behave like ISRs
+ *   preempting the code under test.
+ * - Not thread safe; one simulation per process.
+ */
+
+
+
+#include "HAL_SIM.h"
+#include <string.h>
+
+uint32_t SystemCoreClock = HAL_SIM_SYSCLK_HZ;
+
+GPIO_TypeDef HAL_SIM_GPIOPorts[5];
+TIM_TypeDef HAL_SIM_TIMs[4];
+I2C_TypeDef HAL_SIM_I2Cs[2];
+USART_TypeDef HAL_SIM_USARTs[3];
+ADC_TypeDef HAL_SIM_ADCs[2];
+SPI_TypeDef HAL_SIM_SPIs[2];
+DWT_Type HAL_SIM_DWT;
+CoreDebug_Type HAL_SIM_CoreDebug;
+
+#define SIM_PORT_COUNT (sizeof(HAL_SIM_GPIOPorts) / sizeof(HAL_SIM_GPIOPorts[0]))
+#define SIM_TIM_COUNT  (sizeof(HAL_SIM_TIMs) / sizeof(HAL_SIM_TIMs[0]))
+
+static const HAL_SIM_CostModel defaultCost = {
+    .GpioWrite   = 20,
+    .GpioRead    = 20,
+    .GpioInit    = 150,
+    .GpioReg     = 2,
+    .TimAccess   = 6,
+    .Nop         = 8,
+    .GetTick     = 12,
+    .I2cOverhead = 400,
+    .I2cIrq      = 150,
+    .UartOverhead = 300,
+    .UartIrq      = 150,
+    .ExtiIrq      = 40,
+    .AdcIrq       = 60,
+    .SpiOverhead  = 250,
+    .SpiIrq       = 150,
+};
+
+typedef struct {
+    const HAL_SIM_PinStep *Steps;
+    uint16_t Count;
+    uint8_t Idle;
+    uint64_t Start;
+} SimScript;
+
+typedef struct {
+    uint16_t OutMask;      // pins configured as output through HAL_GPIO_Init
+    uint16_t ExtMask;      // pins driven by the test
+    uint16_t ExtLevel;
+    uint16_t ScriptMask;   // pins currently playing a waveform
+    SimScript Script[16];
+    HAL_SIM_PinWriteHook Hook[16];
+    void *HookCtx[16];
+} SimPort;
+
+typedef struct {
+    uint8_t Running;
+    uint8_t ItMask;        // input capture interrupts enabled, one bit per channel
+    uint8_t UpdateIt;      // update interrupt enabled
+    uint8_t Encoder;       // CNT clocked by the A/B inputs, not by the timer clock
+    uint64_t Base;         // clock value at which the counter was 0
+    uint64_t FlagCleared;  // clock value of the last UIF clear
+    uint64_t StoppedAt;    // clock value at which the counter was stopped
+    uint32_t Polarity[4];
+} SimTim;
+
+typedef struct {
+    uint64_t At;
+    HAL_SIM_EventFn Fn;
+    void *Ctx;
+} SimEvent;
+
+static uint64_t simCycles;
+static HAL_SIM_CostModel simCost;
+static HAL_SIM_Stats simStats;
+static uint64_t statsBase;
+
+static SimPort simPorts[SIM_PORT_COUNT];
+static uint8_t scriptsActive;
+static SimTim simTims[SIM_TIM_COUNT];
+static SimEvent simEvents[HAL_SIM_MAX_EVENTS];
+static uint8_t eventCount;
+static uint8_t inEvent;
+static HAL_SIM_I2CSlave *simSlaves[HAL_SIM_MAX_I2C_SLAVES];
+static uint8_t dwtPresent = 1;
+static uint8_t swoBuf[HAL_SIM_SWO_BUF_SIZE];
+static uint32_t swoLen;
+static uint64_t swoFreeAt;      // clock value when the SWO pin is idle again
+static uint32_t simPrimask;
+
+volatile uint32_t uwTick;
+static uint64_t tickAnchor;     // clock value of the last uwTick increment
+static uint8_t tickSuspended;
+
+#define SIM_I2C_COUNT (sizeof(HAL_SIM_I2Cs) / sizeof(HAL_SIM_I2Cs[0]))
+
+// One interrupt / DMA driven transfer in flight per I2C instance
+typedef enum { XFER_TX, XFER_RX, XFER_MEM_WRITE, XFER_MEM_READ } SimXferKind;
+
+typedef struct {
+    I2C_HandleTypeDef *Handle;
+    HAL_SIM_I2CSlave *Slave;    // NULL = address NACKed
+    SimXferKind Kind;
+    uint16_t MemAddress;
+    uint8_t *Data;
+    uint16_t Size;
+    uint32_t Irqs;              // interrupts the transfer costs the CPU
+} SimI2cXfer;
+
+static SimI2cXfer simXfers[SIM_I2C_COUNT];
+
+// Slave misbehaviour per I2C instance
+typedef struct {
+    uint16_t Sda;               // SDA pin, released after SdaClocks SCL pulses
+    uint8_t SdaClocks;          // 0 = SDA free
+    uint64_t SclUntil;          // clock value when the slave lets SCL go
+} SimI2cFault;
+
+static SimI2cFault simFaults[SIM_I2C_COUNT];
+
+#define SIM_UART_COUNT (sizeof(HAL_SIM_USARTs) / sizeof(HAL_SIM_USARTs[0]))
+
+// Transmit side of one UART: DMA transfer in flight + what the receiver got
+typedef struct {
+    UART_HandleTypeDef *Handle;
+    const uint8_t *Data;
+    uint16_t Size;
+    uint32_t Len;
+    uint8_t Buf[HAL_SIM_UART_BUF_SIZE];
+} SimUart;
+
+static SimUart simUarts[SIM_UART_COUNT];
+
+// EXTI: one line per pin number, routed to one port (AFIO_EXTICR)
+typedef struct {
+    uint8_t Port[16];       // port index + 1, 0 = line not used
+    uint16_t Rising;
+    uint16_t Falling;
+    uint16_t Pending;       // EXTI_PR
+} SimExti;
+
+static SimExti simExti;
+
+#define SIM_ADC_COUNT (sizeof(HAL_SIM_ADCs) / sizeof(HAL_SIM_ADCs[0]))
+
+// One ADC converting continuously into a circular DMA buffer
+typedef struct {
+    ADC_HandleTypeDef *Handle;  // NULL = not converting
+    uint16_t *Buf;
+    uint32_t Len;
+    uint32_t Pos;               // next element the DMA writes
+    uint64_t NextAt;            // clock value at which that conversion ends
+    uint64_t Period;            // cycles per conversion, 0 = HAL_SIM_ADC_SAMPLE_NS
+    uint16_t Input;
+    uint16_t Noise;
+    uint32_t Seed;
+} SimAdc;
+
+static SimAdc simAdcs[SIM_ADC_COUNT];
+
+#define SIM_SPI_COUNT (sizeof(HAL_SIM_SPIs) / sizeof(HAL_SIM_SPIs[0]))
+
+// One SPI bus: DMA receive in flight + the 74HC165 chain on its MISO
+typedef struct {
+    SPI_HandleTypeDef *Handle;
+    uint8_t *Data;
+    uint16_t Size;
+    uint8_t Shifted[HAL_SIM_HC165_MAX_CHIPS];   // bytes of the transfer in flight
+    GPIO_TypeDef *LdPort;
+    uint16_t LdPin;
+    uint8_t Chips;                              // 0 = nothing on MISO (reads 0xFF)
+    uint16_t Clocked;                           // bytes shifted out since the last latch
+    uint64_t LdFall;                            // cycle SH/LD went low
+    uint32_t Loads;
+    uint8_t Inputs[HAL_SIM_HC165_MAX_CHIPS];
+    uint8_t Latch[HAL_SIM_HC165_MAX_CHIPS];
+} SimSpi;
+
+static SimSpi simSpis[SIM_SPI_COUNT];
+
+// ========== Clock ==========
+
+static uint64_t CyclesPerMs(void) {
+    return SystemCoreClock / 1000U;
+}
+
+uint64_t HAL_SIM_NsToCycles(uint64_t ns) {
+    return (ns * SystemCoreClock + 999999999ULL) / 1000000000ULL;
+}
+
+uint64_t HAL_SIM_CyclesToNs(uint64_t cycles) {
+    return cycles * 1000000000ULL / SystemCoreClock;
+}
+
+uint64_t HAL_SIM_Now(void) {
+    return simCycles;
+}
+
+// Fire every scheduled event that is due at or before 'target'
+static void RunEvents(uint64_t target) {
+    if (inEvent || simPrimask) return;
+
+    while (eventCount) {
+        uint8_t next = 0;
+        for (uint8_t i = 1; i < eventCount; ++i) {
+            if (simEvents[i].At < simEvents[next].At) next = i;
+        }
+        if (simEvents[next].At > target) break;
+
+        SimEvent ev = simEvents[next];
+        simEvents[next] = simEvents[--eventCount];
+
+        if (ev.At > simCycles) simCycles = ev.At;
+        HAL_SIM_GPIO_Sync();
+
+        inEvent = 1;
+        ev.Fn(ev.Ctx);
+        inEvent = 0;
+    }
+}
+
+void HAL_SIM_Advance(uint64_t cycles) {
+    uint64_t target = simCycles + cycles;
+
+    RunEvents(target);
+    if (target > simCycles) simCycles = target;
+    if (scriptsActive) HAL_SIM_GPIO_Sync();
+}
+
+void HAL_SIM_AdvanceUs(uint32_t us) {
+    HAL_SIM_Advance(HAL_SIM_NsToCycles((uint64_t)us * 1000U));
+}
+
+void HAL_SIM_Cancel(HAL_SIM_EventFn fn, void *ctx) {
+    for (uint8_t i = 0; i < eventCount;) {
+        if (simEvents[i].Fn == fn && simEvents[i].Ctx == ctx) simEvents[i] = simEvents[--eventCount];
+        else i++;
+    }
+}
+
+int HAL_SIM_Schedule(uint64_t at, HAL_SIM_EventFn fn, void *ctx) {
+    if (eventCount >= HAL_SIM_MAX_EVENTS || fn == NULL) return -1;
+    simEvents[eventCount].At = at;
+    simEvents[eventCount].Fn = fn;
+    simEvents[eventCount].Ctx = ctx;
+    eventCount++;
+    return 0;
+}
+
+HAL_SIM_CostModel *HAL_SIM_Cost(void) {
+    return &simCost;
+}
+
+void HAL_SIM_GetStats(HAL_SIM_Stats *stats) {
+    *stats = simStats;
+    stats->Cycles = simCycles - statsBase;
+}
+
+void HAL_SIM_ResetStats(void) {
+    memset(&simStats, 0, sizeof(simStats));
+    statsBase = simCycles;
+}
+
+void HAL_SIM_Reset(void) {
+    SystemCoreClock = HAL_SIM_SYSCLK_HZ;
+    simCycles = 0;
+    simCost = defaultCost;
+
+    memset(HAL_SIM_GPIOPorts, 0, sizeof(HAL_SIM_GPIOPorts));
+    memset(HAL_SIM_TIMs, 0, sizeof(HAL_SIM_TIMs));
+    memset(HAL_SIM_I2Cs, 0, sizeof(HAL_SIM_I2Cs));
+    memset(HAL_SIM_USARTs, 0, sizeof(HAL_SIM_USARTs));
+    memset(HAL_SIM_ADCs, 0, sizeof(HAL_SIM_ADCs));
+    memset(HAL_SIM_SPIs, 0, sizeof(HAL_SIM_SPIs));
+    // DWT / DEMCR are in the debug power domain: a system reset leaves them alone
+    dwtPresent = 1;
+    swoLen = 0;
+    swoFreeAt = 0;
+    memset(simPorts, 0, sizeof(simPorts));
+    memset(simTims, 0, sizeof(simTims));
+    memset(simSlaves, 0, sizeof(simSlaves));
+    memset(simXfers, 0, sizeof(simXfers));
+    memset(simFaults, 0, sizeof(simFaults));
+    memset(simUarts, 0, sizeof(simUarts));
+    memset(&simExti, 0, sizeof(simExti));
+    memset(simAdcs, 0, sizeof(simAdcs));
+    memset(simSpis, 0, sizeof(simSpis));
+    scriptsActive = 0;
+    eventCount = 0;
+    inEvent = 0;
+    simPrimask = 0;
+    uwTick = 0;
+    tickAnchor = 0;
+    tickSuspended = 0;
+
+    HAL_SIM_ResetStats();
+}
+
+// ========== SysTick ==========
+
+// Apply the SysTick interrupts that happened since the last look
+static void SyncTick(void) {
+    uint64_t ticks = (simCycles - tickAnchor) / CyclesPerMs();
+    if (!tickSuspended) uwTick += (uint32_t)ticks;
+    tickAnchor += ticks * CyclesPerMs();
+}
+
+uint32_t HAL_GetTick(void) {
+    HAL_SIM_Advance(simCost.GetTick);
+    SyncTick();
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay) {
+    uint32_t wait = Delay;
+
+    simStats.DelayCalls++;
+    simStats.DelayMs += Delay;
+    SyncTick();
+
+    // Same behaviour as the HAL: guarantee at least 'Delay' full ticks
+    if (wait < HAL_MAX_DELAY) wait += 1U;
+
+    uint64_t target = tickAnchor + (uint64_t)wait * CyclesPerMs();
+    if (target > simCycles) HAL_SIM_Advance(target - simCycles);
+}
+
+void HAL_SuspendTick(void) {
+    SyncTick();
+    tickSuspended = 1;
+}
+
+void HAL_ResumeTick(void) {
+    SyncTick();
+    tickSuspended = 0;
+}
+
+void HAL_SIM_WFI(void) {
+    uint64_t wake = UINT64_MAX;
+    for (uint8_t i = 0; i < eventCount; ++i) {
+        if (simEvents[i].At < wake) wake = simEvents[i].At;
+    }
+    if (!tickSuspended) {
+        SyncTick();
+        if (tickAnchor + CyclesPerMs() < wake) wake = tickAnchor + CyclesPerMs();
+    }
+    // Nothing left that could wake the core: give up after one second
+    if (wake == UINT64_MAX) wake = simCycles + SystemCoreClock;
+
+    simStats.Wakeups++;
+    if (wake > simCycles) {
+        simStats.SleepCycles += wake - simCycles;
+        HAL_SIM_Advance(wake - simCycles);
+    }
+}
+
+// ========== RCC ==========
+
+uint32_t HAL_RCC_GetSysClockFreq(void) { return SystemCoreClock; }
+uint32_t HAL_RCC_GetHCLKFreq(void)     { return SystemCoreClock; }
+uint32_t HAL_RCC_GetPCLK1Freq(void)    { return SystemCoreClock / 2U; }
+uint32_t HAL_RCC_GetPCLK2Freq(void)    { return SystemCoreClock; }
+
+void HAL_SIM_NOP(void) {
+    HAL_SIM_Advance(simCost.Nop);
+}
+
+// ========== PRIMASK ==========
+
+uint32_t __get_PRIMASK(void) {
+    return simPrimask;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+    simPrimask = priMask & 1U;
+    // Interrupts that became pending while masked are taken right away
+    if (!simPrimask) RunEvents(simCycles);
+}
+
+void __disable_irq(void) {
+    __set_PRIMASK(1U);
+}
+
+void __enable_irq(void) {
+    __set_PRIMASK(0U);
+}
+
+// ========== DWT ==========
+
+void HAL_SIM_DWT_SetPresent(uint8_t present) {
+    dwtPresent = present;
+}
+
+uint32_t HAL_SIM_DWT_ReadCycles(void) {
+    HAL_SIM_Advance(simCost.GpioReg);
+
+    // Counts only with trace enabled in DEMCR and the counter enabled in CTRL
+    if (dwtPresent &&
+        (HAL_SIM_CoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) &&
+        (HAL_SIM_DWT.CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        HAL_SIM_DWT.CYCCNT = (uint32_t)simCycles;
+    }
+    return HAL_SIM_DWT.CYCCNT;
+}
+
+// ========== ITM / SWO ==========
+
+uint32_t ITM_SendChar(uint32_t ch) {
+    // ITM disabled (no debugger): the byte is dropped, like the CMSIS function does
+    if (!(HAL_SIM_CoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk)) return ch;
+
+    // Stimulus port holds one byte: wait until the previous one left
+    if (swoFreeAt > simCycles) HAL_SIM_Advance(swoFreeAt - simCycles);
+    HAL_SIM_Advance(simCost.GpioReg);
+    swoFreeAt = simCycles + 10ULL * SystemCoreClock / HAL_SIM_SWO_HZ;
+
+    if (swoLen < sizeof(swoBuf)) swoBuf[swoLen++] = (uint8_t)ch;
+    return ch;
+}
+
+const uint8_t *HAL_SIM_SWO_Data(uint32_t *len) {
+    *len = swoLen;
+    return swoBuf;
+}
+
+void HAL_SIM_SWO_Clear(void) {
+    swoLen = 0;
+}
+
+// ========== GPIO ==========
+
+static SimPort *FindPort(GPIO_TypeDef *GPIOx) {
+    ptrdiff_t idx = GPIOx - HAL_SIM_GPIOPorts;
+    if (idx < 0 || (size_t)idx >= SIM_PORT_COUNT) return NULL;
+    return &simPorts[idx];
+}
+
+static uint8_t PinIndex(uint16_t GPIO_Pin) {
+    uint8_t idx = 0;
+    while (idx < 15 && !(GPIO_Pin & (1U << idx))) idx++;
+    return idx;
+}
+
+static uint8_t ScriptLevel(SimPort *sp, uint8_t idx) {
+    SimScript *s = &sp->Script[idx];
+    uint64_t elapsed = HAL_SIM_CyclesToNs(simCycles - s->Start);
+
+    for (uint16_t i = 0; i < s->Count; ++i) {
+        if (elapsed < s->Steps[i].DurationNs) return s->Steps[i].Level;
+        elapsed -= s->Steps[i].DurationNs;
+    }
+
+    // Waveform finished: keep driving the idle level
+    uint16_t bit = (uint16_t)(1U << idx);
+    sp->ScriptMask &= (uint16_t)~bit;
+    sp->ExtMask |= bit;
+    if (s->Idle) sp->ExtLevel |= bit; else sp->ExtLevel &= (uint16_t)~bit;
+    if (scriptsActive) scriptsActive--;
+    return s->Idle;
+}
+
+static void ExtiIrq(void *ctx);
+
+// Lines of this port whose selected edge is in 'changed' become pending
+static void ExtiEdges(GPIO_TypeDef *GPIOx, uint16_t changed, uint16_t idr) {
+    uint8_t port = (uint8_t)(GPIOx - HAL_SIM_GPIOPorts + 1);
+    uint16_t hit = (uint16_t)((changed & idr & simExti.Rising) | (changed & ~idr & simExti.Falling));
+
+    for (uint8_t i = 0; hit; ++i, hit >>= 1) {
+        if (!(hit & 1U) || simExti.Port[i] != port) continue;
+        if (!simExti.Pending) HAL_SIM_Schedule(simCycles, ExtiIrq, NULL);
+        simExti.Pending |= (uint16_t)(1U << i);
+    }
+}
+
+static void SyncPort(GPIO_TypeDef *GPIOx, SimPort *sp) {
+    uint16_t ext = sp->ExtLevel;
+    uint16_t before = (uint16_t)GPIOx->IDR;
+
+    if (sp->ScriptMask) {
+        for (uint8_t i = 0; i < 16; ++i) {
+            uint16_t bit = (uint16_t)(1U << i);
+            if (!(sp->ScriptMask & bit)) continue;
+            if (ScriptLevel(sp, i)) ext |= bit; else ext &= (uint16_t)~bit;
+        }
+    }
+
+    uint16_t driven = (uint16_t)((sp->ExtMask | sp->ScriptMask) & ~sp->OutMask);
+    GPIOx->IDR = (GPIOx->ODR & ~driven & 0xFFFFU) | (ext & driven);
+
+    uint16_t changed = (uint16_t)(before ^ GPIOx->IDR);
+    if (changed & (simExti.Rising | simExti.Falling)) ExtiEdges(GPIOx, changed, (uint16_t)GPIOx->IDR);
+}
+
+void HAL_SIM_GPIO_Sync(void) {
+    for (size_t i = 0; i < SIM_PORT_COUNT; ++i) {
+        SyncPort(&HAL_SIM_GPIOPorts[i], &simPorts[i]);
+    }
+}
+
+static void ExtiIrq(void *ctx) {
+    (void)ctx;
+    // Flag cleared before the callback, as HAL_GPIO_EXTI_IRQHandler: an edge inside it pends again
+    while (simExti.Pending) {
+        uint16_t bit = (uint16_t)(1U << PinIndex(simExti.Pending));
+        simExti.Pending &= (uint16_t)~bit;
+        simStats.ExtiIrqs++;
+        HAL_SIM_Advance(simCost.ExtiIrq);
+        HAL_GPIO_EXTI_Callback(bit);
+    }
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) { (void)GPIO_Pin; }
+
+static void ScriptStep(void *ctx);
+
+// A scripted pin on an EXTI line interrupts at the exact step boundary, not at the next sync
+static void ScheduleScriptStep(GPIO_TypeDef *GPIOx, uint8_t idx) {
+    uint8_t port = (uint8_t)(GPIOx - HAL_SIM_GPIOPorts);
+    uint16_t bit = (uint16_t)(1U << idx);
+    void *ctx = (void *)(uintptr_t)(port * 16U + idx);
+    SimPort *sp = &simPorts[port];
+
+    HAL_SIM_Cancel(ScriptStep, ctx);
+    if (simExti.Port[idx] != port + 1U || !((simExti.Rising | simExti.Falling) & bit)) return;
+    if (!(sp->ScriptMask & bit)) return;
+
+    SimScript *s = &sp->Script[idx];
+    uint64_t ns = 0;
+    for (uint16_t i = 0; i < s->Count; ++i) {
+        ns += s->Steps[i].DurationNs;
+        uint64_t at = s->Start + HAL_SIM_NsToCycles(ns);
+        if (at > simCycles) {
+            HAL_SIM_Schedule(at, ScriptStep, ctx);
+            return;
+        }
+    }
+}
+
+static void ScriptStep(void *ctx) {
+    uintptr_t id = (uintptr_t)ctx;
+    GPIO_TypeDef *GPIOx = &HAL_SIM_GPIOPorts[id / 16U];
+
+    SyncPort(GPIOx, &simPorts[id / 16U]);
+    ScheduleScriptStep(GPIOx, (uint8_t)(id % 16U));
+}
+
+// Apply a new ODR value, count changes and notify observers
+static void UpdateOutput(GPIO_TypeDef *GPIOx, uint16_t newOdr) {
+    SimPort *sp = FindPort(GPIOx);
+    uint16_t changed = (uint16_t)((GPIOx->ODR ^ newOdr) & 0xFFFFU);
+
+    GPIOx->ODR = newOdr;
+    if (!sp) return;
+
+    SyncPort(GPIOx, sp);
+    while (changed) {
+        uint8_t i = PinIndex(changed);
+        uint16_t bit = (uint16_t)(1U << i);
+        changed &= (uint16_t)~bit;
+        simStats.GpioToggles++;
+        if (sp->Hook[i]) sp->Hook[i](GPIOx, bit, (newOdr & bit) ? 1 : 0, sp->HookCtx[i]);
+    }
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    SimPort *sp = FindPort(GPIOx);
+    HAL_SIM_Advance(simCost.GpioInit);
+    if (!sp) return;
+
+    uint16_t pins = (uint16_t)GPIO_Init->Pin;
+    if (GPIO_Init->Mode == GPIO_MODE_OUTPUT_PP || GPIO_Init->Mode == GPIO_MODE_OUTPUT_OD) {
+        sp->OutMask |= pins;
+    } else {
+        sp->OutMask &= (uint16_t)~pins;
+    }
+    SyncPort(GPIOx, sp);
+
+    // EXTI routing after the sync: configuring a line does not raise it
+    uint8_t it = (GPIO_Init->Mode & 0x10000000U) != 0;
+    for (uint8_t i = 0; i < 16; ++i) {
+        uint16_t bit = (uint16_t)(1U << i);
+        if (!(pins & bit)) continue;
+        if (it) {
+            simExti.Port[i] = (uint8_t)(GPIOx - HAL_SIM_GPIOPorts + 1);
+        } else if (simExti.Port[i] != (uint8_t)(GPIOx - HAL_SIM_GPIOPorts + 1)) {
+            continue;
+        }
+        if (it && (GPIO_Init->Mode & 0x00100000U)) simExti.Rising |= bit; else simExti.Rising &= (uint16_t)~bit;
+        if (it && (GPIO_Init->Mode & 0x00200000U)) simExti.Falling |= bit; else simExti.Falling &= (uint16_t)~bit;
+        if (sp->ScriptMask & bit) ScheduleScriptStep(GPIOx, i);
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    HAL_SIM_Advance(simCost.GpioRead);
+    simStats.GpioReads++;
+
+    SimPort *sp = FindPort(GPIOx);
+    if (sp) SyncPort(GPIOx, sp);
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    HAL_SIM_Advance(simCost.GpioWrite);
+    simStats.GpioWrites++;
+
+    uint16_t odr = (uint16_t)GPIOx->ODR;
+    if (PinState != GPIO_PIN_RESET) odr |= GPIO_Pin; else odr &= (uint16_t)~GPIO_Pin;
+    UpdateOutput(GPIOx, odr);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    HAL_SIM_Advance(simCost.GpioWrite);
+    simStats.GpioWrites++;
+    UpdateOutput(GPIOx, (uint16_t)(GPIOx->ODR ^ GPIO_Pin));
+}
+
+// BSRR: low half sets, high half resets; set wins when both are given
+void HAL_SIM_GPIO_WriteBSRR(GPIO_TypeDef *GPIOx, uint32_t bsrr) {
+    HAL_SIM_Advance(simCost.GpioReg);
+    simStats.GpioWrites++;
+
+    uint16_t odr = (uint16_t)GPIOx->ODR;
+    odr &= (uint16_t)~(bsrr >> 16);
+    odr |= (uint16_t)bsrr;
+    GPIOx->BSRR = bsrr;
+    UpdateOutput(GPIOx, odr);
+}
+
+uint32_t HAL_SIM_GPIO_ReadIDR(GPIO_TypeDef *GPIOx) {
+    HAL_SIM_Advance(simCost.GpioReg);
+    simStats.GpioReads++;
+
+    SimPort *sp = FindPort(GPIOx);
+    if (sp) SyncPort(GPIOx, sp);
+    return GPIOx->IDR;
+}
+
+void HAL_SIM_GPIO_SetInput(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level) {
+    SimPort *sp = FindPort(GPIOx);
+    if (!sp) return;
+
+    sp->ExtMask |= GPIO_Pin;
+    if (level) sp->ExtLevel |= GPIO_Pin; else sp->ExtLevel &= (uint16_t)~GPIO_Pin;
+    SyncPort(GPIOx, sp);
+}
+
+void HAL_SIM_GPIO_Release(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    SimPort *sp = FindPort(GPIOx);
+    if (!sp) return;
+
+    for (uint8_t i = 0; i < 16; ++i) {
+        uint16_t bit = (uint16_t)(1U << i);
+        if ((GPIO_Pin & bit) && (sp->ScriptMask & bit) && scriptsActive) scriptsActive--;
+    }
+    sp->ExtMask &= (uint16_t)~GPIO_Pin;
+    sp->ScriptMask &= (uint16_t)~GPIO_Pin;
+    SyncPort(GPIOx, sp);
+}
+
+void HAL_SIM_GPIO_PlayScript(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                             const HAL_SIM_PinStep *steps, uint16_t count, uint8_t idleLevel) {
+    SimPort *sp = FindPort(GPIOx);
+    if (!sp || !GPIO_Pin) return;
+
+    uint8_t idx = PinIndex(GPIO_Pin);
+    if (!(sp->ScriptMask & GPIO_Pin)) scriptsActive++;
+
+    sp->Script[idx].Steps = steps;
+    sp->Script[idx].Count = count;
+    sp->Script[idx].Idle = idleLevel;
+    sp->Script[idx].Start = simCycles;
+    sp->ScriptMask |= GPIO_Pin;
+    SyncPort(GPIOx, sp);
+    ScheduleScriptStep(GPIOx, idx);
+}
+
+void HAL_SIM_GPIO_SetWriteHook(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, HAL_SIM_PinWriteHook hook, void *ctx) {
+    SimPort *sp = FindPort(GPIOx);
+    if (!sp || !GPIO_Pin) return;
+
+    uint8_t idx = PinIndex(GPIO_Pin);
+    sp->Hook[idx] = hook;
+    sp->HookCtx[idx] = ctx;
+}
+
+uint8_t HAL_SIM_GPIO_GetOutput(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->ODR & GPIO_Pin) ? 1 : 0;
+}
+
+// ========== TIM ==========
+
+static SimTim *FindTim(TIM_HandleTypeDef *htim) {
+    ptrdiff_t idx = htim->Instance - HAL_SIM_TIMs;
+    if (idx < 0 || (size_t)idx >= SIM_TIM_COUNT) return NULL;
+    return &simTims[idx];
+}
+
+static uint8_t ChannelIndex(uint32_t Channel) {
+    return (uint8_t)((Channel >> 2) & 0x03U);
+}
+
+uint32_t HAL_SIM_TIM_GetClockFreq(TIM_HandleTypeDef *htim) {
+    // TIM1 sits on APB2, the others on APB1 whose prescaler doubles the timer clock
+    if (htim->Instance == TIM1) return HAL_RCC_GetPCLK2Freq();
+    return HAL_RCC_GetPCLK1Freq() * 2U;
+}
+
+static uint32_t CounterAt(TIM_HandleTypeDef *htim, SimTim *st) {
+    if (!st->Running || st->Encoder) return htim->Instance->CNT;
+
+    uint64_t cyclesPerCount = (uint64_t)(SystemCoreClock / HAL_SIM_TIM_GetClockFreq(htim)) *
+                              (htim->Init.Prescaler + 1U);
+    uint64_t period = (uint64_t)(htim->Init.Period ? htim->Init.Period : 0xFFFFU) + 1U;
+    uint32_t cnt = (uint32_t)(((simCycles - st->Base) / cyclesPerCount) % period);
+
+    htim->Instance->CNT = cnt;
+    return cnt;
+}
+
+static void StartCounter(TIM_HandleTypeDef *htim, SimTim *st) {
+    if (st->Running) return;
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period ? htim->Init.Period : 0xFFFFU;
+    st->Running = 1;
+    st->Base = simCycles;
+    st->FlagCleared = simCycles;
+}
+
+// Clock cycles of one full counter period (0 .. ARR)
+static uint64_t PeriodCycles(TIM_HandleTypeDef *htim) {
+    uint64_t cyclesPerCount = (uint64_t)(SystemCoreClock / HAL_SIM_TIM_GetClockFreq(htim)) *
+                              (htim->Init.Prescaler + 1U);
+    return cyclesPerCount * ((uint64_t)(htim->Init.Period ? htim->Init.Period : 0xFFFFU) + 1U);
+}
+
+// Counter wraps (update events) since the counter started, up to 'at'
+static uint64_t Wraps(TIM_HandleTypeDef *htim, SimTim *st, uint64_t at) {
+    return (at - st->Base) / PeriodCycles(htim);
+}
+
+static void TimUpdate(void *ctx);
+
+static void ScheduleUpdate(TIM_HandleTypeDef *htim, SimTim *st) {
+    HAL_SIM_Schedule(st->Base + (Wraps(htim, st, simCycles) + 1U) * PeriodCycles(htim), TimUpdate, htim);
+}
+
+static void TimUpdate(void *ctx) {
+    TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)ctx;
+    SimTim *st = FindTim(htim);
+    if (!st || !st->Running || !st->UpdateIt) return;
+
+    HAL_TIM_PeriodElapsedCallback(htim);
+    ScheduleUpdate(htim, st);
+}
+
+uint32_t HAL_SIM_TIM_GetCounter(TIM_HandleTypeDef *htim) {
+    SimTim *st = FindTim(htim);
+    HAL_SIM_Advance(simCost.TimAccess);
+    return st ? CounterAt(htim, st) : 0;
+}
+
+void HAL_SIM_TIM_SetCounter(TIM_HandleTypeDef *htim, uint32_t value) {
+    SimTim *st = FindTim(htim);
+    HAL_SIM_Advance(simCost.TimAccess);
+    if (!st) return;
+
+    uint64_t cyclesPerCount = (uint64_t)(SystemCoreClock / HAL_SIM_TIM_GetClockFreq(htim)) *
+                              (htim->Init.Prescaler + 1U);
+    htim->Instance->CNT = value;
+    st->Base = simCycles - (uint64_t)value * cyclesPerCount;
+}
+
+void HAL_SIM_TIM_SetCapturePolarity(TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t Polarity) {
+    SimTim *st = FindTim(htim);
+    HAL_SIM_Advance(simCost.TimAccess);
+    if (st) st->Polarity[ChannelIndex(Channel)] = Polarity;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    StartCounter(htim, st);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    CounterAt(htim, st);
+    st->Running = 0;
+    st->StoppedAt = simCycles;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    StartCounter(htim, st);
+    st->UpdateIt = 1;
+    HAL_SIM_Cancel(TimUpdate, htim);
+    ScheduleUpdate(htim, st);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    st->UpdateIt = 0;
+    HAL_SIM_Cancel(TimUpdate, htim);
+    return HAL_TIM_Base_Stop(htim);
+}
+
+void HAL_SIM_TIM_SetAutoreload(TIM_HandleTypeDef *htim, uint32_t value) {
+    HAL_SIM_Advance(simCost.TimAccess);
+    htim->Instance->ARR = value;
+    htim->Init.Period = value;
+}
+
+// UIF: set by every counter wrap since the last clear
+uint32_t HAL_SIM_TIM_GetFlag(TIM_HandleTypeDef *htim, uint32_t flag) {
+    SimTim *st = FindTim(htim);
+    HAL_SIM_Advance(simCost.TimAccess);
+    if (!st || flag != TIM_FLAG_UPDATE) return 0;
+
+    uint64_t until = st->Running ? simCycles : st->StoppedAt;
+    if (until < st->FlagCleared) return 0;
+    return Wraps(htim, st, until) > Wraps(htim, st, st->FlagCleared) ? 1U : 0U;
+}
+
+void HAL_SIM_TIM_ClearFlag(TIM_HandleTypeDef *htim, uint32_t flag) {
+    SimTim *st = FindTim(htim);
+    HAL_SIM_Advance(simCost.TimAccess);
+    if (st && flag == TIM_FLAG_UPDATE) st->FlagCleared = simCycles;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    StartCounter(htim, st);
+    st->ItMask |= (uint8_t)(1U << ChannelIndex(Channel));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    SimTim *st = FindTim(htim);
+    if (!st) return HAL_ERROR;
+    st->ItMask &= (uint8_t)~(1U << ChannelIndex(Channel));
+    return HAL_OK;
+}
+
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    HAL_SIM_Advance(simCost.TimAccess);
+    switch (Channel) {
+        case TIM_CHANNEL_1: return htim->Instance->CCR1;
+        case TIM_CHANNEL_2: return htim->Instance->CCR2;
+        case TIM_CHANNEL_3: return htim->Instance->CCR3;
+        case TIM_CHANNEL_4: return htim->Instance->CCR4;
+        default:            return 0;
+    }
+}
+
+// Latch the counter into CCRx as an input edge would, then raise the IRQ
+void HAL_SIM_TIM_Capture(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    SimTim *st = FindTim(htim);
+    if (!st) return;
+
+    uint32_t cnt = CounterAt(htim, st);
+    uint8_t ch = ChannelIndex(Channel);
+    volatile uint32_t *ccr[4] = { &htim->Instance->CCR1, &htim->Instance->CCR2,
+                                  &htim->Instance->CCR3, &htim->Instance->CCR4 };
+    *ccr[ch] = cnt;
+
+    if (st->ItMask & (1U << ch)) {
+        htim->Channel = (HAL_TIM_ActiveChannel)(1U << ch);
+        HAL_TIM_IC_CaptureCallback(htim);
+        htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig) {
+    SimTim *st = FindTim(htim);
+    if (!st || sConfig == NULL) return HAL_ERROR;
+    if (sConfig->EncoderMode < TIM_ENCODERMODE_TI1 || sConfig->EncoderMode > TIM_ENCODERMODE_TI12) return HAL_ERROR;
+
+    htim->Instance->SMCR = sConfig->EncoderMode;
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period ? htim->Init.Period : 0xFFFFU;
+    htim->Instance->CNT = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    SimTim *st = FindTim(htim);
+    (void)Channel;
+    if (!st || htim->Instance->SMCR == 0) return HAL_ERROR;
+    st->Encoder = 1;
+    st->Running = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Stop(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    SimTim *st = FindTim(htim);
+    (void)Channel;
+    if (!st) return HAL_ERROR;
+    st->Running = 0;
+    st->Encoder = 0;
+    return HAL_OK;
+}
+
+// The counter follows the inputs on its own: wraps at ARR, DIR gives the last direction
+void HAL_SIM_TIM_EncoderTurn(TIM_HandleTypeDef *htim, int32_t counts) {
+    SimTim *st = FindTim(htim);
+    if (!st || !st->Encoder || counts == 0) return;
+
+    int64_t period = (int64_t)htim->Instance->ARR + 1;
+    int64_t cnt = ((int64_t)htim->Instance->CNT + counts) % period;
+    htim->Instance->CNT = (uint32_t)(cnt < 0 ? cnt + period : cnt);
+    if (counts < 0) htim->Instance->CR1 |= TIM_CR1_DIR;
+    else htim->Instance->CR1 &= ~TIM_CR1_DIR;
+}
+
+__weak void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    (void)htim;
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    (void)htim;
+}
+
+// ========== I2C ==========
+
+static HAL_SIM_I2CSlave *FindSlave(I2C_HandleTypeDef *hi2c, uint16_t DevAddress) {
+    for (uint8_t i = 0; i < HAL_SIM_MAX_I2C_SLAVES; ++i) {
+        HAL_SIM_I2CSlave *s = simSlaves[i];
+        if (s && s->Bus == hi2c->Instance && (s->DevAddress & 0xFE) == (DevAddress & 0xFE)) return s;
+    }
+    return NULL;
+}
+
+static uint64_t BusCycles(I2C_HandleTypeDef *hi2c, uint32_t bits) {
+    uint32_t speed = hi2c->Init.ClockSpeed ? hi2c->Init.ClockSpeed : 100000U;
+    return (uint64_t)bits * SystemCoreClock / speed;
+}
+
+// Charge the bus time of 'bits' SCL periods and count the traffic
+static void BusTime(I2C_HandleTypeDef *hi2c, uint32_t bits, uint32_t bytes) {
+    simStats.I2cBytes += bytes;
+    HAL_SIM_Advance(BusCycles(hi2c, bits));
+}
+
+// START + address; returns the slave or NULL after charging a NACKed address phase
+static HAL_SIM_I2CSlave *BeginTransfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress) {
+    HAL_SIM_Advance(simCost.I2cOverhead);
+    simStats.I2cTransactions++;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+    HAL_SIM_I2CSlave *s = FindSlave(hi2c, DevAddress);
+    if (!s || s->Nack) {
+        BusTime(hi2c, 1 + 9 + 1, 1);
+        simStats.I2cErrors++;
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return NULL;
+    }
+    return s;
+}
+
+static uint16_t Wrap(HAL_SIM_I2CSlave *s) {
+    return s->RegCount ? s->RegCount : 256U;
+}
+
+static void SlaveWrite(HAL_SIM_I2CSlave *s, const uint8_t *data, uint16_t len) {
+    uint8_t reg = s->Pointer;
+    for (uint16_t i = 0; i < len; ++i) {
+        s->Regs[s->Pointer] = data[i];
+        s->Pointer = (uint8_t)((s->Pointer + 1U) % Wrap(s));
+    }
+    if (s->OnWrite) s->OnWrite(s, reg, data, len);
+}
+
+static void SlaveRead(HAL_SIM_I2CSlave *s, uint8_t *data, uint16_t len) {
+    if (s->OnRead) s->OnRead(s, s->Pointer, len);
+    for (uint16_t i = 0; i < len; ++i) {
+        data[i] = s->Regs[s->Pointer];
+        s->Pointer = (uint8_t)((s->Pointer + 1U) % Wrap(s));
+    }
+}
+
+static uint16_t MemAddBytes(uint16_t MemAddSize) {
+    return (MemAddSize == I2C_MEMADD_SIZE_16BIT) ? 2U : 1U;
+}
+
+// A blocking call on a handle with an _IT/_DMA transfer in flight gets HAL_BUSY
+static uint8_t I2cBusy(I2C_HandleTypeDef *hi2c) {
+    return hi2c->State == HAL_I2C_STATE_BUSY || hi2c->State == HAL_I2C_STATE_BUSY_TX ||
+           hi2c->State == HAL_I2C_STATE_BUSY_RX;
+}
+
+static SimI2cFault *FindFault(I2C_TypeDef *bus) {
+    ptrdiff_t idx = bus - HAL_SIM_I2Cs;
+    if (idx < 0 || (size_t)idx >= SIM_I2C_COUNT) return NULL;
+    return &simFaults[idx];
+}
+
+void HAL_SIM_I2C_GetPins(I2C_TypeDef *bus, GPIO_TypeDef **port, uint16_t *scl, uint16_t *sda) {
+    *port = GPIOB;
+    *scl = (bus == I2C2) ? GPIO_PIN_10 : GPIO_PIN_6;
+    *sda = (bus == I2C2) ? GPIO_PIN_11 : GPIO_PIN_7;
+}
+
+// Stuck slave state machine: counts the SCL pulses of a bus recovery
+static void SclHook(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx) {
+    SimI2cFault *f = (SimI2cFault *)ctx;
+    (void)GPIO_Pin;
+    if (!level || !f->SdaClocks) return;
+    if (--f->SdaClocks == 0) HAL_SIM_GPIO_SetInput(GPIOx, f->Sda, 1);
+}
+
+void HAL_SIM_I2C_HoldSda(I2C_TypeDef *bus, uint8_t clocks) {
+    SimI2cFault *f = FindFault(bus);
+    GPIO_TypeDef *port;
+    uint16_t scl;
+    if (!f) return;
+
+    HAL_SIM_I2C_GetPins(bus, &port, &scl, &f->Sda);
+    f->SdaClocks = clocks;
+    port->ODR |= scl;       // idle SCL is high: only real pulses count
+    HAL_SIM_GPIO_SetInput(port, f->Sda, clocks ? 0 : 1);
+    HAL_SIM_GPIO_SetWriteHook(port, scl, clocks ? SclHook : NULL, f);
+}
+
+void HAL_SIM_I2C_HoldScl(I2C_TypeDef *bus, uint32_t us) {
+    SimI2cFault *f = FindFault(bus);
+    if (f) f->SclUntil = simCycles + HAL_SIM_NsToCycles((uint64_t)us * 1000U);
+}
+
+// Fault seen when a transfer starts. SDA low: the HAL waits for the BUSY flag, then
+// HAL_BUSY. SCL held: a blocking call waits up to its timeout (IT/DMA: completion late).
+static HAL_StatusTypeDef I2cFault(I2C_HandleTypeDef *hi2c, uint32_t Timeout, uint8_t blocking) {
+    SimI2cFault *f = FindFault(hi2c->Instance);
+    if (!f) return HAL_OK;
+
+    if (f->SdaClocks) {
+        HAL_SIM_Advance((uint64_t)HAL_SIM_I2C_BUSY_FLAG_MS * CyclesPerMs());
+        simStats.I2cErrors++;
+        hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+        return HAL_BUSY;
+    }
+    if (blocking && f->SclUntil > simCycles) {
+        uint64_t wait = f->SclUntil - simCycles;
+        if (Timeout != HAL_MAX_DELAY && (uint64_t)Timeout * CyclesPerMs() < wait) {
+            HAL_SIM_Advance((uint64_t)Timeout * CyclesPerMs());
+            simStats.I2cErrors++;
+            hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+            return HAL_ERROR;
+        }
+        HAL_SIM_Advance(wait);
+    }
+    return HAL_OK;
+}
+
+static void XferComplete(void *ctx);
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    hi2c->State = HAL_I2C_STATE_READY;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+    // MspInit: SCL / SDA back to the peripheral (alternate function)
+    GPIO_TypeDef *port;
+    uint16_t scl, sda;
+    HAL_SIM_I2C_GetPins(hi2c->Instance, &port, &scl, &sda);
+    SimPort *sp = FindPort(port);
+    if (sp) {
+        sp->OutMask &= (uint16_t)~(scl | sda);
+        SyncPort(port, sp);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    ptrdiff_t idx = hi2c->Instance - HAL_SIM_I2Cs;
+    if (idx >= 0 && (size_t)idx < SIM_I2C_COUNT) HAL_SIM_Cancel(XferComplete, &simXfers[idx]);
+    hi2c->State = HAL_I2C_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                          uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    HAL_StatusTypeDef fault = I2cFault(hi2c, Timeout, 1);
+    if (fault != HAL_OK) return fault;
+    HAL_SIM_I2CSlave *s = BeginTransfer(hi2c, DevAddress);
+    if (!s) return HAL_ERROR;
+
+    BusTime(hi2c, 1 + 9 + 9U * Size + 1, 1U + Size);
+    if (s->OnTransmit) {
+        s->OnTransmit(s, pData, Size);
+    } else if (Size) {
+        s->Pointer = (uint8_t)(pData[0] % Wrap(s));
+        SlaveWrite(s, pData + 1, (uint16_t)(Size - 1U));
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                         uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    HAL_StatusTypeDef fault = I2cFault(hi2c, Timeout, 1);
+    if (fault != HAL_OK) return fault;
+    HAL_SIM_I2CSlave *s = BeginTransfer(hi2c, DevAddress);
+    if (!s) return HAL_ERROR;
+
+    BusTime(hi2c, 1 + 9 + 9U * Size + 1, 1U + Size);
+    SlaveRead(s, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    HAL_StatusTypeDef fault = I2cFault(hi2c, Timeout, 1);
+    if (fault != HAL_OK) return fault;
+    HAL_SIM_I2CSlave *s = BeginTransfer(hi2c, DevAddress);
+    if (!s) return HAL_ERROR;
+
+    uint16_t addBytes = MemAddBytes(MemAddSize);
+    BusTime(hi2c, 1 + 9 + 9U * addBytes + 9U * Size + 1, 1U + addBytes + Size);
+    s->Pointer = (uint8_t)(MemAddress % Wrap(s));
+    SlaveWrite(s, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    HAL_StatusTypeDef fault = I2cFault(hi2c, Timeout, 1);
+    if (fault != HAL_OK) return fault;
+    HAL_SIM_I2CSlave *s = BeginTransfer(hi2c, DevAddress);
+    if (!s) return HAL_ERROR;
+
+    // START, address + register, repeated START, address, data, STOP
+    uint16_t addBytes = MemAddBytes(MemAddSize);
+    BusTime(hi2c, 1 + 9 + 9U * addBytes + 1 + 9 + 9U * Size + 1, 2U + addBytes + Size);
+    s->Pointer = (uint8_t)(MemAddress % Wrap(s));
+    SlaveRead(s, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout) {
+    (void)Timeout;
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    for (uint32_t i = 0; i < Trials; ++i) {
+        HAL_SIM_I2CSlave *s = BeginTransfer(hi2c, DevAddress);
+        if (s) {
+            BusTime(hi2c, 1 + 9 + 1, 1);
+            return HAL_OK;
+        }
+    }
+    return HAL_ERROR;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c) {
+    return hi2c->State;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c) {
+    return hi2c->ErrorCode;
+}
+
+// ---------- Interrupt / DMA driven transfers ----------
+
+static void XferComplete(void *ctx) {
+    SimI2cXfer *x = (SimI2cXfer *)ctx;
+    I2C_HandleTypeDef *hi2c = x->Handle;
+    HAL_SIM_I2CSlave *s = x->Slave;
+
+    // The bytes move while the bus runs; the slave sees them all at STOP
+    HAL_SIM_Advance((uint64_t)simCost.I2cIrq * x->Irqs);
+    hi2c->State = HAL_I2C_STATE_READY;
+
+    if (!s) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+        return;
+    }
+
+    switch (x->Kind) {
+        case XFER_TX:
+            if (s->OnTransmit) {
+                s->OnTransmit(s, x->Data, x->Size);
+            } else if (x->Size) {
+                s->Pointer = (uint8_t)(x->Data[0] % Wrap(s));
+                SlaveWrite(s, x->Data + 1, (uint16_t)(x->Size - 1U));
+            }
+            HAL_I2C_MasterTxCpltCallback(hi2c);
+            break;
+        case XFER_RX:
+            SlaveRead(s, x->Data, x->Size);
+            HAL_I2C_MasterRxCpltCallback(hi2c);
+            break;
+        case XFER_MEM_WRITE:
+            s->Pointer = (uint8_t)(x->MemAddress % Wrap(s));
+            SlaveWrite(s, x->Data, x->Size);
+            HAL_I2C_MemTxCpltCallback(hi2c);
+            break;
+        case XFER_MEM_READ:
+            s->Pointer = (uint8_t)(x->MemAddress % Wrap(s));
+            SlaveRead(s, x->Data, x->Size);
+            HAL_I2C_MemRxCpltCallback(hi2c);
+            break;
+    }
+}
+
+static HAL_StatusTypeDef XferStart(I2C_HandleTypeDef *hi2c, SimXferKind kind, uint16_t DevAddress,
+                                   uint16_t MemAddress, uint16_t MemAddSize,
+                                   uint8_t *pData, uint16_t Size, uint8_t dma) {
+    ptrdiff_t idx = hi2c->Instance - HAL_SIM_I2Cs;
+    if (idx < 0 || (size_t)idx >= SIM_I2C_COUNT) return HAL_ERROR;
+    if (I2cBusy(hi2c)) return HAL_BUSY;
+    uint8_t rx = (kind == XFER_RX || kind == XFER_MEM_READ);
+    if (dma && (rx ? hi2c->hdmarx : hi2c->hdmatx) == NULL) return HAL_ERROR;
+    HAL_StatusTypeDef fault = I2cFault(hi2c, 0, 0);
+    if (fault != HAL_OK) return fault;
+
+    HAL_SIM_Advance(simCost.I2cOverhead);
+    simStats.I2cTransactions++;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+    SimI2cXfer *x = &simXfers[idx];
+    x->Handle = hi2c;
+    x->Kind = kind;
+    x->MemAddress = MemAddress;
+    x->Data = pData;
+    x->Size = Size;
+    x->Slave = FindSlave(hi2c, DevAddress);
+    if (x->Slave && x->Slave->Nack) x->Slave = NULL;
+
+    uint32_t bits;
+    uint32_t bytes;
+    if (!x->Slave) {
+        bits = 1 + 9 + 1;
+        bytes = 1;
+        simStats.I2cErrors++;
+    } else {
+        uint16_t addBytes = (kind == XFER_MEM_WRITE || kind == XFER_MEM_READ) ? MemAddBytes(MemAddSize) : 0;
+        bits = 1 + 9 + 9U * addBytes + 9U * Size + 1;
+        bytes = 1U + addBytes + Size;
+        if (kind == XFER_MEM_READ) {
+            bits += 1 + 9;      // repeated START + address
+            bytes += 1;
+        }
+    }
+    simStats.I2cBytes += bytes;
+    x->Irqs = dma ? 1U : bytes;
+
+    // A stretching slave holds the transfer back until it lets SCL go
+    uint64_t start = simCycles;
+    if (simFaults[idx].SclUntil > start) start = simFaults[idx].SclUntil;
+
+    hi2c->State = rx ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+    if (HAL_SIM_Schedule(start + BusCycles(hi2c, bits), XferComplete, x) != 0) {
+        hi2c->State = HAL_I2C_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_TX, DevAddress, 0, 0, pData, Size, 0);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_RX, DevAddress, 0, 0, pData, Size, 0);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_MEM_WRITE, DevAddress, MemAddress, MemAddSize, pData, Size, 0);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_MEM_READ, DevAddress, MemAddress, MemAddSize, pData, Size, 0);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_TX, DevAddress, 0, 0, pData, Size, 1);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_RX, DevAddress, 0, 0, pData, Size, 1);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_MEM_WRITE, DevAddress, MemAddress, MemAddSize, pData, Size, 1);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    return XferStart(hi2c, XFER_MEM_READ, DevAddress, MemAddress, MemAddSize, pData, Size, 1);
+}
+
+__weak void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
+__weak void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) { (void)hi2c; }
+__weak void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)    { (void)hi2c; }
+__weak void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)    { (void)hi2c; }
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)        { (void)hi2c; }
+
+void HAL_SIM_I2C_Attach(I2C_HandleTypeDef *hi2c, HAL_SIM_I2CSlave *slave) {
+    SimI2cFault *f = FindFault(hi2c->Instance);
+    GPIO_TypeDef *port;
+    uint16_t scl, sda;
+    HAL_SIM_I2C_GetPins(hi2c->Instance, &port, &scl, &sda);
+    if (f && !f->SdaClocks) HAL_SIM_GPIO_SetInput(port, scl | sda, 1);   // pull-ups
+
+    slave->Bus = hi2c->Instance;
+    for (uint8_t i = 0; i < HAL_SIM_MAX_I2C_SLAVES; ++i) {
+        if (simSlaves[i] == NULL || simSlaves[i] == slave) {
+            simSlaves[i] = slave;
+            return;
+        }
+    }
+}
+
+void HAL_SIM_I2C_Detach(HAL_SIM_I2CSlave *slave) {
+    for (uint8_t i = 0; i < HAL_SIM_MAX_I2C_SLAVES; ++i) {
+        if (simSlaves[i] == slave) simSlaves[i] = NULL;
+    }
+}
+
+// ========== UART ==========
+
+static SimUart *FindUart(USART_TypeDef *uart) {
+    ptrdiff_t idx = uart - HAL_SIM_USARTs;
+    if (idx < 0 || (size_t)idx >= SIM_UART_COUNT) return NULL;
+    return &simUarts[idx];
+}
+
+// 8N1: start + 8 data + stop bits per byte
+static uint64_t UartCycles(UART_HandleTypeDef *huart, uint32_t bytes) {
+    uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 115200U;
+    return (uint64_t)bytes * 10U * SystemCoreClock / baud;
+}
+
+static void UartDeliver(SimUart *su, const uint8_t *data, uint16_t len) {
+    simStats.UartBytes += len;
+    for (uint16_t i = 0; i < len && su->Len < HAL_SIM_UART_BUF_SIZE; ++i) su->Buf[su->Len++] = data[i];
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    if (FindUart(huart->Instance) == NULL) return HAL_ERROR;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    return HAL_OK;
+}
+
+// Polls TXE byte after byte: the CPU is held for the whole frame
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    SimUart *su = FindUart(huart->Instance);
+    (void)Timeout;
+    if (su == NULL) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    HAL_SIM_Advance(simCost.UartOverhead);
+    HAL_SIM_Advance(UartCycles(huart, Size));
+    UartDeliver(su, pData, Size);
+    return HAL_OK;
+}
+
+static void UartTxComplete(void *ctx) {
+    SimUart *su = (SimUart *)ctx;
+    HAL_SIM_Advance(simCost.UartIrq);
+    UartDeliver(su, su->Data, su->Size);
+    su->Handle->gState = HAL_UART_STATE_READY;
+    HAL_UART_TxCpltCallback(su->Handle);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    SimUart *su = FindUart(huart->Instance);
+    if (su == NULL || huart->hdmatx == NULL || Size == 0) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    HAL_SIM_Advance(simCost.UartOverhead);
+    su->Handle = huart;
+    su->Data = pData;
+    su->Size = Size;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    if (HAL_SIM_Schedule(simCycles + UartCycles(huart, Size), UartTxComplete, su) != 0) {
+        huart->gState = HAL_UART_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef *huart) {
+    return huart->gState;
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) { (void)huart; }
+
+const uint8_t *HAL_SIM_UART_Data(USART_TypeDef *uart, uint32_t *len) {
+    SimUart *su = FindUart(uart);
+    *len = su ? su->Len : 0;
+    return su ? su->Buf : NULL;
+}
+
+void HAL_SIM_UART_Clear(USART_TypeDef *uart) {
+    SimUart *su = FindUart(uart);
+    if (su) su->Len = 0;
+}
+
+// ========== SPI ==========
+
+static SimSpi *FindSpi(SPI_TypeDef *spi) {
+    ptrdiff_t idx = spi - HAL_SIM_SPIs;
+    if (idx < 0 || (size_t)idx >= SIM_SPI_COUNT) return NULL;
+    return &simSpis[idx];
+}
+
+// 8 SCK periods per byte: SPI1 on PCLK2, SPI2 on PCLK1
+static uint64_t SpiCycles(SPI_HandleTypeDef *hspi, uint32_t bytes) {
+    uint32_t pclk = (hspi->Instance == SPI1) ? HAL_SIM_PCLK2_HZ : HAL_SIM_PCLK1_HZ;
+    uint32_t sck = pclk >> (1U + ((hspi->Init.BaudRatePrescaler >> 3) & 7U));
+    return ((uint64_t)bytes * 8U * SystemCoreClock + sck - 1U) / sck;
+}
+
+// SH/LD: the inputs are latched on the rising edge, after a low of HAL_SIM_HC165_LD_MIN_NS
+static void Hc165Load(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx) {
+    SimSpi *ss = (SimSpi *)ctx;
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    if (!level) {
+        ss->LdFall = simCycles;
+        return;
+    }
+    if (simCycles - ss->LdFall < HAL_SIM_NsToCycles(HAL_SIM_HC165_LD_MIN_NS)) return;
+    memcpy(ss->Latch, ss->Inputs, ss->Chips);
+    ss->Clocked = 0;
+    ss->Loads++;
+}
+
+static void SpiRxComplete(void *ctx) {
+    SimSpi *ss = (SimSpi *)ctx;
+    simStats.SpiIrqs++;
+    HAL_SIM_Advance(simCost.SpiIrq);
+    memcpy(ss->Data, ss->Shifted, ss->Size);
+    ss->Handle->hdmarx->Instance->CNDTR = 0;
+    ss->Handle->State = HAL_SPI_STATE_READY;
+    HAL_SPI_RxCpltCallback(ss->Handle);
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi) {
+    if (FindSpi(hspi->Instance) == NULL) return HAL_ERROR;
+    hspi->State = HAL_SPI_STATE_READY;
+    hspi->ErrorCode = 0;
+    return HAL_OK;
+}
+
+// The shift register is clocked from now on: what MISO carries is fixed at the start
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size) {
+    SimSpi *ss = FindSpi(hspi->Instance);
+    if (ss == NULL || hspi->hdmarx == NULL || hspi->hdmarx->Instance == NULL) return HAL_ERROR;
+    if (pData == NULL || Size == 0 || Size > HAL_SIM_HC165_MAX_CHIPS) return HAL_ERROR;
+    if (hspi->State != HAL_SPI_STATE_READY) return HAL_BUSY;
+
+    HAL_SIM_Advance(simCost.SpiOverhead);
+    for (uint16_t k = 0; k < Size; ++k) {
+        uint32_t chip = (uint32_t)ss->Clocked + k;
+        ss->Shifted[k] = (chip < ss->Chips) ? ss->Latch[chip] : 0xFFU;
+    }
+    ss->Clocked = (uint16_t)(ss->Clocked + Size);
+    simStats.SpiBytes += Size;
+
+    ss->Handle = hspi;
+    ss->Data = pData;
+    ss->Size = Size;
+    hspi->hdmarx->Instance->CNDTR = Size;
+    hspi->State = HAL_SPI_STATE_BUSY_RX;
+    if (HAL_SIM_Schedule(simCycles + SpiCycles(hspi, Size), SpiRxComplete, ss) != 0) {
+        hspi->State = HAL_SPI_STATE_READY;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi) {
+    return hspi->State;
+}
+
+__weak void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi) { (void)hspi; }
+
+void HAL_SIM_HC165_Attach(SPI_TypeDef *spi, GPIO_TypeDef *ldPort, uint16_t ldPin, uint8_t chips) {
+    SimSpi *ss = FindSpi(spi);
+    if (ss == NULL || chips > HAL_SIM_HC165_MAX_CHIPS) return;
+
+    ss->LdPort = ldPort;
+    ss->LdPin = ldPin;
+    ss->Chips = chips;
+    ss->Clocked = 0;
+    ss->Loads = 0;
+    memset(ss->Inputs, 0xFF, sizeof(ss->Inputs));
+    memset(ss->Latch, 0xFF, sizeof(ss->Latch));
+    HAL_SIM_GPIO_SetWriteHook(ldPort, ldPin, Hc165Load, ss);
+}
+
+void HAL_SIM_HC165_SetInput(SPI_TypeDef *spi, uint16_t bit, uint8_t level) {
+    SimSpi *ss = FindSpi(spi);
+    if (ss == NULL || bit >= ss->Chips * 8U) return;
+    if (level) ss->Inputs[bit >> 3] |= (uint8_t)(1U << (bit & 7U));
+    else ss->Inputs[bit >> 3] &= (uint8_t)~(1U << (bit & 7U));
+}
+
+uint32_t HAL_SIM_HC165_Loads(SPI_TypeDef *spi) {
+    SimSpi *ss = FindSpi(spi);
+    return ss ? ss->Loads : 0U;
+}
+
+// ========== ADC ==========
+
+static SimAdc *FindAdc(ADC_TypeDef *adc) {
+    ptrdiff_t idx = adc - HAL_SIM_ADCs;
+    if (idx < 0 || (size_t)idx >= SIM_ADC_COUNT) return NULL;
+    return &simAdcs[idx];
+}
+
+static uint64_t AdcPeriod(SimAdc *sa) {
+    return sa->Period ? sa->Period : HAL_SIM_NsToCycles(HAL_SIM_ADC_SAMPLE_NS);
+}
+
+// One conversion of the input, with its noise
+static uint16_t AdcSample(SimAdc *sa) {
+    if (!sa->Noise) return sa->Input;
+
+    sa->Seed ^= sa->Seed << 13;
+    sa->Seed ^= sa->Seed >> 17;
+    sa->Seed ^= sa->Seed << 5;
+    int32_t v = (int32_t)sa->Input + (int32_t)(sa->Seed % (2U * sa->Noise + 1U)) - (int32_t)sa->Noise;
+    return (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+}
+
+// Write the conversions that ended up to 'until' (only the last lap when more are due)
+static void AdcFill(SimAdc *sa, uint64_t until) {
+    if (sa->Handle == NULL || sa->NextAt > until) return;
+
+    uint64_t period = AdcPeriod(sa);
+    uint64_t n = (until - sa->NextAt) / period + 1U;
+    simStats.AdcSamples += (uint32_t)n;
+    if (n > sa->Len) {
+        uint64_t skip = n - sa->Len;
+        sa->Pos = (uint32_t)((sa->Pos + skip) % sa->Len);
+        sa->NextAt += skip * period;
+        n = sa->Len;
+    }
+    for (uint64_t k = 0; k < n; ++k) {
+        uint16_t v = AdcSample(sa);
+        sa->Buf[sa->Pos] = v;
+        sa->Handle->Instance->DR = v;
+        if (++sa->Pos == sa->Len) sa->Pos = 0;
+    }
+    sa->NextAt += n * period;
+    sa->Handle->DMA_Handle->Instance->CNDTR = sa->Len - sa->Pos;
+}
+
+static void AdcHalfway(void *ctx);
+
+// Next half-transfer / transfer-complete interrupt
+static void AdcSchedule(SimAdc *sa) {
+    uint32_t half = sa->Len / 2U;
+    uint32_t end = (half && sa->Pos < half) ? half : sa->Len;
+    HAL_SIM_Schedule(sa->NextAt + (uint64_t)(end - sa->Pos - 1U) * AdcPeriod(sa), AdcHalfway, sa);
+}
+
+static void AdcHalfway(void *ctx) {
+    SimAdc *sa = (SimAdc *)ctx;
+    if (sa->Handle == NULL) return;
+
+    AdcFill(sa, simCycles);
+    simStats.AdcIrqs++;
+    HAL_SIM_Advance(simCost.AdcIrq);
+    if (sa->Pos == 0) HAL_ADC_ConvCpltCallback(sa->Handle);
+    else HAL_ADC_ConvHalfCpltCallback(sa->Handle);
+    if (sa->Handle) AdcSchedule(sa);
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc) {
+    if (FindAdc(hadc->Instance) == NULL) return HAL_ERROR;
+    hadc->State = HAL_ADC_STATE_READY;
+    hadc->ErrorCode = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length) {
+    SimAdc *sa = FindAdc(hadc->Instance);
+    if (sa == NULL || hadc->DMA_Handle == NULL || hadc->DMA_Handle->Instance == NULL) return HAL_ERROR;
+    if (pData == NULL || Length == 0) return HAL_ERROR;
+    if (sa->Handle != NULL) return HAL_BUSY;
+
+    sa->Handle = hadc;
+    sa->Buf = (uint16_t *)pData;        // DMA set to half-words, as CubeMX does for a 12-bit ADC
+    sa->Len = Length;
+    sa->Pos = 0;
+    sa->NextAt = simCycles + AdcPeriod(sa);
+    if (sa->Seed == 0) sa->Seed = 0x2545F491U + (uint32_t)(sa - simAdcs);
+    hadc->DMA_Handle->Instance->CNDTR = Length;
+    hadc->State = HAL_ADC_STATE_REG_BUSY;
+    AdcSchedule(sa);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc) {
+    SimAdc *sa = FindAdc(hadc->Instance);
+    if (sa == NULL) return HAL_ERROR;
+
+    AdcFill(sa, simCycles);
+    HAL_SIM_Cancel(AdcHalfway, sa);
+    sa->Handle = NULL;
+    hadc->State = HAL_ADC_STATE_READY;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetState(ADC_HandleTypeDef *hadc) {
+    return hadc->State;
+}
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) { (void)hadc; }
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) { (void)hadc; }
+
+// CNDTR of an ADC stream follows the virtual clock; one register load
+uint32_t HAL_SIM_DMA_GetCounter(DMA_HandleTypeDef *hdma) {
+    HAL_SIM_Advance(simCost.GpioReg);
+    for (size_t i = 0; i < SIM_ADC_COUNT; ++i) {
+        if (simAdcs[i].Handle && simAdcs[i].Handle->DMA_Handle == hdma) AdcFill(&simAdcs[i], simCycles);
+    }
+    return hdma->Instance->CNDTR;
+}
+
+void HAL_SIM_ADC_SetInput(ADC_TypeDef *adc, uint16_t value) {
+    SimAdc *sa = FindAdc(adc);
+    if (sa == NULL) return;
+    AdcFill(sa, simCycles);         // conversions so far saw the old level
+    sa->Input = value > 4095U ? 4095U : value;
+}
+
+void HAL_SIM_ADC_SetNoise(ADC_TypeDef *adc, uint16_t noise) {
+    SimAdc *sa = FindAdc(adc);
+    if (sa == NULL) return;
+    AdcFill(sa, simCycles);
+    sa->Noise = noise;
+}
+
+void HAL_SIM_ADC_SetSamplePeriod(ADC_TypeDef *adc, uint32_t ns) {
+    SimAdc *sa = FindAdc(adc);
+    if (sa == NULL) return;
+    AdcFill(sa, simCycles);
+    sa->Period = ns ? HAL_SIM_NsToCycles(ns) : 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file HAL_SIM.h
+ * @brief Control API of the host-side HAL simulator.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * The simulator runs the drivers on a PC against a virtual CPU clock. Every HAL
+ * call charges a number of cycles (see HAL_SIM_CostModel), HAL_Delay jumps the
+ * clock forward and I2C transfers take the time they would take on the wire.
+ *
+ * Test code uses this header to:
+ * - drive input pins (static levels or timed waveforms); pins configured with a
+ *   GPIO_MODE_IT_* mode raise HAL_GPIO_EXTI_Callback on their edges,
+ * - observe output pins through write hooks,
+ * - attach virtual I2C slaves with a register map, make them hang the bus,
+ * - inject timer captures and scheduled "interrupts",
+ * - set the voltage seen by the ADCs (with noise), sampled into their DMA buffers,
+ * - capture what goes out on the UARTs and SWO,
+ * - chain 74HC165 shift registers on an SPI bus and set their inputs,
+ * - read the counters used by the benchmarks (time, toggles, bus traffic).
+ */
+
+
+
+#ifndef __HAL_SIM_H
+#define __HAL_SIM_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_SIM_SYSCLK_HZ  72000000U   // Typical F103 setup: HSE 8 MHz x9
+#define HAL_SIM_PCLK1_HZ   36000000U   // APB1 = HCLK / 2 -> timers on APB1 run at 2 x PCLK1
+#define HAL_SIM_PCLK2_HZ   72000000U
+
+#define HAL_SIM_SWO_HZ     2000000U    // SWO pin, async NRZ (10 bits per byte)
+
+#define HAL_SIM_MAX_EVENTS     16
+#define HAL_SIM_SWO_BUF_SIZE   8192
+#define HAL_SIM_UART_BUF_SIZE  32768   // bytes kept per UART
+#define HAL_SIM_MAX_I2C_SLAVES 8
+
+#define HAL_SIM_I2C_BUSY_FLAG_MS 25   // HAL wait on the BUSY flag before a transfer gives up (HAL_BUSY)
+
+// Cycles charged for each simulated operation
+typedef struct {
+    uint32_t GpioWrite;     // HAL_GPIO_WritePin / TogglePin
+    uint32_t GpioRead;      // HAL_GPIO_ReadPin
+    uint32_t GpioInit;      // HAL_GPIO_Init
+    uint32_t GpioReg;       // one direct register load/store
+    uint32_t TimAccess;     // __HAL_TIM_GET/SET_COUNTER, capture read
+    uint32_t Nop;           // __NOP, charged with the volatile loop around it
+    uint32_t GetTick;       // HAL_GetTick
+    uint32_t I2cOverhead;   // software setup of one I2C transfer (blocking, IT or DMA)
+    uint32_t I2cIrq;        // one I2C event/DMA interrupt (IT mode: one per byte)
+    uint32_t UartOverhead;  // software setup of one UART transmit (blocking or DMA)
+    uint32_t UartIrq;       // DMA transfer-complete interrupt of a UART transmit
+    uint32_t ExtiIrq;       // entry + HAL_GPIO_EXTI_IRQHandler, before the callback
+    uint32_t AdcIrq;        // DMA half / complete interrupt of an ADC stream, before the callback
+    uint32_t SpiOverhead;   // software setup of one SPI DMA transfer
+    uint32_t SpiIrq;        // DMA transfer-complete interrupt of an SPI receive, before the callback
+} HAL_SIM_CostModel;
+
+// Counters accumulated since the last HAL_SIM_ResetStats()
+typedef struct {
+    uint64_t Cycles;           // virtual CPU cycles elapsed
+    uint32_t GpioWrites;       // HAL write calls (and direct BSRR/BRR stores)
+    uint32_t GpioToggles;      // output pin level changes
+    uint32_t GpioReads;        // HAL read calls
+    uint32_t I2cTransactions;  // START ... STOP sequences
+    uint32_t I2cBytes;         // bytes clocked on the bus, address bytes included
+    uint32_t I2cErrors;        // NACKs and timeouts
+    uint32_t UartBytes;        // bytes sent on the UARTs
+    uint32_t ExtiIrqs;         // EXTI line interrupts taken
+    uint32_t AdcSamples;       // conversions written by the ADC DMA streams
+    uint32_t AdcIrqs;          // ADC DMA half / complete interrupts taken
+    uint32_t SpiBytes;         // bytes clocked on the SPI buses
+    uint32_t SpiIrqs;          // SPI DMA transfer-complete interrupts taken
+    uint32_t DelayCalls;       // HAL_Delay calls
+    uint32_t DelayMs;          // sum of HAL_Delay arguments
+    uint32_t Wakeups;          // __WFI calls (one wake-up each)
+    uint64_t SleepCycles;      // cycles spent in __WFI
+} HAL_SIM_Stats;
+
+// One segment of a scripted input waveform
+typedef struct {
+    uint32_t DurationNs;
+    uint8_t Level;
+} HAL_SIM_PinStep;
+
+typedef void (*HAL_SIM_PinWriteHook)(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx);
+typedef void (*HAL_SIM_EventFn)(void *ctx);
+
+// Virtual I2C slave with an 8-bit register pointer (RTCs, EEPROMs, PCF8574...)
+typedef struct HAL_SIM_I2CSlave_s {
+    uint16_t DevAddress;       // 8-bit HAL address (7-bit << 1)
+    uint8_t Regs[256];
+    uint16_t RegCount;         // pointer wraps at this value, 0 = 256
+    uint8_t Pointer;           // current register pointer
+    uint8_t Nack;              // 1 = do not acknowledge the address
+
+    // Optional hooks, called after the register map has been updated / before it is read
+    void (*OnWrite)(struct HAL_SIM_I2CSlave_s *slave, uint8_t reg, const uint8_t *data, uint16_t len);
+    void (*OnRead)(struct HAL_SIM_I2CSlave_s *slave, uint8_t reg, uint16_t len);
+    // Raw HAL_I2C_Master_Transmit; when NULL the first byte sets the pointer
+    void (*OnTransmit)(struct HAL_SIM_I2CSlave_s *slave, const uint8_t *data, uint16_t len);
+    void *Ctx;
+
+    // Filled in by HAL_SIM_I2C_Attach
+    I2C_TypeDef *Bus;
+} HAL_SIM_I2CSlave;
+
+// ==== Clock and statistics ====
+void HAL_SIM_Reset(void);
+void HAL_SIM_Advance(uint64_t cycles);
+void HAL_SIM_AdvanceUs(uint32_t us);
+uint64_t HAL_SIM_Now(void);
+uint64_t HAL_SIM_NsToCycles(uint64_t ns);
+uint64_t HAL_SIM_CyclesToNs(uint64_t cycles);
+
+HAL_SIM_CostModel *HAL_SIM_Cost(void);
+void HAL_SIM_GetStats(HAL_SIM_Stats *stats);
+void HAL_SIM_ResetStats(void);
+
+// Run fn(ctx) when the virtual clock reaches 'at' (acts like an interrupt)
+int HAL_SIM_Schedule(uint64_t at, HAL_SIM_EventFn fn, void *ctx);
+// Drop the pending events with this fn / ctx
+void HAL_SIM_Cancel(HAL_SIM_EventFn fn, void *ctx);
+
+// ==== GPIO ====
+void HAL_SIM_GPIO_SetInput(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level);
+void HAL_SIM_GPIO_Release(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_SIM_GPIO_PlayScript(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                             const HAL_SIM_PinStep *steps, uint16_t count, uint8_t idleLevel);
+void HAL_SIM_GPIO_SetWriteHook(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, HAL_SIM_PinWriteHook hook, void *ctx);
+uint8_t HAL_SIM_GPIO_GetOutput(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+// Direct register access (GPIO_FAST): one store / one load, charged GpioReg
+void HAL_SIM_GPIO_WriteBSRR(GPIO_TypeDef *GPIOx, uint32_t bsrr);
+uint32_t HAL_SIM_GPIO_ReadIDR(GPIO_TypeDef *GPIOx);
+void HAL_SIM_GPIO_Sync(void);
+
+// ==== DWT ====
+// 0 = cycle counter never runs (core without DWT, debugger holding trace off)
+void HAL_SIM_DWT_SetPresent(uint8_t present);
+
+// ==== ITM / SWO ====
+// Bytes sent with ITM_SendChar since the last clear (what the debugger received)
+const uint8_t *HAL_SIM_SWO_Data(uint32_t *len);
+void HAL_SIM_SWO_Clear(void);
+
+// ==== UART ====
+// Bytes the other end received since the last clear (8N1: 10 bits per byte at BaudRate).
+// A DMA transmit hands the buffer over when its last byte is out.
+const uint8_t *HAL_SIM_UART_Data(USART_TypeDef *uart, uint32_t *len);
+void HAL_SIM_UART_Clear(USART_TypeDef *uart);
+
+// ==== SPI ====
+// Chain of 'chips' 74HC165 on the MISO of an SPI bus, parallel load on a GPIO output
+// (SH/LD, low = load). The rising edge of SH/LD latches the inputs; each byte clocked
+// after it is the next chip, the one wired to MISO first, input H (D7) as its MSB.
+// Past the chain the bytes read 0xFF (SER of the last chip tied high). Inputs start
+// high (pull-ups). A low pulse shorter than HAL_SIM_HC165_LD_MIN_NS (tw at 2 V) latches
+// nothing.
+#define HAL_SIM_HC165_MAX_CHIPS 32
+#define HAL_SIM_HC165_LD_MIN_NS 80U
+void HAL_SIM_HC165_Attach(SPI_TypeDef *spi, GPIO_TypeDef *ldPort, uint16_t ldPin, uint8_t chips);
+// Input 'bit' = chip * 8 + input (A = 0 ... H = 7)
+void HAL_SIM_HC165_SetInput(SPI_TypeDef *spi, uint16_t bit, uint8_t level);
+// Latches (rising edges of SH/LD after a long enough low) seen since the attach
+uint32_t HAL_SIM_HC165_Loads(SPI_TypeDef *spi);
+
+// ==== ADC ====
+// Conversion result of the input (0..4095) from now on; 'noise' adds a pseudo-random
+// -noise..+noise to each sample. One conversion every HAL_SIM_ADC_SAMPLE_NS by default
+// (ADCCLK 12 MHz, 239.5 cycles sampling)
+#define HAL_SIM_ADC_SAMPLE_NS 21000U
+void HAL_SIM_ADC_SetInput(ADC_TypeDef *adc, uint16_t value);
+void HAL_SIM_ADC_SetNoise(ADC_TypeDef *adc, uint16_t noise);
+void HAL_SIM_ADC_SetSamplePeriod(ADC_TypeDef *adc, uint32_t ns);
+
+// ==== TIM ====
+uint32_t HAL_SIM_TIM_GetClockFreq(TIM_HandleTypeDef *htim);
+void HAL_SIM_TIM_Capture(TIM_HandleTypeDef *htim, uint32_t Channel);
+// Quadrature counts seen by a timer in encoder mode (negative = backwards), at once
+void HAL_SIM_TIM_EncoderTurn(TIM_HandleTypeDef *htim, int32_t counts);
+
+// ==== I2C ====
+void HAL_SIM_I2C_Attach(I2C_HandleTypeDef *hi2c, HAL_SIM_I2CSlave *slave);
+void HAL_SIM_I2C_Detach(HAL_SIM_I2CSlave *slave);
+
+// Bus faults. Bus pins as on the F103 (I2C1 = PB6/PB7, I2C2 = PB10/PB11), pulled up
+// once a slave is attached. HAL_I2C_Init gives them back to the peripheral.
+// A slave reset in the middle of a read keeps SDA low until it has seen 'clocks'
+// SCL pulses on the pin (0 = release): every transfer fails with HAL_BUSY.
+void HAL_SIM_I2C_HoldSda(I2C_TypeDef *bus, uint8_t clocks);
+// A slave stretches SCL for 'us' from now: transfers stall until then, blocking
+// calls give up with HAL_ERROR / HAL_I2C_ERROR_TIMEOUT once their Timeout is over.
+void HAL_SIM_I2C_HoldScl(I2C_TypeDef *bus, uint32_t us);
+void HAL_SIM_I2C_GetPins(I2C_TypeDef *bus, GPIO_TypeDef **port, uint16_t *scl, uint16_t *sda);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HAL_SIM_H
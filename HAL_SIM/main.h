@@ -0,0 +1,14 @@
+/**
+ * @file main.h
+ * @brief Host replacement for the CubeMX generated main.h.
+ *
+ * Application code generated by CubeMX includes "main.h" to get the HAL; on the
+ * host this simply forwards to the simulated HAL.
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include "stm32f1xx_hal.h"
+
+#endif // __MAIN_H
@@ -0,0 +1,149 @@
+/**
+ * @file SIM_DEVICES.c
+ * @brief Device models for the HAL simulator (DHT22, HC-SR04, DS RTC, PCF8574).
+ *
+ * Timings follow the datasheets in the driver folders:
+ * - DHT22: 20 us after release the sensor pulls low 80 us, high 80 us, then each
+ *   bit is 50 us low followed by 26 us (0) or 70 us (1) high.
+ * - HC-SR04: echo rises ~500 us after the trigger pulse, width = 58 us per cm.
+ */
+
+
+
+#include "SIM_DEVICES.h"
+#include <string.h>
+
+// ========== DHT22 ==========
+
+static int DHT22_BuildWave(SIM_DHT22 *dev) {
+    uint16_t t = (uint16_t)(dev->Temperature < 0 ? (0x8000 | -dev->Temperature) : dev->Temperature);
+    uint8_t b[5] = { (uint8_t)(dev->Humidity >> 8), (uint8_t)dev->Humidity, (uint8_t)(t >> 8), (uint8_t)t, 0 };
+    b[4] = (uint8_t)(b[0] + b[1] + b[2] + b[3] + (dev->BadChecksum ? 1 : 0));
+
+    int k = 0;
+    dev->Wave[k++] = (HAL_SIM_PinStep){ 20000, 1 };
+    dev->Wave[k++] = (HAL_SIM_PinStep){ 80000, 0 };
+    dev->Wave[k++] = (HAL_SIM_PinStep){ 80000, 1 };
+    for (int i = 0; i < 40; ++i) {
+        if (dev->StuckAfter && i == dev->StuckAfter) break;
+        uint8_t bit = (b[i / 8] >> (7 - i % 8)) & 1U;
+        dev->Wave[k++] = (HAL_SIM_PinStep){ 50000, 0 };
+        dev->Wave[k++] = (HAL_SIM_PinStep){ bit ? 70000U : 26000U, 1 };
+    }
+    dev->Wave[k++] = (HAL_SIM_PinStep){ 50000, 0 };
+    return k;
+}
+
+// Host releasing the line after the start pulse triggers the answer
+static void DHT22_OnWrite(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx) {
+    SIM_DHT22 *dev = (SIM_DHT22 *)ctx;
+    if (!level || !dev->Present) return;
+
+    int steps = DHT22_BuildWave(dev);
+    HAL_SIM_GPIO_PlayScript(GPIOx, GPIO_Pin, dev->Wave, (uint16_t)steps, dev->StuckAfter ? 0 : 1);
+}
+
+void SIM_DHT22_Attach(SIM_DHT22 *dev, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    HAL_SIM_GPIO_SetInput(GPIOx, GPIO_Pin, 1); // pull-up
+    HAL_SIM_GPIO_SetWriteHook(GPIOx, GPIO_Pin, DHT22_OnWrite, dev);
+}
+
+// ========== HC-SR04 ==========
+
+static void HCSR04_Edge(void *ctx) {
+    SIM_HCSR04 *dev = (SIM_HCSR04 *)ctx;
+    HAL_SIM_TIM_Capture(dev->htim, dev->Channel);
+}
+
+static void HCSR04_OnTrigger(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level, void *ctx) {
+    SIM_HCSR04 *dev = (SIM_HCSR04 *)ctx;
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    if (level) return; // burst starts on the falling edge of TRIG
+
+    uint64_t rise = HAL_SIM_Now() + HAL_SIM_NsToCycles(500000);
+    HAL_SIM_Schedule(rise, HCSR04_Edge, dev);
+    HAL_SIM_Schedule(rise + HAL_SIM_NsToCycles((uint64_t)dev->EchoUs * 1000U), HCSR04_Edge, dev);
+}
+
+void SIM_HCSR04_Attach(SIM_HCSR04 *dev, GPIO_TypeDef *TRIG_Port, uint16_t TRIG_Pin,
+                       TIM_HandleTypeDef *htim, uint32_t Channel) {
+    dev->htim = htim;
+    dev->Channel = Channel;
+    HAL_SIM_GPIO_SetWriteHook(TRIG_Port, TRIG_Pin, HCSR04_OnTrigger, dev);
+}
+
+// ========== DS1307 / DS3231 ==========
+
+void SIM_DSRTC_Attach(HAL_SIM_I2CSlave *slave, I2C_HandleTypeDef *hi2c, SIM_DSRTC_Model model) {
+    memset(slave, 0, sizeof(*slave));
+    slave->DevAddress = 0x68 << 1;
+
+    // 2025-05-14 (Wed) 12:34:56
+    const uint8_t time[7] = { 0x56, 0x34, 0x12, 0x03, 0x14, 0x05, 0x25 };
+    memcpy(slave->Regs, time, sizeof(time));
+
+    if (model == SIM_DSRTC_DS3231) {
+        slave->RegCount = 0x13;
+        slave->Regs[0x0E] = 0x1C;
+        slave->Regs[0x11] = 25;    // 25.25 degC
+        slave->Regs[0x12] = 0x40;
+    } else {
+        slave->RegCount = 0x40;    // 8 time/control registers + 56 bytes SRAM
+    }
+
+    HAL_SIM_I2C_Attach(hi2c, slave);
+}
+
+// ========== PCF8574 ==========
+
+// One complete byte reached the controller at time 'ns'
+static void HD44780_Execute(SIM_PCF8574 *dev, uint8_t value, uint8_t rs, uint64_t ns) {
+    uint32_t execNs = 37000;   // typical at 270 kHz
+
+    if (rs) {
+        dev->Ddram[dev->Address & 0x7F] = (char)value;
+        dev->Address = (uint8_t)((dev->Address + 1) & 0x7F);
+    } else if (value & 0x80) {
+        dev->Address = value & 0x7F;
+    } else if (value == 0x01 || (value & 0xFE) == 0x02) {
+        if (value == 0x01) memset(dev->Ddram, ' ', sizeof(dev->Ddram));
+        dev->Address = 0;
+        execNs = 1520000;
+    }
+    dev->BusyUntilNs = ns + execNs;
+}
+
+static void PCF8574_OnTransmit(HAL_SIM_I2CSlave *slave, const uint8_t *data, uint16_t len) {
+    SIM_PCF8574 *dev = (SIM_PCF8574 *)slave->Ctx;
+    uint64_t end = HAL_SIM_CyclesToNs(HAL_SIM_Now());
+
+    for (uint16_t i = 0; i < len; ++i) {
+        uint8_t prev = dev->Port;
+        dev->Port = data[i];
+
+        // Falling edge of E latches a nibble
+        if ((prev & 0x04) && !(data[i] & 0x04)) {
+            uint64_t ns = end - (uint64_t)(len - 1U - i) * dev->ByteNs;
+            if (!dev->HalfByte) {
+                if (ns < dev->BusyUntilNs) dev->Violations++;
+                dev->Nibble = prev & 0xF0;
+                dev->HalfByte = 1;
+            } else {
+                dev->HalfByte = 0;
+                HD44780_Execute(dev, (uint8_t)(dev->Nibble | (prev >> 4)), prev & 0x01, ns);
+            }
+        }
+    }
+    dev->Writes += len;
+}
+
+void SIM_PCF8574_Attach(SIM_PCF8574 *dev, I2C_HandleTypeDef *hi2c, uint16_t DevAddress) {
+    memset(dev, 0, sizeof(*dev));
+    memset(dev->Ddram, ' ', sizeof(dev->Ddram));
+    dev->ByteNs = 90000;
+    dev->Slave.DevAddress = DevAddress;
+    dev->Slave.OnTransmit = PCF8574_OnTransmit;
+    dev->Slave.Ctx = dev;
+    HAL_SIM_I2C_Attach(hi2c, &dev->Slave);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file SIM_DEVICES.h
+ * @brief Behavioural models of the external chips the drivers talk to.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Models are built on the HAL_SIM primitives (pin write hooks, scripted inputs,
+ * scheduled events and virtual I2C slaves):
+ * - SIM_DHT22:   answers the start pulse with the 40-bit frame.
+ * - SIM_HCSR04:  turns a TRIG pulse into two input captures (echo rise / fall).
+ * - SIM_DSRTC:   DS1307 / DS3231 register map at 0x68.
+ * - SIM_PCF8574: I2C backpack of the 16x2 LCD, decodes the HD44780 stream into DDRAM
+ *                and counts writes sent while the controller is still busy.
+ */
+
+
+
+#ifndef __SIM_DEVICES_H
+#define __SIM_DEVICES_H
+
+#include "HAL_SIM.h"
+
+// ==== DHT22 ====
+typedef struct {
+    int16_t Temperature;      // 0.1 degC
+    uint16_t Humidity;        // 0.1 %RH
+    uint8_t Present;          // 0 = nobody answers, line stays high
+    uint8_t BadChecksum;      // 1 = corrupt the checksum byte
+    uint8_t StuckAfter;       // > 0 = hangs after this many bits, holding the line low
+    HAL_SIM_PinStep Wave[84];
+} SIM_DHT22;
+
+void SIM_DHT22_Attach(SIM_DHT22 *dev, GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+// ==== HC-SR04 ====
+typedef struct {
+    TIM_HandleTypeDef *htim;
+    uint32_t Channel;
+    uint32_t EchoUs;          // echo pulse width (58 us per cm)
+} SIM_HCSR04;
+
+void SIM_HCSR04_Attach(SIM_HCSR04 *dev, GPIO_TypeDef *TRIG_Port, uint16_t TRIG_Pin,
+                       TIM_HandleTypeDef *htim, uint32_t Channel);
+
+// ==== DS1307 / DS3231 ====
+typedef enum {
+    SIM_DSRTC_DS1307,
+    SIM_DSRTC_DS3231
+} SIM_DSRTC_Model;
+
+void SIM_DSRTC_Attach(HAL_SIM_I2CSlave *slave, I2C_HandleTypeDef *hi2c, SIM_DSRTC_Model model);
+
+// ==== PCF8574 LCD backpack ====
+// Also decodes the HD44780 4-bit stream (P2 = E, P0 = RS, P4..P7 = data) into DDRAM
+typedef struct {
+    HAL_SIM_I2CSlave Slave;
+    uint8_t Port;             // last byte written to the expander
+    uint32_t Writes;
+    uint32_t ByteNs;          // time of one byte on the bus (default 90 us = 100 kHz)
+
+    char Ddram[128];
+    uint8_t Address;
+    uint32_t Violations;      // bytes latched while the controller was still busy
+    uint8_t HalfByte;         // high nibble already latched
+    uint8_t Nibble;
+    uint64_t BusyUntilNs;
+} SIM_PCF8574;
+
+void SIM_PCF8574_Attach(SIM_PCF8574 *dev, I2C_HandleTypeDef *hi2c, uint16_t DevAddress);
+
+#endif // __SIM_DEVICES_H
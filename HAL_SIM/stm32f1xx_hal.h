@@ -0,0 +1,602 @@
+/**
+ * @file stm32f1xx_hal.h
+ * @brief Host stand-in for the STM32F1 HAL used by the drivers in this repository.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * This header replaces the real CubeF1 "stm32f1xx_hal.h" when the drivers are
+ * built on a PC. Only the part of the HAL the drivers actually use is declared:
+ * GPIO, SysTick (HAL_GetTick / HAL_Delay), TIM base / input capture / encoder, I2C,
+ * UART, SPI receive by DMA and ADC streams into circular DMA buffers.
+ *
+ * Every call is executed against a virtual clock (see HAL_SIM.h), so the time a
+ * driver blocks and the traffic it produces can be measured without a board.
+ *
+ * Notes:
+ * - Register structs only contain the registers the drivers touch.
+ * - The __HAL_TIM_* macros are routed to functions so spin loops advance time.
+ */
+
+
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Drivers can test this to know they are running against the simulator
+#define HAL_SIM 1
+
+// ==== Compiler / core ====
+#ifndef __weak
+#define __weak __attribute__((weak))
+#endif
+
+void HAL_SIM_NOP(void);
+#define __NOP() HAL_SIM_NOP()
+
+// Sleep until the next interrupt (scheduled event or SysTick)
+void HAL_SIM_WFI(void);
+#define __WFI() HAL_SIM_WFI()
+
+// PRIMASK: while set, scheduled events (simulated ISRs) are held back
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+extern uint32_t SystemCoreClock;
+
+// ==== Common types ====
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+    RESET = 0U,
+    SET = !RESET
+} FlagStatus, ITStatus;
+
+typedef enum {
+    DISABLE = 0U,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+// ==== GPIO ====
+typedef struct {
+    volatile uint32_t CRL;
+    volatile uint32_t CRH;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+    volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef HAL_SIM_GPIOPorts[5];
+
+#define GPIOA (&HAL_SIM_GPIOPorts[0])
+#define GPIOB (&HAL_SIM_GPIOPorts[1])
+#define GPIOC (&HAL_SIM_GPIOPorts[2])
+#define GPIOD (&HAL_SIM_GPIOPorts[3])
+#define GPIOE (&HAL_SIM_GPIOPorts[4])
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_4   ((uint16_t)0x0010)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_13  ((uint16_t)0x2000)
+#define GPIO_PIN_14  ((uint16_t)0x4000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+#define GPIO_PIN_All ((uint16_t)0xFFFF)
+
+#define GPIO_MODE_INPUT     0x00000000U
+#define GPIO_MODE_OUTPUT_PP 0x00000001U
+#define GPIO_MODE_OUTPUT_OD 0x00000011U
+#define GPIO_MODE_IT_RISING         0x10110000U
+#define GPIO_MODE_IT_FALLING        0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+
+#define GPIO_NOPULL   0x00000000U
+#define GPIO_PULLUP   0x00000001U
+#define GPIO_PULLDOWN 0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW    0x00000002U
+#define GPIO_SPEED_FREQ_MEDIUM 0x00000001U
+#define GPIO_SPEED_FREQ_HIGH   0x00000003U
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+// ==== SysTick ====
+extern volatile uint32_t uwTick;
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+
+// ==== RCC ====
+uint32_t HAL_RCC_GetSysClockFreq(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+// ==== TIM ====
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SMCR;
+    volatile uint32_t DIER;
+    volatile uint32_t SR;
+    volatile uint32_t EGR;
+    volatile uint32_t CCMR1;
+    volatile uint32_t CCMR2;
+    volatile uint32_t CCER;
+    volatile uint32_t CNT;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+    volatile uint32_t RCR;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCR2;
+    volatile uint32_t CCR3;
+    volatile uint32_t CCR4;
+} TIM_TypeDef;
+
+extern TIM_TypeDef HAL_SIM_TIMs[4];
+
+#define TIM1 (&HAL_SIM_TIMs[0])
+#define TIM2 (&HAL_SIM_TIMs[1])
+#define TIM3 (&HAL_SIM_TIMs[2])
+#define TIM4 (&HAL_SIM_TIMs[3])
+
+#define TIM_CHANNEL_1   0x00000000U
+#define TIM_CHANNEL_2   0x00000004U
+#define TIM_CHANNEL_3   0x00000008U
+#define TIM_CHANNEL_4   0x0000000CU
+#define TIM_CHANNEL_ALL 0x0000003CU
+
+#define TIM_INPUTCHANNELPOLARITY_RISING    0x00000000U
+#define TIM_INPUTCHANNELPOLARITY_FALLING   0x00000002U
+#define TIM_INPUTCHANNELPOLARITY_BOTHEDGE  0x0000000AU
+
+#define TIM_COUNTERMODE_UP 0x00000000U
+
+#define TIM_FLAG_UPDATE 0x00000001U
+
+#define TIM_CR1_DIR 0x00000010U
+
+#define TIM_ENCODERMODE_TI1  0x00000001U
+#define TIM_ENCODERMODE_TI2  0x00000002U
+#define TIM_ENCODERMODE_TI12 0x00000003U
+
+#define TIM_ICPOLARITY_RISING  TIM_INPUTCHANNELPOLARITY_RISING
+#define TIM_ICPOLARITY_FALLING TIM_INPUTCHANNELPOLARITY_FALLING
+#define TIM_ICSELECTION_DIRECTTI 0x00000001U
+#define TIM_ICPSC_DIV1 0x00000000U
+
+typedef enum {
+    HAL_TIM_ACTIVE_CHANNEL_1       = 0x01U,
+    HAL_TIM_ACTIVE_CHANNEL_2       = 0x02U,
+    HAL_TIM_ACTIVE_CHANNEL_3       = 0x04U,
+    HAL_TIM_ACTIVE_CHANNEL_4       = 0x08U,
+    HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00U
+} HAL_TIM_ActiveChannel;
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+    HAL_TIM_ActiveChannel Channel;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t EncoderMode;       // TIM_ENCODERMODE_TI12: 4 counts per quadrature cycle
+    uint32_t IC1Polarity;
+    uint32_t IC1Selection;
+    uint32_t IC1Prescaler;
+    uint32_t IC1Filter;
+    uint32_t IC2Polarity;
+    uint32_t IC2Selection;
+    uint32_t IC2Prescaler;
+    uint32_t IC2Filter;
+} TIM_Encoder_InitTypeDef;
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+// Encoder mode: CNT is clocked by the A/B inputs, up or down, no interrupt
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_Encoder_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+
+uint32_t HAL_SIM_TIM_GetCounter(TIM_HandleTypeDef *htim);
+void HAL_SIM_TIM_SetCounter(TIM_HandleTypeDef *htim, uint32_t value);
+void HAL_SIM_TIM_SetCapturePolarity(TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t Polarity);
+void HAL_SIM_TIM_SetAutoreload(TIM_HandleTypeDef *htim, uint32_t value);
+uint32_t HAL_SIM_TIM_GetFlag(TIM_HandleTypeDef *htim, uint32_t flag);
+void HAL_SIM_TIM_ClearFlag(TIM_HandleTypeDef *htim, uint32_t flag);
+
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)         HAL_SIM_TIM_GetCounter(__HANDLE__)
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __V__)  HAL_SIM_TIM_SetCounter((__HANDLE__), (__V__))
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__)      ((__HANDLE__)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __V__) HAL_SIM_TIM_SetAutoreload((__HANDLE__), (__V__))
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)  HAL_SIM_TIM_GetFlag((__HANDLE__), (__FLAG__))
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__) HAL_SIM_TIM_ClearFlag((__HANDLE__), (__FLAG__))
+#define __HAL_TIM_SET_CAPTUREPOLARITY(__HANDLE__, __CHANNEL__, __POLARITY__) \
+    HAL_SIM_TIM_SetCapturePolarity((__HANDLE__), (__CHANNEL__), (__POLARITY__))
+#define __HAL_TIM_IS_TIM_COUNTING_DOWN(__HANDLE__) (((__HANDLE__)->Instance->CR1 & TIM_CR1_DIR) == TIM_CR1_DIR)
+
+// ==== Core debug / DWT (CMSIS names) ====
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DHCSR;
+    volatile uint32_t DCRSR;
+    volatile uint32_t DCRDR;
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type HAL_SIM_DWT;
+extern CoreDebug_Type HAL_SIM_CoreDebug;
+
+#define DWT       (&HAL_SIM_DWT)
+#define CoreDebug (&HAL_SIM_CoreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk      0x00000001U
+#define CoreDebug_DEMCR_TRCENA_Msk  0x01000000U
+
+// CYCCNT follows the virtual clock; raw loads of DWT->CYCCNT cannot be intercepted
+uint32_t HAL_SIM_DWT_ReadCycles(void);
+
+// ITM stimulus port 0 (SWO), blocks while the previous byte is shifted out
+uint32_t ITM_SendChar(uint32_t ch);
+
+// ==== DMA ====
+typedef struct {
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+    volatile uint32_t CPAR;
+    volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef *Instance;
+    void *Parent;
+} DMA_HandleTypeDef;
+
+// Transfers left before the end of the buffer (circular: reloaded at 0)
+uint32_t HAL_SIM_DMA_GetCounter(DMA_HandleTypeDef *hdma);
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) HAL_SIM_DMA_GetCounter(__HANDLE__)
+
+// ==== ADC ====
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SMPR1;
+    volatile uint32_t SMPR2;
+    volatile uint32_t JOFR1;
+    volatile uint32_t JOFR2;
+    volatile uint32_t JOFR3;
+    volatile uint32_t JOFR4;
+    volatile uint32_t HTR;
+    volatile uint32_t LTR;
+    volatile uint32_t SQR1;
+    volatile uint32_t SQR2;
+    volatile uint32_t SQR3;
+    volatile uint32_t JSQR;
+    volatile uint32_t JDR1;
+    volatile uint32_t JDR2;
+    volatile uint32_t JDR3;
+    volatile uint32_t JDR4;
+    volatile uint32_t DR;
+} ADC_TypeDef;
+
+extern ADC_TypeDef HAL_SIM_ADCs[2];
+
+#define ADC1 (&HAL_SIM_ADCs[0])
+#define ADC2 (&HAL_SIM_ADCs[1])
+
+#define ADC_DATAALIGN_RIGHT      0x00000000U
+#define ADC_SCAN_DISABLE         0x00000000U
+#define ADC_SOFTWARE_START       0x000E0000U
+
+#define HAL_ADC_STATE_RESET      0x00000000U
+#define HAL_ADC_STATE_READY      0x00000001U
+#define HAL_ADC_STATE_REG_BUSY   0x00000100U
+
+typedef struct {
+    uint32_t DataAlign;
+    uint32_t ScanConvMode;
+    uint32_t ContinuousConvMode;     // ENABLE for a DMA stream
+    uint32_t NbrOfConversion;
+    uint32_t DiscontinuousConvMode;
+    uint32_t NbrOfDiscConversion;
+    uint32_t ExternalTrigConv;
+} ADC_InitTypeDef;
+
+typedef struct {
+    ADC_TypeDef *Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef *DMA_Handle;   // circular, half-word
+    volatile uint32_t State;
+    volatile uint32_t ErrorCode;
+} ADC_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+// Continuous conversions into pData (Length half-words), HT / TC callbacks every half buffer
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+uint32_t HAL_ADC_GetState(ADC_HandleTypeDef *hadc);
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+// ==== I2C ====
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t OAR1;
+    volatile uint32_t OAR2;
+    volatile uint32_t DR;
+    volatile uint32_t SR1;
+    volatile uint32_t SR2;
+    volatile uint32_t CCR;
+    volatile uint32_t TRISE;
+} I2C_TypeDef;
+
+extern I2C_TypeDef HAL_SIM_I2Cs[2];
+
+#define I2C1 (&HAL_SIM_I2Cs[0])
+#define I2C2 (&HAL_SIM_I2Cs[1])
+
+#define I2C_MEMADD_SIZE_8BIT  0x00000001U
+#define I2C_MEMADD_SIZE_16BIT 0x00000010U
+
+#define HAL_I2C_ERROR_NONE    0x00000000U
+#define HAL_I2C_ERROR_BERR    0x00000001U
+#define HAL_I2C_ERROR_ARLO    0x00000002U
+#define HAL_I2C_ERROR_AF      0x00000004U
+#define HAL_I2C_ERROR_TIMEOUT 0x00000020U
+
+typedef enum {
+    HAL_I2C_STATE_RESET = 0x00U,
+    HAL_I2C_STATE_READY   = 0x20U,
+    HAL_I2C_STATE_BUSY    = 0x24U,
+    HAL_I2C_STATE_BUSY_TX = 0x21U,
+    HAL_I2C_STATE_BUSY_RX = 0x22U
+} HAL_I2C_StateTypeDef;
+
+typedef struct {
+    uint32_t ClockSpeed;
+    uint32_t DutyCycle;
+    uint32_t OwnAddress1;
+    uint32_t AddressingMode;
+    uint32_t DualAddressMode;
+    uint32_t OwnAddress2;
+    uint32_t GeneralCallMode;
+    uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef struct {
+    I2C_TypeDef *Instance;
+    I2C_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_I2C_StateTypeDef State;
+    volatile uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                          uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                         uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+
+// Interrupt / DMA driven transfers: return at once, completion comes through the callbacks
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+// ==== SPI ====
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+} SPI_TypeDef;
+
+extern SPI_TypeDef HAL_SIM_SPIs[2];
+
+#define SPI1 (&HAL_SIM_SPIs[0])     // APB2
+#define SPI2 (&HAL_SIM_SPIs[1])     // APB1
+
+#define SPI_MODE_MASTER              0x00000104U
+#define SPI_DIRECTION_2LINES         0x00000000U
+#define SPI_DIRECTION_2LINES_RXONLY  0x00000400U
+#define SPI_DATASIZE_8BIT            0x00000000U
+#define SPI_POLARITY_LOW             0x00000000U
+#define SPI_POLARITY_HIGH            0x00000002U
+#define SPI_PHASE_1EDGE              0x00000000U
+#define SPI_PHASE_2EDGE              0x00000001U
+#define SPI_NSS_SOFT                 0x00000200U
+#define SPI_FIRSTBIT_MSB             0x00000000U
+#define SPI_FIRSTBIT_LSB             0x00000080U
+
+// SCK = PCLK / 2^(n + 1) for SPI_BAUDRATEPRESCALER_2 ... _256
+#define SPI_BAUDRATEPRESCALER_2      0x00000000U
+#define SPI_BAUDRATEPRESCALER_4      0x00000008U
+#define SPI_BAUDRATEPRESCALER_8      0x00000010U
+#define SPI_BAUDRATEPRESCALER_16     0x00000018U
+#define SPI_BAUDRATEPRESCALER_32     0x00000020U
+#define SPI_BAUDRATEPRESCALER_64     0x00000028U
+#define SPI_BAUDRATEPRESCALER_128    0x00000030U
+#define SPI_BAUDRATEPRESCALER_256    0x00000038U
+
+typedef enum {
+    HAL_SPI_STATE_RESET   = 0x00U,
+    HAL_SPI_STATE_READY   = 0x01U,
+    HAL_SPI_STATE_BUSY    = 0x02U,
+    HAL_SPI_STATE_BUSY_RX = 0x04U
+} HAL_SPI_StateTypeDef;
+
+typedef struct {
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+} SPI_InitTypeDef;
+
+typedef struct {
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_SPI_StateTypeDef State;
+    volatile uint32_t ErrorCode;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+// Returns at once, HAL_SPI_RxCpltCallback (state READY) when the last byte is in
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi);
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi);
+
+// ==== UART ====
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+extern USART_TypeDef HAL_SIM_USARTs[3];
+
+#define USART1 (&HAL_SIM_USARTs[0])
+#define USART2 (&HAL_SIM_USARTs[1])
+#define USART3 (&HAL_SIM_USARTs[2])
+
+#define HAL_UART_ERROR_NONE 0x00000000U
+
+typedef enum {
+    HAL_UART_STATE_RESET   = 0x00U,
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U
+} HAL_UART_StateTypeDef;
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+// Returns at once, HAL_UART_TxCpltCallback when the last byte is out
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_UART_StateTypeDef HAL_UART_GetState(UART_HandleTypeDef *huart);
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STM32F1xx_HAL_H
@@ -0,0 +1,181 @@
+/**
+ * @file HC165.c
+ * @brief Chained 74HC165 input shift registers read by SPI DMA, keys through the BUTTON driver.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Functions:
+ * - HC165_Init, HC165_Deinit: Chain on an SPI bus and its SH/LD pin.
+ * - HC165_Update: Debounces the last snapshot, starts the next one every HC165_SCAN_MS.
+ * - HC165_Attach: One BUTTON per input used, by bit index.
+ * - HC165_GetButton, HC165_BitIndex: Input <-> button.
+ * - HC165_Pressed: Debounced level of an input.
+ */
+
+
+
+#include "HC165.h"
+#include "GPIO_FAST.h"
+#include "TIMING.h"
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef HC165_Init(HC165_t* hc, SPI_HandleTypeDef* hspi, GPIO_TypeDef* ldPort, uint16_t ldPin,
+                             uint8_t chips, uint8_t ActiveState) {
+    if (hc == NULL || hspi == NULL || ldPort == NULL || !ldPin) return HAL_ERROR;
+    if (chips == 0 || chips > HC165_MAX_CHIPS) return HAL_ERROR;
+    if (HAL_SPI_GetState(hspi) != HAL_SPI_STATE_READY) return HAL_ERROR;
+
+    *hc = (HC165_t){ .hspi = hspi, .LdPort = ldPort, .LdPin = ldPin, .Chips = chips };
+    hc->Invert = ActiveState ? 0U : 0xFFFFFFFFU;
+
+    for (uint8_t w = 0; w < HC165_WORDS; w++) hc->Cnt[w] = BUTTON_COUNTER_INIT;
+
+    GPIO_FAST_WriteBSRR(ldPort, ldPin);     // SH/LD idle high: shift
+    hc->NextScan = HAL_GetTick();
+    return HAL_OK;
+}
+
+// A snapshot still in flight completes into hc->Rx: keep the HC165_t until then
+void HC165_Deinit(HC165_t* hc) {
+    if (hc == NULL) return;
+    for (uint16_t b = 0; b < HC165_MAX_INPUTS; b++) {
+        BUTTON_Deinit(hc->Btn[b]);
+        hc->Btn[b] = NULL;
+    }
+    for (uint8_t w = 0; w < HC165_WORDS; w++) hc->Used[w] = 0;
+    hc->Chips = 0;
+}
+
+// A Toggle / Hold button on input 'bit' (chip * 8 + input); NULL if taken or the pool is full
+Button_t* HC165_Attach(HC165_t* hc, uint16_t bit, ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t)) {
+    if (hc == NULL || bit >= hc->Chips * 8U || hc->Btn[bit] != NULL) return NULL;
+
+    Button_t* key = BUTTON_InitExternal(mode, Handler);
+    if (key == NULL) return NULL;
+    Set_DebounceTime(key, 0);   // done by the counters
+
+    uint8_t w = (uint8_t)(bit >> 5);
+    uint32_t mask = 1UL << (bit & 31U);
+    hc->State[w] &= ~mask;
+    BUTTON_CounterReset(&hc->Cnt[w], mask);
+    hc->Used[w] |= mask;
+    hc->Btn[bit] = key;
+    return key;
+}
+
+// ========== Snapshot ==========
+
+// 32 inputs per step; only the inputs that flipped reach BUTTON
+static void HC165_Debounce(HC165_t* hc) {
+    uint8_t words = (uint8_t)((hc->Chips + 3U) / 4U);
+
+    for (uint8_t w = 0; w < words; w++) {
+        uint32_t pressed = hc->Rx[w] ^ hc->Invert;      // chip k in byte k: little-endian
+        uint32_t delta = (pressed ^ hc->State[w]) & hc->Used[w];
+        if (!delta && hc->Cnt[w].Cnt0 == 0xFFFFFFFFU && hc->Cnt[w].Cnt1 == 0xFFFFFFFFU) continue;   // all stable
+
+        uint32_t toggle = BUTTON_CounterStep(&hc->Cnt[w], delta);
+        hc->State[w] ^= toggle;
+
+        for (; toggle; toggle &= toggle - 1U) {
+            uint16_t bit = (uint16_t)(w * 32U + __builtin_ctz(toggle));
+            BUTTON_SetLevel(hc->Btn[bit], (uint8_t)((hc->State[w] >> (bit & 31U)) & 1U));
+        }
+    }
+    hc->Snapshots++;
+}
+
+// Debounce the snapshot the DMA completed, then latch and start the next one when due
+void HC165_Update(HC165_t* hc) {
+    if (hc->Chips == 0) return;
+
+    if (hc->Busy) {
+        if (HAL_SPI_GetState(hc->hspi) != HAL_SPI_STATE_READY) return;
+        hc->Busy = 0;
+        HC165_Debounce(hc);
+    }
+
+    uint32_t now = HAL_GetTick();
+    if ((int32_t)(now - hc->NextScan) < 0) return;
+    hc->NextScan += HC165_SCAN_MS;
+    if ((int32_t)(now - hc->NextScan) >= 0) hc->NextScan = now + HC165_SCAN_MS;   // late: no burst of scans
+
+    // SH/LD pulse: all the inputs latched at once, then one DMA receive of the whole chain
+    GPIO_FAST_WriteBSRR(hc->LdPort, (uint32_t)hc->LdPin << 16);
+    TIMING_DelayNs(HC165_LD_PULSE_NS);
+    GPIO_FAST_WriteBSRR(hc->LdPort, hc->LdPin);
+    if (HAL_SPI_Receive_DMA(hc->hspi, (uint8_t*)hc->Rx, hc->Chips) == HAL_OK) hc->Busy = 1;
+    else hc->Errors++;
+}
+
+// Milliseconds until the next snapshot (for a scheduler), 0 while one is in flight
+uint32_t HC165_NextUpdate(const HC165_t* hc) {
+    if (hc->Busy) return 0;
+    int32_t wait = (int32_t)(hc->NextScan - HAL_GetTick());
+    return wait > 0 ? (uint32_t)wait : 0U;
+}
+
+// ========== Inputs ==========
+
+Button_t* HC165_GetButton(const HC165_t* hc, uint16_t bit) {
+    if (bit >= hc->Chips * 8U) return NULL;
+    return hc->Btn[bit];
+}
+
+// Bit index of an input button (for a handler shared by all inputs), -1 if not one
+int16_t HC165_BitIndex(const HC165_t* hc, const Button_t* btn) {
+    if (btn == NULL) return -1;
+    for (uint16_t b = 0; b < hc->Chips * 8U; b++) {
+        if (hc->Btn[b] == btn) return (int16_t)b;
+    }
+    return -1;
+}
+
+// Debounced level of an attached input (before the BUTTON classification), 0 otherwise
+uint8_t HC165_Pressed(const HC165_t* hc, uint16_t bit) {
+    if (bit >= hc->Chips * 8U) return 0;
+    return (uint8_t)((hc->State[bit >> 5] >> (bit & 31U)) & 1U);
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. CubeMX: SPI1 Receive Only Master, 8 bits, MSB first, CPOL low, CPHA 1 edge,
+#    prescaler 16 (4.5 MHz), DMA1 channel 2 on SPI1_RX (normal, byte), its interrupt on.
+#    PA4 as GPIO_Output (SH/LD), PA5 = SCK, PA6 = MISO. 8 chips = 64 inputs with pull-ups.
+#    Build with BUTTON_MAX >= number of inputs used (+ other buttons)
+
+static HC165_t panel;
+enum { IN_PLAY = 0, IN_STOP = 1, IN_VOL_UP = 8, IN_VOL_DOWN = 9 };
+
+void Panel_Handler(Button_t* btn, ButtonPressType_t type) {
+	switch (HC165_BitIndex(&panel, btn)) {
+		case IN_PLAY: if (type == BUTTON_PressType_OnPressed || type == BUTTON_PressType_Normal) Play(); break;
+		case IN_STOP: if (type == BUTTON_PressType_Long) PowerOff(); else Stop(); break;
+		case IN_VOL_UP: if (type == BUTTON_PressType_Repeat || type == BUTTON_PressType_RepeatOnce) VolumeUp(); break;
+		case IN_VOL_DOWN: if (type == BUTTON_PressType_Repeat || type == BUTTON_PressType_RepeatOnce) VolumeDown(); break;
+		default: break;
+	}
+}
+
+
+# 2. Init after MX_SPI1_Init: one button per input used, by bit (chip * 8 + input)
+
+	HC165_Init(&panel, &hspi1, GPIOA, GPIO_PIN_4, 8, 0);
+	HC165_Attach(&panel, IN_PLAY, BUTTON_Mode_Toggle, Panel_Handler);
+	HC165_Attach(&panel, IN_STOP, BUTTON_Mode_Toggle, Panel_Handler);
+	HC165_Attach(&panel, IN_VOL_UP, BUTTON_Mode_Hold, Panel_Handler);
+	HC165_Attach(&panel, IN_VOL_DOWN, BUTTON_Mode_Hold, Panel_Handler);
+
+
+# 3. Main loop: debounce the last snapshot / start the next, then the press timers
+
+while (1)
+{
+	HC165_Update(&panel);
+	BUTTON_Update();
+}
+
+*/
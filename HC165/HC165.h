@@ -0,0 +1,96 @@
+/**
+ * @file HC165.h
+ * @brief Chained 74HC165 input shift registers read by SPI DMA, keys through the BUTTON driver.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * A panel with more buttons than free GPIOs: up to HC165_MAX_CHIPS 74HC165 in a
+ * chain, 8 inputs each, cost one SPI (SCK + MISO) and one GPIO (SH/LD). Every
+ * HC165_SCAN_MS, HC165_Update pulses SH/LD to latch all the inputs at once and starts
+ * one SPI receive by DMA of one byte per chip into a bit array: the snapshot costs
+ * no CPU per bit. The next HC165_Update after the DMA has completed debounces the
+ * snapshot 32 inputs at a time with vertical counters (an input flips after 4
+ * snapshots in a row that disagree with it), and only the inputs that flipped are
+ * handed to BUTTON_SetLevel.
+ *
+ * Buttons are addressed by bit index: bit = chip * 8 + input (A = 0 ... H = 7), chip
+ * 0 being the one wired to MISO. Each is a regular Button_t made by HC165_Attach:
+ * Toggle / Hold classification, SetTime_*, handlers and ButtonPressType_t are those
+ * of the BUTTON driver.
+ *
+ * Wiring:
+ * - SPI master, receive only, CPOL low, CPHA first edge, MSB first, SCK up to a few
+ *   MHz (74HC165 at 3.3 V). QH of chip 0 to MISO, QH of chip k + 1 to SER of chip k,
+ *   SER of the last chip tied high. CLK INH tied low.
+ * - SH/LD on a GPIO output, idle high.
+ * - Inputs with pull-ups, button to GND: ActiveState 0 (as BUTTON_Init).
+ *
+ * Notes:
+ * - Every attached input takes a slot of the BUTTON pool: BUTTON_MAX must cover them.
+ * - The SPI handle is busy between HC165_Update calls while a snapshot is in flight;
+ *   its DMA interrupt must be enabled (HAL state back to READY), no callback is needed.
+ * - Handlers run from HC165_Update; the hold / double-click timers run from
+ *   BUTTON_Update, call both from the main loop.
+ */
+
+
+
+#ifndef __HC165_H
+#define __HC165_H
+
+#include "stm32f1xx_hal.h"
+#include "BUTTON.h"
+#include <stdint.h>
+
+// Chips in the chain, 8 inputs each
+#ifndef HC165_MAX_CHIPS
+#define HC165_MAX_CHIPS 8
+#endif
+
+// Snapshot period (debounce = 4 snapshots, 15-20 ms by default)
+#ifndef HC165_SCAN_MS
+#define HC165_SCAN_MS 5
+#endif
+
+// SH/LD low width: tw is 80 ns at 2 V, 16 ns at 4.5 V; two BSRR stores are 14-28 ns
+#ifndef HC165_LD_PULSE_NS
+#define HC165_LD_PULSE_NS 100
+#endif
+
+#define HC165_MAX_INPUTS (HC165_MAX_CHIPS * 8)
+#define HC165_WORDS ((HC165_MAX_CHIPS + 3) / 4)
+
+typedef struct {
+    SPI_HandleTypeDef* hspi;
+    GPIO_TypeDef* LdPort;
+    uint16_t LdPin;
+    uint8_t Chips;
+    uint8_t Busy;                           // snapshot in flight
+
+    uint32_t Rx[HC165_WORDS];               // DMA target: chip k in byte k, input H as bit 7
+    uint32_t Invert;                        // all ones when a pressed input reads low
+
+    // Vertical counters, one lane per input
+    uint32_t Used[HC165_WORDS];             // inputs with a button
+    uint32_t State[HC165_WORDS];            // debounced: inputs pressed
+    ButtonCounter_t Cnt[HC165_WORDS];
+
+    Button_t* Btn[HC165_MAX_INPUTS];
+    uint32_t NextScan;
+    uint32_t Snapshots;                     // snapshots debounced
+    uint32_t Errors;                        // snapshots that could not be started
+} HC165_t;
+
+HAL_StatusTypeDef HC165_Init(HC165_t* hc, SPI_HandleTypeDef* hspi, GPIO_TypeDef* ldPort, uint16_t ldPin,
+                             uint8_t chips, uint8_t ActiveState);
+void HC165_Deinit(HC165_t* hc);
+void HC165_Update(HC165_t* hc);
+uint32_t HC165_NextUpdate(const HC165_t* hc);
+
+Button_t* HC165_Attach(HC165_t* hc, uint16_t bit, ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t));
+Button_t* HC165_GetButton(const HC165_t* hc, uint16_t bit);
+int16_t HC165_BitIndex(const HC165_t* hc, const Button_t* btn);
+uint8_t HC165_Pressed(const HC165_t* hc, uint16_t bit);
+
+#endif // __HC165_H
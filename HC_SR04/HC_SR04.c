@@ -1,4 +1,17 @@
 #include "HC_SR04.h"
+#include "TIMING.h"
+#include "TRACE.h"
+#include "EVBUS.h"
+
+// Sound: 58 us of echo per cm, round trip
+#define HCSR04_US_PER_CM 58U
+
+// F1 timers run at 2 x PCLK when their APB prescaler is not 1 (TIM1 on APB2, the rest on APB1)
+static uint32_t TimerClockHz(const TIM_HandleTypeDef *htim)
+{
+    uint32_t pclk = (htim->Instance == TIM1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    return (pclk == HAL_RCC_GetHCLKFreq()) ? pclk : 2U * pclk;
+}
 
 void HCSR04_Init(HCSR04_t *sensor, TIM_HandleTypeDef *htim, uint32_t channel,
                  GPIO_TypeDef *TRIG_Port, uint16_t TRIG_Pin)
@@ -10,46 +23,72 @@ void HCSR04_Init(HCSR04_t *sensor, TIM_HandleTypeDef *htim, uint32_t channel,
     sensor->is_first_captured = 0;
     sensor->done = 0;
 
+    // Scale worked out once: reads are a multiply and a shift, no clock query
+    sensor->tick_hz = TimerClockHz(htim) / (htim->Init.Prescaler + 1U);
+    uint64_t den = (uint64_t)HCSR04_US_PER_CM * sensor->tick_hz;
+    sensor->mm_scale = (uint32_t)((10ULL * 1000000ULL * 65536ULL + den / 2U) / den);
+
     HAL_TIM_IC_Start_IT(sensor->htim, sensor->channel);
 }
 
 void HCSR04_Trigger(HCSR04_t *sensor)
 {
+    TRACE_EVENT(TRACE_ID_HCSR04_TRIGGER, 0);
     HAL_GPIO_WritePin(sensor->TRIG_Port, sensor->TRIG_Pin, GPIO_PIN_SET);
-    HAL_Delay(1); // Delay 1ms d? d?m b?o pin ?n d?nh
+    TIMING_DelayUs(HCSR04_TRIG_US); // TRIG high >= 10 us starts one burst
     HAL_GPIO_WritePin(sensor->TRIG_Port, sensor->TRIG_Pin, GPIO_PIN_RESET);
 }
 
+// Echo length in timer ticks, counter wrap included
+static uint32_t EchoTicks(const HCSR04_t *sensor)
+{
+    if (sensor->ic_falling >= sensor->ic_rising)
+        return sensor->ic_falling - sensor->ic_rising;
+    return sensor->htim->Init.Period + 1U - sensor->ic_rising + sensor->ic_falling;
+}
+
 void HCSR04_TIM_IC_CaptureCallback(HCSR04_t *sensor)
 {
     if (sensor->is_first_captured == 0)
     {
         sensor->ic_rising = HAL_TIM_ReadCapturedValue(sensor->htim, sensor->channel);
+        TRACE_EVENT(TRACE_ID_HCSR04_RISE, sensor->ic_rising);
         __HAL_TIM_SET_CAPTUREPOLARITY(sensor->htim, sensor->channel, TIM_INPUTCHANNELPOLARITY_FALLING);
         sensor->is_first_captured = 1;
     }
     else
     {
         sensor->ic_falling = HAL_TIM_ReadCapturedValue(sensor->htim, sensor->channel);
+        TRACE_EVENT(TRACE_ID_HCSR04_FALL, sensor->ic_falling);
         __HAL_TIM_SET_CAPTUREPOLARITY(sensor->htim, sensor->channel, TIM_INPUTCHANNELPOLARITY_RISING);
         sensor->is_first_captured = 0;
         sensor->done = 1;
+#if EVBUS_ENABLED
+        uint32_t ticks = EchoTicks(sensor);
+        EVBUS_PUBLISH(EVBUS_EV_HCSR04_ECHO, 0, (ticks > 0xFFFFU) ? 0xFFFFU : ticks, sensor);
+#endif
     }
 }
 
-float HCSR04_ReadDistance(HCSR04_t *sensor)
+int32_t HCSR04_ReadDistanceMm(HCSR04_t *sensor)
 {
     if (!sensor->done) return -1;
 
-    uint32_t diff;
-    if (sensor->ic_falling >= sensor->ic_rising)
-        diff = sensor->ic_falling - sensor->ic_rising;
-    else
-        diff = (0xFFFF - sensor->ic_rising + sensor->ic_falling);
+    uint32_t mm = (uint32_t)(((uint64_t)EchoTicks(sensor) * sensor->mm_scale + 0x8000U) >> 16);
+
+    sensor->done = 0;
+    return (int32_t)mm;
+}
+
+#if !HCSR04_NO_FLOAT
+float HCSR04_ReadDistance(HCSR04_t *sensor)
+{
+    if (!sensor->done) return -1;
 
-    float time_us = (diff * 1.0f) / (HAL_RCC_GetPCLK1Freq() / (sensor->htim->Init.Prescaler + 1)) * 1e6;
-    float distance_cm = time_us / 58.0f;
+    float time_us = (EchoTicks(sensor) * 1.0f) / sensor->tick_hz * 1e6f;
+    float distance_cm = time_us / (float)HCSR04_US_PER_CM;
 
     sensor->done = 0;
     return distance_cm;
 }
+#endif
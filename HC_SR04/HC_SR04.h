@@ -3,6 +3,17 @@
 
 #include "stm32f1xx_hal.h"  // Thay d?i theo chip b?n dng
 
+#define HCSR04_TRIG_US   10   // trigger pulse width (datasheet: at least 10 us)
+#define HCSR04_CYCLE_MS  60   // minimum measurement cycle, echo of the previous burst gone
+
+// 1 = no float API (HCSR04_ReadDistance), HCSR04_ReadDistanceMm only; follows HAL_LIB_NO_FLOAT
+#ifndef HAL_LIB_NO_FLOAT
+#define HAL_LIB_NO_FLOAT 0
+#endif
+#ifndef HCSR04_NO_FLOAT
+#define HCSR04_NO_FLOAT HAL_LIB_NO_FLOAT
+#endif
+
 typedef struct {
     TIM_HandleTypeDef *htim;
     uint32_t channel; // V d?: TIM_CHANNEL_1
@@ -13,6 +24,9 @@ typedef struct {
     uint32_t ic_falling;
     uint8_t is_first_captured;
     uint8_t done;
+
+    uint32_t tick_hz;  // capture timer rate, from the timer clock at init
+    uint32_t mm_scale; // Q16, echo ticks -> mm
 } HCSR04_t;
 
 void HCSR04_Init(HCSR04_t *sensor, TIM_HandleTypeDef *htim, uint32_t channel,
@@ -20,6 +34,9 @@ void HCSR04_Init(HCSR04_t *sensor, TIM_HandleTypeDef *htim, uint32_t channel,
 
 void HCSR04_Trigger(HCSR04_t *sensor);
 void HCSR04_TIM_IC_CaptureCallback(HCSR04_t *sensor);
+int32_t HCSR04_ReadDistanceMm(HCSR04_t *sensor); // mm, -1 = no new echo
+#if !HCSR04_NO_FLOAT
 float HCSR04_ReadDistance(HCSR04_t *sensor); // don v?: cm
+#endif
 
 #endif
@@ -0,0 +1,575 @@
+/**
+ * @file I2C_BUS.c
+ * @brief Shared I2C bus manager: prioritised transaction queue on top of the HAL IT/DMA calls.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "I2C_BUS.h"
+#include "TIMING.h"
+#include "TRACE.h"
+#include "EVBUS.h"
+
+// Buses in use, looked up from the HAL callbacks
+static I2C_BUS_HandleTypeDef* buses[I2C_BUS_MAX];
+
+// Pins clocked by I2C_BUS_Recover (F103 default mapping)
+typedef struct {
+    I2C_TypeDef* Instance;
+    GPIO_TypeDef* Port;
+    uint16_t Scl;
+    uint16_t Sda;
+} RecoveryPins;
+
+static RecoveryPins recoveryPins[I2C_BUS_MAX] = {
+    { I2C1, GPIOB, GPIO_PIN_6, GPIO_PIN_7 },
+    { I2C2, GPIOB, GPIO_PIN_10, GPIO_PIN_11 },
+};
+
+// Per-device counters; devices past the table share the last slot
+static I2C_BUS_DevStats devStats[I2C_BUS_MAX_DEVICES + 1];
+
+static I2C_BUS_HandleTypeDef* FindBus(I2C_HandleTypeDef* hi2c) {
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+        if (buses[i] && buses[i]->hi2c == hi2c) return buses[i];
+    }
+    return NULL;
+}
+
+static I2C_BUS_DevStats* DevStats(const I2C_HandleTypeDef* hi2c, uint16_t devAddress, uint8_t add) {
+    devAddress &= 0xFEU;
+    for (uint8_t i = 0; i < I2C_BUS_MAX_DEVICES; i++) {
+        I2C_BUS_DevStats* s = &devStats[i];
+        if (s->Instance == hi2c->Instance && s->DevAddress == devAddress) return s;
+        if (s->Instance == NULL) {
+            if (!add) return NULL;
+            s->Instance = hi2c->Instance;
+            s->DevAddress = devAddress;
+            return s;
+        }
+    }
+    return add ? &devStats[I2C_BUS_MAX_DEVICES] : NULL;
+}
+
+// Close one operation in the counters of its device ('start' = TIMING stamp)
+static void CountDone(I2C_BUS_DevStats* s, HAL_StatusTypeDef status, uint32_t start) {
+    uint32_t us = TIMING_TicksToNs(TIMING_Elapsed(start)) / 1000U;
+    if (status == HAL_OK) s->Transfers++;
+    else s->Failures++;
+    if (us > s->MaxUs) s->MaxUs = us;
+}
+
+// ========== Time budgets ==========
+
+// Wire time of one step (START, address, memory address, data, STOP) x2 + slack
+uint32_t I2C_BUS_BudgetMs(const I2C_HandleTypeDef* hi2c, const I2C_BUS_Transaction* txn) {
+    uint32_t speed = hi2c->Init.ClockSpeed ? hi2c->Init.ClockSpeed : 100000U;
+    uint32_t bytes = 1U + txn->Size;
+    if (txn->Op == I2C_BUS_OP_MEM_WRITE || txn->Op == I2C_BUS_OP_MEM_READ) {
+        bytes += (txn->MemAddSize == I2C_MEMADD_SIZE_16BIT) ? 2U : 1U;
+    }
+    if (txn->Op == I2C_BUS_OP_MEM_READ) bytes++;    // repeated START + address
+    uint32_t us = (uint32_t)(((uint64_t)bytes * 9U + 3U) * 1000000U / speed);
+    return (2U * us + 999U) / 1000U + I2C_BUS_TIMEOUT_SLACK_MS;
+}
+
+// Whole chain, every retry with its recovery, and one wait on a bus held busy
+static uint32_t ChainMs(const I2C_HandleTypeDef* hi2c, uint8_t retries, const I2C_BUS_Transaction* txn) {
+    uint32_t ms = I2C_BUS_RECOVERY_MS;
+    for (const I2C_BUS_Transaction* t = txn; t; t = t->Next) ms += I2C_BUS_BudgetMs(hi2c, t);
+    return I2C_BUS_BUSY_FLAG_MS + (retries + 1U) * ms;
+}
+
+// Longest a transaction submitted now can take: everything already queued, then itself
+uint32_t I2C_BUS_WorstCaseMs(const I2C_BUS_HandleTypeDef* bus, const I2C_BUS_Transaction* txn) {
+    return bus->PendingMs + ChainMs(bus->hi2c, bus->Retries, txn);
+}
+
+// ========== Queue ==========
+
+static void Push(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn) {
+    uint8_t p = (txn->Priority < I2C_BUS_PRIO_COUNT) ? txn->Priority : I2C_BUS_PRIO_LOW;
+    txn->QueueNext = NULL;
+    if (bus->Tail[p]) bus->Tail[p]->QueueNext = txn;
+    else bus->Head[p] = txn;
+    bus->Tail[p] = txn;
+
+    bus->Queued++;
+    if (bus->Queued > bus->MaxQueued) bus->MaxQueued = bus->Queued;
+}
+
+static I2C_BUS_Transaction* Pop(I2C_BUS_HandleTypeDef* bus) {
+    for (uint8_t p = 0; p < I2C_BUS_PRIO_COUNT; p++) {
+        I2C_BUS_Transaction* txn = bus->Head[p];
+        if (txn) {
+            bus->Head[p] = txn->QueueNext;
+            if (bus->Head[p] == NULL) bus->Tail[p] = NULL;
+            bus->Queued--;
+            return txn;
+        }
+    }
+    return NULL;
+}
+
+static uint8_t Unlink(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn) {
+    for (uint8_t p = 0; p < I2C_BUS_PRIO_COUNT; p++) {
+        I2C_BUS_Transaction* prev = NULL;
+        for (I2C_BUS_Transaction* t = bus->Head[p]; t; prev = t, t = t->QueueNext) {
+            if (t != txn) continue;
+            if (prev) prev->QueueNext = t->QueueNext;
+            else bus->Head[p] = t->QueueNext;
+            if (bus->Tail[p] == t) bus->Tail[p] = prev;
+            bus->Queued--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ========== Transfers ==========
+
+static HAL_StatusTypeDef StartStep(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* t) {
+    I2C_HandleTypeDef* hi2c = bus->hi2c;
+    uint8_t rx = (t->Op == I2C_BUS_OP_RECEIVE || t->Op == I2C_BUS_OP_MEM_READ);
+    uint8_t dma = bus->DmaMinSize && t->Size >= bus->DmaMinSize &&
+                  (rx ? hi2c->hdmarx : hi2c->hdmatx) != NULL;
+
+    bus->Step = t;
+    bus->Deadline = HAL_GetTick() + I2C_BUS_BudgetMs(hi2c, t);
+    TRACE_EVENT(TRACE_ID_I2C_BUS_START, ((t->DevAddress & 0xFFU) << 8) | t->Op);
+    switch (t->Op) {
+        case I2C_BUS_OP_TRANSMIT:
+            return dma ? HAL_I2C_Master_Transmit_DMA(hi2c, t->DevAddress, t->Data, t->Size)
+                       : HAL_I2C_Master_Transmit_IT(hi2c, t->DevAddress, t->Data, t->Size);
+        case I2C_BUS_OP_RECEIVE:
+            return dma ? HAL_I2C_Master_Receive_DMA(hi2c, t->DevAddress, t->Data, t->Size)
+                       : HAL_I2C_Master_Receive_IT(hi2c, t->DevAddress, t->Data, t->Size);
+        case I2C_BUS_OP_MEM_WRITE:
+            return dma ? HAL_I2C_Mem_Write_DMA(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size)
+                       : HAL_I2C_Mem_Write_IT(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size);
+        case I2C_BUS_OP_MEM_READ:
+            return dma ? HAL_I2C_Mem_Read_DMA(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size)
+                       : HAL_I2C_Mem_Read_IT(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size);
+        default:
+            return HAL_ERROR;
+    }
+}
+
+static void Finish(I2C_BUS_HandleTypeDef* bus, HAL_StatusTypeDef status);
+
+// A step could not start. A slave holding SDA low (the HAL gave up waiting for BUSY
+// to clear) is left to I2C_BUS_Poll to recover; anything else (peripheral busy from
+// outside, missing DMA...) ends the chain
+static void StartFailed(I2C_BUS_HandleTypeDef* bus, HAL_StatusTypeDef status) {
+    bus->Active->ErrorCode = HAL_I2C_GetError(bus->hi2c);
+    if (status == HAL_BUSY && (bus->Active->ErrorCode & HAL_I2C_ERROR_TIMEOUT)) bus->Stuck = 1;
+    else Finish(bus, HAL_ERROR);
+}
+
+// Run the active chain again from its first step
+static void Retry(I2C_BUS_HandleTypeDef* bus) {
+    I2C_BUS_Transaction* head = bus->Active;
+    head->Tries++;
+    DevStats(bus->hi2c, head->DevAddress, 1)->Retries++;
+    HAL_StatusTypeDef status = StartStep(bus, head);
+    if (status != HAL_OK) StartFailed(bus, status);
+}
+
+// Start the highest waiting chain if the bus is free (interrupts masked by the caller)
+static void Kick(I2C_BUS_HandleTypeDef* bus) {
+    while (bus->Active == NULL) {
+        I2C_BUS_Transaction* txn = Pop(bus);
+        if (txn == NULL) return;
+
+        bus->Active = txn;
+        txn->State = I2C_BUS_TXN_ACTIVE;
+        txn->Started = TIMING_Now();
+        txn->Tries = 0;
+        HAL_StatusTypeDef status = StartStep(bus, txn);
+        if (status != HAL_OK) StartFailed(bus, status);
+    }
+}
+
+// End the active chain, start the next one, then report
+static void Finish(I2C_BUS_HandleTypeDef* bus, HAL_StatusTypeDef status) {
+    I2C_BUS_Transaction* head = bus->Active;
+
+    bus->Active = NULL;
+    bus->Step = NULL;
+    bus->Stuck = 0;
+    bus->PendingMs -= head->BudgetMs;
+    if (status == HAL_OK) bus->Completed++;
+    else bus->Failed++;
+    CountDone(DevStats(bus->hi2c, head->DevAddress, 1), status, head->Started);
+
+    head->Status = status;
+    head->State = (status == HAL_OK) ? I2C_BUS_TXN_DONE : I2C_BUS_TXN_ERROR;
+    TRACE_EVENT(TRACE_ID_I2C_BUS_DONE, ((uint32_t)status << 8) | (head->ErrorCode & 0xFFU));
+    EVBUS_PUBLISH(EVBUS_EV_I2C_DONE, status, head->DevAddress, head);
+
+    // Keep the bus busy while the callback runs
+    Kick(bus);
+    if (head->Callback) head->Callback(head, status);
+}
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef I2C_BUS_Init(I2C_BUS_HandleTypeDef* bus, I2C_HandleTypeDef* hi2c, uint16_t dmaMinSize) {
+    if (bus == NULL || hi2c == NULL) return HAL_ERROR;
+
+    *bus = (I2C_BUS_HandleTypeDef){0};
+    bus->hi2c = hi2c;
+    bus->DmaMinSize = dmaMinSize;
+    bus->Retries = I2C_BUS_RETRIES;
+
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+        if (buses[i] == NULL || buses[i]->hi2c == hi2c) {
+            buses[i] = bus;
+            return HAL_OK;
+        }
+    }
+    return HAL_ERROR;
+}
+
+void I2C_BUS_DeInit(I2C_BUS_HandleTypeDef* bus) {
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+        if (buses[i] == bus) buses[i] = NULL;
+    }
+}
+
+// ========== Transaction builders ==========
+
+static void Build(I2C_BUS_Transaction* txn, I2C_BUS_Op op, uint16_t devAddress, uint16_t memAddress,
+                  uint8_t* data, uint16_t size, I2C_BUS_Priority prio) {
+    *txn = (I2C_BUS_Transaction){0};
+    txn->Op = op;
+    txn->DevAddress = devAddress;
+    txn->MemAddress = memAddress;
+    txn->MemAddSize = I2C_MEMADD_SIZE_8BIT;
+    txn->Data = data;
+    txn->Size = size;
+    txn->Priority = prio;
+}
+
+void I2C_BUS_MemRead(I2C_BUS_Transaction* txn, uint16_t devAddress, uint16_t memAddress,
+                     uint8_t* data, uint16_t size, I2C_BUS_Priority prio) {
+    Build(txn, I2C_BUS_OP_MEM_READ, devAddress, memAddress, data, size, prio);
+}
+
+void I2C_BUS_MemWrite(I2C_BUS_Transaction* txn, uint16_t devAddress, uint16_t memAddress,
+                      uint8_t* data, uint16_t size, I2C_BUS_Priority prio) {
+    Build(txn, I2C_BUS_OP_MEM_WRITE, devAddress, memAddress, data, size, prio);
+}
+
+void I2C_BUS_Transmit(I2C_BUS_Transaction* txn, uint16_t devAddress,
+                      uint8_t* data, uint16_t size, I2C_BUS_Priority prio) {
+    Build(txn, I2C_BUS_OP_TRANSMIT, devAddress, 0, data, size, prio);
+}
+
+void I2C_BUS_Receive(I2C_BUS_Transaction* txn, uint16_t devAddress,
+                     uint8_t* data, uint16_t size, I2C_BUS_Priority prio) {
+    Build(txn, I2C_BUS_OP_RECEIVE, devAddress, 0, data, size, prio);
+}
+
+// ========== Submit ==========
+
+HAL_StatusTypeDef I2C_BUS_Submit(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn,
+                                 I2C_BUS_Callback callback, void* ctx) {
+    if (bus == NULL || txn == NULL) return HAL_ERROR;
+    if (txn->State == I2C_BUS_TXN_QUEUED || txn->State == I2C_BUS_TXN_ACTIVE) return HAL_BUSY;
+
+    txn->Callback = callback;
+    txn->Ctx = ctx;
+    txn->Status = HAL_OK;
+    txn->ErrorCode = HAL_I2C_ERROR_NONE;
+    txn->State = I2C_BUS_TXN_QUEUED;
+    txn->BudgetMs = ChainMs(bus->hi2c, bus->Retries, txn);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bus->PendingMs += txn->BudgetMs;
+    Push(bus, txn);
+    Kick(bus);
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+// Read step done: merge the new bits into the value the write step sends
+static HAL_StatusTypeDef RegUpdateModify(I2C_BUS_Transaction* txn) {
+    I2C_BUS_RegUpdate* upd = (I2C_BUS_RegUpdate*)txn;   // Read is the first member
+    upd->Value = (uint8_t)((upd->Value & ~upd->Mask) | (upd->Bits & upd->Mask));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I2C_BUS_UpdateReg(I2C_BUS_HandleTypeDef* bus, I2C_BUS_RegUpdate* upd,
+                                    uint16_t devAddress, uint8_t reg, uint8_t mask, uint8_t bits,
+                                    I2C_BUS_Priority prio, I2C_BUS_Callback callback, void* ctx) {
+    if (upd->Read.State == I2C_BUS_TXN_QUEUED || upd->Read.State == I2C_BUS_TXN_ACTIVE) return HAL_BUSY;
+
+    upd->Mask = mask;
+    upd->Bits = bits;
+    I2C_BUS_MemRead(&upd->Read, devAddress, reg, &upd->Value, 1, prio);
+    I2C_BUS_MemWrite(&upd->Write, devAddress, reg, &upd->Value, 1, prio);
+    upd->Read.Next = &upd->Write;
+    upd->Read.Modify = RegUpdateModify;
+
+    return I2C_BUS_Submit(bus, &upd->Read, callback, ctx);
+}
+
+// ========== Completion ==========
+
+uint8_t I2C_BUS_IsDone(const I2C_BUS_Transaction* txn) {
+    return txn->State == I2C_BUS_TXN_DONE || txn->State == I2C_BUS_TXN_ERROR;
+}
+
+uint8_t I2C_BUS_IsIdle(const I2C_BUS_HandleTypeDef* bus) {
+    return bus->Active == NULL && bus->Queued == 0;
+}
+
+// Waiting is also what notices a step past its budget on any bus
+HAL_StatusTypeDef I2C_BUS_Wait(const I2C_BUS_Transaction* txn, uint32_t timeoutMs) {
+    uint32_t start = HAL_GetTick();
+    while (!I2C_BUS_IsDone(txn)) {
+        for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+            if (buses[i]) I2C_BUS_Poll(buses[i]);
+        }
+        uint32_t elapsed = HAL_GetTick() - start;
+        if (timeoutMs != HAL_MAX_DELAY && elapsed >= timeoutMs) return HAL_TIMEOUT;
+    }
+    return txn->Status;
+}
+
+// Blocking transfer that waits its turn in the queue instead of colliding with it
+HAL_StatusTypeDef I2C_BUS_Transfer(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn, uint32_t timeoutMs) {
+    TRACE_ENTER(TRACE_ID_I2C_BUS_TRANSFER, txn->DevAddress);
+    HAL_StatusTypeDef status = I2C_BUS_Submit(bus, txn, txn->Callback, txn->Ctx);
+    if (status == HAL_OK) status = I2C_BUS_Wait(txn, timeoutMs);
+    // Never return with the (often stack allocated) transaction still in the queue
+    if (status == HAL_TIMEOUT && !I2C_BUS_IsDone(txn)) I2C_BUS_Cancel(bus, txn);
+    TRACE_EXIT(TRACE_ID_I2C_BUS_TRANSFER, status);
+    return status;
+}
+
+// Take a transaction back: dequeued, or its transfer dropped if on the wire.
+// The callback is not called; State ERROR, Status HAL_TIMEOUT.
+HAL_StatusTypeDef I2C_BUS_Cancel(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn) {
+    HAL_StatusTypeDef status = HAL_OK;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (bus->Active == txn) {
+        HAL_I2C_DeInit(bus->hi2c);
+        HAL_I2C_Init(bus->hi2c);
+        bus->Active = NULL;
+        bus->Step = NULL;
+        bus->Stuck = 0;
+        bus->Failed++;
+    } else if (txn->State != I2C_BUS_TXN_QUEUED || !Unlink(bus, txn)) {
+        status = HAL_ERROR;
+    }
+    if (status == HAL_OK) {
+        bus->PendingMs -= txn->BudgetMs;
+        txn->Status = HAL_TIMEOUT;
+        txn->State = I2C_BUS_TXN_ERROR;
+        Kick(bus);
+    }
+    __set_PRIMASK(primask);
+    return status;
+}
+
+// ========== Timeouts and recovery ==========
+
+// Main-context watchdog of the step on the wire. Past its budget (or unable to
+// start on a bus held low): drop it, recover the bus, retry or fail the chain.
+void I2C_BUS_Poll(I2C_BUS_HandleTypeDef* bus) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    I2C_BUS_Transaction* head = bus->Active;
+    if (head == NULL || (!bus->Stuck && (int32_t)(HAL_GetTick() - bus->Deadline) < 0)) {
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    I2C_BUS_DevStats* stats = DevStats(bus->hi2c, head->DevAddress, 1);
+    if (!bus->Stuck) head->ErrorCode |= HAL_I2C_ERROR_TIMEOUT;
+    if (head->ErrorCode & HAL_I2C_ERROR_TIMEOUT) {
+        bus->Timeouts++;
+        stats->Timeouts++;
+    }
+    bus->Stuck = 0;
+    HAL_I2C_DeInit(bus->hi2c);      // drops the transfer without a callback
+    __set_PRIMASK(primask);
+
+    // Clocking takes ~100 us: done with interrupts on, the chain is still Active
+    HAL_StatusTypeDef recovered = I2C_BUS_Recover(bus->hi2c);
+    bus->Recoveries++;
+    stats->Recoveries++;
+
+    __disable_irq();
+    if (recovered == HAL_OK && head->Tries < bus->Retries) Retry(bus);
+    else Finish(bus, (head->ErrorCode & HAL_I2C_ERROR_TIMEOUT) ? HAL_TIMEOUT : HAL_ERROR);
+    __set_PRIMASK(primask);
+}
+
+// Free a bus a slave holds low (reset in the middle of a read): up to 9 SCL pulses
+// until it releases SDA, a STOP, then the peripheral re-initialised.
+HAL_StatusTypeDef I2C_BUS_Recover(I2C_HandleTypeDef* hi2c) {
+    const RecoveryPins* p = NULL;
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+        if (recoveryPins[i].Instance == hi2c->Instance) p = &recoveryPins[i];
+    }
+    if (p == NULL) return HAL_ERROR;
+
+    HAL_I2C_DeInit(hi2c);
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_WritePin(p->Port, p->Scl | p->Sda, GPIO_PIN_SET);
+    gpio.Pin = p->Scl;
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    HAL_GPIO_Init(p->Port, &gpio);
+    gpio.Pin = p->Sda;
+    gpio.Mode = GPIO_MODE_INPUT;
+    HAL_GPIO_Init(p->Port, &gpio);
+
+    // Each pulse lets the slave shift out one more bit; it sees a NACK and lets go
+    uint8_t pulses = 0;
+    while (pulses < 9 && HAL_GPIO_ReadPin(p->Port, p->Sda) == GPIO_PIN_RESET) {
+        HAL_GPIO_WritePin(p->Port, p->Scl, GPIO_PIN_RESET);
+        TIMING_DelayUs(I2C_BUS_RECOVERY_HALF_US);
+        HAL_GPIO_WritePin(p->Port, p->Scl, GPIO_PIN_SET);
+        TIMING_DelayUs(I2C_BUS_RECOVERY_HALF_US);
+        pulses++;
+    }
+    uint8_t released = HAL_GPIO_ReadPin(p->Port, p->Sda) == GPIO_PIN_SET;
+
+    // STOP: SDA low -> high while SCL is high
+    if (released) {
+        HAL_GPIO_WritePin(p->Port, p->Scl, GPIO_PIN_RESET);
+        HAL_GPIO_WritePin(p->Port, p->Sda, GPIO_PIN_RESET);
+        gpio.Mode = GPIO_MODE_OUTPUT_OD;
+        HAL_GPIO_Init(p->Port, &gpio);
+        TIMING_DelayUs(I2C_BUS_RECOVERY_HALF_US);
+        HAL_GPIO_WritePin(p->Port, p->Scl, GPIO_PIN_SET);
+        TIMING_DelayUs(I2C_BUS_RECOVERY_HALF_US);
+        HAL_GPIO_WritePin(p->Port, p->Sda, GPIO_PIN_SET);
+        TIMING_DelayUs(I2C_BUS_RECOVERY_HALF_US);
+    }
+    TRACE_EVENT(TRACE_ID_I2C_BUS_RECOVER, ((uint32_t)pulses << 8) | released);
+
+    // MspInit puts the pins back on the peripheral
+    HAL_I2C_Init(hi2c);
+    return released ? HAL_OK : HAL_ERROR;
+}
+
+void I2C_BUS_SetRecoveryPins(I2C_TypeDef* instance, GPIO_TypeDef* port, uint16_t scl, uint16_t sda) {
+    for (uint8_t i = 0; i < I2C_BUS_MAX; i++) {
+        if (recoveryPins[i].Instance == instance) recoveryPins[i] = (RecoveryPins){ instance, port, scl, sda };
+    }
+}
+
+// ========== Bounded blocking transfer ==========
+
+static HAL_StatusTypeDef Blocking(I2C_HandleTypeDef* hi2c, I2C_BUS_Transaction* t, uint32_t timeoutMs) {
+    switch (t->Op) {
+        case I2C_BUS_OP_TRANSMIT:
+            return HAL_I2C_Master_Transmit(hi2c, t->DevAddress, t->Data, t->Size, timeoutMs);
+        case I2C_BUS_OP_RECEIVE:
+            return HAL_I2C_Master_Receive(hi2c, t->DevAddress, t->Data, t->Size, timeoutMs);
+        case I2C_BUS_OP_MEM_WRITE:
+            return HAL_I2C_Mem_Write(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size, timeoutMs);
+        case I2C_BUS_OP_MEM_READ:
+            return HAL_I2C_Mem_Read(hi2c, t->DevAddress, t->MemAddress, t->MemAddSize, t->Data, t->Size, timeoutMs);
+        default:
+            return HAL_ERROR;
+    }
+}
+
+// Driver entry point for a blocking transfer. With a bus manager: through the queue,
+// waiting at most I2C_BUS_WorstCaseMs. Without: direct HAL calls with the step
+// budget as timeout, recovery after anything but a NACK, I2C_BUS_RETRIES retries.
+HAL_StatusTypeDef I2C_BUS_Exec(I2C_BUS_HandleTypeDef* bus, I2C_HandleTypeDef* hi2c, I2C_BUS_Transaction* txn) {
+    if (bus) return I2C_BUS_Transfer(bus, txn, I2C_BUS_WorstCaseMs(bus, txn));
+
+    I2C_BUS_DevStats* stats = DevStats(hi2c, txn->DevAddress, 1);
+    uint32_t start = TIMING_Now();
+    HAL_StatusTypeDef status;
+    txn->ErrorCode = HAL_I2C_ERROR_NONE;
+    for (uint8_t tries = 0;; tries++) {
+        status = HAL_OK;
+        for (I2C_BUS_Transaction* t = txn; t && status == HAL_OK; t = t->Next) {
+            status = Blocking(hi2c, t, I2C_BUS_BudgetMs(hi2c, t));
+            if (status == HAL_OK && t->Modify) status = t->Modify(t);
+        }
+        if (status == HAL_OK) break;
+
+        txn->ErrorCode = HAL_I2C_GetError(hi2c);
+        if (status == HAL_BUSY && !(txn->ErrorCode & HAL_I2C_ERROR_TIMEOUT)) break;  // handle in use
+        if (txn->ErrorCode & HAL_I2C_ERROR_TIMEOUT) stats->Timeouts++;
+        if (txn->ErrorCode != HAL_I2C_ERROR_AF) {
+            stats->Recoveries++;
+            if (I2C_BUS_Recover(hi2c) != HAL_OK) break;
+        }
+        if (tries >= I2C_BUS_RETRIES) break;
+        stats->Retries++;
+    }
+    if (status != HAL_OK && (txn->ErrorCode & HAL_I2C_ERROR_TIMEOUT)) status = HAL_TIMEOUT;
+    CountDone(stats, status, start);
+
+    txn->Status = status;
+    txn->State = (status == HAL_OK) ? I2C_BUS_TXN_DONE : I2C_BUS_TXN_ERROR;
+    return status;
+}
+
+// ========== Statistics ==========
+
+I2C_BUS_DevStats* I2C_BUS_GetDevStats(const I2C_HandleTypeDef* hi2c, uint16_t devAddress) {
+    return DevStats(hi2c, devAddress, 0);
+}
+
+void I2C_BUS_ResetDevStats(void) {
+    for (uint8_t i = 0; i <= I2C_BUS_MAX_DEVICES; i++) devStats[i] = (I2C_BUS_DevStats){0};
+}
+
+// Step finished on the wire: run the chain forward or close it
+void I2C_BUS_CompleteCallback(I2C_HandleTypeDef* hi2c) {
+    I2C_BUS_HandleTypeDef* bus = FindBus(hi2c);
+    if (bus == NULL || bus->Active == NULL) return;
+
+    I2C_BUS_Transaction* step = bus->Step;
+    if (step->Modify && step->Modify(step) != HAL_OK) {
+        Finish(bus, HAL_ERROR);
+        return;
+    }
+    if (step->Next) {
+        HAL_StatusTypeDef status = StartStep(bus, step->Next);
+        if (status != HAL_OK) StartFailed(bus, status);
+        return;
+    }
+    Finish(bus, HAL_OK);
+}
+
+void I2C_BUS_ErrorCallback(I2C_HandleTypeDef* hi2c) {
+    I2C_BUS_HandleTypeDef* bus = FindBus(hi2c);
+    if (bus == NULL || bus->Active == NULL) return;
+
+    I2C_BUS_Transaction* head = bus->Active;
+    head->ErrorCode = HAL_I2C_GetError(hi2c);
+    if (head->Tries >= bus->Retries) {
+        Finish(bus, HAL_ERROR);
+    } else if (head->ErrorCode & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO)) {
+        bus->Stuck = 1;     // bus state unknown: recover first (I2C_BUS_Poll)
+    } else {
+        Retry(bus);         // NACK: the device may just be busy, try again now
+    }
+}
+
+#if I2C_BUS_HAL_CALLBACKS
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c) { I2C_BUS_CompleteCallback(hi2c); }
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c) { I2C_BUS_CompleteCallback(hi2c); }
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c)    { I2C_BUS_CompleteCallback(hi2c); }
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c)    { I2C_BUS_CompleteCallback(hi2c); }
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c)        { I2C_BUS_ErrorCallback(hi2c); }
+#endif
@@ -0,0 +1,215 @@
+/**
+ * @file I2C_BUS.h
+ * @brief Shared I2C bus manager: prioritised transaction queue on top of the HAL IT/DMA calls.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Several drivers (RTC, LCD over PCF8574...) share one I2C peripheral. Calling the
+ * blocking HAL functions with HAL_MAX_DELAY from each of them means a long LCD
+ * refresh holds the main loop and every other device until it is done.
+ *
+ * The bus manager owns the I2C_HandleTypeDef and serves transactions one by one:
+ * - Drivers submit transactions and return at once; completion is reported through
+ *   a callback (interrupt context) or polled with I2C_BUS_IsDone.
+ * - Three priorities, FIFO inside a priority. A running transfer is never preempted,
+ *   the highest waiting transaction starts as soon as the bus is free.
+ * - Transactions can be chained (Next): the steps run back to back without letting
+ *   another transaction in between, with an optional Modify hook between steps.
+ *   I2C_BUS_UpdateReg builds the usual register read-modify-write from it.
+ * - Transfers of at least DmaMinSize bytes use DMA when the handle has DMA channels
+ *   linked, the others use the interrupt mode.
+ * - Bounded time: each step gets a budget from its size and the bus speed
+ *   (I2C_BUS_BudgetMs). A step past its budget, or one that cannot start because
+ *   a slave holds SDA low, is aborted by I2C_BUS_Poll: the bus is recovered (SCL
+ *   clocked until the slave lets SDA go, STOP, peripheral re-initialised) and the
+ *   chain is retried up to Retries times. NACKs and bus errors are retried at once.
+ *   I2C_BUS_WorstCaseMs bounds the wait for a transaction behind the whole queue.
+ * - I2C_BUS_Exec gives drivers the same bounded blocking transfer with or without
+ *   a bus manager (direct HAL calls with the budget as timeout, retries, recovery).
+ * - Timeouts, retries, recoveries and the longest operation are counted per device
+ *   (I2C peripheral + address), see I2C_BUS_GetDevStats.
+ *
+ * Notes:
+ * - No dynamic memory: transactions are owned by the caller and must stay valid
+ *   until they completed (State DONE or ERROR).
+ * - The bus manager implements the HAL I2C completion callbacks. If the application
+ *   needs them for another I2C peripheral, build with I2C_BUS_HAL_CALLBACKS=0 and
+ *   call I2C_BUS_CompleteCallback / I2C_BUS_ErrorCallback from its own.
+ * - Blocking HAL calls on the same handle return HAL_BUSY while a queued transfer
+ *   runs; use I2C_BUS_Transfer to make a blocking call through the queue.
+ * - I2C_BUS_Wait polls the deadlines itself. Applications with async transfers call
+ *   I2C_BUS_Poll from the main loop (a scheduler task) so a hung step is noticed.
+ * - Recovery pins default to the F103 mapping (I2C1 PB6/PB7, I2C2 PB10/PB11); set
+ *   others with I2C_BUS_SetRecoveryPins (remap).
+ */
+
+
+
+#ifndef __I2C_BUS_H
+#define __I2C_BUS_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+// 1 = this module defines HAL_I2C_*CpltCallback / HAL_I2C_ErrorCallback
+#ifndef I2C_BUS_HAL_CALLBACKS
+#define I2C_BUS_HAL_CALLBACKS 1
+#endif
+
+#define I2C_BUS_MAX 2   // I2C peripherals that can be managed at the same time
+
+// Attempts after the first one failed (NACK, bus error, timeout)
+#ifndef I2C_BUS_RETRIES
+#define I2C_BUS_RETRIES 2
+#endif
+
+#define I2C_BUS_MAX_DEVICES      8    // devices with their own statistics
+#define I2C_BUS_TIMEOUT_SLACK_MS 2    // added to each budget: 1 ms tick resolution + interrupt latency
+#define I2C_BUS_BUSY_FLAG_MS     25   // HAL wait on the BUSY flag (I2C_TIMEOUT_BUSY_FLAG) before HAL_BUSY
+#define I2C_BUS_RECOVERY_MS      1    // 9 SCL pulses + STOP + re-init, rounded up
+#define I2C_BUS_RECOVERY_HALF_US 5    // SCL half period while clocking a slave free (100 kHz)
+
+typedef enum {
+    I2C_BUS_PRIO_HIGH = 0,
+    I2C_BUS_PRIO_NORMAL,
+    I2C_BUS_PRIO_LOW,
+    I2C_BUS_PRIO_COUNT
+} I2C_BUS_Priority;
+
+typedef enum {
+    I2C_BUS_OP_TRANSMIT,     // HAL_I2C_Master_Transmit
+    I2C_BUS_OP_RECEIVE,      // HAL_I2C_Master_Receive
+    I2C_BUS_OP_MEM_WRITE,    // HAL_I2C_Mem_Write
+    I2C_BUS_OP_MEM_READ      // HAL_I2C_Mem_Read
+} I2C_BUS_Op;
+
+typedef enum {
+    I2C_BUS_TXN_IDLE = 0,
+    I2C_BUS_TXN_QUEUED,
+    I2C_BUS_TXN_ACTIVE,
+    I2C_BUS_TXN_DONE,
+    I2C_BUS_TXN_ERROR
+} I2C_BUS_TxnState;
+
+typedef struct I2C_BUS_Transaction_s I2C_BUS_Transaction;
+
+// Called once per submitted chain, from interrupt context (from I2C_BUS_Submit when
+// the transfer could not even be started)
+typedef void (*I2C_BUS_Callback)(I2C_BUS_Transaction* txn, HAL_StatusTypeDef status);
+
+struct I2C_BUS_Transaction_s {
+    // ---- Filled in by the submitter ----
+    I2C_BUS_Op Op;
+    uint16_t DevAddress;            // 8-bit HAL address
+    uint16_t MemAddress;            // MEM_* only
+    uint16_t MemAddSize;            // I2C_MEMADD_SIZE_8BIT / _16BIT
+    uint8_t* Data;
+    uint16_t Size;
+    I2C_BUS_Priority Priority;
+
+    I2C_BUS_Transaction* Next;      // next step of a chain (NULL = last)
+    // Runs after this step succeeded, before Next starts (e.g. modify the read value)
+    HAL_StatusTypeDef (*Modify)(I2C_BUS_Transaction* txn);
+    I2C_BUS_Callback Callback;      // chain head only, may be NULL
+    void* Ctx;
+
+    // ---- Managed by the bus ----
+    volatile I2C_BUS_TxnState State;
+    volatile HAL_StatusTypeDef Status;
+    uint32_t ErrorCode;             // HAL_I2C_ERROR_* of the failed step
+    I2C_BUS_Transaction* QueueNext;
+    uint32_t BudgetMs;              // chain head: worst case, retries included
+    uint32_t Started;               // chain head: TIMING stamp of the first start
+    uint8_t Tries;                  // chain head: attempts after the first
+};
+
+// Error counters of one device
+typedef struct {
+    I2C_TypeDef* Instance;
+    uint16_t DevAddress;
+    uint32_t Transfers;             // operations completed
+    uint32_t Failures;              // operations failed after every retry
+    uint32_t Timeouts;              // attempts past their budget or blocked by a busy bus
+    uint32_t Retries;
+    uint32_t Recoveries;            // bus recoveries run for this device
+    uint32_t MaxUs;                 // longest operation, retries and recoveries included
+} I2C_BUS_DevStats;
+
+typedef struct {
+    I2C_HandleTypeDef* hi2c;
+    uint16_t DmaMinSize;            // 0 = never use DMA
+
+    // Queue, one FIFO per priority
+    I2C_BUS_Transaction* Head[I2C_BUS_PRIO_COUNT];
+    I2C_BUS_Transaction* Tail[I2C_BUS_PRIO_COUNT];
+    I2C_BUS_Transaction* volatile Active;   // chain being served
+    I2C_BUS_Transaction* volatile Step;     // step of the chain on the wire
+    uint32_t Deadline;                      // HAL tick the step on the wire must end by
+    volatile uint8_t Stuck;                 // step could not start: bus held busy
+    uint8_t Retries;                        // I2C_BUS_RETRIES by default
+    uint32_t PendingMs;                     // worst case of the queued + active chains
+
+    // Statistics
+    uint32_t Completed;
+    uint32_t Failed;
+    uint32_t Timeouts;
+    uint32_t Recoveries;
+    uint8_t MaxQueued;
+    uint8_t Queued;
+} I2C_BUS_HandleTypeDef;
+
+// Register read-modify-write: Reg = (Reg & ~Mask) | (Bits & Mask)
+typedef struct {
+    I2C_BUS_Transaction Read;       // must stay first
+    I2C_BUS_Transaction Write;
+    uint8_t Value;
+    uint8_t Mask;
+    uint8_t Bits;
+} I2C_BUS_RegUpdate;
+
+// Setup
+HAL_StatusTypeDef I2C_BUS_Init(I2C_BUS_HandleTypeDef* bus, I2C_HandleTypeDef* hi2c, uint16_t dmaMinSize);
+void I2C_BUS_DeInit(I2C_BUS_HandleTypeDef* bus);
+
+// Transaction builders (do not submit)
+void I2C_BUS_MemRead(I2C_BUS_Transaction* txn, uint16_t devAddress, uint16_t memAddress,
+                     uint8_t* data, uint16_t size, I2C_BUS_Priority prio);
+void I2C_BUS_MemWrite(I2C_BUS_Transaction* txn, uint16_t devAddress, uint16_t memAddress,
+                      uint8_t* data, uint16_t size, I2C_BUS_Priority prio);
+void I2C_BUS_Transmit(I2C_BUS_Transaction* txn, uint16_t devAddress,
+                      uint8_t* data, uint16_t size, I2C_BUS_Priority prio);
+void I2C_BUS_Receive(I2C_BUS_Transaction* txn, uint16_t devAddress,
+                     uint8_t* data, uint16_t size, I2C_BUS_Priority prio);
+
+// Queue a transaction (or chain); HAL_BUSY if it is still queued or running
+HAL_StatusTypeDef I2C_BUS_Submit(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn,
+                                 I2C_BUS_Callback callback, void* ctx);
+HAL_StatusTypeDef I2C_BUS_UpdateReg(I2C_BUS_HandleTypeDef* bus, I2C_BUS_RegUpdate* upd,
+                                    uint16_t devAddress, uint8_t reg, uint8_t mask, uint8_t bits,
+                                    I2C_BUS_Priority prio, I2C_BUS_Callback callback, void* ctx);
+
+// Completion
+uint8_t I2C_BUS_IsDone(const I2C_BUS_Transaction* txn);
+HAL_StatusTypeDef I2C_BUS_Wait(const I2C_BUS_Transaction* txn, uint32_t timeoutMs);
+HAL_StatusTypeDef I2C_BUS_Transfer(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn, uint32_t timeoutMs);
+HAL_StatusTypeDef I2C_BUS_Cancel(I2C_BUS_HandleTypeDef* bus, I2C_BUS_Transaction* txn);
+uint8_t I2C_BUS_IsIdle(const I2C_BUS_HandleTypeDef* bus);
+
+// Time budgets, timeouts and recovery
+uint32_t I2C_BUS_BudgetMs(const I2C_HandleTypeDef* hi2c, const I2C_BUS_Transaction* txn);
+uint32_t I2C_BUS_WorstCaseMs(const I2C_BUS_HandleTypeDef* bus, const I2C_BUS_Transaction* txn);
+void I2C_BUS_Poll(I2C_BUS_HandleTypeDef* bus);
+HAL_StatusTypeDef I2C_BUS_Exec(I2C_BUS_HandleTypeDef* bus, I2C_HandleTypeDef* hi2c, I2C_BUS_Transaction* txn);
+HAL_StatusTypeDef I2C_BUS_Recover(I2C_HandleTypeDef* hi2c);
+void I2C_BUS_SetRecoveryPins(I2C_TypeDef* instance, GPIO_TypeDef* port, uint16_t scl, uint16_t sda);
+
+// Per-device statistics (NULL = no transfer to this device yet)
+I2C_BUS_DevStats* I2C_BUS_GetDevStats(const I2C_HandleTypeDef* hi2c, uint16_t devAddress);
+void I2C_BUS_ResetDevStats(void);
+
+// Hooks for applications that keep the HAL callbacks (I2C_BUS_HAL_CALLBACKS=0)
+void I2C_BUS_CompleteCallback(I2C_HandleTypeDef* hi2c);
+void I2C_BUS_ErrorCallback(I2C_HandleTypeDef* hi2c);
+
+#endif // __I2C_BUS_H
@@ -0,0 +1,176 @@
+/**
+ * @file KEYPAD.c
+ * @brief Key matrix scanner feeding the BUTTON press classification.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Functions:
+ * - KEYPAD_Init, KEYPAD_Deinit: One BUTTON per key of a rows x columns matrix.
+ * - KEYPAD_Update: Scans the matrix when KEYPAD_SCAN_MS has passed.
+ * - KEYPAD_Scan: One scan now (timer or scheduler pacing).
+ * - KEYPAD_GetKey, KEYPAD_KeyIndex: Key <-> button.
+ */
+
+
+
+#include "KEYPAD.h"
+#include "GPIO_FAST.h"
+#include "TIMING.h"
+
+static uint8_t CountPins(uint16_t pins) {
+    return (uint8_t)__builtin_popcount(pins);
+}
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef KEYPAD_Init(KEYPAD_t* kp, GPIO_TypeDef* rowPort, uint16_t rowPins,
+                              GPIO_TypeDef* colPort, uint16_t colPins,
+                              ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t)) {
+    if (kp == NULL || !rowPins || !colPins) return HAL_ERROR;
+    if (CountPins(rowPins) > KEYPAD_MAX_ROWS || CountPins(colPins) > KEYPAD_MAX_COLS) return HAL_ERROR;
+
+    uint16_t colPin[KEYPAD_MAX_COLS];
+    *kp = (KEYPAD_t){ .RowPort = rowPort, .RowPins = rowPins, .ColPort = colPort, .ColPins = colPins };
+
+    for (uint16_t pins = rowPins; pins; pins &= (uint16_t)(pins - 1U)) {
+        uint16_t bit = (uint16_t)(pins & -pins);
+        kp->Strobe[kp->Rows++] = GPIO_FAST_BSRR(rowPins, (uint16_t)(rowPins & ~bit));
+    }
+    for (uint16_t pins = colPins; pins; pins &= (uint16_t)(pins - 1U)) {
+        colPin[kp->Cols] = (uint16_t)(pins & -pins);
+        kp->ColIndex[__builtin_ctz(pins)] = kp->Cols++;
+    }
+
+    for (uint8_t r = 0; r < kp->Rows; r++) kp->Cnt[r] = BUTTON_COUNTER_INIT;
+
+    for (uint16_t k = 0; k < kp->Rows * kp->Cols; k++) {
+        Button_t* key = BUTTON_Init(colPort, colPin[k % kp->Cols], 0, mode, Handler);
+        if (key == NULL) {
+            KEYPAD_Deinit(kp);      // BUTTON_MAX too small for the matrix
+            return HAL_ERROR;
+        }
+        BUTTON_EnableExternal(key);
+        Set_DebounceTime(key, 0);   // done by the counters
+        kp->Keys[k] = key;
+    }
+
+    GPIO_FAST_WriteBSRR(rowPort, rowPins);     // all rows released
+    kp->NextScan = HAL_GetTick();
+    return HAL_OK;
+}
+
+void KEYPAD_Deinit(KEYPAD_t* kp) {
+    if (kp == NULL) return;
+    for (uint16_t k = 0; k < KEYPAD_MAX_ROWS * KEYPAD_MAX_COLS; k++) {
+        BUTTON_Deinit(kp->Keys[k]);
+        kp->Keys[k] = NULL;
+    }
+    kp->Rows = 0;
+}
+
+// ========== Scan ==========
+
+// A row with 2 keys or more that shares a column with another pressed row cannot be told from ghosts
+static uint16_t KEYPAD_Ambiguous(const uint16_t* sample, uint8_t rows) {
+    uint16_t rowsHit = 0;
+    for (uint8_t r = 0; r < rows; r++) {
+        if (CountPins(sample[r]) < 2) continue;
+        for (uint8_t o = 0; o < rows; o++) {
+            if (o != r && (sample[o] & sample[r])) rowsHit |= (uint16_t)(1U << r);
+        }
+    }
+    return rowsHit;
+}
+
+// rows + 1 BSRR stores, rows settle waits and rows IDR loads, then only the keys that flipped reach BUTTON
+void KEYPAD_Scan(KEYPAD_t* kp) {
+    uint16_t sample[KEYPAD_MAX_ROWS];
+
+    for (uint8_t r = 0; r < kp->Rows; r++) {
+        GPIO_FAST_WriteBSRR(kp->RowPort, kp->Strobe[r]);
+        TIMING_DelayNs(KEYPAD_SETTLE_NS);       // previous row released, its columns back high
+        sample[r] = (uint16_t)(~GPIO_FAST_ReadIDR(kp->ColPort) & kp->ColPins);
+    }
+    GPIO_FAST_WriteBSRR(kp->RowPort, kp->RowPins);
+
+    uint16_t frozen = KEYPAD_Ambiguous(sample, kp->Rows);
+    if (frozen) kp->Ghosts++;
+
+    for (uint8_t r = 0; r < kp->Rows; r++) {
+        uint16_t delta = (frozen & (1U << r)) ? 0U : (uint16_t)(sample[r] ^ kp->State[r]);
+
+        uint16_t toggle = (uint16_t)BUTTON_CounterStep(&kp->Cnt[r], delta);
+        kp->State[r] ^= toggle;
+
+        for (; toggle; toggle &= (uint16_t)(toggle - 1U)) {
+            uint8_t pin = (uint8_t)__builtin_ctz(toggle);
+            BUTTON_SetLevel(kp->Keys[r * kp->Cols + kp->ColIndex[pin]], (uint8_t)((kp->State[r] >> pin) & 1U));
+        }
+    }
+}
+
+void KEYPAD_Update(KEYPAD_t* kp) {
+    uint32_t now = HAL_GetTick();
+    if (kp->Rows == 0 || (int32_t)(now - kp->NextScan) < 0) return;
+
+    KEYPAD_Scan(kp);
+    kp->NextScan += KEYPAD_SCAN_MS;
+    if ((int32_t)(now - kp->NextScan) >= 0) kp->NextScan = now + KEYPAD_SCAN_MS;   // late: no burst of scans
+}
+
+// Milliseconds until the next scan (for a scheduler)
+uint32_t KEYPAD_NextUpdate(const KEYPAD_t* kp) {
+    int32_t wait = (int32_t)(kp->NextScan - HAL_GetTick());
+    return wait > 0 ? (uint32_t)wait : 0U;
+}
+
+// ========== Keys ==========
+
+Button_t* KEYPAD_GetKey(const KEYPAD_t* kp, uint8_t row, uint8_t col) {
+    if (row >= kp->Rows || col >= kp->Cols) return NULL;
+    return kp->Keys[row * kp->Cols + col];
+}
+
+// row * columns + column of a key (for a handler shared by all keys), -1 if not a key
+int16_t KEYPAD_KeyIndex(const KEYPAD_t* kp, const Button_t* btn) {
+    for (uint16_t k = 0; k < kp->Rows * kp->Cols; k++) {
+        if (kp->Keys[k] == btn) return (int16_t)k;
+    }
+    return -1;
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. CubeMX: rows PA0..PA3 as GPIO_Output open drain, columns PB12..PB15 as GPIO_Input pull-up.
+#    Build with BUTTON_MAX >= number of keys (+ other buttons)
+
+static KEYPAD_t pad;
+static const char keyChar[16] = "123A456B789C*0#D";
+
+void Pad_Handler(Button_t* btn, ButtonPressType_t type) {
+	int16_t key = KEYPAD_KeyIndex(&pad, btn);
+	if (key < 0) return;
+	if (type == BUTTON_PressType_OnPressed || type == BUTTON_PressType_Normal) TypeChar(keyChar[key]);
+	if (type == BUTTON_PressType_Long && keyChar[key] == '*') ClearInput();
+}
+
+
+# 2. Init: one Toggle-mode button per key, each can be tuned like any button
+
+	KEYPAD_Init(&pad, GPIOA, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3,
+	            GPIOB, GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15,
+	            BUTTON_Mode_Toggle, Pad_Handler);
+	BUTTON_SetImmediate(KEYPAD_GetKey(&pad, 3, 0), 1);		// '*': Long while held
+
+
+# 3. Main loop: scan, then the press timers
+
+while (1)
+{
+	KEYPAD_Update(&pad);
+	BUTTON_Update();
+}
+
+*/
@@ -0,0 +1,100 @@
+/**
+ * @file KEYPAD.h
+ * @brief Key matrix scanner feeding the BUTTON press classification.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * A 4x4 or 8x8 front panel costs rows + columns GPIOs instead of one per key. Every
+ * KEYPAD_SCAN_MS, KEYPAD_Update strobes the rows one after the other (one BSRR store
+ * each), waits KEYPAD_SETTLE_NS and reads the columns (one IDR load each). The wait
+ * lets a column pulled low by a key of the previous row recover through its pull-up;
+ * read right after the store, that key would show in this row too. The columns of a row are debounced
+ * together with vertical counters (a key flips after 4 scans in a row that disagree
+ * with it), and only the keys that flipped are handed to BUTTON_SetLevel. Each key is
+ * a regular Button_t: Toggle / Hold classification, SetTime_*, handlers and
+ * ButtonPressType_t are those of the BUTTON driver.
+ *
+ * Wiring:
+ * - Rows on one port, GPIO_MODE_OUTPUT_OD; the strobed row is driven low, the
+ *   others are released (two keys of one column never short two outputs).
+ * - Columns on one port, input with pull-up: a pressed key reads low.
+ * - Row r / column c are the r-th / c-th lowest pins of the masks.
+ *
+ * Ghosting: without a diode per key, three pressed keys on the corners of a
+ * rectangle make the fourth one read pressed. A row that reads two keys or more and
+ * shares a column with another pressed row is ambiguous: its keys keep their state
+ * for that scan (counted in Ghosts). A matrix with diodes never triggers it.
+ *
+ * Cost: the settle is a busy-wait (TIMING_DelayNs), not paced from a timer or DMA.
+ * Measured in bench_keypad on the simulated F103, a 4x4 scan blocks 8.9 us and an
+ * 8x8 scan 16.7 us, 16 us of it the waits: 0.33 % of the CPU at KEYPAD_SCAN_MS = 5.
+ * A timer strobing one row per interrupt would free those 16 us, at the cost of an
+ * ISR per row and handlers run out of the main loop; not worth it at this rate.
+ *
+ * Notes:
+ * - Every key takes a slot of the BUTTON pool: BUTTON_MAX must cover all the keys.
+ * - Handlers run from KEYPAD_Update; the hold / double-click timers run from
+ *   BUTTON_Update, call both from the main loop.
+ */
+
+
+
+#ifndef __KEYPAD_H
+#define __KEYPAD_H
+
+#include "stm32f1xx_hal.h"
+#include "BUTTON.h"
+#include <stdint.h>
+
+#ifndef KEYPAD_MAX_ROWS
+#define KEYPAD_MAX_ROWS 8
+#endif
+
+#ifndef KEYPAD_MAX_COLS
+#define KEYPAD_MAX_COLS 8
+#endif
+
+// Column recovery after each strobe: ~40 kOhm pull-up on the pin + trace capacitance is
+// about 1 us to the input threshold. Raise it for long ribbons or external capacitors.
+#ifndef KEYPAD_SETTLE_NS
+#define KEYPAD_SETTLE_NS 2000
+#endif
+
+// Scan period (debounce = 4 scans, 15-20 ms by default)
+#ifndef KEYPAD_SCAN_MS
+#define KEYPAD_SCAN_MS 5
+#endif
+
+typedef struct {
+    GPIO_TypeDef* RowPort;
+    uint16_t RowPins;
+    GPIO_TypeDef* ColPort;
+    uint16_t ColPins;
+    uint8_t Rows;
+    uint8_t Cols;
+
+    uint32_t Strobe[KEYPAD_MAX_ROWS];       // BSRR: row r low, other rows released
+    uint8_t ColIndex[16];                   // column number of a column pin
+
+    // Vertical counters, one lane per column pin
+    uint16_t State[KEYPAD_MAX_ROWS];        // debounced: pins of the pressed keys
+    ButtonCounter_t Cnt[KEYPAD_MAX_ROWS];
+
+    Button_t* Keys[KEYPAD_MAX_ROWS * KEYPAD_MAX_COLS];     // row * Cols + column
+    uint32_t NextScan;
+    uint32_t Ghosts;                        // scans with an ambiguous row
+} KEYPAD_t;
+
+HAL_StatusTypeDef KEYPAD_Init(KEYPAD_t* kp, GPIO_TypeDef* rowPort, uint16_t rowPins,
+                              GPIO_TypeDef* colPort, uint16_t colPins,
+                              ButtonMode_t mode, void (*Handler)(Button_t*, ButtonPressType_t));
+void KEYPAD_Deinit(KEYPAD_t* kp);
+void KEYPAD_Update(KEYPAD_t* kp);
+void KEYPAD_Scan(KEYPAD_t* kp);
+uint32_t KEYPAD_NextUpdate(const KEYPAD_t* kp);
+
+Button_t* KEYPAD_GetKey(const KEYPAD_t* kp, uint8_t row, uint8_t col);
+int16_t KEYPAD_KeyIndex(const KEYPAD_t* kp, const Button_t* btn);
+
+#endif // __KEYPAD_H
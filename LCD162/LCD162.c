@@ -22,14 +22,18 @@
  * - Use writeLCD(), setCursor(), etc., to control the LCD content.
  *
  * Notes:
- * - Timing is critical; HAL_Delay is used to meet hardware delay requirements.
+ * - Timing is critical; E pulses and execution times are waited with the TIMING
+ *   service, only the power-up wait still uses HAL_Delay.
  * - Define LCD8Bit to enable 8-bit communication, otherwise 4-bit mode is used.
+ * - Define LCD162_FAST_GPIO=1 to put RS + data lines on the bus with one BSRR
+ *   store per byte (or nibble) instead of one HAL_GPIO_WritePin call per pin.
  *
  ******************************************************************************/
 
 
 
 #include "LCD162.h"
+#include "TIMING.h"
 
 // Macro to simplify setting GPIO pin state based on condition
 #define SET_IF(expr)  ((expr) ? GPIO_PIN_SET : GPIO_PIN_RESET)
@@ -37,13 +41,90 @@
 // Global variable to store current LCD display settings
 static char display_settings;
 
+#if LCD162_FAST_GPIO
+#include "GPIO_FAST.h"
+
+// Pins of a nibble whose bits are set in v, resolved at compile time from the pin map
+#define NIB(v, p0, p1, p2, p3) ((((v) & 1) ? (p0) : 0) | (((v) & 2) ? (p1) : 0) | \
+                                (((v) & 4) ? (p2) : 0) | (((v) & 8) ? (p3) : 0))
+#define NIB_TABLE(p0, p1, p2, p3) { \
+    NIB(0, p0, p1, p2, p3),  NIB(1, p0, p1, p2, p3),  NIB(2, p0, p1, p2, p3),  NIB(3, p0, p1, p2, p3),  \
+    NIB(4, p0, p1, p2, p3),  NIB(5, p0, p1, p2, p3),  NIB(6, p0, p1, p2, p3),  NIB(7, p0, p1, p2, p3),  \
+    NIB(8, p0, p1, p2, p3),  NIB(9, p0, p1, p2, p3),  NIB(10, p0, p1, p2, p3), NIB(11, p0, p1, p2, p3), \
+    NIB(12, p0, p1, p2, p3), NIB(13, p0, p1, p2, p3), NIB(14, p0, p1, p2, p3), NIB(15, p0, p1, p2, p3) }
+
+// Upper data lines (D4..D7), used by both modes
+static const uint16_t nibbleHigh[16] = NIB_TABLE(DATA5_Pin, DATA6_Pin, DATA7_Pin, DATA8_Pin);
+#define HIGH_MASK (DATA5_Pin | DATA6_Pin | DATA7_Pin | DATA8_Pin)
+
+#ifdef LCD8Bit
+static const uint16_t nibbleLow[16] = NIB_TABLE(DATA1_Pin, DATA2_Pin, DATA3_Pin, DATA4_Pin);
+#define LOW_MASK (DATA1_Pin | DATA2_Pin | DATA3_Pin | DATA4_Pin)
+#endif
+
+// ==== Generate a falling edge on the 'E' (Enable) pin ====
+static void fallingEdge(void)
+{
+    TIMING_DelayNs(LCD_AS_NS);      // the bus store right before would be ~28 ns ahead of E
+    GPIO_FAST_WriteBSRR(GPIO_PORT, E_Pin);
+    TIMING_DelayNs(LCD_E_PULSE_NS); // back-to-back stores would only last a few cycles
+    GPIO_FAST_WriteBSRR(GPIO_PORT, (uint32_t)E_Pin << 16);
+    TIMING_DelayNs(LCD_E_CYCLE_NS - LCD_E_PULSE_NS);
+}
+
+// ==== Put RS and the data lines on the bus in one store, then latch ====
+static void sendBus(uint16_t mask, uint16_t value, char rs)
+{
+    mask |= RS_Pin;
+    if (rs) value |= RS_Pin;
+    GPIO_FAST_WriteBSRR(GPIO_PORT, GPIO_FAST_BSRR(mask, value));
+    fallingEdge();
+}
+
+#ifndef LCD8Bit
+// ==== Send 4 bits of data to LCD (used in 4-bit mode, RS left as is) ====
+static void send4Bits(char data)
+{
+    GPIO_FAST_WriteBSRR(GPIO_PORT, GPIO_FAST_BSRR(HIGH_MASK, nibbleHigh[data & 0x0F]));
+    fallingEdge();
+}
+#endif
+
+// ==== Send a command to LCD ====
+static void sendCommand(char cmd)
+{
+#ifdef LCD8Bit
+    sendBus(LOW_MASK | HIGH_MASK, nibbleLow[cmd & 0x0F] | nibbleHigh[(cmd >> 4) & 0x0F], 0);
+#else
+    sendBus(HIGH_MASK, nibbleHigh[(cmd >> 4) & 0x0F], 0);  // Send high nibble
+    sendBus(HIGH_MASK, nibbleHigh[cmd & 0x0F], 0);         // Send low nibble
+#endif
+    TIMING_DelayUs(LCD_EXEC_US);
+}
+
+// ==== Send data (a character) to LCD ====
+static void sendData(char data)
+{
+#ifdef LCD8Bit
+    sendBus(LOW_MASK | HIGH_MASK, nibbleLow[data & 0x0F] | nibbleHigh[(data >> 4) & 0x0F], 1);
+#else
+    sendBus(HIGH_MASK, nibbleHigh[(data >> 4) & 0x0F], 1);  // Send high nibble
+    sendBus(HIGH_MASK, nibbleHigh[data & 0x0F], 1);         // Send low nibble
+#endif
+    TIMING_DelayUs(LCD_EXEC_US);
+}
+
+#else /* !LCD162_FAST_GPIO */
+
 // ==== Generate a falling edge on the 'E' (Enable) pin ====
 static void fallingEdge(void)
 {
     HAL_GPIO_WritePin(GPIO_PORT, E_Pin, GPIO_PIN_RESET);
+    TIMING_DelayNs(LCD_AS_NS);
     HAL_GPIO_WritePin(GPIO_PORT, E_Pin, GPIO_PIN_SET);
+    TIMING_DelayNs(LCD_E_PULSE_NS);
     HAL_GPIO_WritePin(GPIO_PORT, E_Pin, GPIO_PIN_RESET);
-    HAL_Delay(1); // Short delay to ensure command/data is latched
+    TIMING_DelayNs(LCD_E_CYCLE_NS - LCD_E_PULSE_NS);
 }
 
 #ifndef LCD8Bit
@@ -87,6 +168,7 @@ static void sendCommand(char cmd)
     send4Bits(cmd >> 4);  // Send high nibble
     send4Bits(cmd);       // Send low nibble
 #endif
+    TIMING_DelayUs(LCD_EXEC_US);
 }
 
 // ==== Send data (a character) to LCD ====
@@ -100,13 +182,16 @@ static void sendData(char data)
     send4Bits(data >> 4);  // Send high nibble
     send4Bits(data);       // Send low nibble
 #endif
+    TIMING_DelayUs(LCD_EXEC_US);
 }
 
+#endif /* LCD162_FAST_GPIO */
+
 // ==== Clear the LCD screen ====
 void clearLCD(void)
 {
     sendCommand(LCD_CLEARDISPLAY);
-    HAL_Delay(5); // Wait for clear command to complete
+    TIMING_DelayUs(LCD_CLEAR_US - LCD_EXEC_US); // Wait for clear command to complete
 }
 
 // ==== Print a single character on LCD ====
@@ -135,23 +220,23 @@ void initLCD(void)
 #ifdef LCD8Bit
     // Set LCD to 8-bit mode, 2 lines, 5x8 font
     display_settings = LCD_8BITMODE | LCD_2LINE | LCD_5x8DOTS;
+    // Reset by instruction: > 4.1 ms after the first function set, > 100 us after the second
     sendCommand(LCD_FUNCTIONSET | display_settings);
-    HAL_Delay(5);
+    TIMING_DelayUs(4100);
     sendCommand(LCD_FUNCTIONSET | display_settings);
-    HAL_Delay(5);
+    TIMING_DelayUs(100);
     sendCommand(LCD_FUNCTIONSET | display_settings);
-    HAL_Delay(5);
 #else
     // Initialization sequence for 4-bit mode
     display_settings = LCD_4BITMODE | LCD_2LINE | LCD_5x8DOTS;
     send4Bits(0x03);
-    HAL_Delay(5);
+    TIMING_DelayUs(4100);
     send4Bits(0x03);
-    HAL_Delay(5);
+    TIMING_DelayUs(100);
     send4Bits(0x03);
-    HAL_Delay(2);
+    TIMING_DelayUs(LCD_EXEC_US);
     send4Bits(0x02); // Set to 4-bit mode
-    HAL_Delay(2);
+    TIMING_DelayUs(LCD_EXEC_US);
 #endif
 
     sendCommand(LCD_FUNCTIONSET | display_settings);
@@ -159,14 +244,12 @@ void initLCD(void)
     // Turn on display, disable cursor and blinking
     display_settings = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
     sendCommand(LCD_DISPLAYCONTROL | display_settings);
-    HAL_Delay(2);
 
     clearLCD();
 
     // Set entry mode: cursor moves right, no display shift
     display_settings = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
     sendCommand(LCD_ENTRYMODESET | display_settings);
-    HAL_Delay(2);
 }
 
 // ==== Set cursor to position (x, y) ====
@@ -36,6 +36,19 @@
 // ==== L?a ch?n mode ====
 #define LCD8Bit  // B? comment n?u b?n d�ng 8-bit mode
 
+// 1 = drive RS/E/data through BSRR (one store per byte/nibble) instead of HAL_GPIO_WritePin
+#ifndef LCD162_FAST_GPIO
+#define LCD162_FAST_GPIO 0
+#endif
+
+// ==== HD44780 timing ====
+// Execution times are given at fosc = 270 kHz (37 us / 1.52 ms); scaled to the 190 kHz minimum
+#define LCD_AS_NS       60     // tAS, RS / data set up before E rises (40 ns at 5 V)
+#define LCD_E_PULSE_NS  450    // PWEH, E high width
+#define LCD_E_CYCLE_NS  1000   // tcycE, E period (also between the two nibbles)
+#define LCD_EXEC_US     53     // most instructions and data writes
+#define LCD_CLEAR_US    2160   // clear display / return home
+
 // ==== C�c l?nh LCD ====
 #define LCD_CLEARDISPLAY   0x01
 #define LCD_RETURNHOME     0x02
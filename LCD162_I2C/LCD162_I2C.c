@@ -14,6 +14,9 @@
  * - lcd_clear: Clears the display.
  * - lcd_backlight_on: Turns on the LCD backlight.
  * - lcd_backlight_off: Turns off the LCD backlight.
+ * - lcd_attach_bus: Shares the I2C peripheral through the I2C_BUS manager.
+ * - lcd_send_string_async / lcd_write_at_async: Queue a whole update as one
+ *   I2C transfer and return at once.
  * 
  * Usage:
  * - Call lcd_init() once, passing a valid I2C handle.
@@ -23,6 +26,9 @@
  * - Ensure the correct I2C address is defined (LCD_I2C_ADDR).
  * - Uses HAL I2C functions (HAL_I2C_Master_Transmit).
  * - Includes basic delays using HAL_Delay to meet timing requirements.
+ * - Async updates pace the controller with the bus itself: idle bytes are added
+ *   between characters when the bus is fast enough to outrun the execution time.
+ * - One async update can be in flight at a time (HAL_BUSY otherwise).
  * 
  ******************************************************************************/
 
@@ -36,6 +42,26 @@ static I2C_HandleTypeDef *i2cHandle;
 // Backlight state, default is ON
 static uint8_t backlight = LCD_BACKLIGHT;
 
+// Bus manager (NULL = direct blocking HAL calls) and the async update in flight
+static I2C_BUS_HandleTypeDef *lcdBus;
+static I2C_BUS_Transaction asyncTxn;
+static uint8_t asyncFrame[LCD_ASYNC_MAX_CHARS * 6];
+
+/**
+ * @brief Builds the 4 expander bytes that clock one byte into the LCD (two E pulses).
+ */
+static uint8_t *lcd_frame(uint8_t *dst, uint8_t data, uint8_t mode)
+{
+	uint8_t high = data & 0xF0;
+	uint8_t low  = (data << 4) & 0xF0;
+
+	*dst++ = high | mode | backlight | LCD_ENABLE;
+	*dst++ = high | mode | backlight;
+	*dst++ = low  | mode | backlight | LCD_ENABLE;
+	*dst++ = low  | mode | backlight;
+	return dst;
+}
+
 /**
  * @brief Sends a byte to the LCD with control flags via I2C.
  * 
@@ -44,16 +70,13 @@ static uint8_t backlight = LCD_BACKLIGHT;
  */
 static void lcd_send_internal(uint8_t data, uint8_t mode)
 {
-	uint8_t high = data & 0xF0;
-	uint8_t low  = (data << 4) & 0xF0;
 	uint8_t data_arr[4];
+	lcd_frame(data_arr, data, mode);
 
-	data_arr[0] = high | mode | backlight | LCD_ENABLE;
-	data_arr[1] = high | mode | backlight;
-	data_arr[2] = low  | mode | backlight | LCD_ENABLE;
-	data_arr[3] = low  | mode | backlight;
-
-	HAL_I2C_Master_Transmit(i2cHandle, LCD_I2C_ADDR, data_arr, 4, HAL_MAX_DELAY);
+	// Bounded: through the queue when attached (waits our turn), direct HAL otherwise
+	I2C_BUS_Transaction txn;
+	I2C_BUS_Transmit(&txn, LCD_I2C_ADDR, data_arr, 4, LCD_I2C_BUS_PRIORITY);
+	I2C_BUS_Exec(lcdBus, i2cHandle, &txn);
 	HAL_Delay(1);
 }
 
@@ -130,6 +153,102 @@ void lcd_clear(void)
 	HAL_Delay(2);
 }
 
+/**
+ * @brief Routes all LCD traffic through the bus manager.
+ * 
+ * @param bus Bus manager that owns the I2C handle given to lcd_init (NULL = direct HAL calls)
+ */
+void lcd_attach_bus(I2C_BUS_HandleTypeDef *bus)
+{
+	lcdBus = bus;
+}
+
+/**
+ * @brief Idle bytes needed after each byte so the next latch comes after the execution time.
+ * 
+ * A byte is latched at the 2nd and 4th expander byte; the next one 2 bus bytes later.
+ */
+static uint8_t lcd_pad_bytes(void)
+{
+	uint32_t speed = i2cHandle->Init.ClockSpeed ? i2cHandle->Init.ClockSpeed : 100000U;
+	uint32_t byteNs = 9000000000ULL / speed;
+	uint32_t needed = (LCD_I2C_EXEC_US * 1000U + byteNs - 1U) / byteNs;
+
+	if (needed <= 2U) return 0;
+	return (needed - 2U > 2U) ? 2U : (uint8_t)(needed - 2U);
+}
+
+/**
+ * @brief Appends one byte (and its padding) to the async frame.
+ */
+static uint8_t *lcd_frame_paced(uint8_t *dst, uint8_t data, uint8_t mode, uint8_t pad)
+{
+	dst = lcd_frame(dst, data, mode);
+	for (uint8_t i = 0; i < pad; i++) {
+		*dst = dst[-1];     // E low, same lines: the expander just re-latches them
+		dst++;
+	}
+	return dst;
+}
+
+/**
+ * @brief Queues an optional command followed by a string as one I2C transfer.
+ */
+static HAL_StatusTypeDef lcd_queue(int16_t cmd, const char *str, I2C_BUS_Callback done)
+{
+	if (lcdBus == NULL) return HAL_ERROR;
+	if (lcd_async_busy()) return HAL_BUSY;
+
+	uint8_t pad = lcd_pad_bytes();
+	uint8_t *p = asyncFrame;
+	uint8_t count = 0;
+
+	if (cmd >= 0) {
+		p = lcd_frame_paced(p, (uint8_t)cmd, 0x00, pad);
+		count++;
+	}
+	while (*str && count < LCD_ASYNC_MAX_CHARS) {
+		p = lcd_frame_paced(p, (uint8_t)*str++, LCD_REGISTER_SELECT, pad);
+		count++;
+	}
+
+	I2C_BUS_Transmit(&asyncTxn, LCD_I2C_ADDR, asyncFrame, (uint16_t)(p - asyncFrame), LCD_I2C_BUS_PRIORITY);
+	return I2C_BUS_Submit(lcdBus, &asyncTxn, done, NULL);
+}
+
+/**
+ * @brief Queues a string at the current cursor position and returns at once.
+ * 
+ * @param str  Pointer to string (copied, up to LCD_ASYNC_MAX_CHARS characters)
+ * @param done Called from interrupt context when the update is on the display (may be NULL)
+ */
+HAL_StatusTypeDef lcd_send_string_async(char *str, I2C_BUS_Callback done)
+{
+	return lcd_queue(-1, str, done);
+}
+
+/**
+ * @brief Queues cursor positioning plus a string as one transfer and returns at once.
+ * 
+ * @param row  Row number (0 or 1)
+ * @param col  Column number (0 to 15)
+ * @param str  Pointer to string (copied, up to LCD_ASYNC_MAX_CHARS - 1 characters)
+ * @param done Called from interrupt context when the update is on the display (may be NULL)
+ */
+HAL_StatusTypeDef lcd_write_at_async(uint8_t row, uint8_t col, char *str, I2C_BUS_Callback done)
+{
+	uint8_t pos = (row == 0) ? 0x80 + col : 0xC0 + col;
+	return lcd_queue(pos, str, done);
+}
+
+/**
+ * @brief Returns 1 while an async update is queued or on the bus.
+ */
+uint8_t lcd_async_busy(void)
+{
+	return asyncTxn.State == I2C_BUS_TXN_QUEUED || asyncTxn.State == I2C_BUS_TXN_ACTIVE;
+}
+
 /**
  * @brief Turns the LCD backlight on.
  */
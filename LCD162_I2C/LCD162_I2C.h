@@ -21,6 +21,7 @@
 #define INC_LCD_I2C_H_
 
 #include "stm32f1xx_hal.h"  
+#include "I2C_BUS.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -33,6 +34,13 @@
 #define LCD_READWRITE 0x02
 #define LCD_REGISTER_SELECT 0x01
 
+// === NON-BLOCKING (I2C_BUS) ===
+#define LCD_I2C_EXEC_US       53   // HD44780 execution time, 37 us at 270 kHz scaled to 190 kHz
+#define LCD_ASYNC_MAX_CHARS   20   // characters per queued update (cursor command included)
+#ifndef LCD_I2C_BUS_PRIORITY
+#define LCD_I2C_BUS_PRIORITY  I2C_BUS_PRIO_LOW
+#endif
+
 // === API ===
 void lcd_init(I2C_HandleTypeDef *hi2c);
 void lcd_send_cmd(char cmd);
@@ -43,4 +51,10 @@ void lcd_clear(void);
 void lcd_backlight_on(void);
 void lcd_backlight_off(void);
 
+// Share the I2C peripheral through the bus manager; blocking calls then queue as well
+void lcd_attach_bus(I2C_BUS_HandleTypeDef *bus);
+HAL_StatusTypeDef lcd_send_string_async(char *str, I2C_BUS_Callback done);
+HAL_StatusTypeDef lcd_write_at_async(uint8_t row, uint8_t col, char *str, I2C_BUS_Callback done);
+uint8_t lcd_async_busy(void);
+
 #endif /* INC_LCD_I2C_H_ */
@@ -0,0 +1,280 @@
+/**
+ * @file SCHED.c
+ * @brief Tickless cooperative scheduler for the driver update loops.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "SCHED.h"
+#include "TIMING.h"
+
+// ==== Scheduler state ====
+static SCHED_Task* tasks;           // every registered task, active or not
+static volatile uint8_t notified;   // a SCHED_Notify happened since the last pass
+static SCHED_Stats stats;
+
+// Tickless wake-up timer
+static TIM_HandleTypeDef* wakeTim;
+static uint32_t wakeTicksPerMs;
+static uint32_t wakeCarry;          // timer ticks slept but not yet added to uwTick
+
+// Wrap-safe "a is at or after b" on the HAL tick
+static inline uint8_t Reached(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) >= 0;
+}
+
+// Due time 'delayMs' from now; a delay past half the tick range has none
+static void SetDue(SCHED_Task* task, uint32_t delayMs) {
+    task->Waiting = (delayMs >= 0x80000000U);
+    task->Due = HAL_GetTick() + (task->Waiting ? 0U : delayMs);
+}
+
+// Timed run due (a waiting task is never due)
+static inline uint8_t Due(const SCHED_Task* task, uint32_t now) {
+    return !task->Waiting && Reached(now, task->Due);
+}
+
+static void Register(SCHED_Task* task) {
+    for (SCHED_Task* t = tasks; t; t = t->Next) {
+        if (t == task) return;
+    }
+    task->Next = tasks;
+    tasks = task;
+}
+
+// ========== Setup ==========
+
+void SCHED_Init(void) {
+    tasks = NULL;
+    notified = 0;
+    wakeTim = NULL;
+    wakeCarry = 0;
+    SCHED_ResetStats();
+}
+
+// 'htim' counts up at 'hz' (multiple of 1 kHz); it is only started for each sleep
+HAL_StatusTypeDef SCHED_InitTickless(TIM_HandleTypeDef* htim, uint32_t hz) {
+    if (htim == NULL || hz < 1000U || (hz % 1000U) != 0) return HAL_ERROR;
+    if (hz > SCHED_TICKLESS_MAX_HZ) return HAL_ERROR;   // not even 1 ms in 65536 ticks
+
+    wakeTim = htim;
+    wakeTicksPerMs = hz / 1000U;
+    wakeCarry = 0;
+    return HAL_OK;
+}
+
+// ========== Tasks ==========
+
+static HAL_StatusTypeDef Add(SCHED_Task* task, const char* name, SCHED_TaskFn fn, void* ctx,
+                             uint32_t periodMs, uint32_t delayMs) {
+    if (task == NULL || fn == NULL) return HAL_ERROR;
+
+    task->Name = name;
+    task->Fn = fn;
+    task->Ctx = ctx;
+    task->Period = periodMs;
+    SetDue(task, delayMs);
+    task->Pending = 0;
+    task->Rescheduled = 0;
+    task->Stats = (SCHED_TaskStats){0};
+    Register(task);
+    task->Active = 1;
+    return HAL_OK;
+}
+
+// First run right away, then every 'periodMs'
+HAL_StatusTypeDef SCHED_Every(SCHED_Task* task, const char* name, SCHED_TaskFn fn, void* ctx, uint32_t periodMs) {
+    if (periodMs == 0) return HAL_ERROR;
+    return Add(task, name, fn, ctx, periodMs, 0);
+}
+
+// One run after 'delayMs'; the task may call SCHED_Reschedule to run again
+HAL_StatusTypeDef SCHED_After(SCHED_Task* task, const char* name, SCHED_TaskFn fn, void* ctx, uint32_t delayMs) {
+    return Add(task, name, fn, ctx, 0, delayMs);
+}
+
+// Next run 'delayMs' from now; from inside the task it replaces the periodic step.
+// SCHED_FOREVER (or any delay >= 2^31 ms): no timed run, the next SCHED_Notify runs it
+void SCHED_Reschedule(SCHED_Task* task, uint32_t delayMs) {
+    SetDue(task, delayMs);
+    task->Rescheduled = 1;
+    task->Active = 1;
+}
+
+void SCHED_Cancel(SCHED_Task* task) {
+    task->Active = 0;
+    task->Pending = 0;
+}
+
+// ISR safe: run the task on the next pass, whatever its due time
+void SCHED_Notify(SCHED_Task* task) {
+    task->Pending = 1;
+    notified = 1;
+}
+
+// ========== Main loop ==========
+
+static void RunTask(SCHED_Task* task, uint32_t now) {
+    uint8_t pending = task->Pending;
+    task->Pending = 0;
+    task->Rescheduled = 0;
+
+    // Lateness only means something for a timed run
+    if (!pending || Due(task, now)) {
+        uint32_t late = Due(task, now) ? now - task->Due : 0;
+        task->Stats.LatenessSumMs += late;
+        if (late > task->Stats.LatenessMaxMs) task->Stats.LatenessMaxMs = late;
+    }
+
+    uint32_t start = TIMING_Now();
+    task->Fn(task);
+    uint32_t us = TIMING_TicksToNs(TIMING_Elapsed(start)) / 1000U;
+
+    task->Stats.Runs++;
+    task->Stats.RunTimeUs = us;
+    task->Stats.RunTimeSumUs += us;
+    if (us > task->Stats.RunTimeMaxUs) task->Stats.RunTimeMaxUs = us;
+
+    if (task->Rescheduled || !task->Active || task->Waiting) return;   // waiting: until the next notify
+    if (task->Period == 0) {
+        // Deadline task that did not ask for another run
+        if (!pending || Reached(now, task->Due)) task->Active = 0;
+        return;
+    }
+    if (pending && !Reached(now, task->Due)) return;   // early run, keep the period phase
+
+    // Next period; skip the ones already missed instead of running them back to back
+    task->Due += task->Period;
+    uint32_t after = HAL_GetTick();
+    if (Reached(after, task->Due)) {
+        uint32_t missed = (after - task->Due) / task->Period + 1U;
+        task->Stats.Overruns += missed;
+        task->Due += missed * task->Period;
+    }
+}
+
+// Run every task that is due (each at most once), return the ms until the next one
+uint32_t SCHED_RunPending(void) {
+    stats.Passes++;
+    notified = 0;
+
+    for (SCHED_Task* t = tasks; t; t = t->Next) {
+        if (!t->Active) continue;
+        uint32_t now = HAL_GetTick();
+        if (t->Pending || Due(t, now)) RunTask(t, now);
+    }
+
+    uint32_t now = HAL_GetTick();
+    uint32_t next = SCHED_FOREVER;
+    for (SCHED_Task* t = tasks; t; t = t->Next) {
+        if (!t->Active) continue;
+        if (t->Pending || Due(t, now)) return 0;
+        if (t->Waiting) continue;
+        if (t->Due - now < next) next = t->Due - now;
+    }
+    return notified ? 0 : next;
+}
+
+// SysTick off, wake-up timer on, sleep, then put the slept time back into uwTick
+static void TicklessSleep(uint32_t ms) {
+    uint32_t maxMs = 0x10000U / wakeTicksPerMs;
+    if (ms > maxMs) ms = maxMs;
+    uint32_t ticks = ms * wakeTicksPerMs;
+
+    __HAL_TIM_SET_AUTORELOAD(wakeTim, ticks - 1U);
+    __HAL_TIM_SET_COUNTER(wakeTim, 0);
+    __HAL_TIM_CLEAR_FLAG(wakeTim, TIM_FLAG_UPDATE);
+    HAL_SuspendTick();
+    HAL_TIM_Base_Start_IT(wakeTim);
+
+    __WFI();
+
+    HAL_TIM_Base_Stop_IT(wakeTim);
+    uint32_t slept = __HAL_TIM_GET_FLAG(wakeTim, TIM_FLAG_UPDATE) ? ticks : __HAL_TIM_GET_COUNTER(wakeTim);
+    __HAL_TIM_CLEAR_FLAG(wakeTim, TIM_FLAG_UPDATE);
+
+    wakeCarry += slept;
+    uwTick += wakeCarry / wakeTicksPerMs;
+    wakeCarry %= wakeTicksPerMs;
+    HAL_ResumeTick();
+}
+
+// Sleep up to 'ms' or until an interrupt; returns at once if a task was notified
+void SCHED_Idle(uint32_t ms) {
+    if (ms == 0) return;
+    uint32_t start = HAL_GetTick();
+
+    // With PRIMASK set an interrupt still ends __WFI, its handler runs right after
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!notified) {
+        stats.Sleeps++;
+        if (wakeTim && ms >= SCHED_TICKLESS_MIN_MS) TicklessSleep(ms);
+        else __WFI();
+    }
+    __set_PRIMASK(primask);
+
+    stats.SleepMs += HAL_GetTick() - start;
+}
+
+void SCHED_Step(void) {
+    SCHED_Idle(SCHED_RunPending());
+}
+
+void SCHED_Run(void) {
+    for (;;) {
+        SCHED_Step();
+    }
+}
+
+// ========== Statistics ==========
+
+const SCHED_Stats* SCHED_GetStats(void) {
+    return &stats;
+}
+
+void SCHED_ResetStats(void) {
+    stats = (SCHED_Stats){0};
+    for (SCHED_Task* t = tasks; t; t = t->Next) {
+        t->Stats = (SCHED_TaskStats){0};
+    }
+}
+
+/*
+=================================== How to USE ==========================================
+
+static SCHED_Task buttonTask, dhtTask, sonarTask;
+
+void ButtonTask(SCHED_Task* task) {
+    BUTTON_Update();
+    SCHED_Reschedule(task, BUTTON_NextUpdate());  // BUTTON_FOREVER: until SCHED_Notify from the EXTI callback
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    BUTTON_EXTI_Callback(GPIO_Pin);
+    SCHED_Notify(&buttonTask);
+}
+
+void DhtTask(SCHED_Task* task) {
+    DHT22_Read(&dht, &data);
+}
+
+void SonarTask(SCHED_Task* task) {
+    distance = HCSR04_ReadDistance(&sonar);    // echo of the previous trigger
+    HCSR04_Trigger(&sonar);
+}
+
+int main(void) {
+    ...
+    SCHED_Init();
+    SCHED_InitTickless(&htim4, 1000000);         // optional: TIM4 at 1 MHz, SysTick off while asleep
+    SCHED_After(&buttonTask, "button", ButtonTask, NULL, 0);
+    SCHED_Every(&dhtTask, "dht22", DhtTask, NULL, DHT22_MIN_INTERVAL_MS);
+    SCHED_Every(&sonarTask, "hc_sr04", SonarTask, NULL, HCSR04_CYCLE_MS);
+    SCHED_Run();
+}
+
+*/
@@ -0,0 +1,108 @@
+/**
+ * @file SCHED.h
+ * @brief Tickless cooperative scheduler for the driver update loops.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Instead of spinning BUTTON_Update() and polling every sensor from the main loop,
+ * each job is registered as a task:
+ * - periodic task: runs every Period ms, phase kept (DHT22 every 2 s, HC-SR04 ranging).
+ * - deadline task: runs once after a delay and chooses its next run itself with
+ *   SCHED_Reschedule (button debounce / double-click expiry, see BUTTON_NextUpdate).
+ *   A delay of SCHED_FOREVER (any delay of 2^31 ms or more) leaves it waiting with no
+ *   due time: only SCHED_Notify runs it again (BUTTON_FOREVER, edge-driven buttons).
+ *
+ * SCHED_Step() runs the tasks that are due, works out the next wake-up and sleeps
+ * until then with __WFI:
+ * - default: SysTick keeps running, the core wakes up every ms to check.
+ * - SCHED_InitTickless: SysTick is suspended and a spare timer wakes the core at
+ *   the next deadline; uwTick is corrected with the time slept. One sleep lasts at
+ *   most 65536 timer ticks, and each sleep ended by another interrupt loses up to
+ *   one timer tick: 1 MHz (65 ms sleeps, ~1 us error) is a good default. The timer
+ *   must count at SCHED_TICKLESS_MAX_HZ at most: with a 72 MHz timer clock, a
+ *   prescaler of 1 or more (PSC 71 for 1 MHz).
+ * Any other interrupt wakes the core as well; an ISR that has work for a task
+ * calls SCHED_Notify so it runs on the next pass.
+ *
+ * Notes:
+ * - Times in ms on the HAL tick; run times in us on the TIMING service.
+ * - Tasks are owned by the caller (no dynamic memory) and must not block:
+ *   a task running late delays every other task by the same amount.
+ * - Statistics per task: runs, run time (last / max / sum), lateness (max / sum)
+ *   and skipped periods.
+ */
+
+
+
+#ifndef __SCHED_H
+#define __SCHED_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#define SCHED_FOREVER 0xFFFFFFFFU   // no task due / SCHED_Reschedule: wait for SCHED_Notify
+
+// Sleeps shorter than this use plain __WFI even in tickless mode
+#ifndef SCHED_TICKLESS_MIN_MS
+#define SCHED_TICKLESS_MIN_MS 2
+#endif
+
+// Fastest tickless timer: one sleep of 65536 ticks must hold 1 ms
+#define SCHED_TICKLESS_MAX_HZ 65536000U
+
+typedef struct SCHED_Task_s SCHED_Task;
+typedef void (*SCHED_TaskFn)(SCHED_Task* task);
+
+typedef struct {
+    uint32_t Runs;
+    uint32_t RunTimeUs;         // last run
+    uint32_t RunTimeMaxUs;
+    uint32_t RunTimeSumUs;
+    uint32_t LatenessMaxMs;     // start time past the due time
+    uint32_t LatenessSumMs;
+    uint32_t Overruns;          // periods skipped because the task started too late
+} SCHED_TaskStats;
+
+struct SCHED_Task_s {
+    const char* Name;
+    SCHED_TaskFn Fn;
+    void* Ctx;
+    uint32_t Period;            // ms, 0 = deadline task
+    uint32_t Due;               // HAL tick of the next run
+    volatile uint8_t Active;
+    volatile uint8_t Pending;   // set by SCHED_Notify
+    uint8_t Rescheduled;        // SCHED_Reschedule called while running
+    uint8_t Waiting;            // no due time, runs on SCHED_Notify only
+    SCHED_TaskStats Stats;
+    SCHED_Task* Next;           // registry
+};
+
+typedef struct {
+    uint32_t Passes;            // SCHED_RunPending calls
+    uint32_t Sleeps;            // __WFI entered
+    uint32_t SleepMs;           // time spent in SCHED_Idle
+} SCHED_Stats;
+
+// Setup
+void SCHED_Init(void);
+HAL_StatusTypeDef SCHED_InitTickless(TIM_HandleTypeDef* htim, uint32_t hz);
+
+// Tasks
+HAL_StatusTypeDef SCHED_Every(SCHED_Task* task, const char* name, SCHED_TaskFn fn, void* ctx, uint32_t periodMs);
+HAL_StatusTypeDef SCHED_After(SCHED_Task* task, const char* name, SCHED_TaskFn fn, void* ctx, uint32_t delayMs);
+void SCHED_Reschedule(SCHED_Task* task, uint32_t delayMs);
+void SCHED_Cancel(SCHED_Task* task);
+void SCHED_Notify(SCHED_Task* task);
+
+// Main loop
+uint32_t SCHED_RunPending(void);
+void SCHED_Idle(uint32_t ms);
+void SCHED_Step(void);
+void SCHED_Run(void);
+
+// Statistics
+const SCHED_Stats* SCHED_GetStats(void);
+void SCHED_ResetStats(void);
+
+#endif // __SCHED_H
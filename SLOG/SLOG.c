@@ -0,0 +1,234 @@
+/**
+ * @file SLOG.c
+ * @brief Compact binary sample log: sensor readings streamed over a DMA UART.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "SLOG.h"
+
+static SLOG_HandleTypeDef* logs[SLOG_MAX];
+
+// ==== Encoding helpers ====
+
+static inline uint8_t* PutVarint(uint8_t* p, uint32_t v) {
+    while (v >= 0x80U) {
+        *p++ = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Small magnitudes of either sign -> small unsigned values
+static inline uint32_t ZigZag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline void PutU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void PutU32(uint8_t* p, uint32_t v) {
+    PutU16(p, (uint16_t)v);
+    PutU16(p + 2, (uint16_t)(v >> 16));
+}
+
+// ==== Blocks ====
+
+// Start the oldest queued block if the UART is free (main loop or TX complete ISR)
+static void Kick(SLOG_HandleTypeDef* log) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (log->Sending == 0 && log->Queued != 0) {
+        // With both queued, the one to be filled next was closed first
+        uint8_t b = (log->Queued & (1U << log->Fill)) ? log->Fill : (uint8_t)(log->Fill ^ 1U);
+        if (HAL_UART_Transmit_DMA(log->huart, log->Buf[b], log->Size[b]) == HAL_OK) {
+            log->Sending = (uint8_t)(1U << b);
+            log->Queued &= (uint8_t)~(1U << b);
+            log->Bytes += log->Size[b];
+        }
+        // HAL_BUSY: UART used by someone else, retried on the next SLOG call
+    }
+    __set_PRIMASK(primask);
+}
+
+static HAL_StatusTypeDef Open(SLOG_HandleTypeDef* log, uint32_t now) {
+    uint8_t bit = (uint8_t)(1U << log->Fill);
+    if ((log->Sending | log->Queued) & bit) return HAL_BUSY;
+
+    uint8_t* p = log->Buf[log->Fill];
+    uint32_t sinceClock = now - log->ClockTick;
+    p[0] = SLOG_SYNC0;
+    p[1] = SLOG_SYNC1;
+    p[4] = log->Seq;
+    PutU32(&p[5], log->ClockSeconds + sinceClock / 1000U);
+    PutU16(&p[9], (uint16_t)(sinceClock % 1000U));
+
+    log->Len = SLOG_BLOCK_HEADER;
+    log->BaseTick = now;
+    log->LastTick = now;
+    log->Seen = 0;
+    return HAL_OK;
+}
+
+static void Close(SLOG_HandleTypeDef* log) {
+    uint8_t* p = log->Buf[log->Fill];
+    uint16_t len = log->Len;
+
+    PutU16(&p[2], (uint16_t)(len - 4U));
+    PutU16(&p[len], SLOG_Crc16(0xFFFFU, &p[2], len - 2U));
+    log->Size[log->Fill] = (uint16_t)(len + SLOG_BLOCK_CRC);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    log->Queued |= (uint8_t)(1U << log->Fill);
+    __set_PRIMASK(primask);
+
+    log->Fill ^= 1U;
+    log->Len = 0;
+    log->Seq++;
+    log->Blocks++;
+    Kick(log);
+}
+
+// ========== Setup ==========
+
+HAL_StatusTypeDef SLOG_Init(SLOG_HandleTypeDef* log, UART_HandleTypeDef* huart) {
+    if (log == NULL || huart == NULL) return HAL_ERROR;
+
+    *log = (SLOG_HandleTypeDef){0};
+    log->huart = huart;
+
+    for (uint8_t i = 0; i < SLOG_MAX; i++) {
+        if (logs[i] == NULL || logs[i]->huart == huart) {
+            logs[i] = log;
+            return HAL_OK;
+        }
+    }
+    return HAL_ERROR;
+}
+
+void SLOG_DeInit(SLOG_HandleTypeDef* log) {
+    for (uint8_t i = 0; i < SLOG_MAX; i++) {
+        if (logs[i] == log) logs[i] = NULL;
+    }
+}
+
+// 'seconds' since 2000-01-01 now (DS_RTC_ToSeconds); the open block keeps the old base
+void SLOG_SetClock(SLOG_HandleTypeDef* log, uint32_t seconds) {
+    SLOG_Flush(log);
+    log->ClockSeconds = seconds;
+    log->ClockTick = HAL_GetTick();
+}
+
+// ========== Records ==========
+
+HAL_StatusTypeDef SLOG_Add(SLOG_HandleTypeDef* log, uint8_t channel, const int32_t* values, uint8_t count) {
+    if (channel >= SLOG_CHANNELS || values == NULL || count == 0 || count > SLOG_MAX_VALUES) return HAL_ERROR;
+
+    uint32_t now = HAL_GetTick();
+    if (log->Len && now - log->BaseTick >= SLOG_MAX_AGE_MS) Close(log);
+    else if (log->Queued) Kick(log);
+
+    if (log->Len == 0 && Open(log, now) != HAL_OK) {
+        log->Dropped++;
+        return HAL_BUSY;
+    }
+
+    uint8_t* start = &log->Buf[log->Fill][log->Len];
+    uint8_t* p = start + 1;
+    uint16_t bit = (uint16_t)(1U << channel);
+    int32_t* prev = log->Prev[channel];
+    uint8_t head = (uint8_t)(channel | ((count - 1U) << SLOG_HEAD_COUNT_POS));
+
+    p = PutVarint(p, now - log->LastTick);
+    if (log->Seen & bit) {
+        for (uint8_t i = 0; i < count; i++) {
+            p = PutVarint(p, ZigZag((int32_t)((uint32_t)values[i] - (uint32_t)prev[i])));
+            prev[i] = values[i];
+        }
+    } else {
+        head |= SLOG_HEAD_ABS;
+        for (uint8_t i = 0; i < count; i++) {
+            p = PutVarint(p, ZigZag(values[i]));
+            prev[i] = values[i];
+        }
+        log->Seen |= bit;
+    }
+    *start = head;
+
+    log->Len = (uint16_t)(log->Len + (p - start));
+    log->LastTick = now;
+    log->Records++;
+
+    // Send as soon as a worst-case record would not fit
+    if (log->Len + SLOG_RECORD_MAX > SLOG_BLOCK_SIZE - SLOG_BLOCK_CRC) Close(log);
+    return HAL_OK;
+}
+
+// Send the open block now (periodic task, before sleeping or a reset)
+void SLOG_Flush(SLOG_HandleTypeDef* log) {
+    if (log->Len) Close(log);
+    else Kick(log);
+}
+
+uint8_t SLOG_IsIdle(const SLOG_HandleTypeDef* log) {
+    return log->Len == 0 && log->Sending == 0 && log->Queued == 0;
+}
+
+// ========== UART callback ==========
+
+void SLOG_TxCpltCallback(UART_HandleTypeDef* huart) {
+    for (uint8_t i = 0; i < SLOG_MAX; i++) {
+        if (logs[i] && logs[i]->huart == huart) {
+            logs[i]->Sending = 0;
+            Kick(logs[i]);
+        }
+    }
+}
+
+#if SLOG_HAL_CALLBACKS
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { SLOG_TxCpltCallback(huart); }
+#endif
+
+/*
+=================================== How to USE ==========================================
+
+# 1. Setup: UART TX with a DMA channel (CubeMX: USART1, DMA1 channel 4, 921600 baud)
+
+SLOG_HandleTypeDef slog;
+
+SLOG_Init(&slog, &huart1);
+DS_RTC_ReadTime(&rtc, &time);
+SLOG_SetClock(&slog, DS_RTC_ToSeconds(&time));   // again once a day to follow the RTC
+
+# 2. Log integer readings, the call never waits for the UART
+
+int16_t t, h;
+if (DHT22_ReadInt(&dht, &t, &h) == DHT22_OK) {
+    int32_t v[2] = { t, h };
+    SLOG_Add(&slog, SLOG_CH_DHT22, v, 2);
+}
+
+int32_t mm = HCSR04_ReadDistanceMm(&sonar);
+SLOG_Add(&slog, SLOG_CH_HCSR04, &mm, 1);
+
+SLOG_Add(&slog, SLOG_CH_USER + 0, &myValue, 1);  // own channels from SLOG_CH_USER
+
+# 3. Keep the latency bounded when samples are rare
+
+SCHED_Every(&flushTask, "slog", FlushTask, NULL, SLOG_MAX_AGE_MS);   // calls SLOG_Flush(&slog)
+
+# 4. On the PC
+
+slog_decode capture.bin > samples.csv
+    time,channel,values
+    2025-05-14 12:34:56.000,dht22,25.1,65.2
+    2025-05-14 12:34:56.060,hc_sr04,1000
+
+*/
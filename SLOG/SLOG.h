@@ -0,0 +1,102 @@
+/**
+ * @file SLOG.h
+ * @brief Compact binary sample log: sensor readings streamed over a DMA UART.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Logging readings as sprintf text with a blocking HAL_UART_Transmit costs ~40 bytes
+ * per sample and holds the main loop for the whole line (3.5 ms at 115200 baud).
+ * SLOG packs each reading into a few bytes (format in SLOG_FORMAT.h):
+ * - time: one wall-clock base per block (RTC seconds + ms), then the ms since the
+ *   previous record as a varint;
+ * - values: integers (the drivers' integer readings), zigzag varints, as the change
+ *   from the previous record of the same channel;
+ * - blocks of SLOG_BLOCK_SIZE bytes closed by a CRC-16, each decodable on its own.
+ *
+ * Records are encoded straight into one of two block buffers. A full block goes out
+ * with HAL_UART_Transmit_DMA while the next one fills; SLOG_Add never waits for the
+ * UART: with both buffers taken the record is dropped and counted.
+ *
+ * Notes:
+ * - SLOG_SetClock ties the HAL tick to the RTC (DS_RTC_ToSeconds); without it the
+ *   times count from power-up.
+ * - A block also goes out when its first record is SLOG_MAX_AGE_MS old (checked on
+ *   SLOG_Add) or on SLOG_Flush: call it from a periodic task when samples are rare.
+ * - SLOG implements HAL_UART_TxCpltCallback. If the application needs it for another
+ *   UART, build with SLOG_HAL_CALLBACKS=0 and call SLOG_TxCpltCallback from its own.
+ * - On the PC, slog_decode turns the stream into CSV.
+ */
+
+
+
+#ifndef __SLOG_H
+#define __SLOG_H
+
+#include "stm32f1xx_hal.h"
+#include "SLOG_FORMAT.h"
+
+// Block size, header and CRC included (one DMA transfer)
+#ifndef SLOG_BLOCK_SIZE
+#define SLOG_BLOCK_SIZE 256
+#endif
+
+// Channels with delta encoding (ids 0 .. SLOG_CHANNELS-1), 16 bytes of RAM each
+#ifndef SLOG_CHANNELS
+#define SLOG_CHANNELS 8
+#endif
+
+// Oldest record a block may hold before it is sent
+#ifndef SLOG_MAX_AGE_MS
+#define SLOG_MAX_AGE_MS 1000
+#endif
+
+#ifndef SLOG_HAL_CALLBACKS
+#define SLOG_HAL_CALLBACKS 1
+#endif
+
+#define SLOG_MAX 2   // logs (UARTs) at the same time
+
+#define SLOG_RECORD_MAX (1U + 5U + SLOG_MAX_VALUES * 5U)   // head + dt + values, worst case
+
+typedef struct {
+    UART_HandleTypeDef* huart;
+
+    // Double buffer: one block fills while the other is on the wire
+    uint8_t Buf[2][SLOG_BLOCK_SIZE];
+    uint16_t Size[2];                   // bytes of a closed block
+    uint16_t Len;                       // bytes in the block being filled, 0 = none open
+    uint8_t Fill;                       // buffer being filled
+    volatile uint8_t Sending;           // bit per buffer: owned by the DMA
+    volatile uint8_t Queued;            // bit per buffer: closed, waiting for the UART
+    uint8_t Seq;
+
+    // Time base
+    uint32_t BaseTick;                  // HAL tick of the first record of the block
+    uint32_t LastTick;                  // HAL tick of the previous record
+    uint32_t ClockSeconds;              // RTC seconds at ClockTick
+    uint32_t ClockTick;
+
+    // Delta state of the open block
+    uint16_t Seen;                      // bit per channel: absolute values written
+    int32_t Prev[SLOG_CHANNELS][SLOG_MAX_VALUES];
+
+    // Statistics
+    uint32_t Records;
+    uint32_t Blocks;
+    uint32_t Bytes;                     // handed to the UART
+    uint32_t Dropped;                   // records lost: both buffers busy
+} SLOG_HandleTypeDef;
+
+HAL_StatusTypeDef SLOG_Init(SLOG_HandleTypeDef* log, UART_HandleTypeDef* huart);
+void SLOG_DeInit(SLOG_HandleTypeDef* log);
+void SLOG_SetClock(SLOG_HandleTypeDef* log, uint32_t seconds);
+
+HAL_StatusTypeDef SLOG_Add(SLOG_HandleTypeDef* log, uint8_t channel, const int32_t* values, uint8_t count);
+void SLOG_Flush(SLOG_HandleTypeDef* log);
+uint8_t SLOG_IsIdle(const SLOG_HandleTypeDef* log);
+
+// Hook for applications that keep the HAL callback (SLOG_HAL_CALLBACKS=0)
+void SLOG_TxCpltCallback(UART_HandleTypeDef* huart);
+
+#endif // __SLOG_H
@@ -0,0 +1,67 @@
+/**
+ * @file SLOG_FORMAT.h
+ * @brief Stream format of the sample log, shared by the firmware and slog_decode.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * The stream is a sequence of self-contained blocks, little endian:
+ *
+ *   A5 5A          sync
+ *   len    u16     bytes from 'seq' to the last record
+ *   seq    u8      block counter (a gap = blocks lost)
+ *   sec    u32     wall time of the first record: seconds since 2000-01-01 (RTC)
+ *   ms     u16     + milliseconds
+ *   records
+ *   crc    u16     CRC-16/CCITT-FALSE from 'len' to the last record
+ *
+ * One record:
+ *
+ *   head   u8      channel (bits 0-3) | value count - 1 (bits 4-5) | SLOG_HEAD_ABS
+ *   dt     varint  ms since the previous record of the block (first one: 0)
+ *   values varint  zigzag; SLOG_HEAD_ABS: the values, else the difference with the
+ *                  previous record of the same channel in the block
+ *
+ * A DHT22 reading (2 values) takes 4 bytes, an HC-SR04 range 3-4 bytes.
+ */
+
+
+
+#ifndef __SLOG_FORMAT_H
+#define __SLOG_FORMAT_H
+
+#include <stdint.h>
+
+#define SLOG_SYNC0          0xA5U
+#define SLOG_SYNC1          0x5AU
+#define SLOG_BLOCK_HEADER   11U     // sync + len + seq + sec + ms
+#define SLOG_BLOCK_CRC      2U
+#define SLOG_MAX_VALUES     4U      // values per record
+#define SLOG_MAX_CHANNELS   16U     // channel ids the format can carry
+
+#define SLOG_HEAD_CHANNEL   0x0FU
+#define SLOG_HEAD_COUNT_POS 4U
+#define SLOG_HEAD_ABS       0x80U
+
+// Channels of the library drivers; the application numbers its own from SLOG_CH_USER
+typedef enum {
+    SLOG_CH_DHT22,          // temperature 0.1 degC, humidity 0.1 %RH (DHT22_ReadInt)
+    SLOG_CH_HCSR04,         // distance mm (HCSR04_ReadDistanceMm)
+    SLOG_CH_RTC_TEMP,       // temperature 0.25 degC (DS_RTC_GetTemperatureQ)
+    SLOG_CH_USER
+} SLOG_Channel;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), 4 bits per step: 32-byte table
+static inline uint16_t SLOG_Crc16(uint16_t crc, const uint8_t* data, uint32_t len) {
+    static const uint16_t nibble[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    for (uint32_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 4) ^ nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ nibble[(crc >> 12) ^ (data[i] & 0x0FU)]);
+    }
+    return crc;
+}
+
+#endif // __SLOG_FORMAT_H
@@ -0,0 +1,206 @@
+/**
+ * @file slog_decode.c
+ * @brief PC tool: turns a capture of the SLOG stream into CSV.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ *   slog_decode <capture.bin> [--raw] > samples.csv
+ *
+ * - One line per record: time,channel,values. The library channels are scaled to
+ *   their units (degC, %RH, mm); --raw prints the integers as logged.
+ * - The capture may start or stop mid-block: the decoder looks for the sync bytes,
+ *   checks the length and the CRC, and skips what does not pass. A gap in the block
+ *   counter is reported as lost blocks (UART overrun, dropped by the capture...).
+ * - Summary on stderr; exit code 1 when a block was corrupted or cut.
+ *
+ * Built on the PC only: it shares SLOG_FORMAT.h with the target, nothing else.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SLOG_FORMAT.h"
+
+#define MIN_LEN 7U      // seq + sec + ms, no record
+
+typedef struct {
+    unsigned long Blocks, Records, Lost, Bad, Skipped;
+} Summary;
+
+static int raw;
+static Summary sum;
+static int32_t prev[SLOG_MAX_CHANNELS][SLOG_MAX_VALUES];
+
+static uint32_t GetU16(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+static uint32_t GetU32(const uint8_t* p) { return GetU16(p) | (GetU16(p + 2) << 16); }
+
+// 0 when the varint runs past 'end'
+static int GetVarint(const uint8_t** p, const uint8_t* end, uint32_t* v) {
+    uint32_t shift = 0;
+    *v = 0;
+    while (*p < end && shift < 35) {
+        uint8_t b = *(*p)++;
+        *v |= (uint32_t)(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0) return 1;
+        shift += 7;
+    }
+    return 0;
+}
+
+static int32_t UnZigZag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1U);
+}
+
+// Seconds since 2000-01-01 + ms -> "YYYY-MM-DD hh:mm:ss.mmm"
+static void FormatTime(char* buf, uint64_t ms) {
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint32_t sec = (uint32_t)(ms / 1000U);
+    uint32_t day = sec / 86400U;
+    uint32_t year = 2000, month = 0;
+
+    for (;;) {
+        uint32_t len = (year % 4U == 0) ? 366U : 365U;     // 2000-2099, as the RTC
+        if (day < len) break;
+        day -= len;
+        year++;
+    }
+    for (;;) {
+        uint32_t len = days[month] + ((month == 1 && year % 4U == 0) ? 1U : 0U);
+        if (day < len) break;
+        day -= len;
+        month++;
+    }
+    sprintf(buf, "%04lu-%02lu-%02lu %02lu:%02lu:%02lu.%03lu", (unsigned long)year, (unsigned long)month + 1,
+            (unsigned long)day + 1, (unsigned long)(sec / 3600U % 24U), (unsigned long)(sec / 60U % 60U),
+            (unsigned long)(sec % 60U), (unsigned long)(ms % 1000U));
+}
+
+static void PrintRecord(uint64_t ms, uint8_t channel, const int32_t* v, uint8_t count) {
+    char time[32];
+    FormatTime(time, ms);
+
+    if (raw || channel >= SLOG_CH_USER) {
+        if (channel >= SLOG_CH_USER) printf("%s,user_%u", time, (unsigned)(channel - SLOG_CH_USER));
+        else printf("%s,ch_%u", time, (unsigned)channel);
+        for (uint8_t i = 0; i < count; i++) printf(",%ld", (long)v[i]);
+        printf("\n");
+        return;
+    }
+    switch (channel) {
+        case SLOG_CH_DHT22:
+            printf("%s,dht22,%.1f", time, v[0] / 10.0);
+            if (count > 1) printf(",%.1f", v[1] / 10.0);
+            break;
+        case SLOG_CH_HCSR04:
+            printf("%s,hc_sr04,%ld", time, (long)v[0]);
+            break;
+        case SLOG_CH_RTC_TEMP:
+            printf("%s,rtc_temp,%.2f", time, v[0] / 4.0);
+            break;
+    }
+    printf("\n");
+}
+
+// Records of one block whose length and CRC passed; 0 if they do not parse
+static int DecodeBlock(const uint8_t* p, uint32_t len) {
+    const uint8_t* end = p + 4 + len;
+    uint64_t ms = (uint64_t)GetU32(&p[5]) * 1000U + GetU16(&p[9]);
+    uint32_t seen = 0;
+    p += SLOG_BLOCK_HEADER;
+
+    while (p < end) {
+        uint8_t head = *p++;
+        uint8_t channel = head & SLOG_HEAD_CHANNEL;
+        uint8_t count = (uint8_t)(((head >> SLOG_HEAD_COUNT_POS) & 0x03U) + 1U);
+        int32_t v[SLOG_MAX_VALUES];
+        uint32_t x;
+
+        if (!GetVarint(&p, end, &x)) return 0;
+        ms += x;
+        if (!(head & SLOG_HEAD_ABS) && !(seen & (1U << channel))) return 0;   // delta without a base
+        for (uint8_t i = 0; i < count; i++) {
+            if (!GetVarint(&p, end, &x)) return 0;
+            int32_t d = UnZigZag(x);
+            v[i] = (head & SLOG_HEAD_ABS) ? d : (int32_t)((uint32_t)prev[channel][i] + (uint32_t)d);
+            prev[channel][i] = v[i];
+        }
+        seen |= 1U << channel;
+        PrintRecord(ms, channel, v, count);
+        sum.Records++;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--raw") == 0) raw = 1;
+        else path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s <capture.bin> [--raw]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* data = malloc(size > 0 ? (size_t)size : 1U);
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "%s: read error\n", path);
+        fclose(f);
+        free(data);
+        return 2;
+    }
+    fclose(f);
+
+    printf("time,channel,values\n");
+
+    uint32_t pos = 0, n = (uint32_t)size;
+    int haveSeq = 0, cut = 0;
+    uint8_t nextSeq = 0;
+
+    while (pos + SLOG_BLOCK_HEADER + SLOG_BLOCK_CRC <= n) {
+        const uint8_t* p = &data[pos];
+        if (p[0] != SLOG_SYNC0 || p[1] != SLOG_SYNC1) {
+            pos++;
+            sum.Skipped++;
+            continue;
+        }
+        uint32_t len = GetU16(&p[2]);
+        uint32_t total = 4U + len + SLOG_BLOCK_CRC;
+        if (len < MIN_LEN || pos + total > n) {
+            if (len >= MIN_LEN && len < 0x8000U) {
+                cut = 1;     // plausible block cut by the end of the capture
+                break;
+            }
+            pos++;
+            sum.Skipped++;
+            continue;
+        }
+        if (SLOG_Crc16(0xFFFFU, &p[2], 2U + len) != GetU16(&p[4 + len]) || !DecodeBlock(p, len)) {
+            sum.Bad++;
+            pos++;          // not a block after all, or a corrupted one: look further
+            sum.Skipped++;
+            continue;
+        }
+
+        if (haveSeq && p[4] != nextSeq) sum.Lost += (uint8_t)(p[4] - nextSeq);
+        nextSeq = (uint8_t)(p[4] + 1U);
+        haveSeq = 1;
+        sum.Blocks++;
+        pos += total;
+    }
+    if (!cut) sum.Skipped += n - pos;
+    free(data);
+
+    fprintf(stderr, "slog: %lu blocks, %lu records, %lu lost blocks, %lu bad blocks, %lu bytes skipped%s\n",
+            sum.Blocks, sum.Records, sum.Lost, sum.Bad, sum.Skipped, cut ? ", last block cut" : "");
+    return (sum.Bad || cut) ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file TIMING.c
+ * @brief Calibrated short-delay and time measurement service shared by the drivers.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "TIMING.h"
+
+// ==== Time base state ====
+static TIMING_Source source = TIMING_SOURCE_NONE;
+static uint32_t tickHz;
+static uint32_t ticksPerUs;
+static uint32_t ticksPerNsQ32;   // ticks per ns, 32-bit fraction, rounded up
+static uint32_t readOverhead;    // ticks spent by one TIMING_Now() (calibrated at init)
+static uint32_t granule;         // 1 when a tick is coarse enough to be partly gone at start
+
+// Timer fallback: 16-bit counter extended in software
+static TIM_HandleTypeDef* timHandle;
+static uint16_t timLast;
+static uint32_t timHigh;
+
+static inline uint32_t ReadCycles(void) {
+#ifdef HAL_SIM
+    return HAL_SIM_DWT_ReadCycles();
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+static uint32_t ReadTim(void) {
+    uint16_t cnt = (uint16_t)__HAL_TIM_GET_COUNTER(timHandle);
+    if (cnt < timLast) timHigh += 0x10000U;
+    timLast = cnt;
+    return timHigh | cnt;
+}
+
+static uint32_t ReadTicks(void) {
+    if (source == TIMING_SOURCE_DWT) return ReadCycles();
+    if (source == TIMING_SOURCE_TIM) return ReadTim();
+    return HAL_GetTick();
+}
+
+// Scale factors and read overhead for the selected tick rate
+static HAL_StatusTypeDef SetRate(uint32_t hz) {
+    if (hz < 1000000U || (hz % 1000000U) != 0) return HAL_ERROR;
+
+    tickHz = hz;
+    ticksPerUs = hz / 1000000U;
+    granule = (source == TIMING_SOURCE_DWT) ? 0 : 1;
+    ticksPerNsQ32 = (uint32_t)((((uint64_t)ticksPerUs << 32) + 999U) / 1000U);
+
+    uint32_t t0 = ReadTicks();
+    uint32_t t1 = ReadTicks();
+    readOverhead = t1 - t0;
+    return HAL_OK;
+}
+
+static inline void EnsureInit(void) {
+    if (source == TIMING_SOURCE_NONE) TIMING_Init();
+}
+
+// ========== Source selection ==========
+
+// DWT cycle counter: 1 tick = 1 CPU cycle. Call again after changing SYSCLK.
+HAL_StatusTypeDef TIMING_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Some debug setups keep the counter stopped, check that it really runs
+    uint32_t start = ReadCycles();
+    for (volatile uint8_t i = 0; i < 4; i++) {
+        __NOP();
+    }
+    if (ReadCycles() == start) {
+        source = TIMING_SOURCE_TICK;
+        tickHz = 1000U;
+        ticksPerUs = 0;
+        readOverhead = 0;
+        granule = 1;
+        return HAL_ERROR;
+    }
+
+    source = TIMING_SOURCE_DWT;
+    return SetRate(SystemCoreClock);
+}
+
+// Fallback on a timer already configured as 16-bit up-counter (Period 0xFFFF) at 'hz'
+HAL_StatusTypeDef TIMING_InitTim(TIM_HandleTypeDef* htim, uint32_t hz) {
+    if (htim == NULL) return HAL_ERROR;
+
+    timHandle = htim;
+    HAL_TIM_Base_Start(htim);
+    timLast = (uint16_t)__HAL_TIM_GET_COUNTER(htim);
+    timHigh = 0;
+
+    source = TIMING_SOURCE_TIM;
+    if (SetRate(hz) != HAL_OK) {
+        source = TIMING_SOURCE_NONE;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+TIMING_Source TIMING_GetSource(void) {
+    return source;
+}
+
+uint32_t TIMING_GetTickHz(void) {
+    EnsureInit();
+    return tickHz;
+}
+
+// ========== Raw ticks ==========
+
+uint32_t TIMING_Now(void) {
+    EnsureInit();
+    return ReadTicks();
+}
+
+// Wrap-safe as long as less than 2^32 ticks have passed
+uint32_t TIMING_Elapsed(uint32_t since) {
+    return TIMING_Now() - since;
+}
+
+// Conversions round up and add one tick on coarse sources, so waits are never short
+static inline uint32_t UsToMsTicks(uint32_t us) {
+    return (us + 999U) / 1000U + granule;
+}
+
+uint32_t TIMING_NsToTicks(uint32_t ns) {
+    EnsureInit();
+    if (source == TIMING_SOURCE_TICK) return UsToMsTicks((ns + 999U) / 1000U);
+    return (uint32_t)(((uint64_t)ns * ticksPerNsQ32 + 0xFFFFFFFFU) >> 32) + granule;
+}
+
+uint32_t TIMING_UsToTicks(uint32_t us) {
+    EnsureInit();
+    if (source == TIMING_SOURCE_TICK) return UsToMsTicks(us);
+    return us * ticksPerUs + granule;
+}
+
+uint32_t TIMING_TicksToNs(uint32_t ticks) {
+    EnsureInit();
+    if (source == TIMING_SOURCE_TICK) return ticks * 1000000U;
+    return (uint32_t)((uint64_t)ticks * 1000U / ticksPerUs);
+}
+
+// ========== Delays ==========
+
+// Busy-wait at least 'ticks'; the cost of the first read is already part of the wait
+void TIMING_DelayTicks(uint32_t ticks) {
+    EnsureInit();
+    if (ticks <= readOverhead) return;
+    ticks -= readOverhead;
+
+    uint32_t start = ReadTicks();
+    while ((uint32_t)(ReadTicks() - start) < ticks) {
+    }
+}
+
+void TIMING_DelayNs(uint32_t ns) {
+    TIMING_DelayTicks(TIMING_NsToTicks(ns));
+}
+
+void TIMING_DelayUs(uint32_t us) {
+    TIMING_DelayTicks(TIMING_UsToTicks(us));
+}
+
+// ========== Deadlines ==========
+
+void TIMING_DeadlineNs(TIMING_Deadline* d, uint32_t ns) {
+    d->Ticks = TIMING_NsToTicks(ns);
+    d->Start = TIMING_Now();
+}
+
+void TIMING_DeadlineUs(TIMING_Deadline* d, uint32_t us) {
+    d->Ticks = TIMING_UsToTicks(us);
+    d->Start = TIMING_Now();
+}
+
+uint8_t TIMING_DeadlineExpired(const TIMING_Deadline* d) {
+    return TIMING_Elapsed(d->Start) >= d->Ticks;
+}
+
+uint32_t TIMING_DeadlineRemaining(const TIMING_Deadline* d) {
+    uint32_t elapsed = TIMING_Elapsed(d->Start);
+    return (elapsed >= d->Ticks) ? 0 : d->Ticks - elapsed;
+}
+
+void TIMING_DeadlineWait(const TIMING_Deadline* d) {
+    while (!TIMING_DeadlineExpired(d)) {
+    }
+}
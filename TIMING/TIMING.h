@@ -0,0 +1,73 @@
+/**
+ * @file TIMING.h
+ * @brief Calibrated short-delay and time measurement service shared by the drivers.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * One time base for every driver that needs sub-millisecond timing:
+ * - DWT cycle counter of the Cortex-M3 (default, 1 tick = 1 CPU cycle),
+ * - or a free-running hardware timer as fallback (parts / debug setups without DWT).
+ *
+ * Provides:
+ * - TIMING_DelayNs / TIMING_DelayUs: busy-wait at least the requested time,
+ *   independent of clock speed, optimisation level or build.
+ * - TIMING_Deadline: start a time budget now, poll it later.
+ * - TIMING_Now / TIMING_Elapsed: raw tick stamps for measuring code.
+ *
+ * Notes:
+ * - Delay conversions use scale factors computed once at init, no division.
+ * - Tick rates must be whole MHz (any SYSCLK setting of the F1, a 1 MHz timer...).
+ * - The timer fallback extends a 16-bit counter in software; use it from thread
+ *   context only. The DWT source can be used from anywhere.
+ * - If no source was selected, the first call initialises the DWT source. If the
+ *   cycle counter does not run, the HAL tick is used: still never shorter than
+ *   asked, but rounded up to whole milliseconds.
+ */
+
+
+
+#ifndef __TIMING_H
+#define __TIMING_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+typedef enum {
+    TIMING_SOURCE_NONE = 0,
+    TIMING_SOURCE_DWT,
+    TIMING_SOURCE_TIM,
+    TIMING_SOURCE_TICK     // last resort: HAL tick, 1 ms resolution, delays rounded up
+} TIMING_Source;
+
+typedef struct {
+    uint32_t Start;    // tick stamp when the deadline was armed
+    uint32_t Ticks;    // budget in ticks
+} TIMING_Deadline;
+
+// Source selection
+HAL_StatusTypeDef TIMING_Init(void);
+HAL_StatusTypeDef TIMING_InitTim(TIM_HandleTypeDef* htim, uint32_t tickHz);
+TIMING_Source TIMING_GetSource(void);
+uint32_t TIMING_GetTickHz(void);
+
+// Raw ticks
+uint32_t TIMING_Now(void);
+uint32_t TIMING_Elapsed(uint32_t since);
+uint32_t TIMING_NsToTicks(uint32_t ns);
+uint32_t TIMING_UsToTicks(uint32_t us);
+uint32_t TIMING_TicksToNs(uint32_t ticks);
+
+// Busy-wait delays
+void TIMING_DelayTicks(uint32_t ticks);
+void TIMING_DelayNs(uint32_t ns);
+void TIMING_DelayUs(uint32_t us);
+
+// Deadlines (up to 2^32 ticks, ~59 s at 72 MHz)
+void TIMING_DeadlineNs(TIMING_Deadline* d, uint32_t ns);
+void TIMING_DeadlineUs(TIMING_Deadline* d, uint32_t us);
+uint8_t TIMING_DeadlineExpired(const TIMING_Deadline* d);
+uint32_t TIMING_DeadlineRemaining(const TIMING_Deadline* d);
+void TIMING_DeadlineWait(const TIMING_Deadline* d);
+
+#endif // __TIMING_H
@@ -10,7 +10,8 @@
  * colon (dot) toggling, and display clearing.
  * 
  * Notes:
- * * TM1637 requires specific timing between CLK and DIO signals; delays are implemented via NOPs.
+ * * TM1637 requires specific timing between CLK and DIO signals; delays come from the TIMING service.
+ * * Define TM1637_FAST_GPIO=1 to drive the pins through BSRR instead of HAL_GPIO_WritePin.
  * * Ensure proper GPIO configuration before calling any TM1637 functions.
  * * The display supports digits 09 and some characters (limited by segment map).
  
@@ -20,6 +21,7 @@
 
 
 #include "TM1637.h"
+#include "TIMING.h"
 
 static const uint8_t digitToSegment[] = {
     0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07,
@@ -27,48 +29,69 @@ static const uint8_t digitToSegment[] = {
     0x3E, 0x38, 0x76, 0x40, 0x00
 };
 
-static void TM1637_Delay(void) {
-    for (volatile int i = 0; i < 80; i++) {
-        __NOP();
+// One third of a bit period: 3 x TM1637_DELAY_NS per CLK cycle
+static inline void TM1637_Delay(void) {
+    TIMING_DelayNs(TM1637_DELAY_NS);
+}
+
+#if TM1637_FAST_GPIO
+#define CLK_WRITE(tm, lvl)  GPIO_FAST_Write(&(tm)->clk, (lvl))
+#define DIO_WRITE(tm, lvl)  GPIO_FAST_Write(&(tm)->dio, (lvl))
+
+// Drive CLK and DIO to the same level, in one store when they share a port
+static void TM1637_WriteBoth(TM1637_Handle* tm, uint8_t level) {
+    if (tm->samePort) {
+        GPIO_FAST_WriteBSRR(tm->clk.Port, level ? (tm->clk.SetMask | tm->dio.SetMask)
+                                                : (tm->clk.ResetMask | tm->dio.ResetMask));
+    } else {
+        CLK_WRITE(tm, level);
+        DIO_WRITE(tm, level);
     }
 }
+#else
+#define CLK_WRITE(tm, lvl)  HAL_GPIO_WritePin((tm)->CLK_Port, (tm)->CLK_Pin, (lvl) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+#define DIO_WRITE(tm, lvl)  HAL_GPIO_WritePin((tm)->DIO_Port, (tm)->DIO_Pin, (lvl) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+
+static void TM1637_WriteBoth(TM1637_Handle* tm, uint8_t level) {
+    CLK_WRITE(tm, level);
+    DIO_WRITE(tm, level);
+}
+#endif
 
 static void TM1637_Start(TM1637_Handle* tm) {
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_SET);
-    HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, GPIO_PIN_SET);
+    TM1637_WriteBoth(tm, 1);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, GPIO_PIN_RESET);
+    DIO_WRITE(tm, 0);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_RESET);
+    CLK_WRITE(tm, 0);
 }
 
 static void TM1637_Stop(TM1637_Handle* tm) {
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, GPIO_PIN_RESET);
+    TM1637_WriteBoth(tm, 0);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_SET);
+    CLK_WRITE(tm, 1);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, GPIO_PIN_SET);
+    DIO_WRITE(tm, 1);
 }
 
 static void TM1637_WriteByte(TM1637_Handle* tm, uint8_t b) {
     for (int i = 0; i < 8; i++) {
-        HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_RESET);
+        CLK_WRITE(tm, 0);
         TM1637_Delay();
-        HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, (b & 0x01) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+        DIO_WRITE(tm, b & 0x01);
         b >>= 1;
         TM1637_Delay();
-        HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_SET);
+        CLK_WRITE(tm, 1);
         TM1637_Delay();
     }
 
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_RESET);
+    CLK_WRITE(tm, 0);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->DIO_Port, tm->DIO_Pin, GPIO_PIN_SET);
+    DIO_WRITE(tm, 1);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_SET);
+    CLK_WRITE(tm, 1);
     TM1637_Delay();
-    HAL_GPIO_WritePin(tm->CLK_Port, tm->CLK_Pin, GPIO_PIN_RESET);
+    CLK_WRITE(tm, 0);
 }
 
 void TM1637_Init(TM1637_Handle* tm, GPIO_TypeDef* clk_port, uint16_t clk_pin,
@@ -78,6 +101,11 @@ void TM1637_Init(TM1637_Handle* tm, GPIO_TypeDef* clk_port, uint16_t clk_pin,
     tm->DIO_Port = dio_port;
     tm->DIO_Pin = dio_pin;
     tm->colonOn = false;
+#if TM1637_FAST_GPIO
+    GPIO_FAST_Init(&tm->clk, clk_port, clk_pin);
+    GPIO_FAST_Init(&tm->dio, dio_port, dio_pin);
+    tm->samePort = (clk_port == dio_port);
+#endif
     TM1637_Clear(tm);
 }
 
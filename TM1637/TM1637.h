@@ -20,12 +20,32 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// 1 = drive CLK/DIO through BSRR directly instead of HAL_GPIO_WritePin
+#ifndef TM1637_FAST_GPIO
+#define TM1637_FAST_GPIO 0
+#endif
+
+// Half-phase delay of the bit-banged bus; 3 per bit -> 4.2 us, below the 250 kHz max CLK.
+// Raise it for modules with large RC filters on CLK/DIO.
+#ifndef TM1637_DELAY_NS
+#define TM1637_DELAY_NS 1400
+#endif
+
+#if TM1637_FAST_GPIO
+#include "GPIO_FAST.h"
+#endif
+
 typedef struct {
     GPIO_TypeDef* CLK_Port;
     uint16_t CLK_Pin;
     GPIO_TypeDef* DIO_Port;
     uint16_t DIO_Pin;
     bool colonOn;
+#if TM1637_FAST_GPIO
+    GPIO_FAST_Pin clk;
+    GPIO_FAST_Pin dio;
+    bool samePort;      // CLK and DIO can change in one BSRR store
+#endif
 } TM1637_Handle;
 
 void TM1637_Init(TM1637_Handle* tm, GPIO_TypeDef* clk_port, uint16_t clk_pin,
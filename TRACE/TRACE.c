@@ -0,0 +1,119 @@
+/**
+ * @file TRACE.c
+ * @brief Lock-free flight recorder for the drivers' hot paths.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ */
+
+
+
+#include "TRACE.h"
+
+#if (TRACE_BUF_SIZE & (TRACE_BUF_SIZE - 1)) != 0
+#error "TRACE_BUF_SIZE must be a power of two"
+#endif
+
+static TRACE_Rec ring[TRACE_BUF_SIZE];
+static volatile uint32_t head;       // records claimed since the last clear
+static volatile uint8_t running;
+
+static inline uint32_t ReadCycles(void) {
+#ifdef HAL_SIM
+    return HAL_SIM_DWT_ReadCycles();
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+// Cycle counter on, ring empty, recording
+void TRACE_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    TRACE_Clear();
+    TRACE_Start();
+}
+
+void TRACE_Start(void) {
+    running = 1;
+}
+
+void TRACE_Stop(void) {
+    running = 0;
+}
+
+void TRACE_Clear(void) {
+    head = 0;
+}
+
+// ISR safe: claim a slot atomically, then fill it; the oldest record is overwritten
+void TRACE_Record(uint16_t tag, uint16_t arg) {
+    if (!running) return;
+
+    uint32_t slot = __atomic_fetch_add(&head, 1U, __ATOMIC_RELAXED) & (TRACE_BUF_SIZE - 1U);
+    TRACE_Rec* r = &ring[slot];
+    r->Cycles = ReadCycles();
+    r->Arg = arg;
+    r->Tag = tag;
+}
+
+uint32_t TRACE_Count(void) {
+    return (head < TRACE_BUF_SIZE) ? head : TRACE_BUF_SIZE;
+}
+
+// Stop, send header + records oldest first, resume; returns the records sent
+uint32_t TRACE_Dump(TRACE_WriteFn write, void* ctx) {
+    uint8_t wasRunning = running;
+    running = 0;
+
+    uint32_t total = head;
+    TRACE_Header hdr = {
+        .Magic = { TRACE_MAGIC[0], TRACE_MAGIC[1], TRACE_MAGIC[2], TRACE_MAGIC[3] },
+        .CoreClockHz = SystemCoreClock,
+        .Count = TRACE_Count(),
+        .Lost = total - TRACE_Count(),
+    };
+    write(ctx, (const uint8_t*)&hdr, sizeof(hdr));
+
+    for (uint32_t i = total - hdr.Count; i != total; i++) {
+        write(ctx, (const uint8_t*)&ring[i & (TRACE_BUF_SIZE - 1U)], sizeof(TRACE_Rec));
+    }
+
+    running = wasRunning;
+    return hdr.Count;
+}
+
+// SWO / ITM stimulus port 0 (enable it in the debugger, e.g. CubeIDE SWV console)
+void TRACE_WriteSwo(void* ctx, const uint8_t* data, uint16_t len) {
+    (void)ctx;
+    for (uint16_t i = 0; i < len; i++) {
+        ITM_SendChar(data[i]);
+    }
+}
+
+/*
+=================================== How to USE ==========================================
+
+# 1. Build with TRACE_ENABLED=1 (Project > Properties > C/C++ Build > Settings > Symbols)
+
+# 2. Start recording in main()
+
+    TRACE_Init();
+
+# 3. Dump when something went wrong, over SWO ...
+
+    TRACE_Dump(TRACE_WriteSwo, NULL);
+
+#    ... or over a UART
+
+    void UartWrite(void* ctx, const uint8_t* data, uint16_t len) {
+        HAL_UART_Transmit((UART_HandleTypeDef*)ctx, (uint8_t*)data, len, HAL_MAX_DELAY);
+    }
+    TRACE_Dump(UartWrite, &huart1);
+
+# 4. On the PC: save the bytes to a file and decode
+
+    trace_decode dump.bin              // latency histograms + event counts
+    trace_decode dump.bin --timeline   // every record with its time
+
+*/
@@ -0,0 +1,62 @@
+/**
+ * @file TRACE.h
+ * @brief Lock-free flight recorder for the drivers' hot paths.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Drivers mark API enter/exit and interesting events (button state changes, HC-SR04
+ * captures, DHT22 errors, I2C bus transactions) with the TRACE_* macros. Each mark
+ * is one 8-byte record: DWT cycle stamp, tag, 16-bit argument.
+ *
+ * - Build with TRACE_ENABLED=1 to record. With the default 0 every macro expands to
+ *   nothing: no code, no RAM, TRACE.c is not even linked in.
+ * - The ring keeps the last TRACE_BUF_SIZE records. A slot is claimed with one
+ *   atomic increment (LDREX/STREX on Cortex-M3), so main loop and ISRs can record
+ *   at the same time without masking interrupts.
+ * - TRACE_Dump sends the header + records oldest first through any byte sink:
+ *   TRACE_WriteSwo (ITM port 0) or a UART transmit wrapper.
+ * - On the PC, trace_decode turns a dump into a timeline and per-function latency
+ *   histograms.
+ */
+
+
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include "stm32f1xx_hal.h"
+#include "TRACE_FORMAT.h"
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+// Records kept (power of two), 8 bytes each
+#ifndef TRACE_BUF_SIZE
+#define TRACE_BUF_SIZE 256
+#endif
+
+// Byte sink used by TRACE_Dump
+typedef void (*TRACE_WriteFn)(void* ctx, const uint8_t* data, uint16_t len);
+
+void TRACE_Init(void);
+void TRACE_Start(void);
+void TRACE_Stop(void);
+void TRACE_Clear(void);
+void TRACE_Record(uint16_t tag, uint16_t arg);
+uint32_t TRACE_Count(void);
+uint32_t TRACE_Dump(TRACE_WriteFn write, void* ctx);
+void TRACE_WriteSwo(void* ctx, const uint8_t* data, uint16_t len);
+
+#if TRACE_ENABLED
+#define TRACE_ENTER(id, arg)  TRACE_Record(TRACE_TAG(TRACE_KIND_ENTER, (id)), (uint16_t)(arg))
+#define TRACE_EXIT(id, arg)   TRACE_Record(TRACE_TAG(TRACE_KIND_EXIT, (id)), (uint16_t)(arg))
+#define TRACE_EVENT(id, arg)  TRACE_Record(TRACE_TAG(TRACE_KIND_EVENT, (id)), (uint16_t)(arg))
+#else
+#define TRACE_ENTER(id, arg)  ((void)0)
+#define TRACE_EXIT(id, arg)   ((void)0)
+#define TRACE_EVENT(id, arg)  ((void)0)
+#endif
+
+#endif // __TRACE_H
@@ -0,0 +1,67 @@
+/**
+ * @file TRACE_FORMAT.h
+ * @brief Trace record layout and event ids, shared by the target and the host decoder.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ * Dump layout (little endian):
+ *   header  : "TRC1", uint32 core clock (Hz), uint32 record count, uint32 records lost
+ *   records : count x TRACE_Rec, oldest first
+ */
+
+
+
+#ifndef __TRACE_FORMAT_H
+#define __TRACE_FORMAT_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "TRC1"
+
+// Record kind, top 2 bits of the tag
+#define TRACE_KIND_ENTER 0U
+#define TRACE_KIND_EXIT  1U
+#define TRACE_KIND_EVENT 2U
+
+#define TRACE_TAG(kind, id)  ((uint16_t)(((kind) << 14) | ((id) & 0x3FFFU)))
+#define TRACE_TAG_KIND(tag)  ((uint16_t)(tag) >> 14)
+#define TRACE_TAG_ID(tag)    ((uint16_t)(tag) & 0x3FFFU)
+
+typedef enum {
+    TRACE_ID_NONE = 0,
+
+    // API enter / exit
+    TRACE_ID_BUTTON_UPDATE,     // BUTTON_Update
+    TRACE_ID_DHT22_READ,        // DHT22_Read
+    TRACE_ID_I2C_BUS_TRANSFER,  // I2C_BUS_Transfer (blocking through the queue)
+
+    // Events
+    TRACE_ID_BUTTON_STATE,      // arg = button << 8 | new ButtonState_t
+    TRACE_ID_BUTTON_PRESS,      // arg = button << 8 | ButtonPressType_t
+    TRACE_ID_DHT22_ERROR,       // arg = DHT22_StatusTypedef << 8 | bytes received
+    TRACE_ID_HCSR04_TRIGGER,
+    TRACE_ID_HCSR04_RISE,       // arg = captured counter
+    TRACE_ID_HCSR04_FALL,       // arg = captured counter
+    TRACE_ID_I2C_BUS_START,     // arg = 8-bit device address << 8 | I2C_BUS_Op
+    TRACE_ID_I2C_BUS_DONE,      // arg = HAL status << 8 | HAL_I2C_ERROR_* (low byte)
+    TRACE_ID_I2C_BUS_RECOVER,   // arg = SCL pulses << 8 | SDA released
+    TRACE_ID_USER,              // first id free for the application
+
+    TRACE_ID_MAX = 0x3FFF
+} TRACE_Id;
+
+typedef struct {
+    uint32_t Cycles;            // DWT->CYCCNT
+    uint16_t Tag;               // kind << 14 | TRACE_Id
+    uint16_t Arg;
+} TRACE_Rec;
+
+typedef struct {
+    char Magic[4];
+    uint32_t CoreClockHz;
+    uint32_t Count;
+    uint32_t Lost;              // records overwritten before the dump
+} TRACE_Header;
+
+#endif // __TRACE_FORMAT_H
@@ -0,0 +1,182 @@
+/**
+ * @file trace_decode.c
+ * @brief PC tool: turns a TRACE_Dump capture into latency histograms and a timeline.
+ *
+ * Author: Si_Tran
+ * Date: 10/16/2026
+ *
+ *   trace_decode <dump.bin> [--timeline]
+ *
+ * - Cycle stamps are 32-bit (~59 s at 72 MHz); they are unwrapped record by record,
+ *   so two records further apart than that show up closer than they were.
+ * - ENTER/EXIT pairs of the same id give one latency sample (nested calls pair with
+ *   the innermost ENTER). A record overwritten in the ring leaves its partner unpaired.
+ * - Latency histogram: one bucket per power of two of microseconds.
+ *
+ * Built on the PC only: it shares TRACE_FORMAT.h with the target, nothing else.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TRACE_FORMAT.h"
+
+#define MAX_DEPTH   16      // open ENTERs kept per id
+#define HIST_BUCKETS 24     // up to 2^23 us (~8 s)
+
+typedef struct {
+    uint32_t Count;         // records of any kind
+    uint32_t Samples;       // ENTER/EXIT pairs
+    uint32_t Unpaired;
+    uint64_t MinCy, MaxCy, SumCy;
+    uint32_t Hist[HIST_BUCKETS];
+    uint64_t Open[MAX_DEPTH];
+    uint8_t Depth;
+} IdStats;
+
+static const char* const names[TRACE_ID_USER] = {
+    [TRACE_ID_NONE]             = "none",
+    [TRACE_ID_BUTTON_UPDATE]    = "BUTTON_Update",
+    [TRACE_ID_DHT22_READ]       = "DHT22_Read",
+    [TRACE_ID_I2C_BUS_TRANSFER] = "I2C_BUS_Transfer",
+    [TRACE_ID_BUTTON_STATE]     = "button_state",
+    [TRACE_ID_BUTTON_PRESS]     = "button_press",
+    [TRACE_ID_DHT22_ERROR]      = "dht22_error",
+    [TRACE_ID_HCSR04_TRIGGER]   = "hcsr04_trigger",
+    [TRACE_ID_HCSR04_RISE]      = "hcsr04_rise",
+    [TRACE_ID_HCSR04_FALL]      = "hcsr04_fall",
+    [TRACE_ID_I2C_BUS_START]    = "i2c_bus_start",
+    [TRACE_ID_I2C_BUS_DONE]     = "i2c_bus_done",
+    [TRACE_ID_I2C_BUS_RECOVER]  = "i2c_bus_recover",
+};
+
+static IdStats stats[TRACE_ID_MAX + 1];
+
+static const char* Name(uint16_t id, char* buf) {
+    if (id < TRACE_ID_USER && names[id]) return names[id];
+    sprintf(buf, "user_%u", (unsigned)(id - TRACE_ID_USER));
+    return buf;
+}
+
+static uint32_t Bucket(uint64_t us) {
+    uint32_t b = 0;
+    while (us > 1 && b < HIST_BUCKETS - 1) {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void Pair(IdStats* s, uint16_t kind, uint64_t t, double cyPerUs) {
+    if (kind == TRACE_KIND_ENTER) {
+        if (s->Depth < MAX_DEPTH) s->Open[s->Depth++] = t;
+        else s->Unpaired++;
+        return;
+    }
+    if (s->Depth == 0) {
+        s->Unpaired++;      // ENTER lost with the overwritten records
+        return;
+    }
+    uint64_t cy = t - s->Open[--s->Depth];
+    if (s->Samples == 0 || cy < s->MinCy) s->MinCy = cy;
+    if (cy > s->MaxCy) s->MaxCy = cy;
+    s->SumCy += cy;
+    s->Samples++;
+    s->Hist[Bucket((uint64_t)(cy / cyPerUs))]++;
+}
+
+static void PrintHistogram(const IdStats* s) {
+    uint32_t peak = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        if (s->Hist[b] > peak) peak = s->Hist[b];
+    }
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        if (s->Hist[b] == 0) continue;
+        uint32_t bar = (uint32_t)((uint64_t)s->Hist[b] * 40U / peak);
+        printf("    %8lu us+ | %-40.*s %lu\n", b ? 1UL << b : 0UL, (int)(bar ? bar : 1),
+               "########################################", (unsigned long)s->Hist[b]);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int timeline = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--timeline") == 0) timeline = 1;
+        else path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s <dump.bin> [--timeline]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+
+    TRACE_Header hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || memcmp(hdr.Magic, TRACE_MAGIC, 4) != 0 || hdr.CoreClockHz == 0) {
+        fprintf(stderr, "%s: not a trace dump\n", path);
+        fclose(f);
+        return 1;
+    }
+    double cyPerUs = hdr.CoreClockHz / 1e6;
+
+    printf("trace: %lu records, %lu lost, core clock %lu Hz\n",
+           (unsigned long)hdr.Count, (unsigned long)hdr.Lost, (unsigned long)hdr.CoreClockHz);
+    if (timeline) printf("\n%12s %12s  %-5s %-18s %s\n", "time_us", "delta_us", "kind", "id", "arg");
+
+    // Timeline + pairing, one pass
+    TRACE_Rec rec;
+    uint64_t t = 0, first = 0, prev = 0;
+    uint32_t last = 0, n = 0;
+    char buf[16];
+    static const char* const kinds[] = { "ENTER", "EXIT", "EVENT", "?" };
+
+    while (n < hdr.Count && fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (n == 0) first = t = rec.Cycles;
+        else t += (uint32_t)(rec.Cycles - last);
+        last = rec.Cycles;
+
+        uint16_t kind = TRACE_TAG_KIND(rec.Tag);
+        uint16_t id = TRACE_TAG_ID(rec.Tag);
+        IdStats* s = &stats[id];
+        s->Count++;
+        if (kind == TRACE_KIND_ENTER || kind == TRACE_KIND_EXIT) Pair(s, kind, t, cyPerUs);
+
+        if (timeline) {
+            printf("%12.2f %12.2f  %-5s %-18s 0x%04X\n", (t - first) / cyPerUs, n ? (t - prev) / cyPerUs : 0.0,
+                   kinds[kind], Name(id, buf), rec.Arg);
+        }
+        prev = t;
+        n++;
+    }
+    fclose(f);
+    if (n != hdr.Count) fprintf(stderr, "%s: truncated, %lu of %lu records\n", path, (unsigned long)n,
+                                (unsigned long)hdr.Count);
+
+    // Per id summary
+    printf("\n%-18s %8s %8s %10s %10s %10s\n", "id", "records", "calls", "min_us", "avg_us", "max_us");
+    for (uint32_t id = 0; id <= TRACE_ID_MAX; id++) {
+        const IdStats* s = &stats[id];
+        if (s->Count == 0) continue;
+        printf("%-18s %8lu", Name((uint16_t)id, buf), (unsigned long)s->Count);
+        if (s->Samples) {
+            printf(" %8lu %10.2f %10.2f %10.2f", (unsigned long)s->Samples, s->MinCy / cyPerUs,
+                   (double)s->SumCy / s->Samples / cyPerUs, s->MaxCy / cyPerUs);
+        }
+        if (s->Unpaired || s->Depth) printf("  (%lu unpaired)", (unsigned long)(s->Unpaired + s->Depth));
+        printf("\n");
+    }
+
+    // Latency histograms
+    for (uint32_t id = 0; id <= TRACE_ID_MAX; id++) {
+        if (stats[id].Samples == 0) continue;
+        printf("\n%s latency\n", Name((uint16_t)id, buf));
+        PrintHistogram(&stats[id]);
+    }
+
+    return (n == hdr.Count) ? 0 : 1;
+}